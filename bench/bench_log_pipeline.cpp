@@ -0,0 +1,379 @@
+// bench-log-pipeline：日志处理链分阶段基准与多线程争用压测
+//
+// 用法: bench-log-pipeline [--quick] [--out <file.json>]
+// 输出: JSON（默认 stdout），便于不同构建之间对比
+//
+//   stages    单线程逐阶段 ns/op：filter / sample / enrich / redact / format /
+//             flight_record / submit / sink_write
+//   pipeline  端到端 Logger 调用，1~32 个生产者线程，模式：
+//             sync      同步写文件
+//             async     异步队列写文件
+//             filtered  级别过滤丢弃（不产生输出）
+//             overflow  小队列异步，统计溢出丢弃
+//             丢弃数 = 已调用次数 - 文件中实际行数
+
+#include "log.h"
+#include "log/log_level_filter.h"
+#include "log/log_sampler.h"
+#include "log/log_enricher.h"
+#include "log/log_redactor.h"
+#include "log/log_json_formatter.h"
+#include "log/log_async_dispatcher.h"
+#include "log/log_sink_manager.h"
+#include "log/log_flight_recorder.h"
+#include "log/log_module_table.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <dirent.h>
+
+using namespace tbox::fw::log;
+
+namespace {
+
+const std::string kBenchRoot = "/tmp/tbox_bench_log";
+const std::string kService = "bench";
+
+volatile uint64_t g_sink = 0;   // 防止编译器消除被测代码
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedNs(Clock::time_point start) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+struct StageResult {
+    std::string name;
+    uint64_t iterations;
+    double nsPerOp;
+};
+
+struct PipelineResult {
+    std::string mode;
+    uint32_t threads;
+    uint64_t records;
+    double nsPerRecord;         // 单个生产者视角：总耗时 × 线程数 / 总条数
+    double recordsPerSec;
+    uint64_t written;
+    uint64_t dropped;
+};
+
+template<typename Fn>
+StageResult runStage(const std::string& name, uint64_t iterations, Fn&& fn) {
+    // 预热
+    for (uint64_t i = 0; i < iterations / 10 + 1; ++i) fn(i);
+    Clock::time_point start = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) fn(i);
+    return {name, iterations, elapsedNs(start) / static_cast<double>(iterations)};
+}
+
+std::vector<Field> sampleFields() {
+    return {
+        Field::str("did", "0xF190"),
+        Field::i64("len", 17),
+        Field::str("vin", "LSVAX60E2K2000001"),
+        Field::str("token", "abcdef0123456789"),
+    };
+}
+
+uint64_t countLines(const std::string& dir) {
+    uint64_t lines = 0;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return 0;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.size() < 4 || name.compare(name.size() - 4, 4, ".log") != 0) continue;
+        FILE* f = fopen((dir + "/" + name).c_str(), "r");
+        if (!f) continue;
+        char buf[65536];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+            for (size_t i = 0; i < n; ++i) {
+                if (buf[i] == '\n') ++lines;
+            }
+        }
+        fclose(f);
+    }
+    closedir(d);
+    return lines;
+}
+
+void runShell(const std::string& cmd) {
+    if (system(cmd.c_str()) != 0) {
+        std::cerr << "warning: command failed: " << cmd << std::endl;
+    }
+}
+
+void removeDir(const std::string& dir) {
+    runShell("rm -rf '" + dir + "'");
+}
+
+// RollingFileSink 只创建 <root>/<service> 这一级，root 需预先存在
+void makeDir(const std::string& dir) {
+    runShell("mkdir -p '" + dir + "'");
+}
+
+LogConfig baseConfig() {
+    LogConfig config;
+    config.console_config.enabled = false;
+    config.file_config.enabled = true;
+    config.file_config.max_file_size_mb = 256;
+    config.file_config.max_files = 8;
+    config.file_config.total_budget_mb = 2048;
+    config.flight_recorder_config.enabled = false;
+    return config;
+}
+
+// ============================================================
+// 分阶段基准
+// ============================================================
+std::vector<StageResult> runStages(uint64_t iterations) {
+    std::vector<StageResult> results;
+    LogConfig config = baseConfig();
+    config.level = LogLevel::kInfo;
+    ModuleId module = ModuleTable::instance().intern("bench.stage");
+
+    LevelFilter filter(config);
+    results.push_back(runStage("filter_rejected", iterations * 10, [&](uint64_t) {
+        g_sink += filter.shouldLog(LogLevel::kDebug, module);
+    }));
+    results.push_back(runStage("filter_accepted", iterations * 10, [&](uint64_t) {
+        g_sink += filter.shouldLog(LogLevel::kInfo, module);
+    }));
+
+    SamplingRule rule;
+    rule.module = "bench.stage";
+    rule.every_n = 100;
+    Sampler sampler({rule});
+    results.push_back(runStage("sample_every_n", iterations * 10, [&](uint64_t) {
+        g_sink += sampler.shouldKeep(LogLevel::kDebug, module, "bench.event", nullptr);
+    }));
+
+    results.push_back(runStage("start_trace", iterations, [&](uint64_t) {
+        auto scope = ContextScope::startTrace();
+        g_sink += ContextScope::current()->trace_id.size();
+    }));
+
+    Enricher enricher(kService);
+    LogContext ctx;
+    ctx.trace_id = "trace-0123456789abcdef";
+    results.push_back(runStage("enrich", iterations, [&](uint64_t) {
+        auto out = enricher.enrich(sampleFields(), LogLevel::kInfo, module,
+                                   "diag.uds.tx", "frame sent", &ctx);
+        g_sink += out.size();
+    }));
+
+    Redactor redactor(config.redact_config);
+    std::vector<Field> enriched = enricher.enrich(sampleFields(), LogLevel::kInfo, module,
+                                                  "diag.uds.tx", "frame sent", &ctx);
+    results.push_back(runStage("redact", iterations, [&](uint64_t) {
+        auto out = redactor.redact(enriched);
+        g_sink += out.size();
+    }));
+
+    std::vector<Field> redacted = redactor.redact(enriched);
+    results.push_back(runStage("format", iterations, [&](uint64_t) {
+        g_sink += JsonLineFormatter::format(redacted).size();
+    }));
+
+    // 原始帧：截断发生在编码之前，4 KB 帧与 256 B 帧开销应基本一致
+    std::vector<unsigned char> frame(4096, 0x5A);
+    results.push_back(runStage("payload_256b", iterations, [&](uint64_t) {
+        auto out = redactor.redact({Field::bytes("frame", frame.data(), 256)});
+        g_sink += JsonLineFormatter::format(out).size();
+    }));
+    results.push_back(runStage("payload_4kb", iterations, [&](uint64_t) {
+        auto out = redactor.redact({Field::bytes("frame", frame.data(), frame.size())});
+        g_sink += JsonLineFormatter::format(out).size();
+    }));
+
+    std::string line = JsonLineFormatter::format(redacted);
+
+    FlightRecorderConfig flightConfig;
+    flightConfig.dir = kBenchRoot;
+    flightConfig.size_kb = 256;
+    removeDir(kBenchRoot);
+    {
+        FlightRecorder recorder(flightConfig, kService);
+        if (recorder.isAvailable()) {
+            results.push_back(runStage("flight_record", iterations, [&](uint64_t) {
+                recorder.record(LogLevel::kDebug, "bench.stage", "diag.uds.tx", "frame sent");
+            }));
+        }
+    }
+
+    {
+        AsyncDispatcher dispatcher(static_cast<uint32_t>(iterations * 2), 1000,
+                                   [](const std::string& l, bool) { g_sink += l.size(); return true; });
+        dispatcher.start();
+        results.push_back(runStage("submit", iterations, [&](uint64_t) {
+            dispatcher.submit(line, LogLevel::kInfo);
+        }));
+        dispatcher.stop();
+    }
+
+    config.file_config.root = kBenchRoot + "/stage";
+    makeDir(config.file_config.root);
+    {
+        SinkManager sinks(config, kService);
+        results.push_back(runStage("sink_write", iterations, [&](uint64_t) {
+            sinks.write(line);
+        }));
+    }
+    removeDir(kBenchRoot);
+    return results;
+}
+
+// ============================================================
+// 端到端多线程压测
+// ============================================================
+PipelineResult runPipeline(const std::string& mode, uint32_t threads, uint64_t totalRecords, uint32_t runId) {
+    LogConfig config = baseConfig();
+    config.file_config.root = kBenchRoot + "/run_" + std::to_string(runId);
+    config.level = LogLevel::kInfo;
+    config.async_config.enabled = mode != "sync";
+    if (mode == "filtered") {
+        config.level = LogLevel::kError;
+    } else if (mode == "overflow") {
+        config.async_config.queue_size = 64;
+    }
+    makeDir(config.file_config.root);
+    Logger::reload(config);
+
+    uint64_t perThread = totalRecords / threads;
+    std::atomic<uint32_t> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            Logger logger = Logger::get("bench.worker" + std::to_string(t % 4));
+            ready.fetch_add(1);
+            while (!go.load()) std::this_thread::yield();
+            for (uint64_t i = 0; i < perThread; ++i) {
+                logger.info("bench.record", "pipeline record", {
+                    Field::u64("seq", i),
+                    Field::str("did", "0xF190"),
+                    Field::i64("len", 17)
+                });
+            }
+        });
+    }
+    while (ready.load() < threads) std::this_thread::yield();
+
+    Clock::time_point start = Clock::now();
+    go = true;
+    for (auto& worker : workers) worker.join();
+    double ns = elapsedNs(start);
+
+    // 先切回同步（sink 不变，旧队列排空到本轮文件），再关闭文件 sink
+    LogConfig drain = config;
+    drain.async_config.enabled = false;
+    Logger::reload(drain);
+    drain.file_config.enabled = false;
+    Logger::reload(drain);
+
+    uint64_t records = perThread * threads;
+    uint64_t expected = mode == "filtered" ? 0 : records;
+    uint64_t written = countLines(config.file_config.root + "/" + kService);
+    removeDir(config.file_config.root);
+
+    PipelineResult result;
+    result.mode = mode;
+    result.threads = threads;
+    result.records = records;
+    result.nsPerRecord = ns * threads / static_cast<double>(records);
+    result.recordsPerSec = static_cast<double>(records) * 1e9 / ns;
+    result.written = written;
+    result.dropped = expected > written ? expected - written : 0;
+    return result;
+}
+
+std::string toJson(const std::vector<StageResult>& stages, const std::vector<PipelineResult>& runs) {
+    std::ostringstream os;
+    os.setf(std::ios::fixed);
+    os.precision(1);
+    os << "{\n  \"benchmark\": \"log_pipeline\",\n";
+#if defined(__clang__)
+    os << "  \"compiler\": \"clang " << __clang_major__ << "." << __clang_minor__ << "\",\n";
+#elif defined(__GNUC__)
+    os << "  \"compiler\": \"gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "\",\n";
+#endif
+#ifdef NDEBUG
+    os << "  \"assertions\": false,\n";
+#else
+    os << "  \"assertions\": true,\n";
+#endif
+    os << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    os << "  \"stages\": [\n";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        os << "    {\"name\": \"" << stages[i].name << "\", \"iterations\": " << stages[i].iterations
+           << ", \"ns_per_op\": " << stages[i].nsPerOp << "}" << (i + 1 < stages.size() ? "," : "") << "\n";
+    }
+    os << "  ],\n  \"pipeline\": [\n";
+    for (size_t i = 0; i < runs.size(); ++i) {
+        const PipelineResult& r = runs[i];
+        os << "    {\"mode\": \"" << r.mode << "\", \"threads\": " << r.threads
+           << ", \"records\": " << r.records << ", \"ns_per_record\": " << r.nsPerRecord
+           << ", \"records_per_sec\": " << r.recordsPerSec << ", \"written\": " << r.written
+           << ", \"dropped\": " << r.dropped << "}" << (i + 1 < runs.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+    return os.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool quick = false;
+    std::string outPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            quick = true;
+        } else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--quick] [--out <file.json>]" << std::endl;
+            return 2;
+        }
+    }
+
+    uint64_t stageIterations = quick ? 20000 : 200000;
+    uint64_t pipelineRecords = quick ? 20000 : 200000;
+
+    std::vector<StageResult> stages = runStages(stageIterations);
+
+    LogConfig initConfig = baseConfig();
+    initConfig.file_config.enabled = false;
+    Logger::init(kService, initConfig);
+
+    std::vector<PipelineResult> runs;
+    const char* modes[] = {"sync", "async", "filtered", "overflow"};
+    const uint32_t threadCounts[] = {1, 2, 4, 8, 16, 32};
+    uint32_t runId = 0;
+    for (const char* mode : modes) {
+        for (uint32_t threads : threadCounts) {
+            runs.push_back(runPipeline(mode, threads, pipelineRecords, runId++));
+        }
+    }
+    removeDir(kBenchRoot);
+
+    std::string json = toJson(stages, runs);
+    if (outPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream out(outPath);
+        out << json;
+        std::cerr << "Wrote " << outPath << std::endl;
+    }
+    return 0;
+}
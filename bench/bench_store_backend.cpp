@@ -0,0 +1,313 @@
+// bench-store-backend：Store 存储后端对比
+//
+// 用法: bench-store-backend [--quick] [--out <file.json>]
+// 输出: JSON（默认 stdout），便于不同构建之间对比
+//
+//   ops   每个后端逐操作 ns/op：
+//         save_int      写穿模式，小值在 100 个 key 间轮换
+//         save_1kb      写穿模式，1 KB 字符串
+//         save_batch    写回模式，每 100 次 save 一次 flush（摊到每次 save）
+//         save_async    saveAsync 在 10 个 key 间轮换，每 100 次一次 flush（同 key 合并写入）
+//         save_int_8t   8 个线程各写不同的 key，总耗时 / 总次数
+//         load_hot      同一 key 反复读取
+//         has_hit       同一 key 反复 has
+//         load_missing  不存在的 key 反复 loadOr
+//         open          已有 1000 个 key 时重新打开（恢复索引）
+//   codec 值编解码 ns/op（backend 字段为 codec）：
+//         encode_double / decode_double   二进制格式
+//         decode_text_double              旧版文本格式（istringstream）
+//         crc32c_1kb / crc32c_1kb_table   1 KB 校验，当前实现 / 查表实现
+//   lock  FileLock 加解锁 ns/op（backend 字段为 file_lock），总耗时 / 总次数：
+//         acquire_release_1t / _8t       1 个 / 8 个线程各自锁不同的 key
+//         acquire_release_8t_contended   7 个线程锁各自的 key，第 8 个线程反复持有热点 key 200us
+//   disk  1000 个小 key 占用的磁盘块字节数（st_blocks × 512）
+//
+//   file_per_key    每个 key 一个文件：写temp → fsync → rename → fsync(dir)
+//   log_structured  单文件追加 + 内存索引：每批一次 fdatasync
+
+#include "store.h"
+#include "store/store_crc32c.h"
+#include "store/store_file_lock.h"
+#include "store/store_serializer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <dirent.h>
+#include <sys/stat.h>
+
+using namespace hwyz::store;
+
+namespace {
+
+const std::string kBenchRoot = "/tmp/tbox_bench_store";
+
+volatile uint64_t g_sink = 0;   // 防止编译器消除被测代码
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedNs(Clock::time_point start) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+struct OpResult {
+    std::string backend;
+    std::string op;
+    uint64_t iterations;
+    double nsPerOp;
+};
+
+struct DiskResult {
+    std::string backend;
+    uint64_t keys;
+    uint64_t bytes;
+};
+
+void removeDir(const std::string& path) {
+    std::string cmd = "rm -rf '" + path + "'";
+    int ret = system(cmd.c_str());
+    (void)ret;
+}
+
+uint64_t diskBytes(const std::string& dir) {
+    uint64_t total = 0;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return 0;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") continue;
+        struct stat st;
+        if (stat((dir + "/" + name).c_str(), &st) == 0) {
+            total += static_cast<uint64_t>(st.st_blocks) * 512;
+        }
+    }
+    closedir(d);
+    return total;
+}
+
+StoreOptions optionsFor(StoreBackend backend) {
+    StoreOptions options;
+    options.backend = backend;
+    return options;
+}
+
+template<typename Fn>
+OpResult runOp(const std::string& backend, const std::string& op, uint64_t iterations, Fn&& fn) {
+    fn(0);  // 预热：建立文件与缓存
+    Clock::time_point start = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) fn(i);
+    return {backend, op, iterations, elapsedNs(start) / static_cast<double>(iterations)};
+}
+
+// threads 个线程各执行 iterations 次 fn(thread, i)，返回墙钟时间 / 总次数
+template<typename Fn>
+OpResult runParallel(const std::string& backend, const std::string& op, int threads,
+                     uint64_t iterations, Fn&& fn) {
+    for (int t = 0; t < threads; ++t) fn(t, 0);
+    std::vector<std::thread> workers;
+    Clock::time_point start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&fn, t, iterations]() {
+            for (uint64_t i = 0; i < iterations; ++i) fn(t, i);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    uint64_t total = iterations * static_cast<uint64_t>(threads);
+    return {backend, op, total, elapsedNs(start) / static_cast<double>(total)};
+}
+
+void runLock(uint64_t iterations, std::vector<OpResult>& ops) {
+    removeDir(kBenchRoot);
+    PathResolver resolver("bench_lock", kBenchRoot);
+    resolver.ensureDirectory();
+    FileLock lock(resolver);
+
+    auto acquireRelease = [&](int thread, uint64_t) {
+        std::string key = "key" + std::to_string(thread);
+        lock.acquire(key, 1000);
+        lock.release(key);
+    };
+    ops.push_back(runParallel("file_lock", "acquire_release_1t", 1, iterations, acquireRelease));
+    ops.push_back(runParallel("file_lock", "acquire_release_8t", 8, iterations, acquireRelease));
+
+    // 另一线程反复长时间持有一个热点 key：其余线程的无关 key 不应受影响
+    std::atomic<bool> stop(false);
+    std::thread holder([&]() {
+        while (!stop) {
+            lock.acquire("hot", 1000);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            lock.release("hot");
+        }
+    });
+    ops.push_back(runParallel("file_lock", "acquire_release_8t_contended", 7, iterations, acquireRelease));
+    stop = true;
+    holder.join();
+    removeDir(kBenchRoot);
+}
+
+void runBackend(const std::string& name, StoreBackend backend, uint64_t saveIterations,
+                uint64_t loadIterations, std::vector<OpResult>& ops, std::vector<DiskResult>& disks) {
+    std::string service = "bench_" + name;
+    removeDir(kBenchRoot);
+    StoreOptions options = optionsFor(backend);
+    std::string value1kb(1024, 'v');
+
+    {
+        Store store = Store::open(service, kBenchRoot, options);
+        ops.push_back(runOp(name, "save_int", saveIterations, [&](uint64_t i) {
+            store.save<int>("counter" + std::to_string(i % 100), static_cast<int>(i));
+        }));
+        ops.push_back(runOp(name, "save_1kb", saveIterations, [&](uint64_t i) {
+            store.save<std::string>("blob" + std::to_string(i % 100), value1kb);
+        }));
+        ops.push_back(runOp(name, "save_async", saveIterations, [&](uint64_t i) {
+            store.saveAsync<int>("counter" + std::to_string(i % 10), static_cast<int>(i), nullptr);
+            if (i % 100 == 99) store.flush();
+        }));
+        ops.push_back(runParallel(name, "save_int_8t", 8, saveIterations / 8, [&](int thread, uint64_t i) {
+            store.save<int>("t" + std::to_string(thread) + "." + std::to_string(i % 10), static_cast<int>(i));
+        }));
+        ops.push_back(runOp(name, "load_hot", loadIterations, [&](uint64_t) {
+            g_sink += static_cast<uint64_t>(store.load<int>("counter1"));
+        }));
+        ops.push_back(runOp(name, "has_hit", loadIterations, [&](uint64_t) {
+            g_sink += store.has("counter1") ? 1 : 0;
+        }));
+        ops.push_back(runOp(name, "load_missing", loadIterations, [&](uint64_t) {
+            g_sink += static_cast<uint64_t>(store.loadOr<int>("absent", 1));
+        }));
+        store.cleanup();
+    }
+
+    {
+        StoreOptions writeBack = options;
+        writeBack.writeMode = WriteMode::kWriteBack;
+        writeBack.flushPolicy.debounceMs = 60000;
+        Store store = Store::open(service, kBenchRoot, writeBack);
+        ops.push_back(runOp(name, "save_batch", saveIterations * 10, [&](uint64_t i) {
+            store.save<int>("counter" + std::to_string(i % 100), static_cast<int>(i));
+            if (i % 100 == 99) store.flush();
+        }));
+        store.cleanup();
+    }
+
+    const uint64_t diskKeys = 1000;
+    {
+        StoreOptions writeBack = options;
+        writeBack.writeMode = WriteMode::kWriteBack;
+        writeBack.flushPolicy.debounceMs = 60000;
+        writeBack.flushPolicy.maxDirtyCount = diskKeys + 1;
+        Store store = Store::open(service, kBenchRoot, writeBack);
+        for (uint64_t i = 0; i < diskKeys; ++i) {
+            store.save<int>("key" + std::to_string(i), static_cast<int>(i));
+        }
+        store.flush();
+    }
+    disks.push_back({name, diskKeys, diskBytes(kBenchRoot + "/" + service)});
+
+    ops.push_back(runOp(name, "open", 20, [&](uint64_t) {
+        Store store = Store::open(service, kBenchRoot, options);
+        g_sink += store.has("key1") ? 1 : 0;
+    }));
+    removeDir(kBenchRoot);
+}
+
+void runCodec(uint64_t iterations, std::vector<OpResult>& ops) {
+    Serializer serializer;
+    std::string encoded = serializer.serialize<double>(3.141592653589793);
+    std::string text = "3.14159";
+    std::string block(1024, 'c');
+
+    ops.push_back(runOp("codec", "encode_double", iterations, [&](uint64_t i) {
+        g_sink += serializer.serialize<double>(static_cast<double>(i) * 0.5).size();
+    }));
+    ops.push_back(runOp("codec", "decode_double", iterations, [&](uint64_t) {
+        double value = 0.0;
+        g_sink += serializer.deserialize(encoded, value) ? static_cast<uint64_t>(value) : 0;
+    }));
+    ops.push_back(runOp("codec", "decode_text_double", iterations, [&](uint64_t) {
+        double value = 0.0;
+        g_sink += serializer.deserialize(text, value) ? static_cast<uint64_t>(value) : 0;
+    }));
+    ops.push_back(runOp("codec", "crc32c_1kb", iterations, [&](uint64_t) {
+        g_sink += crc32c(block.data(), block.size());
+    }));
+    ops.push_back(runOp("codec", "crc32c_1kb_table", iterations, [&](uint64_t) {
+        g_sink += crc32cPortable(block.data(), block.size());
+    }));
+}
+
+std::string toJson(const std::vector<OpResult>& ops, const std::vector<DiskResult>& disks) {
+    std::ostringstream os;
+    os.setf(std::ios::fixed);
+    os.precision(1);
+    os << "{\n  \"benchmark\": \"store_backend\",\n";
+#if defined(__clang__)
+    os << "  \"compiler\": \"clang " << __clang_major__ << "." << __clang_minor__ << "\",\n";
+#elif defined(__GNUC__)
+    os << "  \"compiler\": \"gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "\",\n";
+#endif
+#ifdef NDEBUG
+    os << "  \"assertions\": false,\n";
+#else
+    os << "  \"assertions\": true,\n";
+#endif
+    os << "  \"ops\": [\n";
+    for (size_t i = 0; i < ops.size(); ++i) {
+        os << "    {\"backend\": \"" << ops[i].backend << "\", \"op\": \"" << ops[i].op
+           << "\", \"iterations\": " << ops[i].iterations << ", \"ns_per_op\": " << ops[i].nsPerOp
+           << "}" << (i + 1 < ops.size() ? "," : "") << "\n";
+    }
+    os << "  ],\n  \"disk\": [\n";
+    for (size_t i = 0; i < disks.size(); ++i) {
+        os << "    {\"backend\": \"" << disks[i].backend << "\", \"keys\": " << disks[i].keys
+           << ", \"bytes\": " << disks[i].bytes << "}" << (i + 1 < disks.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+    return os.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool quick = false;
+    std::string outPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            quick = true;
+        } else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--quick] [--out <file.json>]" << std::endl;
+            return 2;
+        }
+    }
+
+    uint64_t saveIterations = quick ? 200 : 2000;
+    uint64_t loadIterations = quick ? 20000 : 200000;
+
+    std::vector<OpResult> ops;
+    std::vector<DiskResult> disks;
+    runBackend("file_per_key", StoreBackend::kFilePerKey, saveIterations, loadIterations, ops, disks);
+    runBackend("log_structured", StoreBackend::kLogStructured, saveIterations, loadIterations, ops, disks);
+    runCodec(loadIterations, ops);
+    runLock(loadIterations, ops);
+
+    std::string json = toJson(ops, disks);
+    if (outPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream out(outPath);
+        out << json;
+        std::cerr << "Wrote " << outPath << std::endl;
+    }
+    return 0;
+}
@@ -2,6 +2,7 @@
 
 #include "config_types.h"
 #include <string>
+#include <cstdint>
 #include <memory>
 #include <functional>
 #include <vector>
@@ -34,6 +35,19 @@ public:
     // 获取最后错误信息
     ConfigErrorInfo getLastError() const;
 
+    // 重新读取并合并配置文件（线程安全）
+    // 失败时保留原快照；成功后对内容发生变化的节通知订阅者
+    // 并发调用依次执行，快照与回调按调用顺序生效；回调内不可再调用 reload()
+    ConfigError reload();
+
+    // 订阅顶层配置节（如 "log"）的变化，回调在 reload() 的调用线程执行
+    // sectionView 为变化后的节内容，节被删除时为 nullptr
+    using SubscriptionId = uint64_t;
+    using ChangeCallback = std::function<void(const std::string& section,
+                                              std::shared_ptr<const ImmutableConfigView> sectionView)>;
+    SubscriptionId subscribe(const std::string& section, ChangeCallback callback);
+    void unsubscribe(SubscriptionId id);
+
 private:
     ConfigManager();
     ~ConfigManager();
@@ -74,6 +88,11 @@ public:
 
     // 获取所有键
     virtual std::vector<std::string> getKeys() const = 0;
+
+    // 序列化为 YAML 文本（用于变化比较与交给各模块的配置适配器）
+    // 默认经 getKeys/getSection/getStringList/getString 逐层重建，标量均按字符串输出；
+    // 实现持有原始文本时应覆盖
+    virtual std::string toYaml() const;
 };
 
 // 便捷宏：获取配置管理器实例
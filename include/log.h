@@ -1,9 +1,14 @@
 #pragma once
 
 #include "log_types.h"
+#include "log_catalog.h"
+#include "log_format.h"
 #include <string>
+#include <string_view>
 #include <memory>
 #include <initializer_list>
+#include <tuple>
+#include <utility>
 
 namespace tbox {
 namespace fw {
@@ -19,7 +24,18 @@ public:
     // 初始化日志系统（每个服务启动时调用一次）
     static InitResult init(const std::string& service, const LogConfig& config);
 
+    // 热重载：整体替换处理链（级别、模块级别、采样、sink、脱敏），不重启、不丢记录；
+    // 正在记录的线程继续使用旧处理链直至返回，旧异步队列排空后回收
+    static InitResult reload(const LogConfig& config);
+
+    // 定向级别覆盖：ContextScope 的 trace_id / session_id 匹配时按 override.level 放行，
+    // 跨热重载保留（与配置中的 level_overrides 合并生效）。返回用于移除的 ID，未初始化时返回 0
+    static uint64_t addLevelOverride(const LevelOverride& override);
+    static bool removeLevelOverride(uint64_t id);
+
     // 获取指定模块的 Logger 实例
+    // 同一模块共享一个实例，查找开销低，可在热路径调用；
+    // 允许在 init 之前获取：init 之前 ERROR 及以上写 stderr，其余丢弃，init 之后自动接入处理链
     static Logger get(const std::string& module);
 
     // 日志输出方法
@@ -36,6 +52,45 @@ public:
     [[noreturn]] void fatal(std::string_view event, std::string_view message,
                             std::initializer_list<Field> fields = {});
 
+    // 模板消息：参数按引用转交，通过级别与采样过滤后才编码为 CatalogArgs，
+    // 被过滤的记录不做任何编码；编码在 240 字节（CatalogArgs::kCapacity）以内时不分配，
+    // 超出时整体转入堆存储，长参数与后续参数均完整保留（见 log_format.h）
+    template<typename T, typename... Args>
+    void trace(std::string_view event, FormatString<detail::NonDeducedT<T>, detail::NonDeducedT<Args>...> format,
+               const T& arg, const Args&... args) {
+        logFormat(LogLevel::kTrace, event, format.get(), arg, args...);
+    }
+    template<typename T, typename... Args>
+    void debug(std::string_view event, FormatString<detail::NonDeducedT<T>, detail::NonDeducedT<Args>...> format,
+               const T& arg, const Args&... args) {
+        logFormat(LogLevel::kDebug, event, format.get(), arg, args...);
+    }
+    template<typename T, typename... Args>
+    void info(std::string_view event, FormatString<detail::NonDeducedT<T>, detail::NonDeducedT<Args>...> format,
+              const T& arg, const Args&... args) {
+        logFormat(LogLevel::kInfo, event, format.get(), arg, args...);
+    }
+    template<typename T, typename... Args>
+    void warn(std::string_view event, FormatString<detail::NonDeducedT<T>, detail::NonDeducedT<Args>...> format,
+              const T& arg, const Args&... args) {
+        logFormat(LogLevel::kWarn, event, format.get(), arg, args...);
+    }
+    template<typename T, typename... Args>
+    void error(std::string_view event, FormatString<detail::NonDeducedT<T>, detail::NonDeducedT<Args>...> format,
+               const T& arg, const Args&... args) {
+        logFormat(LogLevel::kError, event, format.get(), arg, args...);
+    }
+
+    // 静态目录记录：级别/模块/事件/消息/key 取自 site，只传参数值
+    // file.format 为 binary 时按 ID + 参数写入二进制段；否则还原为字段走常规处理链
+    template<typename... Args>
+    void emit(const CatalogSite& site, const Args&... args) {
+        if (!m_impl) return;
+        CatalogArgs packed;
+        (packed.add(args), ...);
+        emitPacked(site, packed);
+    }
+
     void flush();
 
 private:
@@ -43,15 +98,57 @@ private:
     class Impl;
     std::shared_ptr<Impl> m_impl;
 
+    void emitPacked(const CatalogSite& site, const CatalogArgs& args);
+
+    // 按需编码参数：source 指向调用方栈上的参数引用元组，仅在调用期间有效
+    using ArgPacker = void (*)(CatalogArgs& out, const void* source);
+
+    template<typename... Args>
+    void logFormat(LogLevel level, std::string_view event, std::string_view format, const Args&... args) {
+        if (!m_impl) return;
+        auto refs = std::forward_as_tuple(args...);
+        using Refs = decltype(refs);
+        ArgPacker pack = [](CatalogArgs& out, const void* source) {
+            std::apply([&out](const auto&... values) { (out.add(values), ...); },
+                       *static_cast<const Refs*>(source));
+        };
+        logPacked(level, event, format, pack, &refs);
+    }
+    void logPacked(LogLevel level, std::string_view event, std::string_view format,
+                   ArgPacker pack, const void* source);
+
     friend class LoggerRegistry;
 };
 
 // ============================================================
 // ContextScope — RAII 上下文传播
+//
+// 上下文保存在线程局部变量中，跨线程时用 capture()/restore() 携带：
+//
+//   auto handle = ContextScope::capture();
+//   executor.post([handle] {
+//       auto scope = ContextScope::restore(handle);
+//       logger.info("tsp.upload", "in worker");     // 带原线程的 trace_id
+//   });
+//
+// 或直接 executor.post(ContextScope::bind(task))。
 // ============================================================
 class ContextScope {
 public:
-    explicit ContextScope(LogContext context);
+    // 捕获的上下文快照：定长值类型，拷贝不分配
+    class Handle {
+    public:
+        Handle() noexcept = default;
+        bool active() const noexcept { return m_active; }
+        const LogContext& context() const noexcept { return m_context; }
+
+    private:
+        friend class ContextScope;
+        LogContext m_context;
+        bool m_active = false;
+    };
+
+    explicit ContextScope(const LogContext& context);
     ~ContextScope();
 
     ContextScope(const ContextScope&) = delete;
@@ -59,7 +156,30 @@ public:
 
     static const LogContext* current();
 
+    // 快照当前线程的上下文（无上下文时返回未激活的句柄）
+    static Handle capture() noexcept;
+    // 在当前线程恢复快照，作用域结束后回到原上下文；未激活的句柄恢复为“无上下文”
+    static ContextScope restore(const Handle& handle) { return ContextScope(handle); }
+
+    // 包装可调用对象：调用时在执行线程上恢复包装时的上下文
+    template<typename Fn>
+    static auto bind(Fn&& fn) {
+        return [handle = capture(), fn = std::forward<Fn>(fn)](auto&&... args) mutable {
+            ContextScope scope(handle);
+            return fn(std::forward<decltype(args)>(args)...);
+        };
+    }
+
+    // 生成 W3C 格式的 trace-id（32 位小写十六进制，非全零）；
+    // 线程局部 PRNG，首次使用时播种，之后不分配、不进系统调用
+    static LogContext::Id newTraceId() noexcept;
+
+    // 以新的 trace-id 开启一段上下文（保留当前的 request_id / session_id）
+    static ContextScope startTrace();
+
 private:
+    explicit ContextScope(const Handle& handle);
+
     LogContext m_context;
     const LogContext* m_previous;
 };
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "log_types.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <initializer_list>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// ============================================================
+// 静态事件目录（NanoLog 风格）
+//
+// 调用点的静态部分（模块、级别、事件、消息模板、字段 key）在
+// CatalogSite 构造时登记一次，分配进程内唯一的 ID；之后每条记录
+// 只携带 ID、时间戳与紧凑编码的参数值。file.format 为 binary 时
+// 写入 <svc>_N.tlog 二进制段，由 tbox-log-decode 离线还原为 JSON；
+// 其他情况下按字段还原后走常规 JSON 处理链，调用方式不变。
+//
+// 用法：
+//   static const CatalogSite kCanRx("can", LogLevel::kDebug, "can.rx",
+//                                   "frame received", {"id", "dlc", "data"});
+//   logger.emit(kCanRx, frameId, dlc, std::string_view(data, len));
+// ============================================================
+
+// 目录字段 key 及其敏感级别
+struct CatalogKey {
+    const char* name;
+    Sensitivity sensitivity;
+
+    CatalogKey(const char* n, Sensitivity s = Sensitivity::Normal) : name(n), sensitivity(s) {}
+};
+
+class CatalogSite {
+public:
+    CatalogSite(const char* module, LogLevel level, const char* event, const char* message,
+                std::initializer_list<CatalogKey> keys = {});
+
+    CatalogSite(const CatalogSite&) = delete;
+    CatalogSite& operator=(const CatalogSite&) = delete;
+
+    uint32_t id() const { return m_id; }
+    uint16_t moduleId() const { return m_moduleId; }
+    const char* module() const { return m_module; }
+    LogLevel level() const { return m_level; }
+    const char* event() const { return m_event; }
+    const char* message() const { return m_message; }
+    const std::vector<CatalogKey>& keys() const { return m_keys; }
+
+    // 含密钥类 key 或非 Normal 敏感级别：二进制模式下改走 JSON 脱敏路径
+    bool requiresRedaction() const { return m_requiresRedaction; }
+
+private:
+    const char* m_module;
+    LogLevel m_level;
+    const char* m_event;
+    const char* m_message;
+    std::vector<CatalogKey> m_keys;
+    uint32_t m_id;
+    uint16_t m_moduleId;
+    bool m_requiresRedaction;
+};
+
+// ============================================================
+// CatalogArgs — 参数值的紧凑编码
+//
+// 每个参数：1 字节类型标签 + 值
+//   有符号整数 zigzag varint / 无符号整数 varint / double 8 字节 /
+//   bool 1 字节 / 字符串与字节 varint 长度 + 内容
+// 编码不超过 kCapacity 时只用栈上缓冲，不分配；超出后整体转入堆存储，
+// 参数不截断、不丢弃。
+// ============================================================
+class CatalogArgs {
+public:
+    static constexpr size_t kCapacity = 240;
+
+    enum Tag : uint8_t { kTagInt = 1, kTagUint = 2, kTagDouble = 3, kTagBool = 4, kTagString = 5 };
+
+    template<typename T>
+    void add(const T& value) {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same<U, bool>::value) {
+            uint8_t* out = reserve(2);
+            out[0] = kTagBool;
+            out[1] = value ? 1 : 0;
+            m_size += 2;
+        } else if constexpr (std::is_integral<U>::value && std::is_signed<U>::value) {
+            int64_t v = static_cast<int64_t>(value);
+            putTagged(kTagInt, (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+        } else if constexpr (std::is_integral<U>::value || std::is_enum<U>::value) {
+            putTagged(kTagUint, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_floating_point<U>::value) {
+            uint8_t* out = reserve(1 + sizeof(double));
+            double d = static_cast<double>(value);
+            out[0] = kTagDouble;
+            std::memcpy(out + 1, &d, sizeof(double));
+            m_size += 1 + sizeof(double);
+        } else {
+            addString(std::string_view(value));
+        }
+        ++m_count;
+    }
+
+    const uint8_t* data() const { return m_heap.empty() ? m_buf : m_heap.data(); }
+    size_t size() const { return m_size; }
+    uint8_t count() const { return m_count; }
+    // 编码是否已转入堆存储
+    bool spilled() const { return !m_heap.empty(); }
+
+private:
+    uint8_t m_buf[kCapacity];
+    std::vector<uint8_t> m_heap;    // 非空时为全部编码
+    size_t m_size = 0;
+    uint8_t m_count = 0;
+
+    // 返回可写入 n 字节的位置（当前末尾）
+    uint8_t* reserve(size_t n) {
+        size_t need = m_size + n;
+        if (m_heap.empty()) {
+            if (need <= kCapacity) {
+                return m_buf + m_size;
+            }
+            m_heap.reserve(need > 2 * kCapacity ? need : 2 * kCapacity);
+            m_heap.assign(m_buf, m_buf + m_size);
+        }
+        if (m_heap.size() < need) {
+            m_heap.resize(need);
+        }
+        return m_heap.data() + m_size;
+    }
+
+    uint8_t* putVarint(uint8_t* out, uint64_t v) {
+        while (v >= 0x80) {
+            *out++ = static_cast<uint8_t>(v | 0x80);
+            v >>= 7;
+        }
+        *out++ = static_cast<uint8_t>(v);
+        return out;
+    }
+
+    void putTagged(uint8_t tag, uint64_t v) {
+        uint8_t* start = reserve(11);
+        uint8_t* out = start;
+        *out++ = tag;
+        out = putVarint(out, v);
+        m_size += static_cast<size_t>(out - start);
+    }
+
+    void addString(std::string_view s) {
+        uint8_t* start = reserve(1 + 10 + s.size());
+        uint8_t* out = start;
+        *out++ = kTagString;
+        out = putVarint(out, s.size());
+        std::memcpy(out, s.data(), s.size());
+        out += s.size();
+        m_size += static_cast<size_t>(out - start);
+    }
+};
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
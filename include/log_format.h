@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string_view>
+#include <cstddef>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// ============================================================
+// FormatString — 延迟格式化的消息模板
+//
+//   logger.info("net.link", "link {} up after {} ms", ifname, ms);
+//
+// 模板只接受字符串字面量（记录入队后仍须有效）；参数按值打包，
+// 记录通过级别过滤与采样之后才展开，异步模式下在 dispatcher 线程展开。
+// 占位符为 {}（花括号内的格式说明暂被忽略），{{ 与 }} 表示字面花括号。
+// 以 C++20 编译时占位符数量与参数个数不一致直接报错；C++17 下多余的
+// 参数被忽略，缺少的占位符原样输出。
+// ============================================================
+namespace detail {
+
+template<typename T>
+struct NonDeduced { using type = T; };
+template<typename T>
+using NonDeducedT = typename NonDeduced<T>::type;
+
+constexpr size_t countPlaceholders(const char* s, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (s[i] == '{') {
+            if (i + 1 < n && s[i + 1] == '{') {
+                ++i;
+                continue;
+            }
+            while (i < n && s[i] != '}') ++i;
+            ++count;
+        } else if (s[i] == '}' && i + 1 < n && s[i + 1] == '}') {
+            ++i;
+        }
+    }
+    return count;
+}
+
+// 非 constexpr：在 consteval 构造中被调用即产生编译错误
+void formatArgumentCountMismatch();
+
+} // namespace detail
+
+template<typename... Args>
+class FormatString {
+public:
+    template<size_t N>
+#if defined(__cpp_consteval)
+    consteval FormatString(const char (&str)[N]) : m_str(str, N - 1) {
+        if (detail::countPlaceholders(str, N - 1) != sizeof...(Args)) {
+            detail::formatArgumentCountMismatch();
+        }
+    }
+#else
+    constexpr FormatString(const char (&str)[N]) : m_str(str, N - 1) {}
+#endif
+
+    constexpr std::string_view get() const { return m_str; }
+
+private:
+    std::string_view m_str;
+};
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "log_types.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include <climits>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// ============================================================
+// 读取过滤条件（各条件之间为“与”关系）
+//
+// 只在行内扫描 "level" / "module" / "timestamp" 三个 key，不做完整 JSON 解析
+// ============================================================
+struct LogReadFilter {
+    LogLevel min_level = LogLevel::kTrace;
+    std::vector<std::string> modules;   // 为空表示不限
+    int64_t from_ms = 0;                // epoch 毫秒，含
+    int64_t to_ms = INT64_MAX;          // epoch 毫秒，含
+};
+
+struct LogReaderOptions {
+    bool start_at_end = false;          // true：从活动段末尾开始（tail -f），否则从最旧段开始
+    size_t batch_lines = 256;           // 单批最多行数
+    size_t map_window_bytes = 1 << 20;  // 单次映射窗口，限定常驻内存（超长行临时放大）
+};
+
+// ============================================================
+// LogReader — 顺序读取并跟随 RollingFileSink 输出的 JSON 段
+//
+// 目录为 <file.root>/<service>，段文件为 <service>_N.log。
+// 按段序号从旧到新读取，读到活动段末尾后通过 inotify 等待追加或新段，
+// 滚动对调用方透明；落后过多、段已被预算淘汰时跳到仍存在的下一个段。
+// 只交付以换行结尾的完整行，写到一半的行等下次追加后再交付。
+//
+// 批次中的行借用映射内存，仅在回调期间有效。
+// 除 stop() 外，同一实例的方法不可并发调用。
+// 二进制段（.tlog）不在读取范围内，需先经 tbox-log-decode 还原。
+// ============================================================
+class LogReader {
+public:
+    // 返回 false 时停止读取
+    using BatchCallback = std::function<bool(const std::vector<std::string_view>& lines)>;
+
+    LogReader();
+    ~LogReader();
+
+    LogReader(const LogReader&) = delete;
+    LogReader& operator=(const LogReader&) = delete;
+
+    LogErrorInfo open(const std::string& logDir, const std::string& service,
+                      const LogReadFilter& filter = LogReadFilter(),
+                      const LogReaderOptions& options = LogReaderOptions());
+
+    // 非阻塞：交付当前已写出的全部匹配行
+    LogErrorInfo readAvailable(const BatchCallback& callback);
+
+    // 阻塞跟随：交付已有内容后持续等待新内容，直到 stop()、回调返回 false
+    // 或 timeoutMs 内没有新内容（-1 表示一直等待）
+    LogErrorInfo follow(const BatchCallback& callback, int timeoutMs = -1);
+
+    // 可从其他线程调用，唤醒并结束 follow()
+    void stop();
+
+    // 当前读取位置（段序号、段内偏移）
+    uint32_t currentSegment() const;
+    uint64_t currentOffset() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "log_types.h"
+#include <string>
+#include <string_view>
+#include <functional>
+#include <cstdint>
+#include <climits>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// ============================================================
+// 检索条件（各条件之间为“与”关系，空字符串表示不限）
+// ============================================================
+struct LogSearchQuery {
+    std::string trace_id;
+    std::string request_id;
+    int64_t from_ms = 0;                // epoch 毫秒，含
+    int64_t to_ms = INT64_MAX;          // epoch 毫秒，含
+    size_t limit = 0;                   // 最多返回条数，0 表示不限
+};
+
+// 检索统计（用于评估索引效果）
+struct LogSearchStats {
+    uint32_t segments_total = 0;
+    uint32_t segments_skipped = 0;      // 被索引整体排除的段
+    uint32_t segments_unindexed = 0;    // 缺少或无法使用索引、需整段扫描的段
+    uint64_t bytes_scanned = 0;
+    uint64_t matched = 0;
+};
+
+// ============================================================
+// LogSearch — 基于段索引检索 RollingFileSink 输出的 JSON 日志
+//
+// 目录为 <file.root>/<service>，段文件为 <service>_N.log，
+// 旁路索引为 <service>_N.log.idx。按段序号从旧到新返回匹配行。
+// ============================================================
+class LogSearch {
+public:
+    // 返回 false 时停止检索
+    using Visitor = std::function<bool(std::string_view line)>;
+
+    static LogErrorInfo search(const std::string& logDir, const std::string& service,
+                               const LogSearchQuery& query, const Visitor& visitor,
+                               LogSearchStats* stats = nullptr);
+
+    // 为目录下全部段重建索引（升级前写出的日志），返回成功重建的段数
+    static int reindex(const std::string& logDir, const std::string& service);
+
+    // 解析 "YYYY-MM-DDTHH:MM:SS[.mmm]Z" 为 epoch 毫秒，失败返回 -1
+    static int64_t parseTimestamp(std::string_view iso);
+};
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
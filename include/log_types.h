@@ -1,16 +1,20 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <cstdint>
+#include <cstddef>
+#include <cstring>
 #include <vector>
 #include <unordered_map>
+#include <map>
 
 namespace tbox {
 namespace fw {
 namespace log {
 
 // ============================================================
-// 错误码定义 (FW-0201~0205)
+// 错误码定义 (FW-0201~0206)
 // ============================================================
 enum class LogError : uint32_t {
     kOk = 0,
@@ -18,7 +22,8 @@ enum class LogError : uint32_t {
     kInitFailed = 202,          // FW-0202: registry/队列/worker 初始化失败
     kSinkFailed = 203,          // FW-0203: sink 打开/写入/flush/滚动失败
     kQueueOverflow = 204,       // FW-0204: 异步队列溢出
-    kSensitiveViolation = 205   // FW-0205: 字段违反敏感信息策略
+    kSensitiveViolation = 205,  // FW-0205: 字段违反敏感信息策略
+    kSearchFailed = 206         // FW-0206: 日志段检索失败（目录/段文件不可读）
 };
 
 // 错误信息结构
@@ -74,51 +79,236 @@ enum class Sensitivity : uint8_t {
 };
 
 // ============================================================
-// 字段值类型（简化版，避免依赖 std::variant（C++17））
+// 字段值类型（带标签的联合体，避免依赖 std::variant）
 // ============================================================
 enum class FieldValueType : uint8_t {
     kString,
     kInt64,
     kDouble,
-    kBool
+    kBool,
+    kUint64,
+    kBytes      // 原始字节，编码时转十六进制（或 base64）
 };
 
+// 字段值：标量直接存放在联合体中；字符串/字节不超过 kInlineCapacity 时内联存储，
+// 超长时堆分配；makeStringView 借用调用方内存，调用方须保证其在日志调用返回前有效
 struct FieldValue {
+    static constexpr size_t kInlineCapacity = 24;
+
     FieldValueType type;
     union {
         int64_t intVal;
+        uint64_t uintVal;
         double doubleVal;
         bool boolVal;
+        const char* m_ptr;                  // 内部：堆/借用存储
+        char m_inline[kInlineCapacity];     // 内部：内联存储
     };
-    std::string stringVal; // 用于 kString 类型
+
+    FieldValue() noexcept : type(FieldValueType::kInt64), intVal(0), m_storage(Storage::kNone), m_size(0) {}
+    FieldValue(const FieldValue& other);
+    FieldValue(FieldValue&& other) noexcept;
+    FieldValue& operator=(const FieldValue& other);
+    FieldValue& operator=(FieldValue&& other) noexcept;
+    ~FieldValue() { release(); }
+
+    // 字符串/字节内容（kString / kBytes），其他类型返回空
+    std::string_view stringView() const noexcept;
+
+    // 是否借用外部内存
+    bool isBorrowed() const noexcept { return m_storage == Storage::kBorrowed; }
+
+    // 把借用内容拷贝为自有存储（记录需要在调用返回后继续使用时）
+    void own();
+
+    // 字节载荷：只保留前 maxSize 字节并打上截断标记，不拷贝（借用时仍指向原缓冲区）
+    void truncateBytes(size_t maxSize) noexcept;
+    bool isTruncated() const noexcept { return (m_flags & kFlagTruncated) != 0; }
+    // 字节载荷编码为 base64（默认十六进制）
+    void setBase64(bool enabled) noexcept {
+        m_flags = enabled ? (m_flags | kFlagBase64) : (m_flags & ~kFlagBase64);
+    }
+    bool isBase64() const noexcept { return (m_flags & kFlagBase64) != 0; }
 
     // 便捷构造
-    static FieldValue makeString(const std::string& v);
-    static FieldValue makeInt(int64_t v);
-    static FieldValue makeDouble(double v);
-    static FieldValue makeBool(bool v);
+    static FieldValue makeString(std::string_view v);
+    static FieldValue makeStringView(std::string_view v) noexcept;
+    static FieldValue makeInt(int64_t v) noexcept;
+    static FieldValue makeUint(uint64_t v) noexcept;
+    static FieldValue makeDouble(double v) noexcept;
+    static FieldValue makeBool(bool v) noexcept;
+    static FieldValue makeBytes(const void* data, size_t size);
+    // 借用字节：调用方保证 data 在日志调用返回前有效
+    static FieldValue makeBytesView(const void* data, size_t size) noexcept;
+
+private:
+    enum class Storage : uint8_t { kNone, kInline, kHeap, kBorrowed };
+    static constexpr uint8_t kFlagTruncated = 0x01;
+    static constexpr uint8_t kFlagBase64 = 0x02;
+
+    Storage m_storage;
+    uint8_t m_flags = 0;
+    uint32_t m_size;
+
+    void assignCopy(FieldValueType t, const char* data, size_t size);
+    void release() noexcept;
 };
 
 // ============================================================
 // 结构化字段
 // ============================================================
 struct Field {
-    std::string key;
+    std::string_view key;       // 字面量 key 直接借用；运行期 key 指向 ownedKey
     FieldValue value;
     Sensitivity sensitivity;
+    std::string ownedKey;
 
     Field() : sensitivity(Sensitivity::Normal) {}
-    Field(const std::string& k, const FieldValue& v, Sensitivity s = Sensitivity::Normal)
-        : key(k), value(v), sensitivity(s) {}
+
+    // 字面量 key：不分配（char 数组同样借用，需在调用返回后保留时调用 own()）
+    template<size_t N>
+    Field(const char (&k)[N], FieldValue v, Sensitivity s = Sensitivity::Normal)
+        : key(k), value(std::move(v)), sensitivity(s) {}
+
+    // 运行期 key：拷贝一份
+    Field(const std::string& k, FieldValue v, Sensitivity s = Sensitivity::Normal)
+        : value(std::move(v)), sensitivity(s), ownedKey(k) { key = ownedKey; }
+
+    Field(const Field& other)
+        : key(other.key), value(other.value), sensitivity(other.sensitivity), ownedKey(other.ownedKey) {
+        if (!ownedKey.empty()) key = ownedKey;
+    }
+    Field(Field&& other) noexcept
+        : key(other.key), value(std::move(other.value)), sensitivity(other.sensitivity),
+          ownedKey(std::move(other.ownedKey)) {
+        if (!ownedKey.empty()) key = ownedKey;
+    }
+    Field& operator=(const Field& other) {
+        if (this != &other) {
+            value = other.value;
+            sensitivity = other.sensitivity;
+            ownedKey = other.ownedKey;
+            key = ownedKey.empty() ? other.key : std::string_view(ownedKey);
+        }
+        return *this;
+    }
+    Field& operator=(Field&& other) noexcept {
+        if (this != &other) {
+            value = std::move(other.value);
+            sensitivity = other.sensitivity;
+            ownedKey = std::move(other.ownedKey);
+            key = ownedKey.empty() ? other.key : std::string_view(ownedKey);
+        }
+        return *this;
+    }
+
+    // 把借用的 key 与值拷贝为自有存储（记录需要在调用返回后继续使用时）
+    void own() {
+        if (ownedKey.empty() && !key.empty()) {
+            ownedKey.assign(key.data(), key.size());
+            key = ownedKey;
+        }
+        value.own();
+    }
+
+    // 类型化构造（字面量 key，标量与短字符串不分配）
+    template<size_t N>
+    static Field str(const char (&k)[N], std::string_view v, Sensitivity s = Sensitivity::Normal) {
+        return Field(k, FieldValue::makeString(v), s);
+    }
+    // 借用字符串：调用方保证 v 在日志调用返回前有效
+    template<size_t N>
+    static Field view(const char (&k)[N], std::string_view v, Sensitivity s = Sensitivity::Normal) {
+        return Field(k, FieldValue::makeStringView(v), s);
+    }
+    template<size_t N>
+    static Field i64(const char (&k)[N], int64_t v) {
+        return Field(k, FieldValue::makeInt(v));
+    }
+    template<size_t N>
+    static Field u64(const char (&k)[N], uint64_t v) {
+        return Field(k, FieldValue::makeUint(v));
+    }
+    template<size_t N>
+    static Field f64(const char (&k)[N], double v) {
+        return Field(k, FieldValue::makeDouble(v));
+    }
+    template<size_t N>
+    static Field flag(const char (&k)[N], bool v) {
+        return Field(k, FieldValue::makeBool(v));
+    }
+    // 原始字节：借用调用方缓冲区，脱敏时按 raw_payload_max_bytes 截断，
+    // 只有保留下来的前缀会被拷贝或编码，大帧与小帧开销相同
+    template<size_t N>
+    static Field bytes(const char (&k)[N], const void* data, size_t size,
+                       Sensitivity s = Sensitivity::Payload) {
+        return Field(k, FieldValue::makeBytesView(data, size), s);
+    }
+};
+
+// ============================================================
+// InlineId — 定长内联 ID 存储
+//
+// 最多 N 字节，超出部分截断；平凡可拷贝，拷贝/赋值不分配。
+// 可隐式转换为 std::string_view，按字符串语义比较。
+// ============================================================
+template<size_t N>
+class InlineId {
+public:
+    static constexpr size_t kCapacity = N;
+
+    InlineId() noexcept : m_size(0) {}
+    InlineId(std::string_view v) noexcept { assign(v); }
+    InlineId(const char* v) noexcept { assign(std::string_view(v)); }
+    InlineId(const std::string& v) noexcept { assign(std::string_view(v)); }
+
+    InlineId& operator=(std::string_view v) noexcept { assign(v); return *this; }
+    InlineId& operator=(const char* v) noexcept { assign(std::string_view(v)); return *this; }
+    InlineId& operator=(const std::string& v) noexcept { assign(std::string_view(v)); return *this; }
+
+    void assign(std::string_view v) noexcept {
+        m_size = static_cast<uint8_t>(v.size() < N ? v.size() : N);
+        std::memcpy(m_data, v.data(), m_size);
+    }
+    void clear() noexcept { m_size = 0; }
+
+    bool empty() const noexcept { return m_size == 0; }
+    size_t size() const noexcept { return m_size; }
+    const char* data() const noexcept { return m_data; }
+    std::string_view view() const noexcept { return std::string_view(m_data, m_size); }
+    std::string str() const { return std::string(m_data, m_size); }
+    operator std::string_view() const noexcept { return view(); }
+
+    // 每种右操作数都给出精确匹配的重载，避免隐式构造带来的歧义
+    friend bool operator==(const InlineId& a, const InlineId& b) noexcept { return a.view() == b.view(); }
+    friend bool operator==(const InlineId& a, std::string_view b) noexcept { return a.view() == b; }
+    friend bool operator==(const InlineId& a, const char* b) noexcept { return a.view() == b; }
+    friend bool operator==(const InlineId& a, const std::string& b) noexcept { return a.view() == b; }
+    friend bool operator==(std::string_view a, const InlineId& b) noexcept { return b == a; }
+    friend bool operator==(const char* a, const InlineId& b) noexcept { return b == a; }
+    friend bool operator==(const std::string& a, const InlineId& b) noexcept { return b == a; }
+    template<typename T>
+    friend bool operator!=(const InlineId& a, const T& b) noexcept { return !(a == b); }
+
+private:
+    static_assert(N > 0 && N < 256, "InlineId capacity must fit in uint8_t");
+
+    char m_data[N];
+    uint8_t m_size;
 };
 
 // ============================================================
 // 日志上下文（用于 ContextScope 传播）
+//
+// 三个 ID 均为 48 字节内联存储（放得下 32 位十六进制的 W3C trace-id
+// 与 36 字符的带连字符 UUID），整个上下文可按值拷贝进任务闭包，不分配
 // ============================================================
 struct LogContext {
-    std::string trace_id;
-    std::string request_id;
-    std::string session_id;
+    using Id = InlineId<48>;
+
+    Id trace_id;
+    Id request_id;
+    Id session_id;
 };
 
 // ============================================================
@@ -140,11 +330,65 @@ struct FileConfig {
     uint32_t max_file_size_mb = 20;
     uint32_t max_files = 5;
     uint32_t total_budget_mb = 100;
+    bool index = true;                      // 为每个段维护 .idx 旁路索引（时间桶 + trace/request Bloom）
+    std::string format = "json";            // json / binary（<svc>_N.tlog，静态目录记录只写 ID 与参数）
+};
+
+// 飞行记录器：崩溃后可提取的全级别环形缓冲（mmap 到 tmpfs）
+struct FlightRecorderConfig {
+    bool enabled = true;
+    std::string dir = "/run/tbox";
+    uint32_t size_kb = 256;
+    bool dump_on_crash = true;              // 致命信号时把环内容转储到 stderr
+};
+
+// 错误回溯：线程内最近 size 条被级别过滤（且不低于 capture_level）的记录不格式化地
+// 暂存在环中，同一线程（有 trace 上下文时限同一 trace）记录 ERROR 及以上时先补写，
+// 并标记 "backtrace": true
+struct BacktraceConfig {
+    bool enabled = false;
+    uint32_t size = 64;
+    LogLevel capture_level = LogLevel::kDebug;
+};
+
+// 定向级别覆盖：当前 ContextScope 的 trace_id / session_id 与 value 相同（prefix 为 true
+// 时以 value 开头）的记录按 level 放行，用于针对单个请求或会话临时打开 DEBUG
+// trace_id 与 session_id 二选一；module 为空表示所有模块
+struct LevelOverride {
+    std::string trace_id;
+    std::string session_id;
+    bool prefix = false;
+    std::string module;
+    LogLevel level = LogLevel::kDebug;
+};
+
+// 路由规则：按顺序匹配 (module, level)，首条命中的规则决定记录写往哪些 sink；
+// 无规则命中时写往 console 与 file。sinks 取值 console / file / log.sinks 中的命名 sink，
+// 为空表示丢弃
+struct SinkRoute {
+    std::string module;                     // 为空表示所有模块
+    LogLevel min_level = LogLevel::kTrace;
+    LogLevel max_level = LogLevel::kFatal;
+    std::vector<std::string> sinks;
+};
+
+// 采样规则：在级别过滤之后、enrich 之前生效，仅作用于 level <= max_level 的记录
+// every_n 与 trace_ratio 二选一：
+//   every_n      按模块（可限定事件）每 N 条保留 1 条
+//   trace_ratio  按 trace_id 哈希确定性保留，同一请求整体保留或整体丢弃；
+//                无 trace 上下文的记录退化为每 round(1/ratio) 条保留 1 条
+struct SamplingRule {
+    std::string module;
+    std::string event;                      // 为空表示该模块的全部事件
+    LogLevel max_level = LogLevel::kDebug;
+    uint32_t every_n = 0;
+    double trace_ratio = 0.0;
 };
 
 struct RedactConfig {
     std::string identifiers = "mask";       // mask / reject / hash
     uint32_t raw_payload_max_bytes = 256;
+    std::string payload_encoding = "hex";   // 字节载荷编码：hex / base64
 };
 
 struct LogConfig {
@@ -155,8 +399,18 @@ struct LogConfig {
     ConsoleConfig console_config;
     FileConfig file_config;
     RedactConfig redact_config;
+    FlightRecorderConfig flight_recorder_config;
+    BacktraceConfig backtrace_config;
     // 模块级别覆盖: <module> -> LogLevel
     std::unordered_map<std::string, LogLevel> module_levels;
+    // 命名文件 sink：<root>/<service>-<name>/，各自滚动与预算
+    std::map<std::string, FileConfig> named_sinks;
+    // sink 路由表，在处理链构建时编译为按 (ModuleId, level) 的位图
+    std::vector<SinkRoute> routes;
+    // 定向级别覆盖（运行期还可通过 Logger::addLevelOverride 追加）
+    std::vector<LevelOverride> level_overrides;
+    // 采样规则，按顺序匹配，首条命中的规则生效
+    std::vector<SamplingRule> sampling_rules;
 };
 
 // ============================================================
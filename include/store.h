@@ -1,14 +1,23 @@
 #pragma once
 
 #include "store_types.h"
+#include "store_codec.h"
 #include <string>
 #include <memory>
+#include <functional>
+#include <future>
+#include <cstddef>
 
 namespace hwyz {
 namespace store {
 
 class Store {
 public:
+    class WriteBatch;
+
+    // 异步写入完成回调，在 I/O 线程调用；error 为 nullptr 表示成功
+    using AsyncCallback = std::function<void(const StoreErrorInfo* error)>;
+
     ~Store();
     Store(Store&& other);
     Store& operator=(Store&& other);
@@ -16,6 +25,16 @@ public:
     static Store open(const std::string& serviceName,
                       const std::string& storeRoot = "/var/lib/tbox");
 
+    // 指定写入模式打开；kWriteBack 下 save 只更新内存并标脏，
+    // 由后台线程按 flushPolicy 落盘，flush() 强制落盘，析构时落盘剩余脏数据
+    //
+    // 警告：options.lockWaitSignal 非 0 时，首次跨进程锁等待会为该信号安装进程级空处理函数
+    // （不带 SA_RESTART），并在等待期间解除本线程对它的屏蔽。所选信号须未被进程或其他库使用；
+    // 该信号已有处理函数时不覆盖，退化为重试。默认 0 不触碰任何信号
+    static Store open(const std::string& serviceName,
+                      const std::string& storeRoot,
+                      const StoreOptions& options);
+
     template<typename T>
     void save(const std::string& key, const T& value);
 
@@ -25,10 +44,36 @@ public:
     template<typename T>
     T loadOr(const std::string& key, const T& defaultValue) const;
 
+    // 解码到调用方已有的对象，不经过中间缓冲：vector / string 复用已有容量，
+    // 结构体直接读入。失败抛 StoreException，此时 value 内容未定义
+    template<typename T>
+    void loadInto(const std::string& key, T& value) const;
+
+    // std::vector<uint8_t> 值直接读入定长缓冲区，返回字节数；容量不足抛 kSerializationFailed
+    size_t loadInto(const std::string& key, void* buffer, size_t capacity) const;
+
     bool has(const std::string& key) const;
 
     void remove(const std::string& key);
 
+    // 异步写入：调用方线程只做编码（失败当场抛出），写盘交给本 Store 的 I/O 线程。
+    // 同一 key 尚未执行的写入合并为最后一次，各调用方的 future / 回调都在该次完成后就绪。
+    // 排队期间 load / has 直接读取队列；同一 key 的同步写入会先等待其正在执行的异步写入。
+    // flush() 与析构等待队列执行完毕；cleanup() 丢弃队列，未完成的写入以 kPathUnavailable 结束。
+    // 回调中不要调用 flush()
+    template<typename T>
+    std::future<void> saveAsync(const std::string& key, const T& value);
+
+    template<typename T>
+    void saveAsync(const std::string& key, const T& value, AsyncCallback done);
+
+    std::future<void> removeAsync(const std::string& key);
+
+    void removeAsync(const std::string& key, AsyncCallback done);
+
+    // 创建批量写入，commit() 之前不产生任何 I/O
+    WriteBatch batch();
+
     void flush();
 
     bool isReady() const;
@@ -39,7 +84,118 @@ private:
     Store();
     class Impl;
     std::unique_ptr<Impl> m_impl;
+
+    // 模板只负责 StoreCodec 编解码，其余在 Impl 中完成
+    void saveEncoded(const std::string& key, uint8_t typeTag, CodecWriter& writer);
+    std::future<void> saveAsyncEncoded(const std::string& key, uint8_t typeTag, CodecWriter& writer);
+    void saveAsyncEncoded(const std::string& key, uint8_t typeTag, CodecWriter& writer, AsyncCallback done);
+    void loadDecoded(const std::string& key, const detail::CodecTarget& target) const;
 };
 
+// ============================================================
+// Store::WriteBatch — 多 key 原子提交
+//
+//   auto batch = store.batch();
+//   batch.put<std::string>("provision.vin", vin)
+//        .put<int>("provision.step", 3)
+//        .remove("provision.pending");
+//   batch.commit();
+//
+// commit() 后全部变更同时可见、同时落盘；掉电后要么全部生效要么全部不生效。
+// 同步次数：日志结构后端固定一次 fdatasync；文件级后端为本批写入的文件数 + 4
+// （每个文件一次 fdatasync，另有 journal 一次、目录三次），不使用会刷写整个文件系统的 syncfs。
+// 同一 key 多次操作时以最后一次为准。
+// 不得长于创建它的 Store。
+// ============================================================
+class Store::WriteBatch {
+public:
+    ~WriteBatch();
+    WriteBatch(WriteBatch&& other);
+    WriteBatch& operator=(WriteBatch&& other);
+
+    // 立即序列化，失败抛 kSerializationFailed
+    template<typename T>
+    WriteBatch& put(const std::string& key, const T& value);
+
+    WriteBatch& remove(const std::string& key);
+
+    size_t size() const;
+
+    void clear();
+
+    // 失败抛 StoreException，批次内容保留，可重试
+    void commit();
+
+private:
+    friend class Store;
+    explicit WriteBatch(Store::Impl* store);
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+
+    void putEncoded(const std::string& key, uint8_t typeTag, CodecWriter& writer);
+};
+
+// ============================================================
+// 模板实现：任何有 StoreCodec<T> 的类型均可使用
+// ============================================================
+template<typename T>
+void Store::save(const std::string& key, const T& value) {
+    CodecWriter writer;
+    StoreCodec<T>::encode(value, writer);
+    saveEncoded(key, StoreCodec<T>::kTypeTag, writer);
+}
+
+template<typename T>
+std::future<void> Store::saveAsync(const std::string& key, const T& value) {
+    CodecWriter writer;
+    StoreCodec<T>::encode(value, writer);
+    return saveAsyncEncoded(key, StoreCodec<T>::kTypeTag, writer);
+}
+
+template<typename T>
+void Store::saveAsync(const std::string& key, const T& value, AsyncCallback done) {
+    CodecWriter writer;
+    StoreCodec<T>::encode(value, writer);
+    saveAsyncEncoded(key, StoreCodec<T>::kTypeTag, writer, std::move(done));
+}
+
+template<typename T>
+T Store::load(const std::string& key) const {
+    T value;
+    loadDecoded(key, detail::codecTarget(value));
+    return value;
+}
+
+// 读缓存只保存以下类型，其 load 在库内实现
+template<> int Store::load<int>(const std::string& key) const;
+template<> double Store::load<double>(const std::string& key) const;
+template<> bool Store::load<bool>(const std::string& key) const;
+template<> std::string Store::load<std::string>(const std::string& key) const;
+
+template<typename T>
+T Store::loadOr(const std::string& key, const T& defaultValue) const {
+    try {
+        return load<T>(key);
+    } catch (const StoreException& e) {
+        if (e.getError().code == StoreError::kKeyNotFound) {
+            return defaultValue;
+        }
+        throw;
+    }
+}
+
+template<typename T>
+void Store::loadInto(const std::string& key, T& value) const {
+    loadDecoded(key, detail::codecTarget(value));
+}
+
+template<typename T>
+Store::WriteBatch& Store::WriteBatch::put(const std::string& key, const T& value) {
+    CodecWriter writer;
+    StoreCodec<T>::encode(value, writer);
+    putEncoded(key, StoreCodec<T>::kTypeTag, writer);
+    return *this;
+}
+
 } // namespace store
 } // namespace hwyz
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace hwyz {
+namespace store {
+
+// 值类型标签，写入每个值的帧头；读取时与 StoreCodec<T>::kTypeTag 不一致即失败。
+// 自定义编解码器使用 kTagUser 及以上的值
+enum StoreTypeTag : uint8_t {
+    kTagBool = 1,
+    kTagInt8 = 2,
+    kTagUInt8 = 3,
+    kTagInt16 = 4,
+    kTagUInt16 = 5,
+    kTagInt32 = 6,
+    kTagUInt32 = 7,
+    kTagInt64 = 8,
+    kTagUInt64 = 9,
+    kTagFloat = 10,
+    kTagDouble = 11,
+    kTagString = 12,
+    kTagBytes = 13,
+    kTagStruct = 14,
+    kTagUser = 0x80,
+};
+
+namespace detail {
+
+template<typename U>
+inline void storeLE(char* p, U v) {
+    for (size_t i = 0; i < sizeof(U); ++i) {
+        p[i] = static_cast<char>(static_cast<uint8_t>(v >> (8 * i)));
+    }
+}
+
+template<typename U>
+inline U loadLE(const char* p) {
+    U v = 0;
+    for (size_t i = 0; i < sizeof(U); ++i) {
+        v |= static_cast<U>(static_cast<uint8_t>(p[i])) << (8 * i);
+    }
+    return v;
+}
+
+template<size_t N> struct UIntOf;
+template<> struct UIntOf<1> { using type = uint8_t; };
+template<> struct UIntOf<2> { using type = uint16_t; };
+template<> struct UIntOf<4> { using type = uint32_t; };
+template<> struct UIntOf<8> { using type = uint64_t; };
+
+constexpr size_t kFrameHeaderSize = 12;
+
+} // namespace detail
+
+// ============================================================
+// CodecWriter — 编码输出，追加到帧头之后
+// ============================================================
+class CodecWriter {
+public:
+    CodecWriter() : m_buffer(detail::kFrameHeaderSize, '\0') {}
+
+    void reserve(size_t payloadSize) { m_buffer.reserve(detail::kFrameHeaderSize + payloadSize); }
+
+    void write(const void* data, size_t size) {
+        m_buffer.append(static_cast<const char*>(data), size);
+    }
+
+    // 整数按固定宽度小端写入
+    template<typename U>
+    void writeLE(U value) {
+        char bytes[sizeof(U)];
+        detail::storeLE(bytes, value);
+        m_buffer.append(bytes, sizeof(U));
+    }
+
+    // 帧头（预留）+ payload，由 Store 填写帧头
+    std::string& buffer() { return m_buffer; }
+
+private:
+    std::string m_buffer;
+};
+
+// ============================================================
+// CodecReader — 解码输入，按需从内存或文件读取 payload
+//
+// 从文件读取时 read() 直接 pread 到调用方的目标内存，不经过中间缓冲；
+// 不超过 kInlineSize 的值首次读取时一次读入内部缓冲，省去多次系统调用。
+// ============================================================
+class CodecReader {
+public:
+    static constexpr size_t kInlineSize = 256;
+
+    CodecReader(const char* data, size_t size)
+        : m_data(data), m_remaining(size) {}
+    CodecReader(int fd, uint64_t offset, size_t size)
+        : m_fd(fd), m_offset(offset), m_remaining(size) {}
+
+    CodecReader(const CodecReader&) = delete;
+    CodecReader& operator=(const CodecReader&) = delete;
+
+    // 剩余数据不足或读取失败返回 false
+    bool read(void* data, size_t size);
+
+    template<typename U>
+    bool readLE(U& value) {
+        char bytes[sizeof(U)];
+        if (!read(bytes, sizeof(U))) {
+            return false;
+        }
+        value = detail::loadLE<U>(bytes);
+        return true;
+    }
+
+    size_t remaining() const { return m_remaining; }
+
+    // 文件读取出错（区别于内容不符）
+    bool ioError() const { return m_ioError; }
+
+    // 此后读取的数据累计 CRC32C，由帧解码校验
+    void beginChecksum(uint32_t seed) { m_checksum = true; m_crc = seed; }
+    uint32_t checksum() const { return m_crc; }
+
+private:
+    const char* m_data = nullptr;
+    int m_fd = -1;
+    char m_inline[kInlineSize];
+    uint64_t m_offset = 0;
+    size_t m_remaining = 0;
+    bool m_ioError = false;
+    bool m_checksum = false;
+    uint32_t m_crc = 0;
+};
+
+// ============================================================
+// StoreCodec<T> — 值类型的编解码扩展点
+//
+// 特化需提供：
+//   static const uint8_t kTypeTag;                        // 见 StoreTypeTag
+//   static void encode(const T& value, CodecWriter& out);
+//   static bool decode(CodecReader& in, T& value);        // 须读完 in.remaining()
+// 可选：
+//   static bool decodeText(const std::string& text, T& value);   // 旧版文本格式
+//
+// 内置：算术类型（固定宽度小端）、std::string、std::vector<uint8_t>。
+// 平凡可复制结构体继承 TrivialStoreCodec 即可：
+//
+//   struct Calibration { float gain[16]; uint32_t flags; };
+//   template<> struct hwyz::store::StoreCodec<Calibration>
+//       : hwyz::store::TrivialStoreCodec<Calibration, 2> {};
+// ============================================================
+template<typename T, typename Enable = void>
+struct StoreCodec;
+
+template<typename T>
+struct StoreCodec<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+    static_assert(sizeof(T) <= 8, "long double is not supported");
+
+    using Bits = typename detail::UIntOf<sizeof(T)>::type;
+
+    static constexpr uint8_t kTypeTag =
+        std::is_same<T, bool>::value ? kTagBool
+      : std::is_floating_point<T>::value ? (sizeof(T) == 4 ? kTagFloat : kTagDouble)
+      : sizeof(T) == 1 ? (std::is_signed<T>::value ? kTagInt8 : kTagUInt8)
+      : sizeof(T) == 2 ? (std::is_signed<T>::value ? kTagInt16 : kTagUInt16)
+      : sizeof(T) == 4 ? (std::is_signed<T>::value ? kTagInt32 : kTagUInt32)
+      : (std::is_signed<T>::value ? kTagInt64 : kTagUInt64);
+
+    static void encode(const T& value, CodecWriter& out) {
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        if (std::is_same<T, bool>::value) {
+            bits = value ? 1 : 0;
+        }
+        out.writeLE(bits);
+    }
+
+    static bool decode(CodecReader& in, T& value) {
+        Bits bits;
+        if (in.remaining() != sizeof(T) || !in.readLE(bits)) {
+            return false;
+        }
+        if (std::is_same<T, bool>::value) {
+            value = (bits != 0);
+        } else {
+            std::memcpy(&value, &bits, sizeof(T));
+        }
+        return true;
+    }
+
+    // 旧版 ostringstream 文本：要求整段解析完毕
+    static bool decodeText(const std::string& text, T& value) {
+        std::istringstream iss(text);
+        T parsed;
+        iss >> parsed;
+        if (iss.fail() || iss.peek() != std::char_traits<char>::eof()) {
+            return false;
+        }
+        value = parsed;
+        return true;
+    }
+};
+
+template<>
+struct StoreCodec<std::string> {
+    static constexpr uint8_t kTypeTag = kTagString;
+
+    static void encode(const std::string& value, CodecWriter& out) {
+        out.write(value.data(), value.size());
+    }
+
+    static bool decode(CodecReader& in, std::string& value) {
+        value.resize(in.remaining());
+        return value.empty() || in.read(&value[0], value.size());
+    }
+
+    static bool decodeText(const std::string& text, std::string& value) {
+        value = text;
+        return true;
+    }
+};
+
+// 二进制数据（证书等）；loadInto 复用 vector 已有容量
+template<>
+struct StoreCodec<std::vector<uint8_t>> {
+    static constexpr uint8_t kTypeTag = kTagBytes;
+
+    static void encode(const std::vector<uint8_t>& value, CodecWriter& out) {
+        out.write(value.data(), value.size());
+    }
+
+    static bool decode(CodecReader& in, std::vector<uint8_t>& value) {
+        value.resize(in.remaining());
+        return value.empty() || in.read(value.data(), value.size());
+    }
+};
+
+// 平凡可复制结构体：payload 为 schema(4) | size(4) | 内存布局原样。
+// 结构体变更时递增 Schema，读到其他版本或大小不符时 load 抛 kSerializationFailed。
+// 布局随编译器与字节序而定，仅用于同一平台的本地持久化
+template<typename T, uint32_t Schema>
+struct TrivialStoreCodec {
+    static_assert(std::is_trivially_copyable<T>::value, "TrivialStoreCodec requires a trivially copyable type");
+
+    static constexpr uint8_t kTypeTag = kTagStruct;
+    static constexpr uint32_t kSchemaVersion = Schema;
+
+    static void encode(const T& value, CodecWriter& out) {
+        out.writeLE<uint32_t>(Schema);
+        out.writeLE<uint32_t>(static_cast<uint32_t>(sizeof(T)));
+        out.write(&value, sizeof(T));
+    }
+
+    // 直接读入调用方的对象
+    static bool decode(CodecReader& in, T& value) {
+        uint32_t schema = 0;
+        uint32_t size = 0;
+        return in.remaining() == 8 + sizeof(T) &&
+               in.readLE(schema) && schema == Schema &&
+               in.readLE(size) && size == sizeof(T) &&
+               in.read(&value, sizeof(T));
+    }
+};
+
+namespace detail {
+
+// 解码目标：类型无关的回调，供 Store 的非模板实现调用
+struct CodecTarget {
+    uint8_t typeTag;
+    void* object;
+    bool (*decode)(CodecReader& in, void* object);
+    bool (*decodeText)(const std::string& text, void* object);  // nullptr 表示不兼容旧版文本
+};
+
+template<typename Codec, typename T, typename = void>
+struct HasDecodeText : std::false_type {};
+
+template<typename Codec, typename T>
+struct HasDecodeText<Codec, T, decltype(void(Codec::decodeText(std::declval<const std::string&>(),
+                                                               std::declval<T&>())))>
+    : std::true_type {};
+
+template<typename T>
+bool decodeWith(CodecReader& in, void* object) {
+    return StoreCodec<T>::decode(in, *static_cast<T*>(object));
+}
+
+template<typename T>
+bool decodeTextWith(const std::string& text, void* object) {
+    return StoreCodec<T>::decodeText(text, *static_cast<T*>(object));
+}
+
+template<typename T>
+CodecTarget codecTarget(T& value) {
+    CodecTarget target;
+    target.typeTag = StoreCodec<T>::kTypeTag;
+    target.object = &value;
+    target.decode = &decodeWith<T>;
+    if constexpr (HasDecodeText<StoreCodec<T>, T>::value) {
+        target.decodeText = &decodeTextWith<T>;
+    } else {
+        target.decodeText = nullptr;
+    }
+    return target;
+}
+
+} // namespace detail
+
+} // namespace store
+} // namespace hwyz
@@ -23,6 +23,42 @@ struct StoreErrorInfo {
     std::string key;  // 发生错误的key
 };
 
+// 刷新策略配置
+struct FlushPolicyConfig {
+    bool enableDebounce = true;      // 启用去抖
+    uint32_t debounceMs = 1000;      // 去抖时间(ms)
+    uint32_t maxDelayMs = 0;         // 脏条目最长等待(ms)，0 表示等于 debounceMs；持续更新的 key 也按此周期落盘
+    uint32_t maxDirtyCount = 10;     // 最大脏条目数
+    bool enableBatch = true;         // 启用批量提交（一轮 flush 只同步一次目录）
+};
+
+// 写入模式
+enum class WriteMode : uint8_t {
+    kWriteThrough = 0,  // save 同步原子写盘（默认）
+    kWriteBack = 1      // save 只更新内存并标脏，由后台线程按 FlushPolicy 落盘
+};
+
+// 存储后端
+enum class StoreBackend : uint8_t {
+    kFilePerKey = 0,    // 每个 key 一个文件，支持多进程（默认）
+    kLogStructured = 1  // 单文件追加日志 + 内存索引，单进程独占
+};
+
+// Store 打开选项
+struct StoreOptions {
+    WriteMode writeMode = WriteMode::kWriteThrough;
+    FlushPolicyConfig flushPolicy;
+    bool readCache = true;          // 缓存已反序列化的值，跨进程写入经共享代数文件失效
+    size_t readCacheMaxBytes = 0;   // 读缓存内存上限（估算值），0 表示不限
+    bool keyIndex = true;           // 内存目录索引：has() 与缺失 key 的 load 不访问文件系统；
+                                    // 有进程绕过 Store 直接增删 key 文件时关闭
+    StoreBackend backend = StoreBackend::kFilePerKey;
+    uint64_t compactMinBytes = 1 << 20;     // kLogStructured：垃圾达到该字节数
+    uint32_t compactGarbagePercent = 50;    // 且占文件比例达到该值时后台压缩
+    int lockWaitSignal = 0;         // 跨进程锁等待的超时信号（如 SIGRTMAX - 1），0 表示不用信号、
+                                    // 以 1ms 间隔重试；非 0 时见 store.h 中关于信号处理函数的说明
+};
+
 // 存储异常类
 class StoreException : public std::exception {
 public:
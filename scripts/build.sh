@@ -71,6 +71,14 @@ run_tests() {
     ctest --output-on-failure --verbose
 }
 
+# 运行基准（结果为 JSON，便于不同构建对比）
+run_benchmarks() {
+    print_info "Running benchmarks..."
+
+    cd "${BUILD_DIR}"
+    ./bench-log-pipeline --out "${BUILD_DIR}/bench_log_pipeline.json"
+}
+
 # 安装项目
 install_project() {
     print_info "Installing project..."
@@ -103,6 +111,7 @@ show_help() {
     echo "Options:"
     echo "  build       Configure and build the project"
     echo "  test        Build and run tests"
+    echo "  bench       Build and run benchmarks (JSON in build/)"
     echo "  clean       Remove build directory"
     echo "  clean-obj   Clean build objects only"
     echo "  install     Install project to ./install"
@@ -133,6 +142,12 @@ main() {
             run_tests
             print_info "Tests completed successfully"
             ;;
+        bench)
+            configure_project
+            build_project
+            run_benchmarks
+            print_info "Benchmarks completed successfully"
+            ;;
         clean)
             clean_build
             ;;
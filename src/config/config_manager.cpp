@@ -5,6 +5,8 @@
 #include "immutable_config_view.h"
 #include <yaml-cpp/yaml.h>
 #include <vector>
+#include <mutex>
+#include <map>
 
 namespace hwyz {
 namespace config {
@@ -16,19 +18,108 @@ public:
     ~Impl() = default;
 
     ConfigError load(const std::string& serviceName, const std::string& configRoot) {
+        std::lock_guard<std::mutex> serial(m_reloadMutex);
+
         // 重置状态
-        m_loaded = false;
-        m_snapshot.reset();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_loaded = false;
+            m_snapshot.reset();
+            m_serviceName = serviceName;
+            m_configRoot = configRoot;
+        }
+
+        std::shared_ptr<const ImmutableConfigView> snapshot;
+        ConfigErrorInfo error = build(serviceName, configRoot, snapshot);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastError = error;
+        if (error.code != ConfigError::kOk) {
+            return error.code;
+        }
+        m_snapshot = snapshot;
+        m_loaded = true;
+        return ConfigError::kOk;
+    }
+
+    // 整个构建、发布、通知过程串行：后开始的 reload 总是后发布，回调按发布顺序执行
+    ConfigError reload() {
+        std::lock_guard<std::mutex> serial(m_reloadMutex);
+
+        std::string serviceName;
+        std::string configRoot;
+        std::shared_ptr<const ImmutableConfigView> previous;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_loaded) {
+                m_lastError = {ConfigError::kFileNotFound, "Config is not loaded", ""};
+                return m_lastError.code;
+            }
+            serviceName = m_serviceName;
+            configRoot = m_configRoot;
+            previous = m_snapshot;
+        }
+
+        std::shared_ptr<const ImmutableConfigView> snapshot;
+        ConfigErrorInfo error = build(serviceName, configRoot, snapshot);
+
+        std::vector<std::pair<Subscription, std::shared_ptr<const ImmutableConfigView>>> changed;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_lastError = error;
+            if (error.code != ConfigError::kOk) {
+                return error.code;  // 保留原快照
+            }
+            m_snapshot = snapshot;
+
+            for (const auto& pair : m_subscriptions) {
+                const Subscription& sub = pair.second;
+                auto oldSection = previous ? previous->getSection(sub.section) : nullptr;
+                auto newSection = snapshot->getSection(sub.section);
+                std::string oldYaml = oldSection ? oldSection->toYaml() : "";
+                std::string newYaml = newSection ? newSection->toYaml() : "";
+                if (oldYaml != newYaml) {
+                    changed.emplace_back(sub, newSection);
+                }
+            }
+        }
 
+        // 回调在 m_mutex 外执行，允许回调内再次读取快照、订阅或取消订阅（不可再调用 reload）
+        for (const auto& item : changed) {
+            item.first.callback(item.first.section, item.second);
+        }
+        return ConfigError::kOk;
+    }
+
+    ConfigManager::SubscriptionId subscribe(const std::string& section, ConfigManager::ChangeCallback callback) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ConfigManager::SubscriptionId id = ++m_nextSubscriptionId;
+        m_subscriptions[id] = {section, std::move(callback)};
+        return id;
+    }
+
+    void unsubscribe(ConfigManager::SubscriptionId id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_subscriptions.erase(id);
+    }
+
+private:
+    struct Subscription {
+        std::string section;
+        ConfigManager::ChangeCallback callback;
+    };
+
+    // 读取、合并、校验全部配置层，生成新快照（不修改当前状态）
+    ConfigErrorInfo build(const std::string& serviceName, const std::string& configRoot,
+                          std::shared_ptr<const ImmutableConfigView>& snapshot) const {
         // 1. 路径解析
         PathResolver resolver(serviceName, configRoot);
 
         // 2. 检查必需层（common.yaml）
         if (!resolver.commonExists()) {
-            m_lastError = {ConfigError::kFileNotFound,
-                          "Required config file not found: " + resolver.getCommonPath(),
-                          "common.yaml"};
-            return m_lastError.code;
+            return {ConfigError::kFileNotFound,
+                    "Required config file not found: " + resolver.getCommonPath(),
+                    "common.yaml"};
         }
 
         // 3. 逐层读取和解析
@@ -39,10 +130,9 @@ public:
             YAML::Node common = YAML::LoadFile(resolver.getCommonPath());
             layers.push_back(common);
         } catch (const YAML::Exception& e) {
-            m_lastError = {ConfigError::kParseFailed,
-                          "Failed to parse common.yaml: " + std::string(e.what()),
-                          "common.yaml"};
-            return m_lastError.code;
+            return {ConfigError::kParseFailed,
+                    "Failed to parse common.yaml: " + std::string(e.what()),
+                    "common.yaml"};
         }
 
         // 读取 conf.d/<svc>.yaml（可选）
@@ -51,10 +141,9 @@ public:
                 YAML::Node service = YAML::LoadFile(resolver.getServicePath());
                 layers.push_back(service);
             } catch (const YAML::Exception& e) {
-                m_lastError = {ConfigError::kParseFailed,
-                              "Failed to parse service config: " + std::string(e.what()),
-                              resolver.getServicePath()};
-                return m_lastError.code;
+                return {ConfigError::kParseFailed,
+                        "Failed to parse service config: " + std::string(e.what()),
+                        resolver.getServicePath()};
             }
         }
 
@@ -64,10 +153,9 @@ public:
                 YAML::Node local = YAML::LoadFile(resolver.getLocalPath());
                 layers.push_back(local);
             } catch (const YAML::Exception& e) {
-                m_lastError = {ConfigError::kParseFailed,
-                              "Failed to parse local config: " + std::string(e.what()),
-                              resolver.getLocalPath()};
-                return m_lastError.code;
+                return {ConfigError::kParseFailed,
+                        "Failed to parse local config: " + std::string(e.what()),
+                        resolver.getLocalPath()};
             }
         }
 
@@ -84,35 +172,42 @@ public:
 
         ConfigErrorInfo validationError = validator.validate(merged);
         if (validationError.code != ConfigError::kOk) {
-            m_lastError = validationError;
-            return m_lastError.code;
+            return validationError;
         }
 
         // 7. 创建不可变快照（从序列化字符串重建，避免引用问题）
         YAML::Node mergedCopy = YAML::Load(mergedStr);
-        m_snapshot = std::make_shared<ImmutableConfigViewImpl>(mergedCopy);
-        m_loaded = true;
-
-        m_lastError = {ConfigError::kOk, "", ""};
-        return ConfigError::kOk;
+        snapshot = std::make_shared<ImmutableConfigViewImpl>(mergedCopy);
+        return {ConfigError::kOk, "", ""};
     }
 
+public:
+
     std::shared_ptr<const ImmutableConfigView> getSnapshot() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
         return m_snapshot;
     }
 
     bool isLoaded() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
         return m_loaded;
     }
 
     ConfigErrorInfo getLastError() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
         return m_lastError;
     }
 
 private:
+    std::mutex m_reloadMutex;       // 串行化 load / reload，先于 m_mutex 获取
+    mutable std::mutex m_mutex;
     std::shared_ptr<const ImmutableConfigView> m_snapshot;
     bool m_loaded = false;
     ConfigErrorInfo m_lastError = {ConfigError::kOk, "", ""};
+    std::string m_serviceName;
+    std::string m_configRoot;
+    std::map<ConfigManager::SubscriptionId, Subscription> m_subscriptions;
+    ConfigManager::SubscriptionId m_nextSubscriptionId = 0;
 };
 
 // ConfigManager 单例实现
@@ -144,5 +239,17 @@ ConfigErrorInfo ConfigManager::getLastError() const {
     return m_impl->getLastError();
 }
 
+ConfigError ConfigManager::reload() {
+    return m_impl->reload();
+}
+
+ConfigManager::SubscriptionId ConfigManager::subscribe(const std::string& section, ChangeCallback callback) {
+    return m_impl->subscribe(section, std::move(callback));
+}
+
+void ConfigManager::unsubscribe(SubscriptionId id) {
+    m_impl->unsubscribe(id);
+}
+
 } // namespace config
 } // namespace hwyz
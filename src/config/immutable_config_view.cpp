@@ -4,6 +4,31 @@
 namespace hwyz {
 namespace config {
 
+namespace {
+
+YAML::Node buildNode(const ImmutableConfigView& view) {
+    YAML::Node node(YAML::NodeType::Map);
+    for (const auto& key : view.getKeys()) {
+        if (auto section = view.getSection(key)) {
+            node[key] = buildNode(*section);
+            continue;
+        }
+        std::vector<std::string> list = view.getStringList(key);
+        if (!list.empty()) {
+            node[key] = list;
+        } else {
+            node[key] = view.getString(key);
+        }
+    }
+    return node;
+}
+
+} // namespace
+
+std::string ImmutableConfigView::toYaml() const {
+    return YAML::Dump(buildNode(*this));
+}
+
 ImmutableConfigViewImpl::ImmutableConfigViewImpl(const YAML::Node& root)
     : m_yamlStr(YAML::Dump(root))  // 序列化为字符串确保不可变
 {
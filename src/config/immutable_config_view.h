@@ -25,6 +25,7 @@ public:
     std::vector<std::string> getStringList(const std::string& key) const override;
     std::shared_ptr<const ImmutableConfigView> getSection(const std::string& key) const override;
     std::vector<std::string> getKeys() const override;
+    std::string toYaml() const override { return m_yamlStr; }
 
 private:
     // 获取节点
@@ -6,6 +6,15 @@ namespace fw {
 namespace log {
 
 AsyncDispatcher::AsyncDispatcher(uint32_t queueSize, uint32_t flushIntervalMs, Writer writer)
+    : m_queueSize(queueSize)
+    , m_flushIntervalMs(flushIntervalMs)
+    , m_writer([writer](const std::string& line, bool isError, uint32_t) {
+          return writer(line, isError);
+      })
+{
+}
+
+AsyncDispatcher::AsyncDispatcher(uint32_t queueSize, uint32_t flushIntervalMs, RoutedWriter writer)
     : m_queueSize(queueSize)
     , m_flushIntervalMs(flushIntervalMs)
     , m_writer(std::move(writer))
@@ -29,23 +38,39 @@ void AsyncDispatcher::stop() {
     }
     std::lock_guard<std::mutex> lock(m_mutex);
     while (!m_queue.empty()) {
-        m_writer(m_queue.front(), false);
+        Entry& entry = m_queue.front();
+        m_writer(entry.take(), false, entry.sinkMask);
         m_queue.pop();
     }
 }
 
-bool AsyncDispatcher::submit(const std::string& line, LogLevel level) {
+bool AsyncDispatcher::submit(const std::string& line, LogLevel level, uint32_t sinkMask) {
+    Entry entry;
+    entry.line = line;
+    entry.sinkMask = sinkMask;
+    return enqueue(std::move(entry), level);
+}
+
+bool AsyncDispatcher::submitDeferred(std::unique_ptr<DeferredRecord> record, LogLevel level,
+                                     uint32_t sinkMask) {
+    Entry entry;
+    entry.deferred = std::move(record);
+    entry.sinkMask = sinkMask;
+    return enqueue(std::move(entry), level);
+}
+
+bool AsyncDispatcher::enqueue(Entry entry, LogLevel level) {
     std::unique_lock<std::mutex> lock(m_mutex);
 
     if (m_queue.size() < m_queueSize) {
-        m_queue.push(line);
+        m_queue.push(std::move(entry));
         m_cond.notify_one();
         return true;
     }
 
     if (isHighPriority(level)) {
         lock.unlock();
-        m_writer(line, true);
+        m_writer(entry.take(), true, entry.sinkMask);
         return true;
     }
 
@@ -54,7 +79,7 @@ bool AsyncDispatcher::submit(const std::string& line, LogLevel level) {
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
         lock.lock();
         if (m_queue.size() < m_queueSize) {
-            m_queue.push(line);
+            m_queue.push(std::move(entry));
             m_cond.notify_one();
             return true;
         }
@@ -77,7 +102,7 @@ uint64_t AsyncDispatcher::getDroppedCount() const {
 
 void AsyncDispatcher::workerLoop() {
     while (m_running) {
-        std::vector<std::string> batch;
+        std::vector<Entry> batch;
 
         {
             std::unique_lock<std::mutex> lock(m_mutex);
@@ -91,8 +116,8 @@ void AsyncDispatcher::workerLoop() {
             }
         }
 
-        for (const auto& line : batch) {
-            m_writer(line, false);
+        for (auto& entry : batch) {
+            m_writer(entry.take(), false, entry.sinkMask);
         }
 
         if (batch.size() > 0) {
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "log_types.h"
+#include "log_message_formatter.h"
+#include "log_sink_router.h"
 #include <string>
 #include <queue>
 #include <mutex>
@@ -8,6 +10,7 @@
 #include <thread>
 #include <atomic>
 #include <functional>
+#include <memory>
 #include <cstdint>
 
 namespace tbox {
@@ -17,11 +20,18 @@ namespace log {
 class AsyncDispatcher {
 public:
     using Writer = std::function<bool(const std::string& line, bool isError)>;
+    // 带路由位图的写出回调，sinkMask 随记录入队（见 SinkRouter）
+    using RoutedWriter = std::function<bool(const std::string& line, bool isError, uint32_t sinkMask)>;
 
     AsyncDispatcher(uint32_t queueSize, uint32_t flushIntervalMs, Writer writer);
+    AsyncDispatcher(uint32_t queueSize, uint32_t flushIntervalMs, RoutedWriter writer);
     ~AsyncDispatcher();
 
-    bool submit(const std::string& line, LogLevel level);
+    bool submit(const std::string& line, LogLevel level,
+                uint32_t sinkMask = SinkRouter::kDefaultMask);
+    // 消息未展开的记录：在 worker 线程上展开并格式化，队列满时按同样的优先级策略处理
+    bool submitDeferred(std::unique_ptr<DeferredRecord> record, LogLevel level,
+                        uint32_t sinkMask = SinkRouter::kDefaultMask);
     void flush();
     uint64_t getDroppedCount() const;
     void start();
@@ -30,9 +40,18 @@ public:
 private:
     uint32_t m_queueSize;
     uint32_t m_flushIntervalMs;
-    Writer m_writer;
+    RoutedWriter m_writer;
 
-    std::queue<std::string> m_queue;
+    // 已格式化的行，或待 worker 展开的记录（二者取其一）
+    struct Entry {
+        std::string line;
+        std::unique_ptr<DeferredRecord> deferred;
+        uint32_t sinkMask = SinkRouter::kDefaultMask;
+
+        std::string take() { return deferred ? deferred->render() : std::move(line); }
+    };
+
+    std::queue<Entry> m_queue;
     mutable std::mutex m_mutex;
     std::condition_variable m_cond;
     std::condition_variable m_flushCond;
@@ -41,6 +60,7 @@ private:
     std::atomic<bool> m_running{false};
     std::atomic<uint64_t> m_droppedCount{0};
 
+    bool enqueue(Entry entry, LogLevel level);
     void workerLoop();
     bool isHighPriority(LogLevel level) const;
 };
@@ -0,0 +1,28 @@
+#include "log_backtrace.h"
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+BacktraceBuffer& BacktraceBuffer::local() {
+    static thread_local BacktraceBuffer buffer;
+    return buffer;
+}
+
+BacktraceRecord& BacktraceBuffer::push(uint32_t capacity) {
+    if (m_slots.size() != capacity) {
+        m_slots.clear();
+        m_slots.resize(capacity);
+        m_head = 0;
+        m_size = 0;
+    }
+
+    BacktraceRecord& slot = m_slots[m_head];
+    m_head = (m_head + 1) % capacity;
+    if (m_size < capacity) ++m_size;
+    return slot;
+}
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "log_types.h"
+#include "log_catalog.h"
+#include "log_module_table.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <utility>
+#include <cstdint>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// 被级别过滤的记录原样捕获（不 enrich、不格式化），ERROR 时才展开
+struct BacktraceRecord {
+    enum class Kind : uint8_t { kPlain, kTemplate, kCatalog };
+
+    Kind kind = Kind::kPlain;
+    LogLevel level = LogLevel::kDebug;
+    ModuleId module = 0;
+    std::string moduleName;                 // 溢出模块的真实名字，其余为空
+    std::chrono::system_clock::time_point wallTime;
+    std::chrono::steady_clock::time_point monoTime;
+    std::string event;
+    LogContext::Id traceId;
+
+    std::string message;                    // kPlain
+    std::vector<Field> fields;              // kPlain：自有存储
+    std::string_view format;                // kTemplate：字面量
+    const CatalogSite* site = nullptr;      // kCatalog：静态生命周期
+    CatalogArgs args;                       // kTemplate / kCatalog
+};
+
+// ============================================================
+// BacktraceBuffer — 线程局部环形缓冲
+//
+// 槽位循环复用，event/message 等字符串沿用已有容量，稳态下捕获
+// 一条记录通常不分配。容量随配置变化时清空重建。
+// ============================================================
+class BacktraceBuffer {
+public:
+    static BacktraceBuffer& local();
+
+    // 取下一个可写槽位（满时覆盖最旧的一条），调用方填充全部字段
+    BacktraceRecord& push(uint32_t capacity);
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+
+    // 按时间顺序取出记录；traceId 非空时只取同一 trace 的记录，其余保留在环中
+    template<typename Visitor>
+    void drain(std::string_view traceId, Visitor&& visitor) {
+        size_t capacity = m_slots.size();
+        size_t start = (m_head + capacity - m_size) % capacity;
+        size_t kept = 0;
+        for (size_t i = 0; i < m_size; ++i) {
+            BacktraceRecord& record = m_slots[(start + i) % capacity];
+            if (traceId.empty() || record.traceId == traceId) {
+                visitor(record);
+            } else {
+                if (kept != i) std::swap(m_slots[(start + kept) % capacity], record);
+                ++kept;
+            }
+        }
+        m_size = kept;
+        m_head = (start + kept) % capacity;
+    }
+
+private:
+    std::vector<BacktraceRecord> m_slots;
+    size_t m_head = 0;      // 下一个写入位置
+    size_t m_size = 0;
+};
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
@@ -0,0 +1,410 @@
+#include "log_binary_sink.h"
+#include "log_catalog_registry.h"
+#include "log_json_formatter.h"
+#include "log_segment_index.h"
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <ctime>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <chrono>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+using namespace catalog_wire;
+
+// ============================================================
+// BinaryFileSink
+// ============================================================
+BinaryFileSink::BinaryFileSink(const FileConfig& config, const std::string& serviceName)
+    : m_config(config)
+    , m_serviceName(serviceName)
+{
+    mkdir(segmentDir().c_str(), 0755);
+
+    // 续写最新的段，与 JSON sink 一样跨重启不覆盖
+    std::vector<std::pair<uint32_t, std::string>> segments = listSegments();
+    uint32_t index = segments.empty() ? 0 : segments.back().first;
+    m_available = openSegment(index);
+}
+
+BinaryFileSink::~BinaryFileSink() {
+    if (m_file) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+bool BinaryFileSink::writeRecord(uint32_t catalogId, std::string_view payload) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_available || !m_file) return false;
+
+    if (catalogId >= m_emitted.size() || !m_emitted[catalogId]) {
+        if (!emitCatalog(catalogId)) return false;
+    }
+    if (!writeFrame(kRecord, payload)) return false;
+    rotateIfNeeded();
+    return true;
+}
+
+bool BinaryFileSink::writeLine(std::string_view line) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_available || !m_file) return false;
+
+    if (!writeFrame(kJsonLine, line)) return false;
+    rotateIfNeeded();
+    return true;
+}
+
+void BinaryFileSink::flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file) {
+        fflush(m_file);
+    }
+}
+
+void BinaryFileSink::encodeRecord(std::string& out, uint32_t catalogId, uint64_t epochNs, uint32_t tid,
+                                  const LogContext* context, const CatalogArgs& args) {
+    uint8_t flags = 0;
+    if (context) {
+        if (!context->trace_id.empty()) flags |= kHasTrace;
+        if (!context->request_id.empty()) flags |= kHasRequest;
+        if (!context->session_id.empty()) flags |= kHasSession;
+    }
+
+    out.clear();
+    putVarint(out, catalogId);
+    putFixed64(out, epochNs);
+    putVarint(out, tid);
+    out.push_back(static_cast<char>(flags));
+    if (flags & kHasTrace) putString(out, context->trace_id);
+    if (flags & kHasRequest) putString(out, context->request_id);
+    if (flags & kHasSession) putString(out, context->session_id);
+    out.append(reinterpret_cast<const char*>(args.data()), args.size());
+}
+
+bool BinaryFileSink::writeFrame(FrameKind kind, std::string_view payload) {
+    m_frame.clear();
+    m_frame.push_back(static_cast<char>(kind));
+    putVarint(m_frame, payload.size());
+    m_frame.append(payload.data(), payload.size());
+
+    size_t written = fwrite(m_frame.data(), 1, m_frame.size(), m_file);
+    m_currentSize += written;
+    if (written != m_frame.size()) {
+        m_available = false;
+        return false;
+    }
+    return true;
+}
+
+bool BinaryFileSink::emitCatalog(uint32_t catalogId) {
+    CatalogEntry entry;
+    if (!CatalogRegistry::instance().lookup(catalogId, entry)) return false;
+
+    std::string payload;
+    putVarint(payload, entry.id);
+    payload.push_back(static_cast<char>(entry.level));
+    putString(payload, entry.module);
+    putString(payload, entry.event);
+    putString(payload, entry.message);
+    putVarint(payload, entry.keys.size());
+    for (const auto& key : entry.keys) {
+        putString(payload, key);
+    }
+    if (!writeFrame(kCatalog, payload)) return false;
+
+    if (catalogId >= m_emitted.size()) {
+        m_emitted.resize(static_cast<size_t>(catalogId) + 1, false);
+    }
+    m_emitted[catalogId] = true;
+    return true;
+}
+
+bool BinaryFileSink::openSegment(uint32_t index) {
+    if (m_file) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+
+    m_currentIndex = index;
+    m_currentPath = getFilePath(index);
+    m_file = fopen(m_currentPath.c_str(), "ab");
+    if (!m_file) {
+        return false;
+    }
+
+    struct stat st;
+    m_currentSize = stat(m_currentPath.c_str(), &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+    if (m_currentSize == 0) {
+        if (fwrite(kMagic, 1, kMagicSize, m_file) != kMagicSize) return false;
+        m_currentSize = kMagicSize;
+    }
+
+    // 段头：会话帧 + 已登记目录
+    std::string session;
+    putVarint(session, static_cast<uint64_t>(getpid()));
+    uint64_t nowNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    putFixed64(session, nowNs);
+    putString(session, m_serviceName);
+    m_available = true;
+    if (!writeFrame(kSession, session)) return false;
+
+    m_emitted.assign(m_emitted.size(), false);
+    uint32_t known = CatalogRegistry::instance().size();
+    for (uint32_t id = 1; id <= known; ++id) {
+        if (!emitCatalog(id)) return false;
+    }
+    return true;
+}
+
+void BinaryFileSink::rotateIfNeeded() {
+    size_t maxSizeBytes = static_cast<size_t>(m_config.max_file_size_mb) * 1024 * 1024;
+    if (m_currentSize < maxSizeBytes) return;
+
+    std::vector<std::pair<uint32_t, std::string>> segments = listSegments();
+    if (segments.size() >= m_config.max_files && !segments.empty()) {
+        remove(segments.front().second.c_str());
+    }
+
+    fflush(m_file);
+    m_available = openSegment(m_currentIndex + 1);
+}
+
+std::string BinaryFileSink::segmentDir() const {
+    return m_config.root + "/" + m_serviceName;
+}
+
+std::string BinaryFileSink::getFilePath(uint32_t index) const {
+    return segmentDir() + "/" + m_serviceName + "_" + std::to_string(index) + kSuffix;
+}
+
+std::vector<std::pair<uint32_t, std::string>> BinaryFileSink::listSegments() const {
+    std::vector<std::pair<uint32_t, std::string>> segments;
+    std::string dir = segmentDir();
+    DIR* d = opendir(dir.c_str());
+    if (!d) return segments;
+
+    uint32_t index = 0;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr) {
+        std::string name = entry->d_name;
+        if (SegmentIndex::parseSegmentName(name, m_serviceName, index, kSuffix)) {
+            segments.emplace_back(index, dir + "/" + name);
+        }
+    }
+    closedir(d);
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+// ============================================================
+// BinaryLogReader
+// ============================================================
+namespace {
+
+std::string formatTimestampNs(uint64_t epochNs) {
+    time_t sec = static_cast<time_t>(epochNs / 1000000000ULL);
+    struct tm tm_result;
+    gmtime_r(&sec, &tm_result);
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+             tm_result.tm_year + 1900, tm_result.tm_mon + 1, tm_result.tm_mday,
+             tm_result.tm_hour, tm_result.tm_min, tm_result.tm_sec,
+             static_cast<int>((epochNs / 1000000ULL) % 1000));
+    return buf;
+}
+
+Field makeField(std::string_view key, FieldValue value) {
+    Field field;
+    field.key = key;
+    field.value = std::move(value);
+    return field;
+}
+
+struct DecodeState {
+    std::unordered_map<uint32_t, CatalogEntry> catalog;
+    std::string service;
+    int64_t pid = 0;
+};
+
+bool decodeCatalogFrame(const uint8_t* cursor, const uint8_t* end, DecodeState& state) {
+    CatalogEntry entry;
+    uint64_t id = 0, keyCount = 0;
+    std::string_view module, event, message;
+    if (!getVarint(cursor, end, id) || cursor >= end) return false;
+    entry.id = static_cast<uint32_t>(id);
+    entry.level = static_cast<LogLevel>(*cursor++);
+    if (!getString(cursor, end, module) || !getString(cursor, end, event) ||
+        !getString(cursor, end, message) || !getVarint(cursor, end, keyCount)) {
+        return false;
+    }
+    entry.module.assign(module);
+    entry.event.assign(event);
+    entry.message.assign(message);
+    for (uint64_t i = 0; i < keyCount; ++i) {
+        std::string_view key;
+        if (!getString(cursor, end, key)) return false;
+        entry.keys.emplace_back(key);
+    }
+    state.catalog[entry.id] = std::move(entry);
+    return true;
+}
+
+// 与 Enricher 的公共字段顺序一致，参数按目录 key 依次追加
+bool decodeRecordFrame(const uint8_t* cursor, const uint8_t* end, const DecodeState& state,
+                       std::string& line) {
+    uint64_t id = 0, epochNs = 0, tid = 0;
+    if (!getVarint(cursor, end, id) || !getFixed64(cursor, end, epochNs) ||
+        !getVarint(cursor, end, tid) || cursor >= end) {
+        return false;
+    }
+    uint8_t flags = *cursor++;
+    std::string_view traceId, requestId, sessionId;
+    if ((flags & BinaryFileSink::kHasTrace) && !getString(cursor, end, traceId)) return false;
+    if ((flags & BinaryFileSink::kHasRequest) && !getString(cursor, end, requestId)) return false;
+    if ((flags & BinaryFileSink::kHasSession) && !getString(cursor, end, sessionId)) return false;
+
+    auto it = state.catalog.find(static_cast<uint32_t>(id));
+    if (it == state.catalog.end()) return false;
+    const CatalogEntry& entry = it->second;
+
+    std::vector<FieldValue> values;
+    if (!decodeArgs(cursor, static_cast<size_t>(end - cursor), values)) return false;
+
+    std::vector<Field> fields;
+    fields.reserve(values.size() + 12);
+    fields.push_back(makeField("schema_version", FieldValue::makeInt(1)));
+    fields.push_back(makeField("timestamp", FieldValue::makeString(formatTimestampNs(epochNs))));
+    fields.push_back(makeField("level", FieldValue::makeStringView(logLevelToString(entry.level))));
+    fields.push_back(makeField("service", FieldValue::makeStringView(state.service)));
+    fields.push_back(makeField("module", FieldValue::makeStringView(entry.module)));
+    fields.push_back(makeField("event", FieldValue::makeStringView(entry.event)));
+    fields.push_back(makeField("message", FieldValue::makeStringView(entry.message)));
+    fields.push_back(makeField("pid", FieldValue::makeInt(state.pid)));
+    fields.push_back(makeField("tid", FieldValue::makeInt(static_cast<int64_t>(tid))));
+    if (!traceId.empty()) fields.push_back(makeField("trace_id", FieldValue::makeStringView(traceId)));
+    if (!requestId.empty()) fields.push_back(makeField("request_id", FieldValue::makeStringView(requestId)));
+    if (!sessionId.empty()) fields.push_back(makeField("session_id", FieldValue::makeStringView(sessionId)));
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i < entry.keys.size()) {
+            fields.push_back(makeField(entry.keys[i], std::move(values[i])));
+        } else {
+            fields.push_back(Field("arg" + std::to_string(i), std::move(values[i])));
+        }
+    }
+
+    line = JsonLineFormatter::format(fields);
+    return true;
+}
+
+} // namespace
+
+LogErrorInfo BinaryLogReader::decodeFile(const std::string& path, const Visitor& visitor) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) {
+        return {LogError::kSearchFailed, "Cannot open binary log segment", path};
+    }
+    std::string data;
+    char buf[64 * 1024];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        data.append(buf, n);
+    }
+    fclose(f);
+
+    if (data.size() < BinaryFileSink::kMagicSize ||
+        std::memcmp(data.data(), BinaryFileSink::kMagic, BinaryFileSink::kMagicSize) != 0) {
+        return {LogError::kSearchFailed, "Not a binary log segment", path};
+    }
+
+    const uint8_t* cursor = reinterpret_cast<const uint8_t*>(data.data()) + BinaryFileSink::kMagicSize;
+    const uint8_t* end = reinterpret_cast<const uint8_t*>(data.data()) + data.size();
+    DecodeState state;
+    std::string line;
+
+    while (cursor < end) {
+        uint8_t kind = *cursor++;
+        uint64_t len = 0;
+        if (!getVarint(cursor, end, len) || static_cast<uint64_t>(end - cursor) < len) {
+            break;      // 崩溃截断的尾帧
+        }
+        const uint8_t* payload = cursor;
+        const uint8_t* payloadEnd = cursor + len;
+        cursor = payloadEnd;
+
+        switch (kind) {
+            case BinaryFileSink::kSession: {
+                uint64_t pid = 0, startNs = 0;
+                std::string_view service;
+                if (getVarint(payload, payloadEnd, pid) && getFixed64(payload, payloadEnd, startNs) &&
+                    getString(payload, payloadEnd, service)) {
+                    state.catalog.clear();
+                    state.pid = static_cast<int64_t>(pid);
+                    state.service.assign(service);
+                }
+                break;
+            }
+            case BinaryFileSink::kCatalog:
+                decodeCatalogFrame(payload, payloadEnd, state);
+                break;
+            case BinaryFileSink::kRecord:
+                if (decodeRecordFrame(payload, payloadEnd, state, line) && !visitor(line)) {
+                    return {};
+                }
+                break;
+            case BinaryFileSink::kJsonLine:
+                if (!visitor(std::string_view(reinterpret_cast<const char*>(payload), len))) {
+                    return {};
+                }
+                break;
+            default:
+                break;  // 未知帧类型：按长度跳过，向前兼容
+        }
+    }
+    return {};
+}
+
+LogErrorInfo BinaryLogReader::decodeDir(const std::string& logDir, const std::string& service,
+                                        const Visitor& visitor) {
+    DIR* d = opendir(logDir.c_str());
+    if (!d) {
+        return {LogError::kSearchFailed, "Cannot open log directory", logDir};
+    }
+    std::vector<std::pair<uint32_t, std::string>> segments;
+    uint32_t index = 0;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr) {
+        std::string name = entry->d_name;
+        if (SegmentIndex::parseSegmentName(name, service, index, BinaryFileSink::kSuffix)) {
+            segments.emplace_back(index, logDir + "/" + name);
+        }
+    }
+    closedir(d);
+    std::sort(segments.begin(), segments.end());
+
+    bool stopped = false;
+    Visitor guarded = [&](std::string_view line) {
+        if (!visitor(line)) {
+            stopped = true;
+            return false;
+        }
+        return true;
+    };
+    for (const auto& segment : segments) {
+        LogErrorInfo error = decodeFile(segment.second, guarded);
+        if (error.code != LogError::kOk) return error;
+        if (stopped) break;
+    }
+    return {};
+}
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
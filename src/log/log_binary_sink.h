@@ -0,0 +1,95 @@
+#pragma once
+
+#include "log_types.h"
+#include "log_catalog.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <cstdio>
+#include <mutex>
+#include <cstdint>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// ============================================================
+// 二进制日志段 <svc>_N.tlog
+//
+// 文件头：8 字节魔数 "TBOXBLG1"
+// 其后为帧序列：[u8 kind][varint len][payload]
+//   kSession  pid、启动时刻、服务名；解码器据此重置目录
+//   kCatalog  目录条目：id、级别、模块、事件、消息模板、字段 key
+//   kRecord   varint id、8 字节 epoch ns、varint tid、标志位、
+//             可选 trace_id/request_id/session_id、CatalogArgs 参数
+//   kJsonLine 普通（非目录）记录的完整 JSON 行
+// 每段打开时先写会话帧并转储已登记目录，段内首次出现的新 ID 先补写
+// 目录帧，因此每个段都可以独立解码。崩溃截断的尾帧在解码时忽略。
+// ============================================================
+class BinaryFileSink {
+public:
+    enum FrameKind : uint8_t { kSession = 1, kCatalog = 2, kRecord = 3, kJsonLine = 4 };
+    enum RecordFlags : uint8_t { kHasTrace = 0x01, kHasRequest = 0x02, kHasSession = 0x04 };
+
+    static constexpr const char* kMagic = "TBOXBLG1";
+    static constexpr size_t kMagicSize = 8;
+    static constexpr const char* kSuffix = ".tlog";
+
+    BinaryFileSink(const FileConfig& config, const std::string& serviceName);
+    ~BinaryFileSink();
+
+    BinaryFileSink(const BinaryFileSink&) = delete;
+    BinaryFileSink& operator=(const BinaryFileSink&) = delete;
+
+    // 静态目录记录：payload 为 kRecord 帧负载（encodeRecord 生成）
+    bool writeRecord(uint32_t catalogId, std::string_view payload);
+    // 普通记录：整行 JSON
+    bool writeLine(std::string_view line);
+
+    void flush();
+    bool isAvailable() const { return m_available; }
+
+    static void encodeRecord(std::string& out, uint32_t catalogId, uint64_t epochNs, uint32_t tid,
+                             const LogContext* context, const CatalogArgs& args);
+
+private:
+    FileConfig m_config;
+    std::string m_serviceName;
+    std::string m_currentPath;
+    FILE* m_file = nullptr;
+    size_t m_currentSize = 0;
+    uint32_t m_currentIndex = 0;
+    std::mutex m_mutex;
+    bool m_available = false;
+    std::vector<bool> m_emitted;            // 按目录 ID：当前段是否已写出目录帧
+    std::string m_frame;                    // 帧拼装缓冲，复用避免逐条分配
+
+    bool writeFrame(FrameKind kind, std::string_view payload);
+    bool emitCatalog(uint32_t catalogId);
+    bool openSegment(uint32_t index);
+    void rotateIfNeeded();
+    std::string segmentDir() const;
+    std::string getFilePath(uint32_t index) const;
+    std::vector<std::pair<uint32_t, std::string>> listSegments() const;
+};
+
+// ============================================================
+// BinaryLogReader — 把 .tlog 段还原为与 JSON sink 一致的 JSON 行
+// ============================================================
+class BinaryLogReader {
+public:
+    // 返回 false 终止遍历
+    using Visitor = std::function<bool(std::string_view line)>;
+
+    // 解码单个段文件
+    static LogErrorInfo decodeFile(const std::string& path, const Visitor& visitor);
+
+    // 按序号从旧到新解码 <logDir>/<service>_N.tlog
+    static LogErrorInfo decodeDir(const std::string& logDir, const std::string& service,
+                                  const Visitor& visitor);
+};
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
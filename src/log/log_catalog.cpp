@@ -0,0 +1,166 @@
+#include "log_catalog_registry.h"
+#include "log_module_table.h"
+#include "log_redactor.h"
+#include <cstring>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// ============================================================
+// CatalogSite
+// ============================================================
+CatalogSite::CatalogSite(const char* module, LogLevel level, const char* event, const char* message,
+                         std::initializer_list<CatalogKey> keys)
+    : m_module(module)
+    , m_level(level)
+    , m_event(event)
+    , m_message(message)
+    , m_keys(keys)
+    , m_moduleId(ModuleTable::instance().intern(module))
+    , m_requiresRedaction(false)
+{
+    for (const auto& key : m_keys) {
+        if (key.sensitivity != Sensitivity::Normal || Redactor::isSecretKey(key.name)) {
+            m_requiresRedaction = true;
+        }
+    }
+    m_id = CatalogRegistry::instance().add(*this);
+}
+
+// ============================================================
+// CatalogRegistry
+// ============================================================
+CatalogRegistry& CatalogRegistry::instance() {
+    static CatalogRegistry inst;
+    return inst;
+}
+
+uint32_t CatalogRegistry::add(const CatalogSite& site) {
+    CatalogEntry entry;
+    entry.level = site.level();
+    entry.module = site.module();
+    entry.event = site.event();
+    entry.message = site.message();
+    entry.keys.reserve(site.keys().size());
+    for (const auto& key : site.keys()) {
+        entry.keys.emplace_back(key.name);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    entry.id = static_cast<uint32_t>(m_entries.size() + 1);
+    m_entries.push_back(std::move(entry));
+    return m_entries.back().id;
+}
+
+bool CatalogRegistry::lookup(uint32_t id, CatalogEntry& entry) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (id == 0 || id > m_entries.size()) return false;
+    entry = m_entries[id - 1];
+    return true;
+}
+
+uint32_t CatalogRegistry::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<uint32_t>(m_entries.size());
+}
+
+// ============================================================
+// 线格式
+// ============================================================
+namespace catalog_wire {
+
+void putVarint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+void putFixed64(std::string& out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>(v >> (8 * i)));
+    }
+}
+
+void putString(std::string& out, std::string_view s) {
+    putVarint(out, s.size());
+    out.append(s.data(), s.size());
+}
+
+bool getVarint(const uint8_t*& cursor, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (cursor >= end) return false;
+        uint8_t b = *cursor++;
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+bool getFixed64(const uint8_t*& cursor, const uint8_t* end, uint64_t& v) {
+    if (end - cursor < 8) return false;
+    v = 0;
+    for (int i = 0; i < 8; ++i) {
+        v |= static_cast<uint64_t>(cursor[i]) << (8 * i);
+    }
+    cursor += 8;
+    return true;
+}
+
+bool getString(const uint8_t*& cursor, const uint8_t* end, std::string_view& s) {
+    uint64_t len = 0;
+    if (!getVarint(cursor, end, len)) return false;
+    if (static_cast<uint64_t>(end - cursor) < len) return false;
+    s = std::string_view(reinterpret_cast<const char*>(cursor), static_cast<size_t>(len));
+    cursor += len;
+    return true;
+}
+
+bool decodeArgs(const uint8_t* data, size_t size, std::vector<FieldValue>& values) {
+    const uint8_t* cursor = data;
+    const uint8_t* end = data + size;
+    while (cursor < end) {
+        uint8_t tag = *cursor++;
+        uint64_t raw = 0;
+        switch (tag) {
+            case CatalogArgs::kTagInt:
+                if (!getVarint(cursor, end, raw)) return false;
+                values.push_back(FieldValue::makeInt(static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1)));
+                break;
+            case CatalogArgs::kTagUint:
+                if (!getVarint(cursor, end, raw)) return false;
+                values.push_back(FieldValue::makeUint(raw));
+                break;
+            case CatalogArgs::kTagDouble: {
+                if (end - cursor < static_cast<ptrdiff_t>(sizeof(double))) return false;
+                double d;
+                std::memcpy(&d, cursor, sizeof(double));
+                cursor += sizeof(double);
+                values.push_back(FieldValue::makeDouble(d));
+                break;
+            }
+            case CatalogArgs::kTagBool:
+                if (cursor >= end) return false;
+                values.push_back(FieldValue::makeBool(*cursor++ != 0));
+                break;
+            case CatalogArgs::kTagString: {
+                std::string_view s;
+                if (!getString(cursor, end, s)) return false;
+                values.push_back(FieldValue::makeStringView(s));
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace catalog_wire
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "log_types.h"
+#include "log_catalog.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// 目录条目：CatalogSite 静态部分的自有拷贝，供 sink 写入段头与解码器还原
+struct CatalogEntry {
+    uint32_t id = 0;
+    LogLevel level = LogLevel::kInfo;
+    std::string module;
+    std::string event;
+    std::string message;
+    std::vector<std::string> keys;
+};
+
+// ============================================================
+// CatalogRegistry — 进程内目录，ID 从 1 开始连续分配
+//
+// 登记只在 CatalogSite 构造时发生一次；sink 仅在某个 ID 首次
+// 出现在当前段时查询，因此用互斥锁即可，不在记录热路径上。
+// ============================================================
+class CatalogRegistry {
+public:
+    static CatalogRegistry& instance();
+
+    uint32_t add(const CatalogSite& site);
+
+    // 按 ID 取条目拷贝，不存在返回 false
+    bool lookup(uint32_t id, CatalogEntry& entry) const;
+
+    // 当前已登记条目数（即最大 ID）
+    uint32_t size() const;
+
+private:
+    CatalogRegistry() = default;
+
+    mutable std::mutex m_mutex;
+    std::deque<CatalogEntry> m_entries;     // 下标 = id - 1
+};
+
+// ============================================================
+// 二进制段线格式辅助
+// ============================================================
+namespace catalog_wire {
+
+void putVarint(std::string& out, uint64_t v);
+void putFixed64(std::string& out, uint64_t v);
+void putString(std::string& out, std::string_view s);
+
+// 读取失败（越界/varint 过长）返回 false，cursor 不保证有效
+bool getVarint(const uint8_t*& cursor, const uint8_t* end, uint64_t& v);
+bool getFixed64(const uint8_t*& cursor, const uint8_t* end, uint64_t& v);
+bool getString(const uint8_t*& cursor, const uint8_t* end, std::string_view& s);
+
+// 解码 CatalogArgs 编码的参数；字符串值借用 data，调用方保证其有效
+bool decodeArgs(const uint8_t* data, size_t size, std::vector<FieldValue>& values);
+
+} // namespace catalog_wire
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
@@ -1,10 +1,153 @@
 #include "log_config_adapter.h"
+#include "log.h"
+#include "log_emergency_writer.h"
+#include "log_sink_router.h"
 #include <yaml-cpp/yaml.h>
 
 namespace tbox {
 namespace fw {
 namespace log {
 
+namespace {
+
+std::vector<SamplingRule> parseSamplingRules(const YAML::Node& node) {
+    std::vector<SamplingRule> rules;
+    for (const auto& item : node) {
+        SamplingRule rule;
+        if (item["module"]) rule.module = item["module"].as<std::string>("");
+        if (item["event"]) rule.event = item["event"].as<std::string>("");
+        if (item["max_level"]) rule.max_level = logLevelFromString(item["max_level"].as<std::string>("DEBUG"));
+        if (item["every_n"]) rule.every_n = item["every_n"].as<uint32_t>(0);
+        if (item["trace_ratio"]) rule.trace_ratio = item["trace_ratio"].as<double>(0.0);
+        rules.push_back(rule);
+    }
+    return rules;
+}
+
+void applyFileNode(const YAML::Node& fileNode, FileConfig& file) {
+    if (fileNode["enabled"]) file.enabled = fileNode["enabled"].as<bool>(false);
+    if (fileNode["root"]) file.root = fileNode["root"].as<std::string>("/var/log/tbox");
+    if (fileNode["max_file_size_mb"]) file.max_file_size_mb = fileNode["max_file_size_mb"].as<uint32_t>(20);
+    if (fileNode["max_files"]) file.max_files = fileNode["max_files"].as<uint32_t>(5);
+    if (fileNode["total_budget_mb"]) file.total_budget_mb = fileNode["total_budget_mb"].as<uint32_t>(100);
+    if (fileNode["index"]) file.index = fileNode["index"].as<bool>(true);
+    if (fileNode["format"]) file.format = fileNode["format"].as<std::string>("json");
+}
+
+std::vector<SinkRoute> parseRoutes(const YAML::Node& node) {
+    std::vector<SinkRoute> routes;
+    for (const auto& item : node) {
+        SinkRoute route;
+        if (item["module"]) route.module = item["module"].as<std::string>("");
+        if (item["min_level"]) route.min_level = logLevelFromString(item["min_level"].as<std::string>("TRACE"));
+        if (item["max_level"]) route.max_level = logLevelFromString(item["max_level"].as<std::string>("FATAL"));
+        if (item["sinks"]) {
+            for (const auto& sink : item["sinks"]) {
+                route.sinks.push_back(sink.as<std::string>(""));
+            }
+        }
+        routes.push_back(std::move(route));
+    }
+    return routes;
+}
+
+// 解析 log 节（common.log 或 ConfigManager 合并后的顶层 log）
+void applyLogNode(const YAML::Node& logNode, LogConfig& config) {
+    if (logNode["schema_version"]) {
+        config.schema_version = logNode["schema_version"].as<uint32_t>(1);
+    }
+    if (logNode["level"]) {
+        config.level = logLevelFromString(logNode["level"].as<std::string>("INFO"));
+    }
+    if (logNode["strict"]) {
+        config.strict = logNode["strict"].as<bool>(false);
+    }
+
+    if (logNode["async"]) {
+        YAML::Node asyncNode = logNode["async"];
+        if (asyncNode["enabled"]) config.async_config.enabled = asyncNode["enabled"].as<bool>(true);
+        if (asyncNode["queue_size"]) config.async_config.queue_size = asyncNode["queue_size"].as<uint32_t>(4096);
+        if (asyncNode["flush_interval_ms"]) config.async_config.flush_interval_ms = asyncNode["flush_interval_ms"].as<uint32_t>(1000);
+    }
+
+    if (logNode["console"]) {
+        YAML::Node consoleNode = logNode["console"];
+        if (consoleNode["enabled"]) config.console_config.enabled = consoleNode["enabled"].as<bool>(true);
+    }
+
+    if (logNode["file"]) {
+        applyFileNode(logNode["file"], config.file_config);
+    }
+
+    // 命名 sink：未写的字段沿用 file 节，默认启用，固定为 JSON 行
+    if (logNode["sinks"]) {
+        config.named_sinks.clear();
+        YAML::Node sinks = logNode["sinks"];
+        for (auto it = sinks.begin(); it != sinks.end(); ++it) {
+            FileConfig named = config.file_config;
+            named.enabled = true;
+            named.format = "json";
+            applyFileNode(it->second, named);
+            config.named_sinks[it->first.as<std::string>()] = named;
+        }
+    }
+
+    if (logNode["routes"]) {
+        config.routes = parseRoutes(logNode["routes"]);
+    }
+
+    if (logNode["redact"]) {
+        YAML::Node redactNode = logNode["redact"];
+        if (redactNode["identifiers"]) config.redact_config.identifiers = redactNode["identifiers"].as<std::string>("mask");
+        if (redactNode["raw_payload_max_bytes"]) config.redact_config.raw_payload_max_bytes = redactNode["raw_payload_max_bytes"].as<uint32_t>(256);
+        if (redactNode["payload_encoding"]) config.redact_config.payload_encoding = redactNode["payload_encoding"].as<std::string>("hex");
+    }
+
+    if (logNode["flight_recorder"]) {
+        YAML::Node flightNode = logNode["flight_recorder"];
+        if (flightNode["enabled"]) config.flight_recorder_config.enabled = flightNode["enabled"].as<bool>(true);
+        if (flightNode["dir"]) config.flight_recorder_config.dir = flightNode["dir"].as<std::string>("/run/tbox");
+        if (flightNode["size_kb"]) config.flight_recorder_config.size_kb = flightNode["size_kb"].as<uint32_t>(256);
+        if (flightNode["dump_on_crash"]) config.flight_recorder_config.dump_on_crash = flightNode["dump_on_crash"].as<bool>(true);
+    }
+
+    if (logNode["backtrace"]) {
+        YAML::Node backtraceNode = logNode["backtrace"];
+        if (backtraceNode["enabled"]) config.backtrace_config.enabled = backtraceNode["enabled"].as<bool>(false);
+        if (backtraceNode["size"]) config.backtrace_config.size = backtraceNode["size"].as<uint32_t>(64);
+        if (backtraceNode["capture_level"]) {
+            config.backtrace_config.capture_level = logLevelFromString(backtraceNode["capture_level"].as<std::string>("DEBUG"));
+        }
+    }
+
+    if (logNode["overrides"]) {
+        config.level_overrides.clear();
+        for (const auto& node : logNode["overrides"]) {
+            LevelOverride item;
+            if (node["trace_id"]) item.trace_id = node["trace_id"].as<std::string>("");
+            if (node["session_id"]) item.session_id = node["session_id"].as<std::string>("");
+            if (node["prefix"]) item.prefix = node["prefix"].as<bool>(false);
+            if (node["module"]) item.module = node["module"].as<std::string>("");
+            if (node["level"]) item.level = logLevelFromString(node["level"].as<std::string>("DEBUG"));
+            config.level_overrides.push_back(std::move(item));
+        }
+    }
+
+    if (logNode["sampling"]) {
+        config.sampling_rules = parseSamplingRules(logNode["sampling"]);
+    }
+
+    if (logNode["modules"]) {
+        YAML::Node modules = logNode["modules"];
+        for (auto it = modules.begin(); it != modules.end(); ++it) {
+            config.module_levels[it->first.as<std::string>()] =
+                logLevelFromString(it->second.as<std::string>("INFO"));
+        }
+    }
+}
+
+} // namespace
+
 std::pair<LogConfig, LogErrorInfo> LogConfigAdapter::loadFromYaml(
     const std::string& commonConfigPath,
     const std::string& serviceConfigPath
@@ -39,59 +182,13 @@ std::pair<LogConfig, LogErrorInfo> LogConfigAdapter::loadFromYamlString(
         YAML::Node service = serviceYaml.empty() ? YAML::Node() : YAML::Load(serviceYaml);
 
         if (common["common"] && common["common"]["log"]) {
-            YAML::Node logNode = common["common"]["log"];
-
-            if (logNode["schema_version"]) {
-                config.schema_version = logNode["schema_version"].as<uint32_t>(1);
-            }
-            if (logNode["level"]) {
-                config.level = parseLevel(logNode["level"].as<std::string>("INFO"));
-            }
-            if (logNode["strict"]) {
-                config.strict = logNode["strict"].as<bool>(false);
-            }
-
-            if (logNode["async"]) {
-                YAML::Node asyncNode = logNode["async"];
-                if (asyncNode["enabled"]) config.async_config.enabled = asyncNode["enabled"].as<bool>(true);
-                if (asyncNode["queue_size"]) config.async_config.queue_size = asyncNode["queue_size"].as<uint32_t>(4096);
-                if (asyncNode["flush_interval_ms"]) config.async_config.flush_interval_ms = asyncNode["flush_interval_ms"].as<uint32_t>(1000);
-            }
-
-            if (logNode["console"]) {
-                YAML::Node consoleNode = logNode["console"];
-                if (consoleNode["enabled"]) config.console_config.enabled = consoleNode["enabled"].as<bool>(true);
-            }
-
-            if (logNode["file"]) {
-                YAML::Node fileNode = logNode["file"];
-                if (fileNode["enabled"]) config.file_config.enabled = fileNode["enabled"].as<bool>(false);
-                if (fileNode["root"]) config.file_config.root = fileNode["root"].as<std::string>("/var/log/tbox");
-                if (fileNode["max_file_size_mb"]) config.file_config.max_file_size_mb = fileNode["max_file_size_mb"].as<uint32_t>(20);
-                if (fileNode["max_files"]) config.file_config.max_files = fileNode["max_files"].as<uint32_t>(5);
-                if (fileNode["total_budget_mb"]) config.file_config.total_budget_mb = fileNode["total_budget_mb"].as<uint32_t>(100);
-            }
-
-            if (logNode["redact"]) {
-                YAML::Node redactNode = logNode["redact"];
-                if (redactNode["identifiers"]) config.redact_config.identifiers = redactNode["identifiers"].as<std::string>("mask");
-                if (redactNode["raw_payload_max_bytes"]) config.redact_config.raw_payload_max_bytes = redactNode["raw_payload_max_bytes"].as<uint32_t>(256);
-            }
+            applyLogNode(common["common"]["log"], config);
         }
 
-        // 服务级覆盖
+        // 服务级覆盖：与公共层使用同一解析，写出的字段覆盖公共值，
+        // 模块级别逐项合并，采样规则、路由、命名 sink 与 overrides 整体替换
         if (service && service["log"]) {
-            YAML::Node svcLog = service["log"];
-            if (svcLog["level"]) {
-                config.level = parseLevel(svcLog["level"].as<std::string>("INFO"));
-            }
-            if (svcLog["modules"]) {
-                YAML::Node modules = svcLog["modules"];
-                for (auto it = modules.begin(); it != modules.end(); ++it) {
-                    std::string moduleName = it->first.as<std::string>();
-                    config.module_levels[moduleName] = parseLevel(it->second.as<std::string>("INFO"));
-                }
-            }
+            applyLogNode(service["log"], config);
         }
 
         LogErrorInfo validationError = validate(config);
@@ -106,6 +203,38 @@ std::pair<LogConfig, LogErrorInfo> LogConfigAdapter::loadFromYamlString(
     }
 }
 
+std::pair<LogConfig, LogErrorInfo> LogConfigAdapter::loadFromSection(const std::string& logSectionYaml) {
+    LogConfig config;
+    try {
+        YAML::Node logNode = YAML::Load(logSectionYaml);
+        if (logNode && logNode.IsMap()) {
+            applyLogNode(logNode, config);
+        }
+    } catch (const YAML::Exception& e) {
+        return {getDefaultConfig(), {LogError::kConfigInvalid, "YAML parse error: " + std::string(e.what()), "log"}};
+    }
+
+    LogErrorInfo validationError = validate(config);
+    if (validationError.code != LogError::kOk) {
+        return {getDefaultConfig(), validationError};
+    }
+    return {config, {LogError::kOk, "", ""}};
+}
+
+hwyz::config::ConfigManager::SubscriptionId LogConfigAdapter::subscribeReload(hwyz::config::ConfigManager& manager) {
+    return manager.subscribe("log", [](const std::string&, std::shared_ptr<const hwyz::config::ImmutableConfigView> view) {
+        if (!view) return;  // log 节被删除：保持当前配置
+
+        auto result = loadFromSection(view->toYaml());
+        if (result.second.code != LogError::kOk) {
+            EmergencyWriter::write("[LOG_RELOAD] rejected: " + result.second.message +
+                                   (result.second.detail.empty() ? "" : " (" + result.second.detail + ")") + "\n");
+            return;
+        }
+        Logger::reload(result.first);
+    });
+}
+
 LogErrorInfo LogConfigAdapter::validate(const LogConfig& config) {
     if (config.schema_version != 1) {
         return {LogError::kConfigInvalid, "schema_version must be 1, got " + std::to_string(config.schema_version), ""};
@@ -119,6 +248,15 @@ LogErrorInfo LogConfigAdapter::validate(const LogConfig& config) {
         return {LogError::kConfigInvalid, "file.root is required when file sink is enabled", ""};
     }
 
+    if (config.file_config.format != "json" && config.file_config.format != "binary") {
+        return {LogError::kConfigInvalid, "file.format must be json or binary, got " + config.file_config.format, ""};
+    }
+
+    if (config.redact_config.payload_encoding != "hex" && config.redact_config.payload_encoding != "base64") {
+        return {LogError::kConfigInvalid,
+                "redact.payload_encoding must be hex or base64, got " + config.redact_config.payload_encoding, ""};
+    }
+
     if (config.file_config.enabled) {
         uint64_t totalNeeded = static_cast<uint64_t>(config.file_config.max_file_size_mb) * config.file_config.max_files;
         if (totalNeeded > config.file_config.total_budget_mb) {
@@ -129,6 +267,83 @@ LogErrorInfo LogConfigAdapter::validate(const LogConfig& config) {
         }
     }
 
+    if (config.flight_recorder_config.enabled) {
+        if (config.flight_recorder_config.dir.empty()) {
+            return {LogError::kConfigInvalid, "flight_recorder.dir is required when flight recorder is enabled", ""};
+        }
+        if (config.flight_recorder_config.size_kb < 4) {
+            return {LogError::kConfigInvalid, "flight_recorder.size_kb must be at least 4", ""};
+        }
+    }
+
+    if (config.backtrace_config.enabled &&
+        (config.backtrace_config.size == 0 || config.backtrace_config.size > 4096)) {
+        return {LogError::kConfigInvalid, "backtrace.size must be in [1, 4096]", ""};
+    }
+
+    for (size_t i = 0; i < config.level_overrides.size(); ++i) {
+        const LevelOverride& item = config.level_overrides[i];
+        if (item.trace_id.empty() == item.session_id.empty()) {
+            return {LogError::kConfigInvalid, "level override needs exactly one of trace_id or session_id",
+                    "overrides[" + std::to_string(i) + "]"};
+        }
+    }
+
+    if (config.named_sinks.size() > SinkRouter::kMaxNamedSinks) {
+        return {LogError::kConfigInvalid,
+                "at most " + std::to_string(SinkRouter::kMaxNamedSinks) + " named sinks are supported", "sinks"};
+    }
+    for (const auto& pair : config.named_sinks) {
+        const FileConfig& named = pair.second;
+        std::string where = "sinks." + pair.first;
+        if (pair.first == "console" || pair.first == "file") {
+            return {LogError::kConfigInvalid, "sink name is reserved", where};
+        }
+        if (!named.enabled) continue;
+        if (named.root.empty()) {
+            return {LogError::kConfigInvalid, "named sink requires root", where};
+        }
+        if (named.format != "json") {
+            return {LogError::kConfigInvalid, "named sink format must be json", where};
+        }
+        uint64_t totalNeeded = static_cast<uint64_t>(named.max_file_size_mb) * named.max_files;
+        if (totalNeeded > named.total_budget_mb) {
+            return {LogError::kConfigInvalid,
+                    "max_file_size_mb × max_files (" + std::to_string(totalNeeded) +
+                    ") exceeds total_budget_mb (" + std::to_string(named.total_budget_mb) + ")",
+                    where};
+        }
+    }
+
+    for (size_t i = 0; i < config.routes.size(); ++i) {
+        const SinkRoute& route = config.routes[i];
+        std::string where = "routes[" + std::to_string(i) + "]";
+        if (route.min_level > route.max_level || route.max_level == LogLevel::kOff) {
+            return {LogError::kConfigInvalid, "route level range is invalid", where};
+        }
+        for (const auto& sink : route.sinks) {
+            if (SinkRouter::sinkBit(config, sink) == 0) {
+                return {LogError::kConfigInvalid, "route references unknown sink: " + sink, where};
+            }
+        }
+    }
+
+    for (size_t i = 0; i < config.sampling_rules.size(); ++i) {
+        const SamplingRule& rule = config.sampling_rules[i];
+        std::string where = "sampling[" + std::to_string(i) + "]";
+        if (rule.module.empty()) {
+            return {LogError::kConfigInvalid, "sampling rule requires module", where};
+        }
+        bool byCount = rule.every_n > 0;
+        bool byTrace = rule.trace_ratio > 0.0;
+        if (byCount == byTrace) {
+            return {LogError::kConfigInvalid, "sampling rule needs exactly one of every_n or trace_ratio", where};
+        }
+        if (byTrace && rule.trace_ratio > 1.0) {
+            return {LogError::kConfigInvalid, "sampling trace_ratio must be in (0, 1]", where};
+        }
+    }
+
     return {LogError::kOk, "", ""};
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "log_types.h"
+#include "config.h"
 #include <string>
 #include <utility>
 
@@ -22,6 +23,13 @@ public:
         const std::string& serviceYaml = ""
     );
 
+    // 从 ConfigManager 合并后的 log 节（不带 common 前缀的映射）读取
+    static std::pair<LogConfig, LogErrorInfo> loadFromSection(const std::string& logSectionYaml);
+
+    // 订阅 ConfigManager 的 log 节：变化时解析、校验并调用 Logger::reload，
+    // 非法配置被拒绝并写 stderr，当前处理链保持不变。返回订阅 ID
+    static hwyz::config::ConfigManager::SubscriptionId subscribeReload(hwyz::config::ConfigManager& manager);
+
     // 校验 LogConfig 合法性
     static LogErrorInfo validate(const LogConfig& config);
 
@@ -1,11 +1,32 @@
 #include "log_emergency_writer.h"
+#include "log_flight_recorder.h"
 #include <unistd.h>
+#include <csignal>
 #include <cstring>
+#include <atomic>
 
 namespace tbox {
 namespace fw {
 namespace log {
 
+namespace {
+
+const int kFatalSignals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+const size_t kFatalSignalCount = sizeof(kFatalSignals) / sizeof(kFatalSignals[0]);
+
+struct sigaction g_previousActions[kFatalSignalCount];
+std::atomic<bool> g_handlersInstalled{false};
+std::atomic<bool> g_dumping{false};
+
+int signal_slot(int sig) {
+    for (size_t i = 0; i < kFatalSignalCount; ++i) {
+        if (kFatalSignals[i] == sig) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+} // anonymous namespace
+
 void EmergencyWriter::write(const char* msg) {
     if (!msg) return;
     size_t len = strlen(msg);
@@ -17,6 +38,50 @@ void EmergencyWriter::write(const std::string& msg) {
     write(msg.c_str());
 }
 
+void EmergencyWriter::dumpFlightRecorder() {
+    FlightRecorder* recorder = FlightRecorder::active();
+    if (recorder) {
+        recorder->dumpTo(STDERR_FILENO);
+    }
+}
+
+void EmergencyWriter::installFatalSignalHandlers() {
+    if (g_handlersInstalled.exchange(true)) return;
+
+    for (size_t i = 0; i < kFatalSignalCount; ++i) {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_sigaction = &EmergencyWriter::onFatalSignal;
+        sigemptyset(&sa.sa_mask);
+        sa.sa_flags = SA_SIGINFO | SA_RESETHAND;
+        sigaction(kFatalSignals[i], &sa, &g_previousActions[i]);
+    }
+}
+
+void EmergencyWriter::onFatalSignal(int sig, siginfo_t* info, void* context) {
+    // 同一进程只转储一次（如转储过程中再次崩溃）
+    if (!g_dumping.exchange(true)) {
+        write("[emergency] fatal signal received, dumping flight recorder\n");
+        dumpFlightRecorder();
+    }
+
+    // 交还给原处理函数（如 Application 的处理），SA_SIGINFO 处理函数原样收到
+    // siginfo 与上下文；否则按默认动作重新触发
+    int slot = signal_slot(sig);
+    if (slot >= 0) {
+        const struct sigaction& prev = g_previousActions[slot];
+        if (prev.sa_flags & SA_SIGINFO) {
+            if (prev.sa_sigaction) {
+                prev.sa_sigaction(sig, info, context);
+            }
+        } else if (prev.sa_handler != SIG_DFL && prev.sa_handler != SIG_IGN) {
+            prev.sa_handler(sig);
+        }
+    }
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
 } // namespace log
 } // namespace fw
 } // namespace tbox
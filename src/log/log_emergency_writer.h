@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <csignal>
 
 namespace tbox {
 namespace fw {
@@ -11,6 +12,16 @@ class EmergencyWriter {
 public:
     static void write(const char* msg);
     static void write(const std::string& msg);
+
+    // 把飞行记录器内容转储到 stderr（异步信号安全）
+    static void dumpFlightRecorder();
+
+    // 安装致命信号处理：SIGSEGV/SIGBUS/SIGFPE/SIGILL/SIGABRT
+    // 处理函数先转储飞行记录器，再交给原处理函数或按默认动作重新触发信号
+    static void installFatalSignalHandlers();
+
+private:
+    static void onFatalSignal(int sig, siginfo_t* info, void* context);
 };
 
 } // namespace log
@@ -36,9 +36,9 @@ Enricher::Enricher(const std::string& service)
 std::vector<Field> Enricher::enrich(
     std::vector<Field> fields,
     LogLevel level,
-    const std::string& module,
-    const std::string& event,
-    const std::string& message,
+    ModuleId module,
+    std::string_view event,
+    std::string_view message,
     const LogContext* context
 ) const {
     std::vector<Field> enriched;
@@ -48,23 +48,24 @@ std::vector<Field> Enricher::enrich(
     enriched.push_back({"timestamp", FieldValue::makeString(getTimestampUTC())});
     enriched.push_back({"time_synced", FieldValue::makeBool(isTimeSynced())});
     enriched.push_back({"mono_ms", FieldValue::makeInt(getMonoMs())});
-    enriched.push_back({"level", FieldValue::makeString(logLevelToString(level))});
-    enriched.push_back({"service", FieldValue::makeString(m_service)});
-    enriched.push_back({"module", FieldValue::makeString(module)});
+    enriched.push_back({"level", FieldValue::makeStringView(logLevelToString(level))});
+    enriched.push_back({"service", FieldValue::makeStringView(m_service)});
+    enriched.push_back({"module", FieldValue::makeStringView(ModuleTable::instance().name(module))});
     enriched.push_back({"event", FieldValue::makeString(event)});
     enriched.push_back({"message", FieldValue::makeString(message)});
     enriched.push_back({"pid", FieldValue::makeInt(static_cast<int64_t>(m_pid))});
     enriched.push_back({"tid", FieldValue::makeInt(static_cast<int64_t>(current_tid()))});
 
+    // 上下文 ID 借用：上下文在本次日志调用期间有效，延迟记录入队前会 own()
     if (context) {
         if (!context->trace_id.empty()) {
-            enriched.push_back({"trace_id", FieldValue::makeString(context->trace_id)});
+            enriched.push_back({"trace_id", FieldValue::makeStringView(context->trace_id)});
         }
         if (!context->request_id.empty()) {
-            enriched.push_back({"request_id", FieldValue::makeString(context->request_id)});
+            enriched.push_back({"request_id", FieldValue::makeStringView(context->request_id)});
         }
         if (!context->session_id.empty()) {
-            enriched.push_back({"session_id", FieldValue::makeString(context->session_id)});
+            enriched.push_back({"session_id", FieldValue::makeStringView(context->session_id)});
         }
     }
 
@@ -80,18 +81,37 @@ int64_t Enricher::getMonoMs() const {
 std::string Enricher::getTimestampUTC() const {
     struct timeval tv;
     gettimeofday(&tv, nullptr);
+    return formatTimestampUTC(static_cast<int64_t>(tv.tv_sec) * 1000 + tv.tv_usec / 1000);
+}
+
+std::string Enricher::formatTimestampUTC(int64_t epochMs) {
     struct tm tm_result;
-    time_t sec = tv.tv_sec;
+    time_t sec = static_cast<time_t>(epochMs / 1000);
     gmtime_r(&sec, &tm_result);
 
     char buf[64];
     snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
              tm_result.tm_year + 1900, tm_result.tm_mon + 1, tm_result.tm_mday,
              tm_result.tm_hour, tm_result.tm_min, tm_result.tm_sec,
-             static_cast<int>(tv.tv_usec / 1000));
+             static_cast<int>(epochMs % 1000));
     return std::string(buf);
 }
 
+void Enricher::restamp(std::vector<Field>& enriched, std::chrono::system_clock::time_point wallTime,
+                       std::chrono::steady_clock::time_point monoTime) const {
+    int64_t epochMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        wallTime.time_since_epoch()).count();
+    int64_t monoMs = std::chrono::duration_cast<std::chrono::milliseconds>(monoTime - m_startTime).count();
+    for (auto& field : enriched) {
+        if (field.key == "timestamp") {
+            field.value = FieldValue::makeString(formatTimestampUTC(epochMs));
+        } else if (field.key == "mono_ms") {
+            field.value = FieldValue::makeInt(monoMs);
+            break;
+        }
+    }
+}
+
 bool Enricher::isTimeSynced() const {
     struct timespec ts;
     clock_gettime(CLOCK_REALTIME, &ts);
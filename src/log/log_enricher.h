@@ -1,7 +1,9 @@
 #pragma once
 
 #include "log_types.h"
+#include "log_module_table.h"
 #include <string>
+#include <string_view>
 #include <chrono>
 #include <vector>
 
@@ -17,12 +19,16 @@ public:
     std::vector<Field> enrich(
         std::vector<Field> fields,
         LogLevel level,
-        const std::string& module,
-        const std::string& event,
-        const std::string& message,
+        ModuleId module,
+        std::string_view event,
+        std::string_view message,
         const LogContext* context = nullptr
     ) const;
 
+    // 以捕获时刻改写 timestamp / mono_ms（延迟补写的回溯记录）
+    void restamp(std::vector<Field>& enriched, std::chrono::system_clock::time_point wallTime,
+                 std::chrono::steady_clock::time_point monoTime) const;
+
 private:
     std::string m_service;
     std::chrono::steady_clock::time_point m_startTime;
@@ -30,6 +36,7 @@ private:
 
     int64_t getMonoMs() const;
     std::string getTimestampUTC() const;
+    static std::string formatTimestampUTC(int64_t epochMs);
     bool isTimeSynced() const;
 };
 
@@ -0,0 +1,378 @@
+#include "log_flight_recorder.h"
+#include "log_json_formatter.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <ctime>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <new>
+
+#ifdef __APPLE__
+#include <pthread.h>
+#endif
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// ============================================================
+// 环文件布局：Header(64B) + slotCount × Slot(kSlotSize)
+// ============================================================
+struct FlightRecorder::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t slotSize;
+    uint32_t slotCount;
+    uint32_t pid;
+    std::atomic<uint64_t> cursor;   // 下一条记录的 seq
+    char reserved[32];
+};
+
+struct FlightRecorder::Slot {
+    std::atomic<uint64_t> seq;      // 已提交记录的 seq + 1；0 表示空或写入中
+    int64_t epochNs;
+    uint32_t tid;
+    uint8_t level;
+    uint8_t moduleLen;
+    uint8_t eventLen;
+    uint8_t reserved0;
+    uint16_t messageLen;
+    uint16_t reserved1;
+    uint32_t reserved2;
+    char text[kSlotSize - 32];
+};
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "atomic<uint64_t> must be plain-sized");
+
+// 槽位内容的一致副本（seq 为记录自身的序号）
+struct FlightRecorder::SlotCopy {
+    uint64_t seq;
+    int64_t epochNs;
+    uint32_t tid;
+    uint8_t level;
+    uint8_t moduleLen;
+    uint8_t eventLen;
+    uint16_t messageLen;
+    char text[sizeof(Slot::text)];
+};
+
+namespace {
+
+const char kMagic[8] = {'T', 'B', 'O', 'X', 'F', 'L', 'T', '1'};
+const uint32_t kMaxModuleLen = 48;
+const uint32_t kMaxEventLen = 64;
+
+pid_t cached_tid() {
+    static thread_local pid_t t_tid = 0;
+    if (t_tid == 0) {
+#ifdef __APPLE__
+        uint64_t tid;
+        pthread_threadid_np(nullptr, &tid);
+        t_tid = static_cast<pid_t>(tid);
+#else
+        t_tid = gettid();
+#endif
+    }
+    return t_tid;
+}
+
+// 以下辅助函数在信号处理上下文中使用，只能做纯内存操作
+size_t append_raw(char* buf, size_t pos, size_t cap, const char* src, size_t len) {
+    size_t n = std::min(len, cap - pos);
+    for (size_t i = 0; i < n; ++i) {
+        buf[pos + i] = src[i];
+    }
+    return pos + n;
+}
+
+size_t append_uint(char* buf, size_t pos, size_t cap, uint64_t value) {
+    char digits[24];
+    size_t n = 0;
+    do {
+        digits[n++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (n > 0 && pos < cap) {
+        buf[pos++] = digits[--n];
+    }
+    return pos;
+}
+
+size_t c_strlen(const char* s) {
+    size_t n = 0;
+    while (s[n] != '\0') ++n;
+    return n;
+}
+
+std::string format_epoch_ns(int64_t epochNs) {
+    time_t sec = static_cast<time_t>(epochNs / 1000000000LL);
+    int ms = static_cast<int>((epochNs / 1000000LL) % 1000);
+    struct tm tm_result;
+    gmtime_r(&sec, &tm_result);
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+             tm_result.tm_year + 1900, tm_result.tm_mon + 1, tm_result.tm_mday,
+             tm_result.tm_hour, tm_result.tm_min, tm_result.tm_sec, ms);
+    return std::string(buf);
+}
+
+} // anonymous namespace
+
+std::atomic<FlightRecorder*> FlightRecorder::s_active{nullptr};
+
+FlightRecorder::FlightRecorder(const FlightRecorderConfig& config, const std::string& service)
+    : m_path(config.dir + "/" + service + ".flight")
+{
+    mkdir(config.dir.c_str(), 0755);
+    if (openRing(config.size_kb)) {
+        s_active.store(this, std::memory_order_release);
+    }
+}
+
+FlightRecorder::~FlightRecorder() {
+    FlightRecorder* self = this;
+    s_active.compare_exchange_strong(self, nullptr);
+    closeRing();
+}
+
+FlightRecorder* FlightRecorder::active() {
+    return s_active.load(std::memory_order_acquire);
+}
+
+bool FlightRecorder::openRing(uint32_t sizeKb) {
+    static_assert(sizeof(Header) == 64, "flight header must be 64 bytes");
+    static_assert(sizeof(Slot) == kSlotSize, "flight slot size mismatch");
+
+    uint64_t bytes = static_cast<uint64_t>(sizeKb) * 1024;
+    if (bytes <= sizeof(Header)) {
+        return false;
+    }
+    m_slotCount = static_cast<uint32_t>((bytes - sizeof(Header)) / kSlotSize);
+    if (m_slotCount == 0) {
+        return false;
+    }
+    m_mapSize = sizeof(Header) + static_cast<size_t>(m_slotCount) * kSlotSize;
+
+    // 上一次运行（可能已崩溃）的环保留为 .prev，避免重启时被覆盖
+    struct stat st;
+    if (stat(m_path.c_str(), &st) == 0) {
+        std::string prev = m_path + ".prev";
+        rename(m_path.c_str(), prev.c_str());
+    }
+
+    m_fd = open(m_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (m_fd < 0) {
+        return false;
+    }
+    if (ftruncate(m_fd, static_cast<off_t>(m_mapSize)) != 0) {
+        closeRing();
+        return false;
+    }
+
+    void* base = mmap(nullptr, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (base == MAP_FAILED) {
+        closeRing();
+        return false;
+    }
+    m_base = base;
+    m_header = static_cast<Header*>(base);
+    m_slots = reinterpret_cast<Slot*>(static_cast<char*>(base) + sizeof(Header));
+
+    memcpy(m_header->magic, kMagic, sizeof(kMagic));
+    m_header->version = kVersion;
+    m_header->slotSize = kSlotSize;
+    m_header->slotCount = m_slotCount;
+    m_header->pid = static_cast<uint32_t>(getpid());
+    new (&m_header->cursor) std::atomic<uint64_t>(0);
+    return true;
+}
+
+void FlightRecorder::closeRing() {
+    if (m_base) {
+        munmap(m_base, m_mapSize);
+        m_base = nullptr;
+    }
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_header = nullptr;
+    m_slots = nullptr;
+}
+
+void FlightRecorder::record(LogLevel level, std::string_view module,
+                            std::string_view event, std::string_view message) {
+    if (!m_base) return;
+
+    uint64_t seq = m_header->cursor.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = m_slots[seq % m_slotCount];
+
+    // 占用槽位：seq 为 0 且环已绕过一圈说明上一圈的写者仍在写，
+    // 丢弃本条而不是与其交错写坏槽位；占用失败同样丢弃
+    uint64_t current = slot.seq.load(std::memory_order_relaxed);
+    if ((current == 0 && seq >= m_slotCount) || current > seq ||
+        !slot.seq.compare_exchange_strong(current, 0, std::memory_order_relaxed)) {
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    slot.epochNs = static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    slot.tid = static_cast<uint32_t>(cached_tid());
+    slot.level = static_cast<uint8_t>(level);
+
+    size_t moduleLen = std::min<size_t>(module.size(), kMaxModuleLen);
+    size_t eventLen = std::min<size_t>(event.size(), kMaxEventLen);
+    size_t messageLen = std::min<size_t>(message.size(), sizeof(slot.text) - moduleLen - eventLen);
+    memcpy(slot.text, module.data(), moduleLen);
+    memcpy(slot.text + moduleLen, event.data(), eventLen);
+    memcpy(slot.text + moduleLen + eventLen, message.data(), messageLen);
+    slot.moduleLen = static_cast<uint8_t>(moduleLen);
+    slot.eventLen = static_cast<uint8_t>(eventLen);
+    slot.messageLen = static_cast<uint16_t>(messageLen);
+
+    slot.seq.store(seq + 1, std::memory_order_release);
+}
+
+// seqlock 读：复制前后两次读到相同的已提交 seq 才是完整记录，否则复制期间被改写，丢弃。
+// expected 非 0 时还要求已提交值等于它。只用 memcpy 与原子操作，异步信号安全
+bool FlightRecorder::copySlot(const Slot& slot, uint64_t expected, SlotCopy& out) {
+    uint64_t committed = slot.seq.load(std::memory_order_acquire);
+    if (committed == 0 || (expected != 0 && committed != expected)) {
+        return false;
+    }
+    out.epochNs = slot.epochNs;
+    out.tid = slot.tid;
+    out.level = slot.level;
+    out.moduleLen = slot.moduleLen;
+    out.eventLen = slot.eventLen;
+    out.messageLen = slot.messageLen;
+    memcpy(out.text, slot.text, sizeof(out.text));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != committed) {
+        return false;
+    }
+    if (static_cast<size_t>(out.moduleLen) + out.eventLen + out.messageLen > sizeof(out.text)) {
+        return false;
+    }
+    out.seq = committed - 1;
+    return true;
+}
+
+void FlightRecorder::dumpTo(int fd) const {
+    if (!m_base) return;
+
+    static const char kBegin[] = "[flight] ---- begin flight recorder dump ----\n";
+    static const char kEnd[] = "[flight] ---- end flight recorder dump ----\n";
+    ssize_t ret = ::write(fd, kBegin, sizeof(kBegin) - 1);
+
+    uint64_t cursor = m_header->cursor.load(std::memory_order_acquire);
+    uint64_t first = cursor > m_slotCount ? cursor - m_slotCount : 0;
+
+    char line[kSlotSize + 128];
+    SlotCopy copy;
+    const SlotCopy* slot = &copy;
+    for (uint64_t seq = first; seq < cursor; ++seq) {
+        if (!copySlot(m_slots[seq % m_slotCount], seq + 1, copy)) continue;
+
+        const size_t cap = sizeof(line) - 1;
+        size_t pos = 0;
+        const char* level = logLevelToString(static_cast<LogLevel>(slot->level));
+        pos = append_raw(line, pos, cap, "[flight] ", 9);
+        pos = append_uint(line, pos, cap, seq);
+        pos = append_raw(line, pos, cap, " ", 1);
+        pos = append_uint(line, pos, cap, static_cast<uint64_t>(slot->epochNs));
+        pos = append_raw(line, pos, cap, " ", 1);
+        pos = append_raw(line, pos, cap, level, c_strlen(level));
+        pos = append_raw(line, pos, cap, " tid=", 5);
+        pos = append_uint(line, pos, cap, slot->tid);
+        pos = append_raw(line, pos, cap, " ", 1);
+        pos = append_raw(line, pos, cap, slot->text, slot->moduleLen);
+        pos = append_raw(line, pos, cap, " ", 1);
+        pos = append_raw(line, pos, cap, slot->text + slot->moduleLen, slot->eventLen);
+        pos = append_raw(line, pos, cap, " ", 1);
+        pos = append_raw(line, pos, cap, slot->text + slot->moduleLen + slot->eventLen, slot->messageLen);
+        line[pos++] = '\n';
+        ret = ::write(fd, line, pos);
+    }
+
+    ret = ::write(fd, kEnd, sizeof(kEnd) - 1);
+    (void)ret;
+}
+
+bool FlightRecorder::readFile(const std::string& path, std::vector<FlightRecord>& records) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    const Header* header = static_cast<const Header*>(base);
+    bool valid = memcmp(header->magic, kMagic, sizeof(kMagic)) == 0
+        && header->version == kVersion
+        && header->slotSize == kSlotSize
+        && sizeof(Header) + static_cast<size_t>(header->slotCount) * kSlotSize <= size;
+    if (!valid) {
+        munmap(base, size);
+        return false;
+    }
+
+    const Slot* slots = reinterpret_cast<const Slot*>(static_cast<const char*>(base) + sizeof(Header));
+    records.clear();
+    SlotCopy slot;
+    for (uint32_t i = 0; i < header->slotCount; ++i) {
+        // 环文件可能仍被运行中的进程写入
+        if (!copySlot(slots[i], 0, slot)) continue;
+
+        FlightRecord record;
+        record.seq = slot.seq;
+        record.epoch_ns = slot.epochNs;
+        record.tid = slot.tid;
+        record.level = static_cast<LogLevel>(std::min<uint8_t>(slot.level, static_cast<uint8_t>(LogLevel::kFatal)));
+        record.module.assign(slot.text, slot.moduleLen);
+        record.event.assign(slot.text + slot.moduleLen, slot.eventLen);
+        record.message.assign(slot.text + slot.moduleLen + slot.eventLen, slot.messageLen);
+        records.push_back(std::move(record));
+    }
+    munmap(base, size);
+
+    std::sort(records.begin(), records.end(),
+              [](const FlightRecord& a, const FlightRecord& b) { return a.seq < b.seq; });
+    return true;
+}
+
+std::string FlightRecorder::toJsonLine(const FlightRecord& record) {
+    std::vector<Field> fields;
+    fields.reserve(8);
+    fields.push_back({"seq", FieldValue::makeInt(static_cast<int64_t>(record.seq))});
+    fields.push_back({"timestamp", FieldValue::makeString(format_epoch_ns(record.epoch_ns))});
+    fields.push_back({"level", FieldValue::makeString(logLevelToString(record.level))});
+    fields.push_back({"tid", FieldValue::makeInt(static_cast<int64_t>(record.tid))});
+    fields.push_back({"module", FieldValue::makeString(record.module)});
+    fields.push_back({"event", FieldValue::makeString(record.event)});
+    fields.push_back({"message", FieldValue::makeString(record.message)});
+    fields.push_back({"source", FieldValue::makeString("flight_recorder")});
+    return JsonLineFormatter::format(fields);
+}
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
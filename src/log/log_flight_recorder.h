@@ -0,0 +1,85 @@
+#pragma once
+
+#include "log_types.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// 飞行记录条目（离线提取结果）
+struct FlightRecord {
+    uint64_t seq = 0;
+    int64_t epoch_ns = 0;
+    uint32_t tid = 0;
+    LogLevel level = LogLevel::kInfo;
+    std::string module;
+    std::string event;
+    std::string message;
+};
+
+// ============================================================
+// FlightRecorder — 崩溃可存活的内存飞行记录器
+//
+// 记录写入 /run 下 mmap 的环形文件，每条记录占一个定长槽位，
+// 写入路径只有一次 fetch_add 和若干 memcpy，不格式化、不分配。
+// 进程崩溃后文件仍留在 tmpfs 上，可用 tbox-flight-dump 离线提取。
+// ============================================================
+class FlightRecorder {
+public:
+    static constexpr uint32_t kSlotSize = 256;
+    static constexpr uint32_t kVersion = 1;
+
+    FlightRecorder(const FlightRecorderConfig& config, const std::string& service);
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    bool isAvailable() const { return m_base != nullptr; }
+    const std::string& getPath() const { return m_path; }
+
+    // 热路径：记录一条日志（所有级别，超长部分截断）
+    void record(LogLevel level, std::string_view module,
+                std::string_view event, std::string_view message);
+
+    // 异步信号安全：按时间顺序把环内容写到 fd（仅使用 write(2)）
+    void dumpTo(int fd) const;
+
+    // 当前进程的活动记录器（供致命信号处理函数使用）
+    static FlightRecorder* active();
+
+    // 离线读取环文件，按 seq 升序返回已提交的记录
+    static bool readFile(const std::string& path, std::vector<FlightRecord>& records);
+
+    // 单条记录转 JSON 行
+    static std::string toJsonLine(const FlightRecord& record);
+
+private:
+    struct Header;
+    struct Slot;
+    struct SlotCopy;
+
+    std::string m_path;
+    int m_fd = -1;
+    void* m_base = nullptr;
+    size_t m_mapSize = 0;
+    Header* m_header = nullptr;
+    Slot* m_slots = nullptr;
+    uint32_t m_slotCount = 0;
+
+    bool openRing(uint32_t sizeKb);
+    void closeRing();
+    static bool copySlot(const Slot& slot, uint64_t expected, SlotCopy& out);
+
+    static std::atomic<FlightRecorder*> s_active;
+};
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
@@ -17,7 +17,7 @@ std::string JsonLineFormatter::format(const std::vector<Field>& fields) {
     return oss.str();
 }
 
-std::string JsonLineFormatter::escapeString(const std::string& str) {
+std::string JsonLineFormatter::escapeString(std::string_view str) {
     std::string result;
     result.reserve(str.size() + 8);
     for (char c : str) {
@@ -46,9 +46,17 @@ std::string JsonLineFormatter::escapeString(const std::string& str) {
 std::string JsonLineFormatter::formatValue(const FieldValue& value) {
     switch (value.type) {
         case FieldValueType::kString:
-            return '"' + escapeString(value.stringVal) + '"';
+            return '"' + escapeString(value.stringView()) + '"';
         case FieldValueType::kInt64:
             return std::to_string(value.intVal);
+        case FieldValueType::kUint64:
+            return std::to_string(value.uintVal);
+        case FieldValueType::kBytes: {
+            std::string encoded = value.isBase64() ? base64Encode(value.stringView())
+                                                   : hexEncode(value.stringView());
+            if (value.isTruncated()) encoded += "...[truncated]";
+            return '"' + encoded + '"';
+        }
         case FieldValueType::kDouble: {
             char buf[64];
             snprintf(buf, sizeof(buf), "%g", value.doubleVal);
@@ -61,6 +69,44 @@ std::string JsonLineFormatter::formatValue(const FieldValue& value) {
     }
 }
 
+std::string JsonLineFormatter::hexEncode(std::string_view bytes) {
+    static const char kHex[] = "0123456789abcdef";
+    std::string result;
+    result.resize(bytes.size() * 2);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        unsigned char b = static_cast<unsigned char>(bytes[i]);
+        result[i * 2] = kHex[b >> 4];
+        result[i * 2 + 1] = kHex[b & 0x0F];
+    }
+    return result;
+}
+
+std::string JsonLineFormatter::base64Encode(std::string_view bytes) {
+    static const char kTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string result;
+    result.reserve((bytes.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 2 < bytes.size(); i += 3) {
+        uint32_t n = (static_cast<uint32_t>(static_cast<unsigned char>(bytes[i])) << 16) |
+                     (static_cast<uint32_t>(static_cast<unsigned char>(bytes[i + 1])) << 8) |
+                     static_cast<uint32_t>(static_cast<unsigned char>(bytes[i + 2]));
+        result += kTable[(n >> 18) & 0x3F];
+        result += kTable[(n >> 12) & 0x3F];
+        result += kTable[(n >> 6) & 0x3F];
+        result += kTable[n & 0x3F];
+    }
+    size_t rest = bytes.size() - i;
+    if (rest > 0) {
+        uint32_t n = static_cast<uint32_t>(static_cast<unsigned char>(bytes[i])) << 16;
+        if (rest == 2) n |= static_cast<uint32_t>(static_cast<unsigned char>(bytes[i + 1])) << 8;
+        result += kTable[(n >> 18) & 0x3F];
+        result += kTable[(n >> 12) & 0x3F];
+        result += rest == 2 ? kTable[(n >> 6) & 0x3F] : '=';
+        result += '=';
+    }
+    return result;
+}
+
 } // namespace log
 } // namespace fw
 } // namespace tbox
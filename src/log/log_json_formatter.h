@@ -2,6 +2,7 @@
 
 #include "log_types.h"
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace tbox {
@@ -12,8 +13,12 @@ class JsonLineFormatter {
 public:
     static std::string format(const std::vector<Field>& fields);
 
+    // 字节字段的文本形式，脱敏按同一形式处理标识符
+    static std::string hexEncode(std::string_view bytes);
+    static std::string base64Encode(std::string_view bytes);
+
 private:
-    static std::string escapeString(const std::string& str);
+    static std::string escapeString(std::string_view str);
     static std::string formatValue(const FieldValue& value);
 };
 
@@ -1,29 +1,74 @@
 #include "log_level_filter.h"
+#include <mutex>
 
 namespace tbox {
 namespace fw {
 namespace log {
 
 LevelFilter::LevelFilter(const LogConfig& config)
-    : m_globalLevel(config.level)
-    , m_moduleLevels(config.module_levels)
+    : m_globalLevel(static_cast<uint8_t>(config.level))
+    , m_moduleLevels(new std::atomic<uint8_t>[ModuleTable::kMaxModules])
 {
+    for (size_t i = 0; i < ModuleTable::kMaxModules; ++i) {
+        m_moduleLevels[i].store(kUnset, std::memory_order_relaxed);
+    }
+    for (const auto& pair : config.module_levels) {
+        setModuleLevel(pair.first, pair.second);
+    }
+    setOverrides(config.level_overrides);
 }
 
-bool LevelFilter::shouldLog(LogLevel level, const std::string& module) const {
-    auto it = m_moduleLevels.find(module);
-    if (it != m_moduleLevels.end()) {
-        return static_cast<uint8_t>(level) >= static_cast<uint8_t>(it->second);
+void LevelFilter::setOverrides(const std::vector<LevelOverride>& overrides) {
+    std::vector<CompiledOverride> compiled;
+    uint8_t minLevel = kUnset;
+    for (const auto& item : overrides) {
+        CompiledOverride entry;
+        entry.bySession = item.trace_id.empty();
+        entry.value = entry.bySession ? item.session_id : item.trace_id;
+        entry.prefix = item.prefix;
+        entry.anyModule = item.module.empty();
+        entry.module = entry.anyModule ? 0 : ModuleTable::instance().intern(item.module);
+        entry.level = static_cast<uint8_t>(item.level);
+        if (entry.value.empty()) continue;
+        if (entry.level < minLevel) minLevel = entry.level;
+        compiled.push_back(std::move(entry));
+    }
+
+    std::unique_ptr<const Overrides> snapshot(new Overrides(std::move(compiled)));
+    std::lock_guard<std::mutex> lock(m_snapshotsMutex);
+    m_overrides.store(snapshot.get(), std::memory_order_release);
+    m_minOverrideLevel.store(minLevel, std::memory_order_relaxed);
+    m_snapshots.push_back(std::move(snapshot));
+}
+
+bool LevelFilter::matchOverride(LogLevel level, ModuleId module, const LogContext* context) const {
+    if (!context) return false;
+
+    const Overrides* overrides = m_overrides.load(std::memory_order_acquire);
+    if (!overrides) return false;
+    for (const auto& item : *overrides) {
+        if (static_cast<uint8_t>(level) < item.level) continue;
+        if (!item.anyModule && item.module != module) continue;
+
+        std::string_view actual = item.bySession ? context->session_id.view() : context->trace_id.view();
+        bool matched = item.prefix ? actual.substr(0, item.value.size()) == item.value
+                                   : actual == item.value;
+        if (matched) return true;
     }
-    return static_cast<uint8_t>(level) >= static_cast<uint8_t>(m_globalLevel);
+    return false;
+}
+
+bool LevelFilter::shouldLog(LogLevel level, const std::string& module) const {
+    return shouldLog(level, ModuleTable::instance().intern(module));
 }
 
 void LevelFilter::setGlobalLevel(LogLevel level) {
-    m_globalLevel = level;
+    m_globalLevel.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
 }
 
 void LevelFilter::setModuleLevel(const std::string& module, LogLevel level) {
-    m_moduleLevels[module] = level;
+    ModuleId id = ModuleTable::instance().intern(module);
+    m_moduleLevels[id].store(static_cast<uint8_t>(level), std::memory_order_relaxed);
 }
 
 } // namespace log
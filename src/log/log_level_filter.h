@@ -1,8 +1,12 @@
 #pragma once
 
 #include "log_types.h"
+#include "log_module_table.h"
 #include <string>
-#include <unordered_map>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <mutex>
 
 namespace tbox {
 namespace fw {
@@ -12,13 +16,55 @@ class LevelFilter {
 public:
     explicit LevelFilter(const LogConfig& config);
 
+    // 热路径：按模块 ID 查表，无哈希、无锁
+    bool shouldLog(LogLevel level, ModuleId module) const {
+        uint8_t threshold = m_moduleLevels[module].load(std::memory_order_relaxed);
+        if (threshold == kUnset) {
+            threshold = m_globalLevel.load(std::memory_order_relaxed);
+        }
+        return static_cast<uint8_t>(level) >= threshold;
+    }
+
+    // 未通过 shouldLog 的记录再按定向覆盖判定；没有覆盖时只多一次比较
+    bool overrideAllows(LogLevel level, ModuleId module, const LogContext* context) const {
+        if (static_cast<uint8_t>(level) < m_minOverrideLevel.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        return matchOverride(level, module, context);
+    }
+
+    // 整体替换定向覆盖：发布新的不可变快照，读者无锁读取。
+    // 旧快照保留到过滤器析构；处理链的覆盖变化通过重建过滤器生效，不反复调用
+    void setOverrides(const std::vector<LevelOverride>& overrides);
+
     bool shouldLog(LogLevel level, const std::string& module) const;
     void setGlobalLevel(LogLevel level);
     void setModuleLevel(const std::string& module, LogLevel level);
 
 private:
-    LogLevel m_globalLevel;
-    std::unordered_map<std::string, LogLevel> m_moduleLevels;
+    static constexpr uint8_t kUnset = 0xFF;
+
+    struct CompiledOverride {
+        std::string value;
+        bool bySession;
+        bool prefix;
+        bool anyModule;
+        ModuleId module;
+        uint8_t level;
+    };
+
+    std::atomic<uint8_t> m_globalLevel;
+    // 按 ModuleId 索引的模块级别覆盖，kUnset 表示沿用全局级别
+    std::unique_ptr<std::atomic<uint8_t>[]> m_moduleLevels;
+
+    // 所有覆盖中最低的级别，无覆盖时为 kUnset
+    std::atomic<uint8_t> m_minOverrideLevel{kUnset};
+    using Overrides = std::vector<CompiledOverride>;
+    std::atomic<const Overrides*> m_overrides{nullptr};    // 当前快照
+    std::mutex m_snapshotsMutex;
+    std::vector<std::unique_ptr<const Overrides>> m_snapshots;     // 已发布的全部快照
+
+    bool matchOverride(LogLevel level, ModuleId module, const LogContext* context) const;
 };
 
 } // namespace log
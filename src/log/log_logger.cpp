@@ -2,14 +2,31 @@
 #include "log_enricher.h"
 #include "log_redactor.h"
 #include "log_level_filter.h"
+#include "log_sampler.h"
 #include "log_json_formatter.h"
 #include "log_async_dispatcher.h"
+#include "log_sink_router.h"
 #include "log_sink_manager.h"
 #include "log_emergency_writer.h"
+#include "log_flight_recorder.h"
+#include "log_module_table.h"
+#include "log_catalog_registry.h"
+#include "log_message_formatter.h"
+#include "log_backtrace.h"
 #include <unordered_map>
 #include <mutex>
+#include <shared_mutex>
+#include <atomic>
 #include <vector>
+#include <thread>
+#include <chrono>
 #include <cstdlib>
+#include <random>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <pthread.h>
+#endif
 
 namespace tbox {
 namespace fw {
@@ -20,23 +37,144 @@ namespace log {
 // ============================================================
 static thread_local const LogContext* t_context = nullptr;
 
+// 线程 ID 缓存：二进制记录每条都要携带 tid
+static uint32_t currentTid() {
+    static thread_local uint32_t t_tid = 0;
+    if (t_tid == 0) {
+#ifdef __APPLE__
+        uint64_t tid;
+        pthread_threadid_np(nullptr, &tid);
+        t_tid = static_cast<uint32_t>(tid);
+#else
+        t_tid = static_cast<uint32_t>(gettid());
+#endif
+    }
+    return t_tid;
+}
+
 const LogContext* ContextScope::current() {
     return t_context;
 }
 
-ContextScope::ContextScope(LogContext context)
-    : m_context(std::move(context))
+ContextScope::ContextScope(const LogContext& context)
+    : m_context(context)
     , m_previous(t_context)
 {
     t_context = &m_context;
 }
 
+ContextScope::ContextScope(const Handle& handle)
+    : m_context(handle.m_context)
+    , m_previous(t_context)
+{
+    t_context = handle.m_active ? &m_context : nullptr;
+}
+
+ContextScope::Handle ContextScope::capture() noexcept {
+    Handle handle;
+    if (t_context) {
+        handle.m_context = *t_context;
+        handle.m_active = true;
+    }
+    return handle;
+}
+
+namespace {
+
+// xoshiro256**：每线程一份状态，首次使用时由 random_device 与线程地址播种
+class TraceIdRng {
+public:
+    TraceIdRng() {
+        std::random_device device;
+        uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device() ^
+                        reinterpret_cast<uintptr_t>(this) ^
+                        static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        for (uint64_t& word : m_state) {
+            seed += 0x9E3779B97F4A7C15ULL;      // splitmix64 展开种子
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() noexcept {
+        uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+private:
+    uint64_t m_state[4];
+
+    static uint64_t rotl(uint64_t x, int k) noexcept { return (x << k) | (x >> (64 - k)); }
+};
+
+} // namespace
+
+LogContext::Id ContextScope::newTraceId() noexcept {
+    static thread_local TraceIdRng t_rng;
+    static const char kHex[] = "0123456789abcdef";
+
+    uint64_t high;
+    uint64_t low;
+    do {
+        high = t_rng.next();
+        low = t_rng.next();
+    } while (high == 0 && low == 0);      // W3C：全零 trace-id 无效
+
+    char text[32];
+    for (int i = 0; i < 16; ++i) {
+        text[i] = kHex[(high >> (60 - i * 4)) & 0x0F];
+        text[16 + i] = kHex[(low >> (60 - i * 4)) & 0x0F];
+    }
+    return LogContext::Id(std::string_view(text, sizeof(text)));
+}
+
+ContextScope ContextScope::startTrace() {
+    LogContext context = t_context ? *t_context : LogContext();
+    context.trace_id = newTraceId();
+    return ContextScope(context);
+}
+
 ContextScope::~ContextScope() {
     t_context = m_previous;
 }
 
+// ============================================================
+// Pipeline — 一代完整处理链
+//
+// 热重载时构建新一代并整体替换；配置未变化的组件（enricher、sink、
+// 异步队列、飞行记录器）在相邻两代之间共享，因此用 shared_ptr 持有。
+// ============================================================
+struct Pipeline {
+    std::shared_ptr<Enricher> enricher;
+    std::shared_ptr<Redactor> redactor;
+    std::shared_ptr<LevelFilter> levelFilter;
+    std::shared_ptr<Sampler> sampler;           // 未配置采样规则时为空
+    std::shared_ptr<SinkManager> sinkManager;
+    std::shared_ptr<AsyncDispatcher> dispatcher;
+    std::shared_ptr<FlightRecorder> flightRecorder;
+    std::shared_ptr<SinkRouter> router;         // 随每代重建，与 config 保持一致
+    LogConfig config;
+};
+
 // ============================================================
 // LoggerRegistry
+//
+// 每个模块只有一个共享的 Logger::Impl，按 ModuleId 缓存；
+// Impl 不持有处理链指针，每次记录时从 registry 取当前 Pipeline，
+// 因此 init 之前创建的 Logger 在 init 之后自动生效。
+//
+// Pipeline 的发布与回收采用 RCU：读者进入时在当前纪元的计数器上
+// 登记，写者替换指针后翻转纪元，等待旧纪元计数归零即可安全回收旧代。
+// 热路径只有两次原子加减，不加锁。
 // ============================================================
 class LoggerRegistry {
 public:
@@ -45,65 +183,72 @@ public:
         return inst;
     }
 
-    InitResult init(const std::string& service, const LogConfig& config) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-
-        if (m_initialized) {
-            return {LogError::kOk, "Already initialized"};
+    InitResult init(const std::string& service, const LogConfig& config);
+    InitResult reload(const LogConfig& config);
+    uint64_t addLevelOverride(const LevelOverride& override);
+    bool removeLevelOverride(uint64_t id);
+    Logger getLogger(const std::string& module);
+    void shutdown();
+
+    bool isInitialized() const { return m_pipeline.load(std::memory_order_acquire) != nullptr; }
+
+    // 读侧临界区：存活期间取得的 Pipeline 不会被回收
+    class ReadGuard {
+    public:
+        // 读纪元与登记计数之间可能发生翻转：登记后纪元已变则撤销重来，
+        // 否则登记到已被等待过的旧计数器，之后的回收不会再等待本读者
+        explicit ReadGuard(const LoggerRegistry& registry) {
+            while (true) {
+                uint32_t epoch = registry.m_epoch.load();
+                m_counter = &registry.m_readers[epoch & 1].count;
+                m_counter->fetch_add(1);
+                if (registry.m_epoch.load() == epoch) {
+                    break;
+                }
+                m_counter->fetch_sub(1, std::memory_order_release);
+            }
+            m_pipeline = registry.m_pipeline.load();
         }
+        ~ReadGuard() { m_counter->fetch_sub(1, std::memory_order_release); }
 
-        m_service = service;
-        m_enricher.reset(new Enricher(service));
-        m_redactor.reset(new Redactor(config.redact_config));
-        m_levelFilter.reset(new LevelFilter(config));
-        m_sinkManager.reset(new SinkManager(config, service));
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
 
-        if (config.async_config.enabled) {
-            auto writer = [this](const std::string& line, bool isError) -> bool {
-                return m_sinkManager->write(line, isError);
-            };
-            m_dispatcher.reset(new AsyncDispatcher(
-                config.async_config.queue_size,
-                config.async_config.flush_interval_ms,
-                std::move(writer)
-            ));
-            m_dispatcher->start();
-        }
+        const Pipeline* get() const { return m_pipeline; }
 
-        m_initialized = true;
-        return {LogError::kOk, ""};
-    }
-
-    Logger getLogger(const std::string& module) {
-        Logger logger;
-        logger.m_impl = std::make_shared<Logger::Impl>(
-            module, m_enricher.get(), m_redactor.get(),
-            m_levelFilter.get(), m_dispatcher.get(), m_sinkManager.get()
-        );
-        return logger;
-    }
-
-    bool isInitialized() const { return m_initialized; }
-
-    void shutdown() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (m_dispatcher) {
-            m_dispatcher->stop();
-        }
-        m_initialized = false;
-    }
+    private:
+        std::atomic<uint64_t>* m_counter;
+        const Pipeline* m_pipeline;
+    };
 
 private:
     LoggerRegistry() = default;
 
-    std::mutex m_mutex;
-    bool m_initialized = false;
+    // 各纪元的在途读者计数，独占缓存行避免伪共享
+    struct alignas(64) ReaderCount {
+        std::atomic<uint64_t> count{0};
+    };
+
+    std::mutex m_mutex;                         // 串行化 init/reload/shutdown
     std::string m_service;
-    std::unique_ptr<Enricher> m_enricher;
-    std::unique_ptr<Redactor> m_redactor;
-    std::unique_ptr<LevelFilter> m_levelFilter;
-    std::unique_ptr<AsyncDispatcher> m_dispatcher;
-    std::unique_ptr<SinkManager> m_sinkManager;
+    std::unique_ptr<Pipeline> m_owned;
+    std::atomic<Pipeline*> m_pipeline{nullptr};
+    mutable ReaderCount m_readers[2];
+    std::atomic<uint32_t> m_epoch{0};
+
+    // 运行期定向覆盖，重建处理链时与配置中的覆盖合并
+    std::vector<std::pair<uint64_t, LevelOverride>> m_runtimeOverrides;
+    uint64_t m_nextOverrideId = 1;
+
+    mutable std::shared_mutex m_loggersMutex;
+    std::vector<std::shared_ptr<Logger::Impl>> m_loggers;  // 按 ModuleId 索引
+
+    std::unique_ptr<Pipeline> buildPipeline(const LogConfig& config, const Pipeline* previous);
+    std::vector<LevelOverride> mergedOverrides(const LogConfig& config) const;
+    std::unique_ptr<Pipeline> publish(std::unique_ptr<Pipeline> next);
+    void rebuildLocked();   // 须持有 m_mutex：按当前配置重建并发布新一代处理链
+    void synchronize();
+    static void retire(std::unique_ptr<Pipeline> old, const Pipeline* next);
 };
 
 // ============================================================
@@ -111,60 +256,524 @@ private:
 // ============================================================
 class Logger::Impl {
 public:
-    Impl(const std::string& module,
-         Enricher* enricher,
-         Redactor* redactor,
-         LevelFilter* levelFilter,
-         AsyncDispatcher* dispatcher,
-         SinkManager* sinkManager)
+    Impl(ModuleId module, const LoggerRegistry& registry)
         : m_module(module)
-        , m_enricher(enricher)
-        , m_redactor(redactor)
-        , m_levelFilter(levelFilter)
-        , m_dispatcher(dispatcher)
-        , m_sinkManager(sinkManager)
+        , m_moduleName(ModuleTable::instance().name(module))
+        , m_registry(registry)
+    {}
+
+    // 模块表已满：共用溢出 ID，自存真实模块名，不进入缓存
+    Impl(const std::string& moduleName, const LoggerRegistry& registry)
+        : m_module(ModuleTable::kOverflowId)
+        , m_ownName(moduleName)
+        , m_moduleName(m_ownName)
+        , m_registry(registry)
     {}
 
     void log(LogLevel level, std::string_view event, std::string_view message,
              std::initializer_list<Field> fields) {
-        if (!m_levelFilter->shouldLog(level, m_module)) {
+        LoggerRegistry::ReadGuard guard(m_registry);
+        const Pipeline* pipeline = guard.get();
+        if (!pipeline) {
+            logBeforeInit(level, event, message);
+            return;
+        }
+
+        // 飞行记录器不受级别过滤影响，崩溃后可取回 DEBUG 上下文
+        if (pipeline->flightRecorder) {
+            pipeline->flightRecorder->record(level, m_moduleName, event, message);
+        }
+
+        if (!passesLevel(*pipeline, level, m_module)) {
+            if (BacktraceRecord* record = captureBacktrace(*pipeline, level, m_module, m_moduleName, event)) {
+                record->kind = BacktraceRecord::Kind::kPlain;
+                record->message.assign(message.data(), message.size());
+                record->fields.assign(fields.begin(), fields.end());
+                for (auto& field : record->fields) {
+                    pipeline->redactor->limitPayload(field);    // 只拷贝保留的前缀
+                    field.own();
+                }
+            }
             return;
         }
 
+        const LogContext* ctx = ContextScope::current();
+        if (pipeline->sampler && !pipeline->sampler->shouldKeep(level, m_module, event, ctx)) {
+            return;
+        }
+        if (level >= LogLevel::kError) {
+            flushBacktrace(*pipeline, ctx);
+        }
+
         std::vector<Field> fieldVec(fields.begin(), fields.end());
+        dispatch(*pipeline, std::move(fieldVec), level, m_module, m_moduleName, event, message, ctx);
+    }
+
+    // 模板消息：通过过滤/采样后才展开；异步模式下由 dispatcher 线程展开
+    // 参数经 pack 按需编码：被级别/采样过滤的记录不编码
+    void logFormatted(LogLevel level, std::string_view event, std::string_view format,
+                      Logger::ArgPacker pack, const void* source) {
+        LoggerRegistry::ReadGuard guard(m_registry);
+        const Pipeline* pipeline = guard.get();
+        if (!pipeline) {
+            if (level >= LogLevel::kError) {
+                CatalogArgs args;
+                pack(args, source);
+                logBeforeInit(level, event, MessageFormatter::format(format, args));
+            }
+            return;
+        }
+
+        // 飞行记录器记录未展开的模板，保持其全级别记录的低开销
+        if (pipeline->flightRecorder) {
+            pipeline->flightRecorder->record(level, m_moduleName, event, format);
+        }
+
+        if (!passesLevel(*pipeline, level, m_module)) {
+            if (BacktraceRecord* record = captureBacktrace(*pipeline, level, m_module, m_moduleName, event)) {
+                record->kind = BacktraceRecord::Kind::kTemplate;
+                record->format = format;
+                record->args = CatalogArgs();
+                pack(record->args, source);
+            }
+            return;
+        }
+
         const LogContext* ctx = ContextScope::current();
+        if (pipeline->sampler && !pipeline->sampler->shouldKeep(level, m_module, event, ctx)) {
+            return;
+        }
+        if (level >= LogLevel::kError) {
+            flushBacktrace(*pipeline, ctx);
+        }
+
+        if (!pipeline->dispatcher) {
+            CatalogArgs args;
+            pack(args, source);
+            dispatch(*pipeline, {}, level, m_module, m_moduleName, event,
+                     MessageFormatter::format(format, args), ctx);
+            return;
+        }
+
+        std::unique_ptr<DeferredRecord> record(new DeferredRecord());
+        std::vector<Field> enriched = pipeline->enricher->enrich({}, level, m_module, event, std::string_view(), ctx);
+        stampModuleName(enriched, m_module, m_moduleName);
+        record->fields = pipeline->redactor->redact(std::move(enriched));
+        record->messageIndex = 0;
+        for (size_t i = 0; i < record->fields.size(); ++i) {
+            record->fields[i].own();
+            if (record->fields[i].key == "message") record->messageIndex = i;
+        }
+        record->format = format;
+        pack(record->args, source);
+        pipeline->dispatcher->submitDeferred(std::move(record), level, pipeline->router->route(m_module, level));
+    }
+
+    void emit(const CatalogSite& site, const CatalogArgs& args) {
+        LoggerRegistry::ReadGuard guard(m_registry);
+        const Pipeline* pipeline = guard.get();
+        LogLevel level = site.level();
+        if (!pipeline) {
+            logBeforeInit(level, site.event(), site.message());
+            return;
+        }
+
+        if (pipeline->flightRecorder) {
+            pipeline->flightRecorder->record(level, site.module(), site.event(), site.message());
+        }
+
+        if (!passesLevel(*pipeline, level, site.moduleId())) {
+            if (BacktraceRecord* record = captureBacktrace(*pipeline, level, site.moduleId(), site.module(),
+                                                           site.event())) {
+                record->kind = BacktraceRecord::Kind::kCatalog;
+                record->site = &site;
+                record->args = args;
+            }
+            return;
+        }
+
+        const LogContext* ctx = ContextScope::current();
+        if (pipeline->sampler && !pipeline->sampler->shouldKeep(level, site.moduleId(), site.event(), ctx)) {
+            return;
+        }
+        if (level >= LogLevel::kError) {
+            flushBacktrace(*pipeline, ctx);
+        }
+
+        // 二进制段：只写 ID + 时间戳 + 参数，跳过 enrich/format；
+        // 需要脱敏的调用点仍走 JSON 路径，保证敏感值不以原文落盘
+        // 路由到命名 sink 的记录同样走 JSON 路径；同时路由到控制台的记录另以 JSON 只写控制台
+        uint32_t sinkMask = pipeline->router->route(site.moduleId(), level);
+        if (pipeline->sinkManager->binaryEnabled() && !site.requiresRedaction() &&
+            (sinkMask & ~SinkRouter::kConsole) == SinkRouter::kFile) {
+            static thread_local std::string t_payload;
+            uint64_t epochNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+            BinaryFileSink::encodeRecord(t_payload, site.id(), epochNs, currentTid(), ctx, args);
+            if (pipeline->sinkManager->writeRecord(site.id(), t_payload)) {
+                if ((sinkMask & SinkRouter::kConsole) && pipeline->sinkManager->consoleEnabled()) {
+                    dispatch(*pipeline, catalogFields(site, args), level, site.moduleId(), site.module(),
+                             site.event(), site.message(), ctx, nullptr, SinkRouter::kConsole);
+                }
+                return;
+            }
+        }
+
+        dispatch(*pipeline, catalogFields(site, args), level, site.moduleId(), site.module(),
+                 site.event(), site.message(), ctx);
+    }
 
-        std::vector<Field> enriched = m_enricher->enrich(
-            std::move(fieldVec), level, m_module,
-            std::string(event), std::string(message), ctx
+    void flush() {
+        LoggerRegistry::ReadGuard guard(m_registry);
+        const Pipeline* pipeline = guard.get();
+        if (!pipeline) return;
+        if (pipeline->dispatcher) {
+            pipeline->dispatcher->flush();
+        }
+        pipeline->sinkManager->flush();
+    }
+
+private:
+    ModuleId m_module;
+    std::string m_ownName;              // 仅溢出模块使用
+    const std::string& m_moduleName;
+    const LoggerRegistry& m_registry;
+
+    void dispatch(const Pipeline& pipeline, std::vector<Field> fields, LogLevel level, ModuleId module,
+                  std::string_view moduleName, std::string_view event, std::string_view message,
+                  const LogContext* ctx, const BacktraceRecord* backtrace = nullptr,
+                  uint32_t sinkFilter = ~0u) {
+        std::vector<Field> enriched = pipeline.enricher->enrich(
+            std::move(fields), level, module, event, message, ctx
         );
+        stampModuleName(enriched, module, moduleName);
+        if (backtrace) {
+            pipeline.enricher->restamp(enriched, backtrace->wallTime, backtrace->monoTime);
+            enriched.push_back({"backtrace", FieldValue::makeBool(true)});
+        }
 
-        std::vector<Field> redacted = m_redactor->redact(std::move(enriched));
+        std::vector<Field> redacted = pipeline.redactor->redact(std::move(enriched));
         std::string jsonLine = JsonLineFormatter::format(redacted);
 
-        if (m_dispatcher) {
-            m_dispatcher->submit(jsonLine, level);
+        // sinkFilter 只收窄路由结果，二进制记录已写文件时只剩控制台
+        uint32_t sinkMask = pipeline.router->route(module, level) & sinkFilter;
+        if (pipeline.dispatcher) {
+            pipeline.dispatcher->submit(jsonLine, level, sinkMask);
         } else {
-            m_sinkManager->write(jsonLine, level >= LogLevel::kError);
+            pipeline.sinkManager->write(jsonLine, level >= LogLevel::kError, sinkMask);
         }
     }
 
-    void flush() {
-        if (m_dispatcher) {
-            m_dispatcher->flush();
+    // 溢出模块共用 "_overflow" 的 ID，记录中换回真实模块名
+    static void stampModuleName(std::vector<Field>& fields, ModuleId module, std::string_view moduleName) {
+        if (module != ModuleTable::kOverflowId || moduleName.empty()) return;
+        for (auto& field : fields) {
+            if (field.key == "module") {
+                field.value = FieldValue::makeStringView(moduleName);
+                return;
+            }
         }
-        m_sinkManager->flush();
     }
 
-private:
-    std::string m_module;
-    Enricher* m_enricher;
-    Redactor* m_redactor;
-    LevelFilter* m_levelFilter;
-    AsyncDispatcher* m_dispatcher;
-    SinkManager* m_sinkManager;
+    // 级别判定：全局/模块级别之外，再看当前上下文是否命中定向覆盖
+    static bool passesLevel(const Pipeline& pipeline, LogLevel level, ModuleId module) {
+        return pipeline.levelFilter->shouldLog(level, module) ||
+               pipeline.levelFilter->overrideAllows(level, module, ContextScope::current());
+    }
+
+    // 目录参数还原为字段：key 借用 site 的静态字符串，值借用 args
+    static std::vector<Field> catalogFields(const CatalogSite& site, const CatalogArgs& args) {
+        std::vector<FieldValue> values;
+        values.reserve(args.count());
+        catalog_wire::decodeArgs(args.data(), args.size(), values);
+
+        const std::vector<CatalogKey>& keys = site.keys();
+        std::vector<Field> fields;
+        fields.reserve(values.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i < keys.size()) {
+                Field field;
+                field.key = keys[i].name;
+                field.value = std::move(values[i]);
+                field.sensitivity = keys[i].sensitivity;
+                fields.push_back(std::move(field));
+            } else {
+                fields.push_back(Field("arg" + std::to_string(i), std::move(values[i])));
+            }
+        }
+        return fields;
+    }
+
+    // 被级别过滤的记录：开启回溯且不低于捕获级别时返回待填充的槽位
+    static BacktraceRecord* captureBacktrace(const Pipeline& pipeline, LogLevel level, ModuleId module,
+                                             std::string_view moduleName, std::string_view event) {
+        const BacktraceConfig& config = pipeline.config.backtrace_config;
+        if (!config.enabled || level < config.capture_level) return nullptr;
+
+        BacktraceRecord& record = BacktraceBuffer::local().push(config.size);
+        record.level = level;
+        record.module = module;
+        if (module == ModuleTable::kOverflowId) {
+            record.moduleName.assign(moduleName.data(), moduleName.size());
+        } else {
+            record.moduleName.clear();
+        }
+        record.wallTime = std::chrono::system_clock::now();
+        record.monoTime = std::chrono::steady_clock::now();
+        record.event.assign(event.data(), event.size());
+        const LogContext* ctx = ContextScope::current();
+        if (ctx) {
+            record.traceId = ctx->trace_id;
+        } else {
+            record.traceId.clear();
+        }
+        record.fields.clear();
+        record.site = nullptr;
+        return &record;
+    }
+
+    // ERROR 之前补写本线程（有 trace 时限同一 trace）暂存的记录
+    void flushBacktrace(const Pipeline& pipeline, const LogContext* ctx) {
+        if (!pipeline.config.backtrace_config.enabled) return;
+        BacktraceBuffer& buffer = BacktraceBuffer::local();
+        if (buffer.empty()) return;
+
+        std::string_view traceId = ctx ? std::string_view(ctx->trace_id) : std::string_view();
+        buffer.drain(traceId, [&](BacktraceRecord& record) {
+            LogContext recordContext;
+            const LogContext* recordCtx = ctx;
+            if (!ctx && !record.traceId.empty()) {
+                recordContext.trace_id = record.traceId;
+                recordCtx = &recordContext;
+            }
+
+            switch (record.kind) {
+                case BacktraceRecord::Kind::kPlain:
+                    dispatch(pipeline, std::move(record.fields), record.level, record.module,
+                             record.moduleName, record.event, record.message, recordCtx, &record);
+                    break;
+                case BacktraceRecord::Kind::kTemplate:
+                    dispatch(pipeline, {}, record.level, record.module, record.moduleName, record.event,
+                             MessageFormatter::format(record.format, record.args), recordCtx, &record);
+                    break;
+                case BacktraceRecord::Kind::kCatalog:
+                    dispatch(pipeline, catalogFields(*record.site, record.args), record.level, record.module,
+                             record.moduleName, record.event, record.site->message(), recordCtx, &record);
+                    break;
+            }
+        });
+    }
+
+    // init 之前：ERROR 及以上直接写 stderr，其余丢弃
+    void logBeforeInit(LogLevel level, std::string_view event, std::string_view message) {
+        if (level < LogLevel::kError) return;
+        std::string line = "[LOG_PREINIT] ";
+        line += logLevelToString(level);
+        line += ' ';
+        line += m_moduleName;
+        line += ' ';
+        line.append(event.data(), event.size());
+        line += ": ";
+        line.append(message.data(), message.size());
+        line += '\n';
+        EmergencyWriter::write(line);
+    }
 };
 
+// ============================================================
+// LoggerRegistry 实现
+// ============================================================
+InitResult LoggerRegistry::init(const std::string& service, const LogConfig& config) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_pipeline.load(std::memory_order_relaxed)) {
+        return {LogError::kOk, "Already initialized"};
+    }
+
+    m_service = service;
+    publish(buildPipeline(config, nullptr));
+    return {LogError::kOk, ""};
+}
+
+InitResult LoggerRegistry::reload(const LogConfig& config) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const Pipeline* current = m_pipeline.load(std::memory_order_relaxed);
+    if (!current) {
+        return {LogError::kInitFailed, "Logger is not initialized"};
+    }
+
+    std::unique_ptr<Pipeline> next = buildPipeline(config, current);
+    const Pipeline* published = next.get();
+    std::unique_ptr<Pipeline> old = publish(std::move(next));
+    retire(std::move(old), published);
+    return {LogError::kOk, ""};
+}
+
+std::unique_ptr<Pipeline> LoggerRegistry::buildPipeline(const LogConfig& config, const Pipeline* previous) {
+    std::unique_ptr<Pipeline> pipeline(new Pipeline());
+    pipeline->config = config;
+
+    // 每次重建：规则类组件构造开销小，直接按新配置生成
+    pipeline->redactor = std::make_shared<Redactor>(config.redact_config);
+    pipeline->levelFilter = std::make_shared<LevelFilter>(config);
+    if (!m_runtimeOverrides.empty()) {
+        pipeline->levelFilter->setOverrides(mergedOverrides(config));
+    }
+    if (!config.sampling_rules.empty()) {
+        pipeline->sampler = std::make_shared<Sampler>(config.sampling_rules);
+    }
+    pipeline->router = std::make_shared<SinkRouter>(config);
+
+    // 跨代共享：enricher 保持 mono_ms 基准；sink 原地重配
+    if (previous) {
+        pipeline->enricher = previous->enricher;
+        pipeline->sinkManager = previous->sinkManager;
+        pipeline->sinkManager->reconfigure(config, m_service);
+    } else {
+        pipeline->enricher = std::make_shared<Enricher>(m_service);
+        pipeline->sinkManager = std::make_shared<SinkManager>(config, m_service);
+    }
+
+    const FlightRecorderConfig& flight = config.flight_recorder_config;
+    const FlightRecorderConfig* prevFlight = previous ? &previous->config.flight_recorder_config : nullptr;
+    if (prevFlight && previous->flightRecorder && flight.enabled &&
+        flight.dir == prevFlight->dir && flight.size_kb == prevFlight->size_kb) {
+        pipeline->flightRecorder = previous->flightRecorder;
+    } else if (flight.enabled) {
+        pipeline->flightRecorder = std::make_shared<FlightRecorder>(flight, m_service);
+        if (!pipeline->flightRecorder->isAvailable()) {
+            pipeline->flightRecorder.reset();
+        }
+    }
+    if (pipeline->flightRecorder && flight.dump_on_crash) {
+        EmergencyWriter::installFatalSignalHandlers();
+    }
+
+    const AsyncConfig& async = config.async_config;
+    const AsyncConfig* prevAsync = previous ? &previous->config.async_config : nullptr;
+    if (prevAsync && previous->dispatcher && async.enabled &&
+        async.queue_size == prevAsync->queue_size && async.flush_interval_ms == prevAsync->flush_interval_ms) {
+        pipeline->dispatcher = previous->dispatcher;
+    } else if (async.enabled) {
+        std::shared_ptr<SinkManager> sinkManager = pipeline->sinkManager;
+        auto writer = [sinkManager](const std::string& line, bool isError, uint32_t sinkMask) -> bool {
+            return sinkManager->write(line, isError, sinkMask);
+        };
+        pipeline->dispatcher = std::make_shared<AsyncDispatcher>(
+            async.queue_size,
+            async.flush_interval_ms,
+            std::move(writer)
+        );
+        pipeline->dispatcher->start();
+    }
+
+    return pipeline;
+}
+
+std::vector<LevelOverride> LoggerRegistry::mergedOverrides(const LogConfig& config) const {
+    std::vector<LevelOverride> merged = config.level_overrides;
+    for (const auto& item : m_runtimeOverrides) {
+        merged.push_back(item.second);
+    }
+    return merged;
+}
+
+uint64_t LoggerRegistry::addLevelOverride(const LevelOverride& override) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_owned) return 0;
+
+    uint64_t id = m_nextOverrideId++;
+    m_runtimeOverrides.emplace_back(id, override);
+    rebuildLocked();
+    return id;
+}
+
+bool LoggerRegistry::removeLevelOverride(uint64_t id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_runtimeOverrides.begin(); it != m_runtimeOverrides.end(); ++it) {
+        if (it->first == id) {
+            m_runtimeOverrides.erase(it);
+            if (m_owned) {
+                rebuildLocked();
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+std::unique_ptr<Pipeline> LoggerRegistry::publish(std::unique_ptr<Pipeline> next) {
+    m_pipeline.store(next.get());
+    std::unique_ptr<Pipeline> old = std::move(m_owned);
+    m_owned = std::move(next);
+    synchronize();
+    return old;
+}
+
+// 覆盖变化时整体换代而不是原地修改过滤器：热路径读到的过滤器发布后不再变化
+void LoggerRegistry::rebuildLocked() {
+    std::unique_ptr<Pipeline> next = buildPipeline(m_owned->config, m_owned.get());
+    const Pipeline* published = next.get();
+    std::unique_ptr<Pipeline> old = publish(std::move(next));
+    retire(std::move(old), published);
+}
+
+void LoggerRegistry::synchronize() {
+    // 翻转纪元后，登记成功（登记后纪元未变）的新读者只会在新计数器上并读到新指针；
+    // 旧计数器归零即说明再没有线程持有旧 Pipeline
+    uint32_t previous = m_epoch.fetch_add(1) & 1;
+    while (m_readers[previous].count.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+}
+
+void LoggerRegistry::retire(std::unique_ptr<Pipeline> old, const Pipeline* next) {
+    if (!old) return;
+
+    // 不再被新一代复用的异步队列：停止并排空到 sink，保证不丢记录
+    if (old->dispatcher && (!next || old->dispatcher != next->dispatcher)) {
+        old->dispatcher->stop();
+    }
+    old->sinkManager->flush();
+}
+
+Logger LoggerRegistry::getLogger(const std::string& module) {
+    ModuleId id = ModuleTable::instance().intern(module);
+    Logger logger;
+
+    {
+        std::shared_lock<std::shared_mutex> lock(m_loggersMutex);
+        if (id < m_loggers.size() && m_loggers[id]) {
+            logger.m_impl = m_loggers[id];
+            return logger;
+        }
+    }
+
+    // 溢出模块不缓存：共用的槽位只能保存一个名字
+    if (id == ModuleTable::kOverflowId && module != ModuleTable::instance().name(id)) {
+        logger.m_impl = std::make_shared<Logger::Impl>(module, *this);
+        return logger;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_loggersMutex);
+    if (id >= m_loggers.size()) {
+        m_loggers.resize(static_cast<size_t>(id) + 1);
+    }
+    if (!m_loggers[id]) {
+        m_loggers[id] = std::make_shared<Logger::Impl>(id, *this);
+    }
+    logger.m_impl = m_loggers[id];
+    return logger;
+}
+
+void LoggerRegistry::shutdown() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_pipeline.load(std::memory_order_relaxed)) return;
+
+    retire(publish(nullptr), nullptr);
+}
+
 // ============================================================
 // Logger 公共 API 实现
 // ============================================================
@@ -175,6 +784,18 @@ InitResult Logger::init(const std::string& service, const LogConfig& config) {
     return LoggerRegistry::instance().init(service, config);
 }
 
+InitResult Logger::reload(const LogConfig& config) {
+    return LoggerRegistry::instance().reload(config);
+}
+
+uint64_t Logger::addLevelOverride(const LevelOverride& override) {
+    return LoggerRegistry::instance().addLevelOverride(override);
+}
+
+bool Logger::removeLevelOverride(uint64_t id) {
+    return LoggerRegistry::instance().removeLevelOverride(id);
+}
+
 Logger Logger::get(const std::string& module) {
     return LoggerRegistry::instance().getLogger(module);
 }
@@ -213,6 +834,15 @@ void Logger::fatal(std::string_view event, std::string_view message,
     std::abort();
 }
 
+void Logger::emitPacked(const CatalogSite& site, const CatalogArgs& args) {
+    m_impl->emit(site, args);
+}
+
+void Logger::logPacked(LogLevel level, std::string_view event, std::string_view format,
+                       ArgPacker pack, const void* source) {
+    m_impl->logFormatted(level, event, format, pack, source);
+}
+
 void Logger::flush() {
     if (m_impl) m_impl->flush();
 }
@@ -0,0 +1,79 @@
+#include "log_message_formatter.h"
+#include "log_catalog_registry.h"
+#include "log_json_formatter.h"
+#include <cstdio>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+namespace {
+
+void appendValue(std::string& out, const FieldValue& value) {
+    switch (value.type) {
+        case FieldValueType::kInt64:
+            out += std::to_string(value.intVal);
+            break;
+        case FieldValueType::kUint64:
+            out += std::to_string(value.uintVal);
+            break;
+        case FieldValueType::kDouble: {
+            char buf[64];
+            snprintf(buf, sizeof(buf), "%g", value.doubleVal);
+            out += buf;
+            break;
+        }
+        case FieldValueType::kBool:
+            out += value.boolVal ? "true" : "false";
+            break;
+        default:
+            out.append(value.stringView().data(), value.stringView().size());
+            break;
+    }
+}
+
+} // namespace
+
+std::string MessageFormatter::format(std::string_view format, const CatalogArgs& args) {
+    std::vector<FieldValue> values;
+    values.reserve(args.count());
+    catalog_wire::decodeArgs(args.data(), args.size(), values);
+
+    std::string out;
+    out.reserve(format.size() + values.size() * 8);
+    size_t next = 0;
+    for (size_t i = 0; i < format.size(); ++i) {
+        char c = format[i];
+        if (c == '{' && i + 1 < format.size() && format[i + 1] == '{') {
+            out += '{';
+            ++i;
+        } else if (c == '}' && i + 1 < format.size() && format[i + 1] == '}') {
+            out += '}';
+            ++i;
+        } else if (c == '{') {
+            size_t close = format.find('}', i);
+            if (close == std::string_view::npos) {
+                out.append(format.data() + i, format.size() - i);
+                break;
+            }
+            if (next < values.size()) {
+                appendValue(out, values[next++]);
+            } else {
+                out.append(format.data() + i, close - i + 1);     // 缺少参数：占位符原样保留
+            }
+            i = close;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string DeferredRecord::render() {
+    fields[messageIndex].value = FieldValue::makeString(MessageFormatter::format(format, args));
+    return JsonLineFormatter::format(fields);
+}
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
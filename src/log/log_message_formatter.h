@@ -0,0 +1,38 @@
+#pragma once
+
+#include "log_types.h"
+#include "log_catalog.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// ============================================================
+// MessageFormatter — 按 {} 占位符展开消息模板
+// ============================================================
+class MessageFormatter {
+public:
+    static std::string format(std::string_view format, const CatalogArgs& args);
+};
+
+// ============================================================
+// DeferredRecord — 消息尚未展开的记录
+//
+// 调用线程完成过滤、enrich 与脱敏后入队，dispatcher 线程展开消息
+// 并格式化为 JSON 行。fields 全部为自有存储，不借用调用方内存。
+// ============================================================
+struct DeferredRecord {
+    std::vector<Field> fields;
+    size_t messageIndex;            // fields 中 message 字段的位置
+    std::string_view format;        // 字面量，静态生命周期
+    CatalogArgs args;
+
+    std::string render();
+};
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
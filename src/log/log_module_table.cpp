@@ -0,0 +1,77 @@
+#include "log_module_table.h"
+#include "log_emergency_writer.h"
+#include <mutex>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+ModuleTable& ModuleTable::instance() {
+    static ModuleTable inst;
+    return inst;
+}
+
+ModuleTable::ModuleTable()
+    : m_names(new std::atomic<const std::string*>[kMaxModules])
+{
+    for (size_t i = 0; i < kMaxModules; ++i) {
+        m_names[i].store(nullptr, std::memory_order_relaxed);
+    }
+    m_storage.emplace_back("_overflow");
+    m_ids.emplace(m_storage.back(), kOverflowId);
+    m_names[kOverflowId].store(&m_storage.back(), std::memory_order_release);
+    m_size.store(1, std::memory_order_release);
+}
+
+ModuleId ModuleTable::intern(std::string_view name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        auto it = m_ids.find(name);
+        if (it != m_ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_ids.find(name);
+    if (it != m_ids.end()) {
+        return it->second;
+    }
+
+    size_t next = m_size.load(std::memory_order_relaxed);
+    if (next >= kMaxModules) {
+        if (!m_overflowReported) {
+            m_overflowReported = true;
+            EmergencyWriter::write("[log] module table full (" + std::to_string(kMaxModules) +
+                                   " modules), module '" + std::string(name) +
+                                   "' and later new modules share the overflow id\n");
+        }
+        return kOverflowId;
+    }
+
+    m_storage.emplace_back(name);
+    ModuleId id = static_cast<ModuleId>(next);
+    m_ids.emplace(m_storage.back(), id);
+    m_names[id].store(&m_storage.back(), std::memory_order_release);
+    m_size.store(next + 1, std::memory_order_release);
+    return id;
+}
+
+const std::string& ModuleTable::name(ModuleId id) const {
+    const std::string* ptr = nullptr;
+    if (id < kMaxModules) {
+        ptr = m_names[id].load(std::memory_order_acquire);
+    }
+    if (!ptr) {
+        ptr = m_names[kOverflowId].load(std::memory_order_acquire);
+    }
+    return *ptr;
+}
+
+size_t ModuleTable::size() const {
+    return m_size.load(std::memory_order_acquire);
+}
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
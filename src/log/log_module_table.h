@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <deque>
+#include <shared_mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// 模块 ID：进程内唯一的小整数，替代过滤/编码路径上的模块字符串
+using ModuleId = uint16_t;
+
+// ============================================================
+// ModuleTable — 模块名驻留表
+//
+// intern() 在首次遇到模块名时分配 ID，之后只做一次无分配的哈希查找；
+// name() 无锁，返回的引用在进程生命周期内有效。
+// ============================================================
+class ModuleTable {
+public:
+    static constexpr size_t kMaxModules = 1024;
+    // 表满后新模块统一归入该 ID；首次溢出经紧急输出报告一次
+    static constexpr ModuleId kOverflowId = 0;
+
+    static ModuleTable& instance();
+
+    ModuleId intern(std::string_view name);
+    const std::string& name(ModuleId id) const;
+    size_t size() const;
+
+private:
+    ModuleTable();
+
+    mutable std::shared_mutex m_mutex;
+    std::deque<std::string> m_storage;                     // 名字存储，地址稳定
+    std::unordered_map<std::string_view, ModuleId> m_ids;  // 键指向 m_storage
+    std::unique_ptr<std::atomic<const std::string*>[]> m_names;
+    std::atomic<size_t> m_size{0};
+    bool m_overflowReported = false;                       // 受 m_mutex 保护
+};
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
@@ -0,0 +1,314 @@
+#include "log_reader.h"
+#include "log_segment_index.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+namespace {
+
+std::vector<std::pair<uint32_t, std::string>> listSegments(const std::string& logDir,
+                                                           const std::string& service) {
+    std::vector<std::pair<uint32_t, std::string>> segments;
+    DIR* d = opendir(logDir.c_str());
+    if (!d) return segments;
+
+    uint32_t index = 0;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr) {
+        std::string name = entry->d_name;
+        if (SegmentIndex::parseSegmentName(name, service, index)) {
+            segments.emplace_back(index, logDir + "/" + name);
+        }
+    }
+    closedir(d);
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+// 只看级别名首字母：TRACE / DEBUG / INFO / WARN / ERROR / FATAL
+LogLevel levelOf(std::string_view name) {
+    switch (name.empty() ? '\0' : name[0]) {
+        case 'T': return LogLevel::kTrace;
+        case 'D': return LogLevel::kDebug;
+        case 'W': return LogLevel::kWarn;
+        case 'E': return LogLevel::kError;
+        case 'F': return LogLevel::kFatal;
+        default:  return LogLevel::kInfo;
+    }
+}
+
+} // namespace
+
+// ============================================================
+// LogReader::Impl
+// ============================================================
+class LogReader::Impl {
+public:
+    std::string logDir;
+    std::string service;
+    LogReadFilter filter;
+    LogReaderOptions options;
+    bool timeFiltered = false;
+
+    int inotifyFd = -1;
+    int wakeFd = -1;
+
+    bool positioned = false;
+    uint32_t segment = 0;
+    uint64_t offset = 0;
+
+    std::vector<std::string_view> batch;
+
+    ~Impl() {
+        if (inotifyFd >= 0) ::close(inotifyFd);
+        if (wakeFd >= 0) ::close(wakeFd);
+    }
+
+    bool matches(std::string_view line) const {
+        std::string_view value;
+        if (filter.min_level > LogLevel::kTrace) {
+            if (!SegmentIndex::extractString(line, "level", value)) return false;
+            if (levelOf(value) < filter.min_level) return false;
+        }
+        if (!filter.modules.empty()) {
+            if (!SegmentIndex::extractString(line, "module", value)) return false;
+            if (std::find(filter.modules.begin(), filter.modules.end(), value) == filter.modules.end()) {
+                return false;
+            }
+        }
+        if (timeFiltered) {
+            if (!SegmentIndex::extractString(line, "timestamp", value)) return false;
+            int64_t ts = SegmentIndex::parseTimestampMs(value);
+            if (ts < filter.from_ms || ts > filter.to_ms) return false;
+        }
+        return true;
+    }
+
+    bool deliver(const BatchCallback& callback) {
+        if (batch.empty()) return true;
+        bool more = callback(batch);
+        batch.clear();
+        return more;
+    }
+
+    // 首次读取时确定起点：最旧段开头，或活动段末尾
+    bool position() {
+        auto segments = listSegments(logDir, service);
+        if (segments.empty()) return false;
+        if (options.start_at_end) {
+            segment = segments.back().first;
+            struct stat st;
+            offset = stat(segments.back().second.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+        } else {
+            segment = segments.front().first;
+            offset = 0;
+        }
+        positioned = true;
+        return true;
+    }
+
+    // 读取当前段从 offset 起的全部完整行；按窗口映射，窗口结束前交付批次
+    LogErrorInfo drainSegment(const std::string& path, const BatchCallback& callback, bool& stop) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            // 读取期间被预算淘汰：由调用方跳到下一个段
+            if (errno == ENOENT) return {LogError::kOk, "", ""};
+            return {LogError::kSearchFailed, "Cannot open log segment", path};
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return {LogError::kSearchFailed, "Cannot stat log segment", path};
+        }
+        uint64_t fileSize = static_cast<uint64_t>(st.st_size);
+        if (fileSize < offset) offset = 0;      // 同名段被重建
+
+        static const uint64_t kPageMask = static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) - 1;
+        size_t window = std::max<size_t>(options.map_window_bytes, 4096);
+
+        while (offset < fileSize && !stop) {
+            uint64_t aligned = offset & ~kPageMask;
+            size_t length = static_cast<size_t>(std::min<uint64_t>(fileSize - aligned, window));
+            void* base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(aligned));
+            if (base == MAP_FAILED) {
+                ::close(fd);
+                return {LogError::kSearchFailed, "Cannot map log segment", path};
+            }
+
+            const char* data = static_cast<const char*>(base) + (offset - aligned);
+            size_t available = length - static_cast<size_t>(offset - aligned);
+            size_t pos = 0;
+            while (pos < available && !stop) {
+                const char* nl = static_cast<const char*>(std::memchr(data + pos, '\n', available - pos));
+                if (!nl) break;
+                std::string_view line(data + pos, static_cast<size_t>(nl - data) - pos);
+                pos = static_cast<size_t>(nl - data) + 1;
+                if (!line.empty() && matches(line)) {
+                    batch.push_back(line);
+                    if (batch.size() >= options.batch_lines && !deliver(callback)) {
+                        stop = true;
+                    }
+                }
+            }
+            // 行视图借用映射，解除映射前必须交付
+            if (!stop && !deliver(callback)) stop = true;
+            batch.clear();
+            munmap(base, length);
+
+            offset += pos;
+            if (pos == 0) {
+                if (aligned + length >= fileSize) break;    // 末尾是写到一半的行
+                window *= 2;                                // 超长行：放大窗口重试
+            }
+        }
+        ::close(fd);
+        return {LogError::kOk, "", ""};
+    }
+
+    LogErrorInfo drain(const BatchCallback& callback, bool& stop) {
+        if (!positioned && !position()) return {LogError::kOk, "", ""};
+
+        while (!stop) {
+            auto segments = listSegments(logDir, service);
+            const std::string* currentPath = nullptr;
+            const std::pair<uint32_t, std::string>* next = nullptr;
+            for (const auto& item : segments) {
+                if (item.first == segment) currentPath = &item.second;
+                if (item.first > segment) {
+                    next = &item;
+                    break;
+                }
+            }
+
+            if (currentPath) {
+                LogErrorInfo error = drainSegment(*currentPath, callback, stop);
+                if (error.code != LogError::kOk || stop) return error;
+            }
+
+            if (next) {
+                // 已出现更新的段：当前段已封存且读完，切到下一段
+                segment = next->first;
+                offset = 0;
+            } else if (!currentPath && !segments.empty()) {
+                // 目录被清空后从头编号：回到现存最旧段
+                segment = segments.front().first;
+                offset = 0;
+            } else {
+                break;
+            }
+        }
+        return {LogError::kOk, "", ""};
+    }
+
+    // 读走全部 inotify 事件，只关心“有变化”
+    void consumeEvents() {
+        alignas(struct inotify_event) char buffer[4096];
+        while (::read(inotifyFd, buffer, sizeof(buffer)) > 0) {
+        }
+    }
+};
+
+// ============================================================
+// LogReader
+// ============================================================
+LogReader::LogReader() : m_impl(new Impl()) {}
+
+LogReader::~LogReader() = default;
+
+LogErrorInfo LogReader::open(const std::string& logDir, const std::string& service,
+                             const LogReadFilter& filter, const LogReaderOptions& options) {
+    m_impl.reset(new Impl());
+    m_impl->logDir = logDir;
+    m_impl->service = service;
+    m_impl->filter = filter;
+    m_impl->options = options;
+    if (m_impl->options.batch_lines == 0) m_impl->options.batch_lines = 1;
+    m_impl->timeFiltered = filter.from_ms > 0 || filter.to_ms != INT64_MAX;
+    m_impl->batch.reserve(m_impl->options.batch_lines);
+
+    m_impl->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_impl->inotifyFd < 0) {
+        return {LogError::kSearchFailed, "inotify_init1 failed: " + std::string(strerror(errno)), logDir};
+    }
+    // 监视目录：同时覆盖活动段追加与新段创建
+    if (inotify_add_watch(m_impl->inotifyFd, logDir.c_str(), IN_MODIFY | IN_CREATE | IN_MOVED_TO) < 0) {
+        return {LogError::kSearchFailed, "Cannot watch log directory", logDir};
+    }
+    m_impl->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_impl->wakeFd < 0) {
+        return {LogError::kSearchFailed, "eventfd failed: " + std::string(strerror(errno)), logDir};
+    }
+    return {LogError::kOk, "", ""};
+}
+
+LogErrorInfo LogReader::readAvailable(const BatchCallback& callback) {
+    if (m_impl->inotifyFd < 0) {
+        return {LogError::kSearchFailed, "LogReader is not open", ""};
+    }
+    bool stop = false;
+    return m_impl->drain(callback, stop);
+}
+
+LogErrorInfo LogReader::follow(const BatchCallback& callback, int timeoutMs) {
+    if (m_impl->inotifyFd < 0) {
+        return {LogError::kSearchFailed, "LogReader is not open", ""};
+    }
+
+    for (;;) {
+        // 先清掉积压事件再读取，读取期间的新写入会留下事件，不会漏读
+        m_impl->consumeEvents();
+        bool stop = false;
+        LogErrorInfo error = m_impl->drain(callback, stop);
+        if (error.code != LogError::kOk || stop) return error;
+
+        struct pollfd fds[2];
+        fds[0].fd = m_impl->inotifyFd;
+        fds[0].events = POLLIN;
+        fds[1].fd = m_impl->wakeFd;
+        fds[1].events = POLLIN;
+        int ret = ::poll(fds, 2, timeoutMs);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            return {LogError::kSearchFailed, "poll failed: " + std::string(strerror(errno)), m_impl->logDir};
+        }
+        if (ret == 0) return {LogError::kOk, "", ""};
+        if (fds[1].revents & POLLIN) {
+            uint64_t value;
+            while (::read(m_impl->wakeFd, &value, sizeof(value)) > 0) {
+            }
+            return {LogError::kOk, "", ""};
+        }
+    }
+}
+
+void LogReader::stop() {
+    if (m_impl->wakeFd < 0) return;
+    uint64_t one = 1;
+    ssize_t ret = ::write(m_impl->wakeFd, &one, sizeof(one));
+    (void)ret;
+}
+
+uint32_t LogReader::currentSegment() const {
+    return m_impl->segment;
+}
+
+uint64_t LogReader::currentOffset() const {
+    return m_impl->offset;
+}
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
@@ -1,4 +1,5 @@
 #include "log_redactor.h"
+#include "log_json_formatter.h"
 #include <algorithm>
 #include <cctype>
 
@@ -25,34 +26,33 @@ std::vector<Field> Redactor::redact(std::vector<Field> fields) const {
 
         if (effectiveSensitivity == Sensitivity::Secret) {
             result.push_back({
-                field.key + "_redacted",
-                FieldValue::makeString("[REDACTED:secret]")
+                std::string(field.key) + "_redacted",
+                FieldValue::makeStringView("[REDACTED:secret]")
             });
             continue;
         }
 
-        if (field.value.type == FieldValueType::kString) {
+        if (field.value.type == FieldValueType::kBytes) {
+            // 字节字段不论敏感级别都按 raw_payload_max_bytes 截断；
+            // 标识符再对保留部分的十六进制 / base64 文本执行标识符策略
+            limitPayload(field);
+            if (effectiveSensitivity == Sensitivity::Identifier) {
+                std::string_view bytes = field.value.stringView();
+                std::string rendered = field.value.isBase64() ? JsonLineFormatter::base64Encode(bytes)
+                                                              : JsonLineFormatter::hexEncode(bytes);
+                redactIdentifier(field, rendered, result);
+            } else {
+                result.push_back(std::move(field));
+            }
+        } else if (field.value.type == FieldValueType::kString) {
             switch (effectiveSensitivity) {
                 case Sensitivity::Identifier: {
-                    if (m_config.identifiers == "mask") {
-                        Field masked = field;
-                        masked.value = FieldValue::makeString(maskValue(field.value.stringVal));
-                        result.push_back(std::move(masked));
-                    } else if (m_config.identifiers == "reject") {
-                        result.push_back({
-                            field.key + "_redacted",
-                            FieldValue::makeString("[REDACTED:identifier]")
-                        });
-                    } else {
-                        Field hashed = field;
-                        hashed.value = FieldValue::makeString(hashValue(field.value.stringVal));
-                        result.push_back(std::move(hashed));
-                    }
+                    redactIdentifier(field, field.value.stringView(), result);
                     break;
                 }
                 case Sensitivity::Payload: {
                     Field truncated = field;
-                    truncated.value = FieldValue::makeString(truncatePayload(field.value.stringVal));
+                    truncated.value = FieldValue::makeString(truncatePayload(field.value.stringView()));
                     result.push_back(std::move(truncated));
                     break;
                 }
@@ -68,30 +68,59 @@ std::vector<Field> Redactor::redact(std::vector<Field> fields) const {
     return result;
 }
 
-bool Redactor::isSecretKey(const std::string& key) const {
-    std::string lower;
-    lower.reserve(key.size());
-    for (char c : key) {
-        lower.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+// value 为标识符的文本形式（字符串原文或字节的编码结果），调用方保证其在调用期间有效
+void Redactor::redactIdentifier(const Field& field, std::string_view value, std::vector<Field>& out) const {
+    if (m_config.identifiers == "reject") {
+        out.push_back({
+            std::string(field.key) + "_redacted",
+            FieldValue::makeStringView("[REDACTED:identifier]")
+        });
+        return;
+    }
+    Field redacted = field;
+    redacted.value = FieldValue::makeString(m_config.identifiers == "mask" ? maskValue(value)
+                                                                           : hashValue(value));
+    out.push_back(std::move(redacted));
+}
+
+void Redactor::limitPayload(Field& field) const {
+    if (field.value.type != FieldValueType::kBytes) return;
+    field.value.truncateBytes(m_config.raw_payload_max_bytes);
+    field.value.setBase64(m_config.payload_encoding == "base64");
+}
+
+bool Redactor::isSecretKey(std::string_view key) {
+    // 比最长敏感 key 还长的不可能命中，避免逐字段分配
+    char lower[kMaxSecretKeyLength];
+    if (key.size() > sizeof(lower)) {
+        return false;
+    }
+    for (size_t i = 0; i < key.size(); ++i) {
+        lower[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(key[i])));
     }
-    return s_secretKeys.count(lower) > 0;
+    return s_secretKeys.count(std::string(lower, key.size())) > 0;
 }
 
-std::string Redactor::maskValue(const std::string& value) const {
+std::string Redactor::maskValue(std::string_view value) const {
     if (value.size() <= 4) {
         return "****";
     }
-    return value.substr(0, 2) + "****" + value.substr(value.size() - 2);
+    std::string masked(value.substr(0, 2));
+    masked += "****";
+    masked.append(value.substr(value.size() - 2));
+    return masked;
 }
 
-std::string Redactor::truncatePayload(const std::string& value) const {
+std::string Redactor::truncatePayload(std::string_view value) const {
     if (value.size() <= m_config.raw_payload_max_bytes) {
-        return value;
+        return std::string(value);
     }
-    return value.substr(0, m_config.raw_payload_max_bytes) + "...[truncated]";
+    std::string truncated(value.substr(0, m_config.raw_payload_max_bytes));
+    truncated += "...[truncated]";
+    return truncated;
 }
 
-std::string Redactor::hashValue(const std::string& value) const {
+std::string Redactor::hashValue(std::string_view value) const {
     return "[hash:" + std::to_string(value.size()) + "]";
 }
 
@@ -3,6 +3,7 @@
 #include "log_types.h"
 #include <vector>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 
 namespace tbox {
@@ -16,14 +17,22 @@ public:
     // 对字段列表执行脱敏
     std::vector<Field> redact(std::vector<Field> fields) const;
 
+    // 字节字段（不论敏感级别）按 raw_payload_max_bytes 截断并设置编码；只改长度，不拷贝
+    void limitPayload(Field& field) const;
+
+    // key 是否属于密钥类（大小写不敏感），命中即按 Secret 处理
+    static bool isSecretKey(std::string_view key);
+
 private:
     RedactConfig m_config;
     static const std::unordered_set<std::string> s_secretKeys;
+    static constexpr size_t kMaxSecretKeyLength = 12;   // s_secretKeys 中最长 key 的长度
 
-    bool isSecretKey(const std::string& key) const;
-    std::string maskValue(const std::string& value) const;
-    std::string truncatePayload(const std::string& value) const;
-    std::string hashValue(const std::string& value) const;
+    // 按 identifiers 策略（mask / hash / reject）处理标识符字段
+    void redactIdentifier(const Field& field, std::string_view value, std::vector<Field>& out) const;
+    std::string maskValue(std::string_view value) const;
+    std::string truncatePayload(std::string_view value) const;
+    std::string hashValue(std::string_view value) const;
 };
 
 } // namespace log
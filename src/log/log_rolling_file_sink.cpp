@@ -25,6 +25,7 @@ RollingFileSink::~RollingFileSink() {
         fclose(m_file);
         m_file = nullptr;
     }
+    saveIndex();
 }
 
 bool RollingFileSink::write(const std::string& line) {
@@ -39,15 +40,20 @@ bool RollingFileSink::write(const std::string& line) {
         return false;
     }
 
+    if (m_config.index) {
+        m_index.addLine(line, m_currentSize);
+    }
     m_currentSize += written;
     rotateIfNeeded();
     return true;
 }
 
 void RollingFileSink::flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
     if (m_file) {
         fflush(m_file);
     }
+    saveIndex();
 }
 
 bool RollingFileSink::isAvailable() const {
@@ -60,14 +66,16 @@ int RollingFileSink::cleanup() {
     if (!d) return 0;
 
     int removed = 0;
+    uint32_t index = 0;
     struct dirent* entry;
     while ((entry = readdir(d)) != nullptr) {
         std::string name = entry->d_name;
-        if (name.find(m_serviceName + "_") == 0 && name.find(".log") != std::string::npos) {
+        if (SegmentIndex::parseSegmentName(name, m_serviceName, index)) {
             std::string path = dir + "/" + name;
             if (remove(path.c_str()) == 0) {
                 ++removed;
             }
+            remove(SegmentIndex::indexPathFor(path).c_str());
         }
     }
     closedir(d);
@@ -93,6 +101,15 @@ bool RollingFileSink::openNewFile() {
         m_currentSize = 0;
     }
 
+    // 续写已有段：旁路索引与段长度一致则直接复用，否则重新扫描
+    m_index.reset();
+    if (m_config.index && m_currentSize > 0) {
+        std::string indexPath = SegmentIndex::indexPathFor(m_currentPath);
+        if (!m_index.load(indexPath) || m_index.coveredBytes() != m_currentSize) {
+            m_index.build(m_currentPath);
+        }
+    }
+
     return true;
 }
 
@@ -105,6 +122,10 @@ void RollingFileSink::rotateIfNeeded() {
         removeOldestFile();
     }
 
+    // 段关闭前落盘内容与索引，保证索引偏移指向已写出的数据
+    fflush(m_file);
+    saveIndex();
+
     ++m_currentIndex;
     openNewFile();
 }
@@ -123,26 +144,20 @@ void RollingFileSink::removeOldestFile() {
     uint32_t minIndex = UINT32_MAX;
     std::string oldestFile;
 
+    uint32_t idx = 0;
     struct dirent* entry;
     while ((entry = readdir(d)) != nullptr) {
         std::string name = entry->d_name;
-        if (name.find(m_serviceName + "_") == 0 && name.find(".log") != std::string::npos) {
-            size_t start = m_serviceName.size() + 1;
-            size_t end = name.find(".log");
-            if (end != std::string::npos) {
-                std::string indexStr = name.substr(start, end - start);
-                uint32_t idx = static_cast<uint32_t>(std::stoul(indexStr));
-                if (idx < minIndex) {
-                    minIndex = idx;
-                    oldestFile = dir + "/" + name;
-                }
-            }
+        if (SegmentIndex::parseSegmentName(name, m_serviceName, idx) && idx < minIndex) {
+            minIndex = idx;
+            oldestFile = dir + "/" + name;
         }
     }
     closedir(d);
 
     if (!oldestFile.empty()) {
         remove(oldestFile.c_str());
+        remove(SegmentIndex::indexPathFor(oldestFile).c_str());
     }
 }
 
@@ -152,10 +167,11 @@ uint32_t RollingFileSink::countFiles() const {
     if (!d) return 0;
 
     uint32_t count = 0;
+    uint32_t index = 0;
     struct dirent* entry;
     while ((entry = readdir(d)) != nullptr) {
         std::string name = entry->d_name;
-        if (name.find(m_serviceName + "_") == 0 && name.find(".log") != std::string::npos) {
+        if (SegmentIndex::parseSegmentName(name, m_serviceName, index)) {
             ++count;
         }
     }
@@ -163,6 +179,12 @@ uint32_t RollingFileSink::countFiles() const {
     return count;
 }
 
+void RollingFileSink::saveIndex() {
+    if (m_config.index && m_index.isDirty() && !m_currentPath.empty()) {
+        m_index.save(SegmentIndex::indexPathFor(m_currentPath));
+    }
+}
+
 } // namespace log
 } // namespace fw
 } // namespace tbox
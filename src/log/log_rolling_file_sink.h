@@ -1,6 +1,7 @@
 #pragma once
 
 #include "log_types.h"
+#include "log_segment_index.h"
 #include <string>
 #include <cstdio>
 #include <mutex>
@@ -29,6 +30,9 @@ private:
     uint32_t m_currentIndex = 0;
     mutable std::mutex m_mutex;
     bool m_available = false;
+    SegmentIndex m_index;       // 当前段的稀疏索引（file.index 开启时维护）
+
+    void saveIndex();
 
     bool openNewFile();
     void rotateIfNeeded();
@@ -0,0 +1,81 @@
+#include "log_sampler.h"
+#include <cmath>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+namespace {
+
+// FNV-1a 64 + fmix64 收尾：相邻 trace_id 的高位也能充分打散
+uint64_t hashTraceId(std::string_view data) {
+    uint64_t h = 1469598103934665603ULL;
+    for (char c : data) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 1099511628211ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace
+
+Sampler::Sampler(const std::vector<SamplingRule>& rules)
+    : m_rules(new RuleList*[ModuleTable::kMaxModules]())
+{
+    for (const auto& rule : rules) {
+        ModuleId id = ModuleTable::instance().intern(rule.module);
+        if (!m_rules[id]) {
+            m_lists.emplace_back(new RuleList());
+            m_rules[id] = m_lists.back().get();
+        }
+
+        std::unique_ptr<CompiledRule> compiled(new CompiledRule());
+        compiled->event = rule.event;
+        compiled->maxLevel = static_cast<uint8_t>(rule.max_level);
+        compiled->everyN = rule.every_n;
+        compiled->traceThreshold = 0;
+        if (rule.every_n == 0) {
+            compiled->traceThreshold = ratioToThreshold(rule.trace_ratio);
+            // 无 trace 上下文时的退化步长
+            double step = rule.trace_ratio > 0.0 ? std::round(1.0 / rule.trace_ratio) : 0.0;
+            compiled->everyN = step >= 1.0 ? static_cast<uint32_t>(step) : 1;
+        }
+        m_rules[id]->push_back(std::move(compiled));
+    }
+}
+
+Sampler::~Sampler() = default;
+
+bool Sampler::evaluate(const RuleList& rules, LogLevel level, std::string_view event,
+                       const LogContext* context) {
+    for (const auto& rule : rules) {
+        if (static_cast<uint8_t>(level) > rule->maxLevel) continue;
+        if (!rule->event.empty() && rule->event != event) continue;
+
+        if (rule->traceThreshold > 0 && context && !context->trace_id.empty()) {
+            return (hashTraceId(context->trace_id) >> 32) < rule->traceThreshold;
+        }
+        uint64_t n = rule->counter.fetch_add(1, std::memory_order_relaxed);
+        return n % rule->everyN == 0;
+    }
+    return true;
+}
+
+bool Sampler::traceSelected(std::string_view traceId, double ratio) {
+    return (hashTraceId(traceId) >> 32) < ratioToThreshold(ratio);
+}
+
+uint64_t Sampler::ratioToThreshold(double ratio) {
+    if (ratio <= 0.0) return 0;
+    if (ratio >= 1.0) return 1ULL << 32;
+    return static_cast<uint64_t>(ratio * 4294967296.0);
+}
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
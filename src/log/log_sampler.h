@@ -0,0 +1,61 @@
+#pragma once
+
+#include "log_types.h"
+#include "log_module_table.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// ============================================================
+// Sampler — 按模块/事件的采样
+//
+// 规则在构造时按 ModuleId 编译成指针表；没有规则的模块只需一次
+// 取表和判空即可放行，被采样丢弃的记录不会进入 enrich/format。
+// ============================================================
+class Sampler {
+public:
+    explicit Sampler(const std::vector<SamplingRule>& rules);
+    ~Sampler();
+
+    Sampler(const Sampler&) = delete;
+    Sampler& operator=(const Sampler&) = delete;
+
+    // 热路径：true 表示保留
+    bool shouldKeep(LogLevel level, ModuleId module, std::string_view event,
+                    const LogContext* context) const {
+        const RuleList* rules = m_rules[module];
+        if (!rules) return true;
+        return evaluate(*rules, level, event, context);
+    }
+
+    // trace_id 哈希是否落在保留区间（跨进程稳定，供测试与离线分析复现）
+    static bool traceSelected(std::string_view traceId, double ratio);
+
+private:
+    struct CompiledRule {
+        std::string event;
+        uint8_t maxLevel;
+        uint32_t everyN;
+        uint64_t traceThreshold;            // 哈希高 32 位小于该值则保留
+        mutable std::atomic<uint64_t> counter{0};
+    };
+    using RuleList = std::vector<std::unique_ptr<CompiledRule>>;
+
+    std::unique_ptr<RuleList*[]> m_rules;            // 按 ModuleId 索引，无规则为 nullptr
+    std::vector<std::unique_ptr<RuleList>> m_lists;
+
+    static bool evaluate(const RuleList& rules, LogLevel level, std::string_view event,
+                         const LogContext* context);
+    static uint64_t ratioToThreshold(double ratio);
+};
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
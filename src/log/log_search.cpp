@@ -0,0 +1,194 @@
+#include "log_search.h"
+#include "log_segment_index.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+namespace {
+
+using Range = std::pair<uint64_t, uint64_t>;
+
+std::vector<std::pair<uint32_t, std::string>> listSegments(const std::string& logDir,
+                                                           const std::string& service,
+                                                           bool& ok) {
+    std::vector<std::pair<uint32_t, std::string>> segments;
+    DIR* d = opendir(logDir.c_str());
+    ok = d != nullptr;
+    if (!d) return segments;
+
+    uint32_t index = 0;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr) {
+        std::string name = entry->d_name;
+        if (SegmentIndex::parseSegmentName(name, service, index)) {
+            segments.emplace_back(index, logDir + "/" + name);
+        }
+    }
+    closedir(d);
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+bool lineMatches(std::string_view line, const LogSearchQuery& query, bool timeFiltered) {
+    std::string_view value;
+    if (!query.trace_id.empty() &&
+        (!SegmentIndex::extractString(line, "trace_id", value) || value != query.trace_id)) {
+        return false;
+    }
+    if (!query.request_id.empty() &&
+        (!SegmentIndex::extractString(line, "request_id", value) || value != query.request_id)) {
+        return false;
+    }
+    if (timeFiltered) {
+        if (!SegmentIndex::extractString(line, "timestamp", value)) return false;
+        int64_t ts = SegmentIndex::parseTimestampMs(value);
+        if (ts < query.from_ms || ts > query.to_ms) return false;
+    }
+    return true;
+}
+
+// 根据索引计算需要扫描的字节区间；返回空表示整段可跳过
+std::vector<Range> planRanges(const SegmentIndex& index, uint64_t fileSize,
+                              const LogSearchQuery& query, bool timeFiltered) {
+    std::vector<Range> ranges;
+    uint64_t covered = std::min(index.coveredBytes(), fileSize);
+
+    bool keyMiss = (!query.trace_id.empty() && !index.mayContain("trace_id", query.trace_id)) ||
+                   (!query.request_id.empty() && !index.mayContain("request_id", query.request_id));
+    if (!keyMiss) {
+        const auto& buckets = index.buckets();
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            uint64_t begin = buckets[i].offset;
+            uint64_t end = (i + 1 < buckets.size()) ? buckets[i + 1].offset : covered;
+            if (begin >= end) continue;
+            bool hasTs = buckets[i].minTsMs <= buckets[i].maxTsMs;
+            if (timeFiltered && hasTs &&
+                (buckets[i].maxTsMs < query.from_ms || buckets[i].minTsMs > query.to_ms)) {
+                continue;
+            }
+            if (!ranges.empty() && ranges.back().second == begin) {
+                ranges.back().second = end;
+            } else {
+                ranges.emplace_back(begin, end);
+            }
+        }
+    }
+
+    // 索引之后追加的内容（活动段）
+    if (covered < fileSize) {
+        ranges.emplace_back(covered, fileSize);
+    }
+    return ranges;
+}
+
+} // namespace
+
+LogErrorInfo LogSearch::search(const std::string& logDir, const std::string& service,
+                               const LogSearchQuery& query, const Visitor& visitor,
+                               LogSearchStats* stats) {
+    LogSearchStats localStats;
+    LogSearchStats& st = stats ? *stats : localStats;
+    st = LogSearchStats();
+
+    bool ok = false;
+    auto segments = listSegments(logDir, service, ok);
+    if (!ok) {
+        return {LogError::kSearchFailed, "Cannot open log directory", logDir};
+    }
+
+    bool timeFiltered = query.from_ms > 0 || query.to_ms != INT64_MAX;
+
+    for (const auto& segment : segments) {
+        const std::string& path = segment.second;
+        ++st.segments_total;
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return {LogError::kSearchFailed, "Cannot open log segment", path};
+        }
+        struct stat sb;
+        if (fstat(fd, &sb) != 0) {
+            ::close(fd);
+            return {LogError::kSearchFailed, "Cannot stat log segment", path};
+        }
+        uint64_t fileSize = static_cast<uint64_t>(sb.st_size);
+
+        std::vector<Range> ranges;
+        SegmentIndex index;
+        if (index.load(SegmentIndex::indexPathFor(path)) && index.coveredBytes() <= fileSize) {
+            ranges = planRanges(index, fileSize, query, timeFiltered);
+        } else {
+            ++st.segments_unindexed;
+            if (fileSize > 0) ranges.emplace_back(0, fileSize);
+        }
+
+        if (ranges.empty()) {
+            ++st.segments_skipped;
+            ::close(fd);
+            continue;
+        }
+
+        void* base = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            return {LogError::kSearchFailed, "Cannot map log segment", path};
+        }
+
+        const char* data = static_cast<const char*>(base);
+        bool stop = false;
+        for (const Range& range : ranges) {
+            st.bytes_scanned += range.second - range.first;
+            size_t pos = range.first;
+            while (pos < range.second && !stop) {
+                const char* nl = static_cast<const char*>(std::memchr(data + pos, '\n', range.second - pos));
+                size_t end = nl ? static_cast<size_t>(nl - data) : range.second;
+                std::string_view line(data + pos, end - pos);
+                if (!line.empty() && lineMatches(line, query, timeFiltered)) {
+                    ++st.matched;
+                    if (!visitor(line) || (query.limit > 0 && st.matched >= query.limit)) {
+                        stop = true;
+                    }
+                }
+                pos = end + 1;
+            }
+            if (stop) break;
+        }
+        munmap(base, fileSize);
+        if (stop) break;
+    }
+
+    return {LogError::kOk, "", ""};
+}
+
+int LogSearch::reindex(const std::string& logDir, const std::string& service) {
+    bool ok = false;
+    auto segments = listSegments(logDir, service, ok);
+
+    int rebuilt = 0;
+    for (const auto& segment : segments) {
+        SegmentIndex index;
+        if (index.build(segment.second) &&
+            index.save(SegmentIndex::indexPathFor(segment.second))) {
+            ++rebuilt;
+        }
+    }
+    return rebuilt;
+}
+
+int64_t LogSearch::parseTimestamp(std::string_view iso) {
+    return SegmentIndex::parseTimestampMs(iso);
+}
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
@@ -0,0 +1,316 @@
+#include "log_segment_index.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <climits>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// ============================================================
+// 索引文件布局：FileHeader + bucketCount × Bucket + Bloom 位图
+// ============================================================
+namespace {
+
+const char kMagic[8] = {'T', 'B', 'O', 'X', 'I', 'D', 'X', '1'};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t bucketCount;
+    uint32_t bloomBits;
+    uint32_t bloomHashes;
+    uint64_t coveredBytes;
+    int64_t minTsMs;
+    int64_t maxTsMs;
+};
+
+const std::string_view kTimestampKey = "timestamp";
+const std::string_view kIndexedKeys[] = {"trace_id", "request_id"};
+
+bool writeAll(int fd, const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = ::write(fd, p, size);
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool readAll(int fd, void* data, size_t size) {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = ::read(fd, p, size);
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+int parseDigits(std::string_view s, size_t pos, size_t count) {
+    int value = 0;
+    for (size_t i = pos; i < pos + count; ++i) {
+        if (s[i] < '0' || s[i] > '9') return -1;
+        value = value * 10 + (s[i] - '0');
+    }
+    return value;
+}
+
+// 公历日期转 1970-01-01 起的天数
+int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+} // namespace
+
+SegmentIndex::SegmentIndex() {
+    reset();
+}
+
+void SegmentIndex::reset() {
+    m_buckets.clear();
+    m_bloom.assign(kBloomBits / 8, 0);
+    m_coveredBytes = 0;
+    m_minTsMs = INT64_MAX;
+    m_maxTsMs = INT64_MIN;
+    m_dirty = false;
+}
+
+void SegmentIndex::addLine(std::string_view line, uint64_t offset) {
+    if (m_buckets.empty() || offset - m_buckets.back().offset >= kBucketBytes) {
+        m_buckets.push_back({offset, INT64_MAX, INT64_MIN});
+    }
+
+    std::string_view value;
+    if (extractString(line, kTimestampKey, value)) {
+        int64_t ts = parseTimestampMs(value);
+        if (ts >= 0) {
+            Bucket& bucket = m_buckets.back();
+            if (ts < bucket.minTsMs) bucket.minTsMs = ts;
+            if (ts > bucket.maxTsMs) bucket.maxTsMs = ts;
+            if (ts < m_minTsMs) m_minTsMs = ts;
+            if (ts > m_maxTsMs) m_maxTsMs = ts;
+        }
+    }
+
+    for (std::string_view key : kIndexedKeys) {
+        if (extractString(line, key, value)) {
+            addToBloom(key, value);
+        }
+    }
+
+    m_coveredBytes = offset + line.size() + 1;
+    m_dirty = true;
+}
+
+bool SegmentIndex::save(const std::string& indexPath) {
+    std::string tmpPath = indexPath + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.bucketCount = static_cast<uint32_t>(m_buckets.size());
+    header.bloomBits = kBloomBits;
+    header.bloomHashes = kBloomHashes;
+    header.coveredBytes = m_coveredBytes;
+    header.minTsMs = m_minTsMs;
+    header.maxTsMs = m_maxTsMs;
+
+    bool ok = writeAll(fd, &header, sizeof(header)) &&
+              writeAll(fd, m_buckets.data(), m_buckets.size() * sizeof(Bucket)) &&
+              writeAll(fd, m_bloom.data(), m_bloom.size());
+    ::close(fd);
+
+    if (!ok || ::rename(tmpPath.c_str(), indexPath.c_str()) != 0) {
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+    m_dirty = false;
+    return true;
+}
+
+bool SegmentIndex::load(const std::string& indexPath) {
+    int fd = ::open(indexPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    FileHeader header;
+    bool ok = readAll(fd, &header, sizeof(header)) &&
+              std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+              header.version == kVersion &&
+              header.bloomBits == kBloomBits &&
+              header.bloomHashes == kBloomHashes;
+
+    std::vector<Bucket> buckets;
+    std::vector<uint8_t> bloom;
+    if (ok) {
+        buckets.resize(header.bucketCount);
+        bloom.resize(kBloomBits / 8);
+        ok = readAll(fd, buckets.data(), buckets.size() * sizeof(Bucket)) &&
+             readAll(fd, bloom.data(), bloom.size());
+    }
+    ::close(fd);
+    if (!ok) return false;
+
+    m_buckets.swap(buckets);
+    m_bloom.swap(bloom);
+    m_coveredBytes = header.coveredBytes;
+    m_minTsMs = header.minTsMs;
+    m_maxTsMs = header.maxTsMs;
+    m_dirty = false;
+    return true;
+}
+
+bool SegmentIndex::build(const std::string& segmentPath) {
+    reset();
+
+    int fd = ::open(segmentPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size == 0) {
+        ::close(fd);
+        m_dirty = true;
+        return true;
+    }
+
+    void* base = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+
+    const char* data = static_cast<const char*>(base);
+    size_t pos = 0;
+    while (pos < size) {
+        const char* nl = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+        if (!nl) break;     // 末尾不完整的行留给下次追加
+        size_t end = static_cast<size_t>(nl - data);
+        addLine(std::string_view(data + pos, end - pos), pos);
+        pos = end + 1;
+    }
+    munmap(base, size);
+    m_dirty = true;
+    return true;
+}
+
+bool SegmentIndex::mayContain(std::string_view key, std::string_view value) const {
+    uint64_t h = hashKeyValue(key, value);
+    uint32_t h1 = static_cast<uint32_t>(h);
+    uint32_t h2 = static_cast<uint32_t>(h >> 32) | 1;
+    for (uint32_t i = 0; i < kBloomHashes; ++i) {
+        uint32_t bit = (h1 + i * h2) % kBloomBits;
+        if ((m_bloom[bit >> 3] & (1u << (bit & 7))) == 0) return false;
+    }
+    return true;
+}
+
+void SegmentIndex::addToBloom(std::string_view key, std::string_view value) {
+    uint64_t h = hashKeyValue(key, value);
+    uint32_t h1 = static_cast<uint32_t>(h);
+    uint32_t h2 = static_cast<uint32_t>(h >> 32) | 1;
+    for (uint32_t i = 0; i < kBloomHashes; ++i) {
+        uint32_t bit = (h1 + i * h2) % kBloomBits;
+        m_bloom[bit >> 3] |= static_cast<uint8_t>(1u << (bit & 7));
+    }
+}
+
+// FNV-1a 64，key 与 value 之间插入分隔符避免拼接歧义
+uint64_t SegmentIndex::hashKeyValue(std::string_view key, std::string_view value) {
+    uint64_t h = 1469598103934665603ULL;
+    for (char c : key) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 1099511628211ULL;
+    }
+    h ^= 0xFF;
+    h *= 1099511628211ULL;
+    for (char c : value) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+bool SegmentIndex::parseSegmentName(std::string_view name, std::string_view service, uint32_t& index,
+                                    std::string_view suffix) {
+    if (name.size() <= service.size() + 1 + suffix.size()) return false;
+    if (name.substr(0, service.size()) != service || name[service.size()] != '_') return false;
+    if (name.substr(name.size() - suffix.size()) != suffix) return false;
+
+    std::string_view digits = name.substr(service.size() + 1,
+                                          name.size() - service.size() - 1 - suffix.size());
+    if (digits.empty() || digits.size() > 9) return false;
+    uint32_t value = 0;
+    for (char c : digits) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + static_cast<uint32_t>(c - '0');
+    }
+    index = value;
+    return true;
+}
+
+int64_t SegmentIndex::parseTimestampMs(std::string_view iso) {
+    // 0123456789012345678901234
+    // 2024-01-02T03:04:05.678Z
+    if (iso.size() < 19 || iso[4] != '-' || iso[7] != '-' || iso[10] != 'T' ||
+        iso[13] != ':' || iso[16] != ':') {
+        return -1;
+    }
+    int year = parseDigits(iso, 0, 4);
+    int month = parseDigits(iso, 5, 2);
+    int day = parseDigits(iso, 8, 2);
+    int hour = parseDigits(iso, 11, 2);
+    int minute = parseDigits(iso, 14, 2);
+    int second = parseDigits(iso, 17, 2);
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60) {
+        return -1;
+    }
+    int millis = 0;
+    if (iso.size() >= 23 && iso[19] == '.') {
+        millis = parseDigits(iso, 20, 3);
+        if (millis < 0) return -1;
+    }
+
+    int64_t days = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    return ((days * 24 + hour) * 60 + minute) * 60000LL + second * 1000LL + millis;
+}
+
+bool SegmentIndex::extractString(std::string_view line, std::string_view key, std::string_view& value) {
+    // 匹配 "key":" ；字段值中的引号已被转义，不会误命中
+    size_t pos = 0;
+    while ((pos = line.find(key, pos)) != std::string_view::npos) {
+        size_t end = pos + key.size();
+        if (pos > 0 && line[pos - 1] == '"' &&
+            end + 3 <= line.size() && line[end] == '"' && line[end + 1] == ':' && line[end + 2] == '"') {
+            size_t start = end + 3;
+            size_t close = line.find('"', start);
+            if (close == std::string_view::npos) return false;
+            value = line.substr(start, close - start);
+            return true;
+        }
+        pos = end;
+    }
+    return false;
+}
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// ============================================================
+// SegmentIndex — 日志段稀疏索引（<svc>_N.log.idx 旁路文件）
+//
+// 按 kBucketBytes 把段切成若干桶，每个桶记录起始偏移与时间范围；
+// 另有一个覆盖整段的 Bloom 过滤器，登记 trace_id / request_id。
+// 查询时先用 Bloom 排除整段，再按时间范围只读取相交的桶。
+// 索引只描述 [0, coveredBytes)，之后追加的内容由查询方顺序扫描。
+// ============================================================
+class SegmentIndex {
+public:
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kBucketBytes = 64 * 1024;
+    static constexpr uint32_t kBloomBits = 128 * 1024;     // 16KB，单段万级 trace 误判率 < 1%
+    static constexpr uint32_t kBloomHashes = 4;
+
+    struct Bucket {
+        uint64_t offset;
+        int64_t minTsMs;    // 桶内没有可解析时间戳时 minTsMs > maxTsMs
+        int64_t maxTsMs;
+    };
+
+    SegmentIndex();
+
+    void reset();
+
+    // 写入侧：登记一行（line 不含换行，offset 为该行在段内的起始偏移）
+    void addLine(std::string_view line, uint64_t offset);
+
+    // 原子写出（临时文件 + rename）
+    bool save(const std::string& indexPath);
+    bool load(const std::string& indexPath);
+
+    // 顺序扫描已有段重建索引
+    bool build(const std::string& segmentPath);
+
+    // Bloom 判定：false 表示该段一定不含 key=value
+    bool mayContain(std::string_view key, std::string_view value) const;
+
+    const std::vector<Bucket>& buckets() const { return m_buckets; }
+    uint64_t coveredBytes() const { return m_coveredBytes; }
+    int64_t minTsMs() const { return m_minTsMs; }
+    int64_t maxTsMs() const { return m_maxTsMs; }
+    bool isDirty() const { return m_dirty; }
+
+    static std::string indexPathFor(const std::string& segmentPath) { return segmentPath + ".idx"; }
+
+    // 解析段文件名 <service>_<N><suffix>，成功时返回序号
+    static bool parseSegmentName(std::string_view name, std::string_view service, uint32_t& index,
+                                 std::string_view suffix = ".log");
+
+    // 解析 "YYYY-MM-DDTHH:MM:SS.mmmZ" 为 epoch 毫秒，失败返回 -1
+    static int64_t parseTimestampMs(std::string_view iso);
+
+    // 在 JSON 行中查找 "key":"value" 形式的字符串字段
+    static bool extractString(std::string_view line, std::string_view key, std::string_view& value);
+
+private:
+    std::vector<Bucket> m_buckets;
+    std::vector<uint8_t> m_bloom;
+    uint64_t m_coveredBytes = 0;
+    int64_t m_minTsMs;
+    int64_t m_maxTsMs;
+    bool m_dirty = false;
+
+    void addToBloom(std::string_view key, std::string_view value);
+    static uint64_t hashKeyValue(std::string_view key, std::string_view value);
+};
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
@@ -5,38 +5,61 @@ namespace tbox {
 namespace fw {
 namespace log {
 
-SinkManager::SinkManager(const LogConfig& config, const std::string& serviceName) {
+namespace {
+
+bool sameFileConfig(const FileConfig& a, const FileConfig& b) {
+    return a.enabled == b.enabled && a.root == b.root &&
+           a.max_file_size_mb == b.max_file_size_mb && a.max_files == b.max_files &&
+           a.total_budget_mb == b.total_budget_mb && a.index == b.index && a.format == b.format;
+}
+
+bool sameNamedConfigs(const std::map<std::string, FileConfig>& a,
+                      const std::map<std::string, FileConfig>& b) {
+    if (a.size() != b.size()) return false;
+    for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib) {
+        if (ia->first != ib->first || !sameFileConfig(ia->second, ib->second)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+SinkManager::SinkManager(const LogConfig& config, const std::string& serviceName)
+    : m_fileConfig(config.file_config)
+{
     if (config.console_config.enabled) {
         m_consoleSink.reset(new ConsoleSink());
     }
-    if (config.file_config.enabled) {
-        m_fileSink.reset(new RollingFileSink(config.file_config, serviceName));
-    }
+    m_consoleEnabled.store(config.console_config.enabled, std::memory_order_relaxed);
+    openFileSink(config.file_config, serviceName);
+    openNamedSinks(config.named_sinks, serviceName);
 }
 
 SinkManager::~SinkManager() {
     flush();
 }
 
-bool SinkManager::write(const std::string& line, bool isError) {
+bool SinkManager::write(const std::string& line, bool isError, uint32_t sinkMask) {
+    if (sinkMask == 0) return true;     // 路由规则显式丢弃
+
     std::lock_guard<std::mutex> lock(m_mutex);
     bool anySuccess = false;
 
-    if (m_consoleSink && m_consoleSink->isAvailable()) {
+    if ((sinkMask & SinkRouter::kConsole) && m_consoleSink && m_consoleSink->isAvailable()) {
         if (m_consoleSink->write(line, isError)) {
             anySuccess = true;
         }
     }
 
-    if (m_fileSink && m_fileSink->isAvailable()) {
-        if (m_fileSink->write(line)) {
+    if ((sinkMask & SinkRouter::kFile) && writeFile(line)) {
+        anySuccess = true;
+    }
+
+    for (size_t i = 0; i < m_namedSinks.size(); ++i) {
+        if (!(sinkMask & SinkRouter::namedBit(i))) continue;
+        RollingFileSink* sink = m_namedSinks[i].get();
+        if (sink && sink->isAvailable() && sink->write(line)) {
             anySuccess = true;
-            m_consecutiveFailures = 0;
-        } else {
-            ++m_consecutiveFailures;
-            if (m_consecutiveFailures >= 3) {
-                m_stderrFallback = true;
-            }
         }
     }
 
@@ -49,17 +72,107 @@ bool SinkManager::write(const std::string& line, bool isError) {
     return anySuccess;
 }
 
+bool SinkManager::writeRecord(uint32_t catalogId, std::string_view payload) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_binarySink || !m_binarySink->isAvailable()) return false;
+    if (!m_binarySink->writeRecord(catalogId, payload)) {
+        if (++m_consecutiveFailures >= 3) {
+            m_stderrFallback = true;
+        }
+        return false;
+    }
+    m_consecutiveFailures = 0;
+    return true;
+}
+
 void SinkManager::flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
     if (m_consoleSink) m_consoleSink->flush();
     if (m_fileSink) m_fileSink->flush();
+    if (m_binarySink) m_binarySink->flush();
+    for (auto& sink : m_namedSinks) {
+        if (sink) sink->flush();
+    }
+}
+
+void SinkManager::reconfigure(const LogConfig& config, const std::string& serviceName) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (config.console_config.enabled && !m_consoleSink) {
+        m_consoleSink.reset(new ConsoleSink());
+    } else if (!config.console_config.enabled && m_consoleSink) {
+        m_consoleSink.reset();
+    }
+    m_consoleEnabled.store(config.console_config.enabled, std::memory_order_relaxed);
+
+    if (!sameFileConfig(config.file_config, m_fileConfig)) {
+        // 先关闭旧文件（落盘内容与段索引），再按新配置打开
+        m_fileSink.reset();
+        m_binarySink.reset();
+        openFileSink(config.file_config, serviceName);
+        m_fileConfig = config.file_config;
+        m_consecutiveFailures = 0;
+        m_stderrFallback = false;
+    }
+
+    if (!sameNamedConfigs(config.named_sinks, m_namedConfigs)) {
+        m_namedSinks.clear();
+        openNamedSinks(config.named_sinks, serviceName);
+    }
 }
 
 bool SinkManager::hasAvailableSink() const {
     if (m_consoleSink && m_consoleSink->isAvailable()) return true;
     if (m_fileSink && m_fileSink->isAvailable()) return true;
+    if (m_binarySink && m_binarySink->isAvailable()) return true;
+    for (const auto& sink : m_namedSinks) {
+        if (sink && sink->isAvailable()) return true;
+    }
     return m_stderrFallback;
 }
 
+void SinkManager::openFileSink(const FileConfig& config, const std::string& serviceName) {
+    bool binary = config.enabled && config.format == "binary";
+    if (binary) {
+        m_binarySink.reset(new BinaryFileSink(config, serviceName));
+    } else if (config.enabled) {
+        m_fileSink.reset(new RollingFileSink(config, serviceName));
+    }
+    m_binaryEnabled.store(binary && m_binarySink->isAvailable(), std::memory_order_relaxed);
+}
+
+bool SinkManager::writeFile(const std::string& line) {
+    bool ok;
+    if (m_fileSink && m_fileSink->isAvailable()) {
+        ok = m_fileSink->write(line);
+    } else if (m_binarySink && m_binarySink->isAvailable()) {
+        ok = m_binarySink->writeLine(line);
+    } else {
+        return false;
+    }
+
+    if (ok) {
+        m_consecutiveFailures = 0;
+    } else if (++m_consecutiveFailures >= 3) {
+        m_stderrFallback = true;
+    }
+    return ok;
+}
+
+void SinkManager::openNamedSinks(const std::map<std::string, FileConfig>& configs,
+                                 const std::string& serviceName) {
+    m_namedConfigs = configs;
+    for (const auto& pair : configs) {
+        if (m_namedSinks.size() >= SinkRouter::kMaxNamedSinks) break;
+        std::unique_ptr<RollingFileSink> sink;
+        if (pair.second.enabled) {
+            // 独立目录 <root>/<service>-<name>/，滚动与预算互不影响
+            sink.reset(new RollingFileSink(pair.second, serviceName + "-" + pair.first));
+        }
+        m_namedSinks.push_back(std::move(sink));
+    }
+}
+
 void SinkManager::tryRecoverFileSink() {
     // 退避探测恢复（简化实现）
 }
@@ -3,7 +3,11 @@
 #include "log_types.h"
 #include "log_console_sink.h"
 #include "log_rolling_file_sink.h"
+#include "log_binary_sink.h"
+#include "log_sink_router.h"
+#include <map>
 #include <memory>
+#include <vector>
 #include <mutex>
 #include <atomic>
 
@@ -16,18 +20,40 @@ public:
     SinkManager(const LogConfig& config, const std::string& serviceName);
     ~SinkManager();
 
-    bool write(const std::string& line, bool isError = false);
+    // sinkMask 取自 SinkRouter：只写入被选中的 sink；掩码为 0 表示路由丢弃
+    bool write(const std::string& line, bool isError = false,
+               uint32_t sinkMask = SinkRouter::kDefaultMask);
+
+    // file.format 为 binary 时：静态目录记录直接写入二进制段（只写文件，控制台另以 JSON 写入）
+    bool binaryEnabled() const { return m_binaryEnabled.load(std::memory_order_relaxed); }
+    bool writeRecord(uint32_t catalogId, std::string_view payload);
+    // 控制台是否启用：二进制记录另需写一份 JSON 到控制台时据此跳过格式化
+    bool consoleEnabled() const { return m_consoleEnabled.load(std::memory_order_relaxed); }
     void flush();
     bool hasAvailableSink() const;
 
+    // 热重载：按新配置原地替换 sink，与 write 串行，新旧 sink 不会同时写同一文件
+    void reconfigure(const LogConfig& config, const std::string& serviceName);
+
 private:
     std::unique_ptr<ConsoleSink> m_consoleSink;
     std::unique_ptr<RollingFileSink> m_fileSink;
+    std::unique_ptr<BinaryFileSink> m_binarySink;
+    std::atomic<bool> m_binaryEnabled{false};
+    std::atomic<bool> m_consoleEnabled{false};
+    FileConfig m_fileConfig;
+    // log.sinks 命名 sink，按名字排序，下标 i 对应 SinkRouter::namedBit(i)
+    std::vector<std::unique_ptr<RollingFileSink>> m_namedSinks;
+    std::map<std::string, FileConfig> m_namedConfigs;
     mutable std::mutex m_mutex;
     std::atomic<bool> m_stderrFallback{false};
     int m_consecutiveFailures = 0;
 
     void tryRecoverFileSink();
+    void openFileSink(const FileConfig& config, const std::string& serviceName);
+    bool writeFile(const std::string& line);
+    void openNamedSinks(const std::map<std::string, FileConfig>& configs,
+                        const std::string& serviceName);
 };
 
 } // namespace log
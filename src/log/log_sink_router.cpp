@@ -0,0 +1,60 @@
+#include "log_sink_router.h"
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+SinkRouter::SinkRouter(const LogConfig& config) {
+    if (config.routes.empty()) return;
+
+    struct CompiledRoute {
+        bool anyModule;
+        ModuleId module;
+        uint8_t minLevel;
+        uint8_t maxLevel;
+        uint32_t mask;
+    };
+    std::vector<CompiledRoute> routes;
+    for (const auto& route : config.routes) {
+        CompiledRoute compiled;
+        compiled.anyModule = route.module.empty();
+        compiled.module = compiled.anyModule ? 0 : ModuleTable::instance().intern(route.module);
+        compiled.minLevel = static_cast<uint8_t>(route.min_level);
+        compiled.maxLevel = static_cast<uint8_t>(route.max_level);
+        compiled.mask = 0;
+        for (const auto& name : route.sinks) {
+            compiled.mask |= sinkBit(config, name);
+        }
+        routes.push_back(compiled);
+    }
+
+    m_table.reset(new uint32_t[ModuleTable::kMaxModules * kLevels]);
+    for (size_t module = 0; module < ModuleTable::kMaxModules; ++module) {
+        for (size_t level = 0; level < kLevels; ++level) {
+            uint32_t mask = kDefaultMask;
+            for (const auto& route : routes) {
+                if (!route.anyModule && route.module != module) continue;
+                if (level < route.minLevel || level > route.maxLevel) continue;
+                mask = route.mask;
+                break;
+            }
+            m_table[module * kLevels + level] = mask;
+        }
+    }
+}
+
+uint32_t SinkRouter::sinkBit(const LogConfig& config, const std::string& name) {
+    if (name == "console") return kConsole;
+    if (name == "file") return kFile;
+    size_t index = 0;
+    for (const auto& pair : config.named_sinks) {
+        if (index >= kMaxNamedSinks) break;
+        if (pair.first == name) return namedBit(index);
+        ++index;
+    }
+    return 0;
+}
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
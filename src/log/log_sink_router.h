@@ -0,0 +1,46 @@
+#pragma once
+
+#include "log_types.h"
+#include "log_module_table.h"
+#include <memory>
+#include <cstdint>
+
+namespace tbox {
+namespace fw {
+namespace log {
+
+// ============================================================
+// SinkRouter — log.routes 编译后的路由位图
+//
+// 位 0 为 console，位 1 为 file，位 2 起依次为 named_sinks（按名字排序）。
+// 每个 (ModuleId, level) 预先算好位图，记录时一次查表；
+// 未配置路由时不分配表，所有记录写往 console 与 file。
+// ============================================================
+class SinkRouter {
+public:
+    static constexpr uint32_t kConsole = 1u << 0;
+    static constexpr uint32_t kFile = 1u << 1;
+    static constexpr uint32_t kDefaultMask = kConsole | kFile;
+    static constexpr size_t kMaxNamedSinks = 30;
+
+    explicit SinkRouter(const LogConfig& config);
+
+    uint32_t route(ModuleId module, LogLevel level) const {
+        if (!m_table) return kDefaultMask;
+        return m_table[static_cast<size_t>(module) * kLevels + static_cast<size_t>(level)];
+    }
+
+    static uint32_t namedBit(size_t index) { return 1u << (2 + index); }
+
+    // sink 名字转位，未知名字返回 0
+    static uint32_t sinkBit(const LogConfig& config, const std::string& name);
+
+private:
+    static constexpr size_t kLevels = static_cast<size_t>(LogLevel::kOff) + 1;
+
+    std::unique_ptr<uint32_t[]> m_table;    // [ModuleId][level]
+};
+
+} // namespace log
+} // namespace fw
+} // namespace tbox
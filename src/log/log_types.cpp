@@ -1,39 +1,162 @@
 #include "log_types.h"
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 
 namespace tbox {
 namespace fw {
 namespace log {
 
-FieldValue FieldValue::makeString(const std::string& v) {
+FieldValue::FieldValue(const FieldValue& other)
+    : type(other.type), intVal(0), m_storage(Storage::kNone), m_size(0)
+{
+    *this = other;
+}
+
+FieldValue::FieldValue(FieldValue&& other) noexcept
+    : type(other.type), intVal(0), m_storage(Storage::kNone), m_size(0)
+{
+    *this = std::move(other);
+}
+
+FieldValue& FieldValue::operator=(const FieldValue& other) {
+    if (this == &other) return *this;
+    if (other.m_storage == Storage::kHeap) {
+        std::string_view v = other.stringView();
+        assignCopy(other.type, v.data(), v.size());
+        m_flags = other.m_flags;
+        return *this;
+    }
+    release();
+    type = other.type;
+    m_flags = other.m_flags;
+    m_storage = other.m_storage;
+    m_size = other.m_size;
+    memcpy(m_inline, other.m_inline, kInlineCapacity);
+    return *this;
+}
+
+FieldValue& FieldValue::operator=(FieldValue&& other) noexcept {
+    if (this == &other) return *this;
+    release();
+    type = other.type;
+    m_flags = other.m_flags;
+    m_storage = other.m_storage;
+    m_size = other.m_size;
+    memcpy(m_inline, other.m_inline, kInlineCapacity);
+    // 堆存储所有权转移
+    other.m_storage = Storage::kNone;
+    other.m_size = 0;
+    return *this;
+}
+
+std::string_view FieldValue::stringView() const noexcept {
+    switch (m_storage) {
+        case Storage::kInline:   return std::string_view(m_inline, m_size);
+        case Storage::kHeap:
+        case Storage::kBorrowed: return std::string_view(m_ptr, m_size);
+        default:                 return std::string_view();
+    }
+}
+
+void FieldValue::own() {
+    if (m_storage != Storage::kBorrowed) return;
+    const char* data = m_ptr;
+    assignCopy(type, data, m_size);
+}
+
+void FieldValue::truncateBytes(size_t maxSize) noexcept {
+    if (m_size <= maxSize) return;
+    // 内联/堆/借用存储都只需缩短长度，多余部分不会被读取或拷贝
+    m_size = static_cast<uint32_t>(maxSize);
+    m_flags |= kFlagTruncated;
+}
+
+void FieldValue::assignCopy(FieldValueType t, const char* data, size_t size) {
+    // data 可能指向自身借用的外部内存，先拷贝再释放
+    if (size <= kInlineCapacity) {
+        char tmp[kInlineCapacity];
+        memcpy(tmp, data, size);
+        release();
+        memcpy(m_inline, tmp, size);
+        m_storage = Storage::kInline;
+    } else {
+        char* heap = new char[size];
+        memcpy(heap, data, size);
+        release();
+        m_ptr = heap;
+        m_storage = Storage::kHeap;
+    }
+    type = t;
+    m_size = static_cast<uint32_t>(size);
+}
+
+void FieldValue::release() noexcept {
+    if (m_storage == Storage::kHeap) {
+        delete[] m_ptr;
+    }
+    m_storage = Storage::kNone;
+    m_size = 0;
+}
+
+FieldValue FieldValue::makeString(std::string_view v) {
+    FieldValue fv;
+    fv.assignCopy(FieldValueType::kString, v.data(), v.size());
+    return fv;
+}
+
+FieldValue FieldValue::makeStringView(std::string_view v) noexcept {
     FieldValue fv;
     fv.type = FieldValueType::kString;
-    fv.stringVal = v;
+    fv.m_storage = Storage::kBorrowed;
+    fv.m_ptr = v.data();
+    fv.m_size = static_cast<uint32_t>(v.size());
     return fv;
 }
 
-FieldValue FieldValue::makeInt(int64_t v) {
+FieldValue FieldValue::makeInt(int64_t v) noexcept {
     FieldValue fv;
     fv.type = FieldValueType::kInt64;
     fv.intVal = v;
     return fv;
 }
 
-FieldValue FieldValue::makeDouble(double v) {
+FieldValue FieldValue::makeUint(uint64_t v) noexcept {
+    FieldValue fv;
+    fv.type = FieldValueType::kUint64;
+    fv.uintVal = v;
+    return fv;
+}
+
+FieldValue FieldValue::makeDouble(double v) noexcept {
     FieldValue fv;
     fv.type = FieldValueType::kDouble;
     fv.doubleVal = v;
     return fv;
 }
 
-FieldValue FieldValue::makeBool(bool v) {
+FieldValue FieldValue::makeBool(bool v) noexcept {
     FieldValue fv;
     fv.type = FieldValueType::kBool;
     fv.boolVal = v;
     return fv;
 }
 
+FieldValue FieldValue::makeBytes(const void* data, size_t size) {
+    FieldValue fv;
+    fv.assignCopy(FieldValueType::kBytes, static_cast<const char*>(data), size);
+    return fv;
+}
+
+FieldValue FieldValue::makeBytesView(const void* data, size_t size) noexcept {
+    FieldValue fv;
+    fv.type = FieldValueType::kBytes;
+    fv.m_storage = Storage::kBorrowed;
+    fv.m_ptr = static_cast<const char*>(data);
+    fv.m_size = static_cast<uint32_t>(size);
+    return fv;
+}
+
 LogLevel logLevelFromString(const std::string& str) {
     std::string upper;
     upper.reserve(str.size());
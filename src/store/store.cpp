@@ -4,96 +4,148 @@
 #include "store_atomic_writer.h"
 #include "store_file_lock.h"
 #include "store_flush_policy.h"
-#include <fstream>
+#include "store_generation.h"
+#include "store_read_cache.h"
+#include "store_key_index.h"
+#include "store_log_engine.h"
+#include "store_journal.h"
+#include <map>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <condition_variable>
+#include <algorithm>
+#include <utility>
 #include <sys/stat.h>
 #include <dirent.h>
 #include <cstdio>
 #include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
 
 namespace hwyz {
 namespace store {
 
 class Store::Impl {
 public:
-    Impl(const std::string& serviceName, const std::string& storeRoot)
+    Impl(const std::string& serviceName, const std::string& storeRoot,
+         const StoreOptions& options = StoreOptions())
         : m_pathResolver(serviceName, storeRoot)
         , m_atomicWriter(m_pathResolver)
-        , m_fileLock(m_pathResolver)
+        , m_fileLock(m_pathResolver, options.lockWaitSignal)
+        , m_journal(m_pathResolver)
+        , m_flushPolicy(options.flushPolicy)
+        , m_generation(m_pathResolver)
+        , m_readCache(m_pathResolver, m_generation, options.readCacheMaxBytes)
+        , m_keyIndex(m_pathResolver, m_generation)
+        , m_options(options)
     {
         m_ready = m_pathResolver.ensureDirectory();
+        if (m_ready && m_options.backend == StoreBackend::kLogStructured) {
+            // 索引常驻内存，读缓存的按文件校验不适用
+            LogEngine::Options engineOptions;
+            engineOptions.compactMinBytes = m_options.compactMinBytes;
+            engineOptions.compactGarbagePercent = m_options.compactGarbagePercent;
+            m_logEngine.reset(new LogEngine(m_pathResolver, engineOptions));
+            m_ready = m_logEngine->open();
+        } else if (m_ready) {
+            m_generation.open();
+            if (m_options.readCache) {
+                m_readCache.open();
+            }
+            // 前滚上次未完成的批量提交；无法前滚时停止写入，
+            // 否则之后的写入会在下次打开时被该批次覆盖
+            bool stuck = false;
+            if (m_journal.recover(m_fileLock, &stuck) > 0 || stuck) {
+                m_generation.bump();
+            }
+            if (stuck) {
+                m_ready = false;
+            }
+            if (m_options.keyIndex) {
+                m_keyIndex.open();
+            }
+        }
+        if (m_ready && m_options.writeMode == WriteMode::kWriteBack) {
+            m_flusher = std::thread(&Impl::flusherLoop, this);
+        }
     }
 
-    ~Impl() = default;
-
-    template<typename T>
-    void save(const std::string& key, const T& value) {
-        if (!m_ready) {
-            throw StoreException(StoreError::kPathUnavailable,
-                                 "Store not ready", key);
+    ~Impl() {
+        // 先执行完异步队列，写回模式下其结果再随最后一轮落盘
+        stopAsync();
+        if (m_flusher.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(m_flusherMutex);
+                m_stopping = true;
+            }
+            m_flusherCv.notify_all();
+            m_flusher.join();
         }
+        // 析构不抛异常：落盘失败的脏数据丢失
+        std::string failedKey;
+        flushDirty(failedKey);
+    }
 
-        if (!m_fileLock.acquire(key, 1000)) {
-            throw StoreException(StoreError::kLockFailed,
-                                 "Failed to acquire lock", key);
-        }
+    // bytes 为已封帧的值
+    void save(const std::string& key, std::string bytes) {
+        checkReady(key);
+        settleAsync(key);
+        saveNow(key, std::move(bytes));
+    }
 
-        std::string bytes = m_serializer.serialize(value);
-        if (bytes.empty()) {
-            m_fileLock.release(key);
-            throw StoreException(StoreError::kSerializationFailed,
-                                 "Failed to serialize value", key);
+    // 交给 I/O 线程；同一 key 尚未执行的写入合并
+    void enqueue(const std::string& key, std::string bytes, bool remove, AsyncCallback done) {
+        checkReady(key);
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        if (!m_asyncThread.joinable()) {
+            m_asyncThread = std::thread(&Impl::asyncLoop, this);
         }
-
-        if (!m_atomicWriter.write(key, bytes)) {
-            m_fileLock.release(key);
-            throw StoreException(StoreError::kAtomicWriteFailed,
-                                 "Failed to write atomically", key);
+        auto it = m_asyncQueue.find(key);
+        if (it == m_asyncQueue.end()) {
+            it = m_asyncQueue.emplace(key, AsyncOp()).first;
+            m_asyncOrder.push_back(key);
         }
-
-        m_flushPolicy.clearDirty(key);
-        m_fileLock.release(key);
+        it->second.bytes = std::move(bytes);
+        it->second.remove = remove;
+        if (done) {
+            it->second.waiters.push_back(std::move(done));
+        }
+        updateAsyncOps();
+        m_asyncCv.notify_all();
     }
 
+    // 读缓存支持的类型：命中时不做任何 I/O 与解码。
+    // 数据来源依次为异步队列、写回缓存、读缓存、文件
     template<typename T>
     T load(const std::string& key) const {
-        if (!m_ready) {
-            throw StoreException(StoreError::kPathUnavailable,
-                                 "Store not ready", key);
-        }
+        checkReady(key);
 
-        if (!m_atomicWriter.exists(key)) {
-            throw StoreException(StoreError::kKeyNotFound,
-                                 "Key not found", key);
+        T value;
+        detail::CodecTarget target = detail::codecTarget(value);
+        if (loadQueued(key, target) || loadPending(key, target)) {
+            return value;
         }
 
-        std::string filePath = m_pathResolver.getKeyPath(key);
-        std::ifstream ifs(filePath);
-        if (!ifs.is_open()) {
-            throw StoreException(StoreError::kAtomicWriteFailed,
-                                 "Failed to open file", key);
+        // 热路径：一次哈希查找加一次共享代数比较
+        if (!m_logEngine && m_readCache.get(key, value)) {
+            return value;
         }
 
-        std::string bytes((std::istreambuf_iterator<char>(ifs)),
-                          std::istreambuf_iterator<char>());
-
-        T value;
-        if (!m_serializer.deserialize(bytes, value)) {
-            throw StoreException(StoreError::kSerializationFailed,
-                                 "Failed to deserialize value", key);
+        // 先取代数再读文件，读取期间的并发写入会让该条目在下次访问时被校验
+        uint64_t generation = m_readCache.generation();
+        FileIdentity identity;
+        if (loadStored(key, target, &identity)) {
+            m_readCache.put(key, value, identity, generation);
         }
-
         return value;
     }
 
-    template<typename T>
-    T loadOr(const std::string& key, const T& defaultValue) const {
-        try {
-            return load<T>(key);
-        } catch (const StoreException& e) {
-            if (e.getError().code == StoreError::kKeyNotFound) {
-                return defaultValue;
-            }
-            throw;
+    void loadInto(const std::string& key, const detail::CodecTarget& target) const {
+        checkReady(key);
+        if (!loadQueued(key, target) && !loadPending(key, target)) {
+            loadStored(key, target, nullptr);
         }
     }
 
@@ -101,27 +153,139 @@ public:
         if (!m_ready) {
             return false;
         }
+        if (m_asyncOps.load(std::memory_order_acquire) > 0) {
+            std::lock_guard<std::mutex> lock(m_asyncMutex);
+            if (const AsyncOp* op = queuedOp(key)) {
+                return !op->remove;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            if (m_pending.count(key) > 0) {
+                return true;
+            }
+        }
+        if (m_logEngine) {
+            return m_logEngine->contains(key);
+        }
+        if (m_keyIndex.enabled()) {
+            return m_keyIndex.contains(key);
+        }
         return m_atomicWriter.exists(key);
     }
 
     void remove(const std::string& key) {
+        checkReady(key);
+        settleAsync(key);
+        removeNow(key);
+    }
+
+    void commitBatch(const std::vector<Mutation>& mutations) {
         if (!m_ready) {
             throw StoreException(StoreError::kPathUnavailable,
-                                 "Store not ready", key);
+                                 "Store not ready", mutations.empty() ? "" : mutations.front().key);
+        }
+        if (mutations.empty()) {
+            return;
+        }
+        for (const auto& mutation : mutations) {
+            settleAsync(mutation.key);
         }
 
-        if (!m_fileLock.acquire(key, 1000)) {
-            throw StoreException(StoreError::kLockFailed,
-                                 "Failed to acquire lock", key);
+        // 与后台落盘互斥，批次之后不会被旧的脏数据覆盖
+        std::lock_guard<std::mutex> commit(m_commitMutex);
+
+        // 写回 save 不取 m_commitMutex：提交前记下同 key 的待落盘值，
+        // 提交后只清除未被再次 save 的，与 flushDirty 相同
+        std::vector<std::pair<std::string, std::string>> superseded;
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            for (const auto& mutation : mutations) {
+                auto it = m_pending.find(mutation.key);
+                if (it != m_pending.end()) {
+                    superseded.emplace_back(it->first, it->second);
+                }
+            }
         }
+        if (m_logEngine) {
+            if (!m_logEngine->commitBatch(mutations)) {
+                throw StoreException(StoreError::kAtomicWriteFailed,
+                                     "Failed to commit batch", mutations.front().key);
+            }
+        } else {
+            // 按（槽位, key）排序加锁，避免与其他批次互相等待
+            std::vector<std::string> keys;
+            for (const auto& mutation : mutations) {
+                keys.push_back(mutation.key);
+            }
+            std::sort(keys.begin(), keys.end(), FileLock::lockOrder);
+            std::vector<std::string> locked;
+            for (const auto& key : keys) {
+                if (!m_fileLock.acquire(key, 1000)) {
+                    for (const auto& held : locked) {
+                        m_fileLock.release(held);
+                    }
+                    throw StoreException(StoreError::kLockFailed,
+                                         "Failed to acquire lock", key);
+                }
+                locked.push_back(key);
+            }
 
-        m_atomicWriter.remove(key);
-        m_flushPolicy.clearDirty(key);
-        m_fileLock.release(key);
+            Journal::Result result = m_journal.commit(mutations);
+            bool ok = (result == Journal::Result::kCommitted);
+            // 失败时可能已部分应用，同样需要让缓存失效，目录索引留待重建
+            for (const auto& key : keys) {
+                m_readCache.invalidate(key);
+            }
+            if (ok) {
+                for (const auto& mutation : mutations) {
+                    m_keyIndex.update(mutation.key, !mutation.remove);
+                }
+                publish();
+            } else {
+                m_generation.bump();
+            }
+            // journal 留在磁盘上：之后的写入会在下次打开时被该批次覆盖，停止写入
+            if (result == Journal::Result::kPending) {
+                m_ready = false;
+            }
+            for (const auto& key : locked) {
+                m_fileLock.release(key);
+            }
+            if (result == Journal::Result::kPending) {
+                throw StoreException(StoreError::kAtomicWriteFailed,
+                                     "Failed to commit batch, store disabled until reopened",
+                                     mutations.front().key);
+            }
+            if (!ok) {
+                throw StoreException(StoreError::kAtomicWriteFailed,
+                                     "Failed to commit batch", mutations.front().key);
+            }
+        }
+
+        // 批次覆盖提交前尚未落盘的写回值；提交期间的 save 保留
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        for (const auto& entry : superseded) {
+            auto it = m_pending.find(entry.first);
+            if (it != m_pending.end() && it->second == entry.second) {
+                m_pending.erase(it);
+                m_flushPolicy.clearDirty(entry.first);
+            }
+        }
     }
 
     void flush() {
-        m_flushPolicy.reset();
+        drainAsync();
+        if (m_options.writeMode != WriteMode::kWriteBack) {
+            m_flushPolicy.reset();
+            return;
+        }
+
+        std::string failedKey;
+        if (!flushDirty(failedKey)) {
+            throw StoreException(StoreError::kAtomicWriteFailed,
+                                 "Failed to flush dirty keys", failedKey);
+        }
     }
 
     bool isReady() const {
@@ -133,6 +297,38 @@ public:
             return;
         }
 
+        // 丢弃异步队列，排队中的写入以错误结束，再等待正在执行的写入结束
+        {
+            std::unique_lock<std::mutex> lock(m_asyncMutex);
+            for (auto& entry : m_asyncQueue) {
+                AsyncResult result;
+                result.waiters = std::move(entry.second.waiters);
+                result.failed = true;
+                result.error = StoreErrorInfo{StoreError::kPathUnavailable, "Store cleaned up", entry.first};
+                m_asyncResults.push_back(std::move(result));
+            }
+            m_asyncQueue.clear();
+            m_asyncOrder.clear();
+            updateAsyncOps();
+            m_asyncCv.notify_all();
+            m_asyncCv.wait(lock, [this] { return !m_inflight; });
+        }
+
+        // 丢弃未落盘的脏数据
+        std::lock_guard<std::mutex> commit(m_commitMutex);
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            m_pending.clear();
+            m_flushPolicy.reset();
+        }
+        m_readCache.close();
+        m_keyIndex.close();
+        m_generation.close();
+        if (m_logEngine) {
+            m_logEngine->close(true);
+            m_logEngine.reset();
+        }
+
         std::string storePath = m_pathResolver.getStorePath();
         DIR* dir = opendir(storePath.c_str());
         if (dir == nullptr) {
@@ -159,11 +355,527 @@ public:
 
 private:
     PathResolver m_pathResolver;
-    Serializer m_serializer;
     AtomicWriter m_atomicWriter;
     FileLock m_fileLock;
+    Journal m_journal;
     FlushPolicy m_flushPolicy;
-    bool m_ready = false;
+    Generation m_generation;
+    mutable ReadCache m_readCache;
+    mutable KeyIndex m_keyIndex;    // 文件后端：has() 与缺失 key 的 load 不访问文件系统
+    StoreOptions m_options;
+    std::unique_ptr<LogEngine> m_logEngine;     // kLogStructured 时替代文件级存储
+    std::atomic<bool> m_ready{false};
+
+    // 写回缓存：key → 已序列化、尚未落盘的值
+    mutable std::mutex m_pendingMutex;
+    std::map<std::string, std::string> m_pending;
+
+    // 串行化落盘、批次提交与 cleanup；写回模式下日志结构后端的 remove 也取此锁
+    std::mutex m_commitMutex;
+
+    std::thread m_flusher;
+    std::mutex m_flusherMutex;
+    std::condition_variable m_flusherCv;
+    bool m_stopping = false;
+
+    // 异步写入：每个 key 只保留最后一次，m_asyncOrder 为首次入队的顺序
+    struct AsyncOp {
+        std::string bytes;
+        bool remove = false;
+        std::vector<AsyncCallback> waiters;
+    };
+    struct AsyncResult {
+        std::vector<AsyncCallback> waiters;
+        bool failed = false;
+        StoreErrorInfo error;
+    };
+    std::thread m_asyncThread;
+    mutable std::mutex m_asyncMutex;
+    std::condition_variable m_asyncCv;
+    std::map<std::string, AsyncOp> m_asyncQueue;
+    std::deque<std::string> m_asyncOrder;
+    std::deque<AsyncResult> m_asyncResults;     // 已结束、待在 I/O 线程回调
+    std::string m_inflightKey;
+    AsyncOp m_inflightOp;                       // 正在执行，读取仍以它为准
+    bool m_inflight = false;
+    bool m_asyncStopping = false;
+    std::atomic<size_t> m_asyncOps{0};          // 排队与执行中的 key 数，为 0 时读取不加锁
+
+    // key 文件已改动：递增共享代数，本进程的目录索引随之前进
+    void publish() {
+        m_keyIndex.published(m_generation.bump());
+    }
+
+    void checkReady(const std::string& key) const {
+        if (!m_ready) {
+            throw StoreException(StoreError::kPathUnavailable,
+                                 "Store not ready", key);
+        }
+    }
+
+    // 写入与删除本身，I/O 线程直接调用
+    void saveNow(const std::string& key, std::string bytes) {
+        if (!m_ready) {
+            throw StoreException(StoreError::kPathUnavailable,
+                                 "Store not ready", key);
+        }
+
+        if (m_options.writeMode == WriteMode::kWriteBack) {
+            // 编码在调用方同步完成，错误当场抛出；落盘交给后台线程
+            bool wake = false;
+            {
+                std::lock_guard<std::mutex> lock(m_pendingMutex);
+                wake = m_pending.empty();
+                m_pending[key] = std::move(bytes);
+                wake = wake || m_pending.size() >= m_options.flushPolicy.maxDirtyCount;
+                m_flushPolicy.markDirty(key);
+                m_readCache.invalidate(key);
+            }
+            // 空闲的后台线程无限期等待：首个脏 key 或达到数量阈值时唤醒它重新计算期限
+            if (wake) {
+                std::lock_guard<std::mutex> lock(m_flusherMutex);
+                m_flusherCv.notify_one();
+            }
+            return;
+        }
+
+        if (m_logEngine) {
+            if (!m_logEngine->put(key, bytes)) {
+                throw StoreException(StoreError::kAtomicWriteFailed,
+                                     "Failed to append record", key);
+            }
+            return;
+        }
+
+        if (!m_fileLock.acquire(key, 1000)) {
+            throw StoreException(StoreError::kLockFailed,
+                                 "Failed to acquire lock", key);
+        }
+
+        if (!m_atomicWriter.write(key, bytes)) {
+            // rename 之后的目录同步失败时新值已可见：与批次失败相同，
+            // 让缓存失效并递增代数，目录索引留待重建
+            m_readCache.invalidate(key);
+            m_generation.bump();
+            m_fileLock.release(key);
+            throw StoreException(StoreError::kAtomicWriteFailed,
+                                 "Failed to write atomically", key);
+        }
+
+        // rename 之后递增代数，读者据此校验缓存
+        m_readCache.invalidate(key);
+        m_keyIndex.update(key, true);
+        publish();
+        m_flushPolicy.clearDirty(key);
+        m_fileLock.release(key);
+    }
+
+    void removeNow(const std::string& key) {
+        if (!m_ready) {
+            throw StoreException(StoreError::kPathUnavailable,
+                                 "Store not ready", key);
+        }
+
+        if (m_logEngine) {
+            // 写回模式下与后台落盘互斥：落盘整批追加的快照不会盖过删除记录
+            std::unique_lock<std::mutex> commit(m_commitMutex, std::defer_lock);
+            if (m_options.writeMode == WriteMode::kWriteBack) {
+                commit.lock();
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_pendingMutex);
+                m_pending.erase(key);
+                m_flushPolicy.clearDirty(key);
+            }
+            if (!m_logEngine->remove(key)) {
+                throw StoreException(StoreError::kAtomicWriteFailed,
+                                     "Failed to append tombstone", key);
+            }
+            return;
+        }
+
+        // 文件后端只取 key 锁：后台落盘在 key 锁下复核待落盘值，已删除的 key 不会被写回
+        if (!m_fileLock.acquire(key, 1000)) {
+            throw StoreException(StoreError::kLockFailed,
+                                 "Failed to acquire lock", key);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            m_pending.erase(key);
+            m_flushPolicy.clearDirty(key);
+        }
+        m_atomicWriter.remove(key);
+        m_readCache.invalidate(key);
+        m_keyIndex.update(key, false);
+        publish();
+        m_fileLock.release(key);
+    }
+
+
+    // 须持有 m_asyncMutex
+    const AsyncOp* queuedOp(const std::string& key) const {
+        auto it = m_asyncQueue.find(key);
+        if (it != m_asyncQueue.end()) {
+            return &it->second;
+        }
+        if (m_inflight && m_inflightKey == key) {
+            return &m_inflightOp;
+        }
+        return nullptr;
+    }
+
+    // 须持有 m_asyncMutex
+    void updateAsyncOps() {
+        m_asyncOps.store(m_asyncQueue.size() + (m_inflight ? 1 : 0), std::memory_order_release);
+    }
+
+    // 异步队列中的值：持锁解码；排队中的删除视为不存在
+    bool loadQueued(const std::string& key, const detail::CodecTarget& target) const {
+        if (m_asyncOps.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_asyncMutex);
+        const AsyncOp* op = queuedOp(key);
+        if (op == nullptr) {
+            return false;
+        }
+        if (op->remove) {
+            throw StoreException(StoreError::kKeyNotFound,
+                                 "Key not found", key);
+        }
+        CodecReader reader(op->bytes.data(), op->bytes.size());
+        if (!Serializer::decode(reader, target)) {
+            throw StoreException(StoreError::kSerializationFailed,
+                                 "Failed to deserialize value", key);
+        }
+        return true;
+    }
+
+    // 同步写入之前：等待该 key 正在执行的异步写入，排队中的视为已被覆盖
+    void settleAsync(const std::string& key) {
+        if (m_asyncOps.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(m_asyncMutex);
+        m_asyncCv.wait(lock, [&] { return !m_inflight || m_inflightKey != key; });
+        auto it = m_asyncQueue.find(key);
+        if (it == m_asyncQueue.end()) {
+            return;
+        }
+        AsyncResult result;
+        result.waiters = std::move(it->second.waiters);
+        m_asyncResults.push_back(std::move(result));
+        m_asyncQueue.erase(it);
+        updateAsyncOps();
+        m_asyncCv.notify_all();
+    }
+
+    // 等待已入队的写入执行完毕；在 I/O 线程内调用时直接返回
+    void drainAsync() {
+        std::unique_lock<std::mutex> lock(m_asyncMutex);
+        if (!m_asyncThread.joinable() || m_asyncThread.get_id() == std::this_thread::get_id()) {
+            return;
+        }
+        m_asyncCv.wait(lock, [this] { return m_asyncQueue.empty() && !m_inflight; });
+    }
+
+    void stopAsync() {
+        {
+            std::lock_guard<std::mutex> lock(m_asyncMutex);
+            if (!m_asyncThread.joinable()) {
+                return;
+            }
+            m_asyncStopping = true;
+        }
+        m_asyncCv.notify_all();
+        m_asyncThread.join();
+    }
+
+    static void notifyWaiters(const AsyncResult& result) {
+        for (const auto& done : result.waiters) {
+            // 回调抛出的异常不影响 I/O 线程
+            try {
+                done(result.failed ? &result.error : nullptr);
+            } catch (...) {
+            }
+        }
+    }
+
+    // I/O 线程：按入队顺序执行，停止时先排空队列
+    void asyncLoop() {
+        std::unique_lock<std::mutex> lock(m_asyncMutex);
+        while (true) {
+            m_asyncCv.wait(lock, [this] {
+                return m_asyncStopping || !m_asyncOrder.empty() || !m_asyncResults.empty();
+            });
+            if (!m_asyncResults.empty()) {
+                AsyncResult result = std::move(m_asyncResults.front());
+                m_asyncResults.pop_front();
+                lock.unlock();
+                notifyWaiters(result);
+                lock.lock();
+                continue;
+            }
+            if (m_asyncOrder.empty()) {
+                break;
+            }
+
+            std::string key = std::move(m_asyncOrder.front());
+            m_asyncOrder.pop_front();
+            auto it = m_asyncQueue.find(key);
+            if (it == m_asyncQueue.end()) {
+                continue;
+            }
+            m_inflightKey = key;
+            m_inflightOp = std::move(it->second);
+            m_inflight = true;
+            m_asyncQueue.erase(it);
+            updateAsyncOps();
+            lock.unlock();
+
+            // 执行期间其他线程只读 m_inflightOp
+            AsyncResult result;
+            try {
+                if (m_inflightOp.remove) {
+                    removeNow(key);
+                } else {
+                    saveNow(key, m_inflightOp.bytes);
+                }
+            } catch (const StoreException& e) {
+                result.failed = true;
+                result.error = e.getError();
+            } catch (const std::exception& e) {
+                result.failed = true;
+                result.error = StoreErrorInfo{StoreError::kAtomicWriteFailed, e.what(), key};
+            }
+
+            lock.lock();
+            result.waiters = std::move(m_inflightOp.waiters);
+            m_inflightOp = AsyncOp();
+            m_inflight = false;
+            updateAsyncOps();
+            m_asyncCv.notify_all();
+            lock.unlock();
+            notifyWaiters(result);
+            lock.lock();
+        }
+    }
+
+    // 写回缓存中的值：持锁解码，不复制
+    bool loadPending(const std::string& key, const detail::CodecTarget& target) const {
+        if (m_options.writeMode != WriteMode::kWriteBack) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        auto it = m_pending.find(key);
+        if (it == m_pending.end()) {
+            return false;
+        }
+        CodecReader reader(it->second.data(), it->second.size());
+        if (!Serializer::decode(reader, target)) {
+            throw StoreException(StoreError::kSerializationFailed,
+                                 "Failed to deserialize value", key);
+        }
+        return true;
+    }
+
+    // 从日志引擎或 key 文件直接解码到 target；来自 key 文件时返回 true 并填写 identity
+    bool loadStored(const std::string& key, const detail::CodecTarget& target,
+                    FileIdentity* identity) const {
+        int error = 0;
+        bool decoded = false;
+        bool fromFile = false;
+        if (m_logEngine) {
+            error = m_logEngine->read(key, [&](int fd, uint64_t offset, uint32_t size) {
+                CodecReader reader(fd, offset, size);
+                decoded = Serializer::decode(reader, target);
+                return reader.ioError() ? EIO : 0;
+            });
+        } else if (m_keyIndex.enabled() && !m_keyIndex.contains(key)) {
+            error = ENOENT;
+        } else {
+            int fd = ::open(m_pathResolver.getKeyPath(key).c_str(), O_RDONLY | O_CLOEXEC);
+            FileIdentity fileIdentity;
+            if (fd < 0) {
+                error = errno;
+            } else if (!ReadCache::identityOf(fd, fileIdentity)) {
+                error = errno;
+            } else {
+                CodecReader reader(fd, 0, static_cast<size_t>(fileIdentity.size));
+                decoded = Serializer::decode(reader, target);
+                error = reader.ioError() ? EIO : 0;
+                fromFile = true;
+            }
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            if (identity != nullptr) {
+                *identity = fileIdentity;
+            }
+        }
+
+        if (error == ENOENT) {
+            throw StoreException(StoreError::kKeyNotFound,
+                                 "Key not found", key);
+        }
+        if (error != 0) {
+            throw StoreException(StoreError::kAtomicWriteFailed,
+                                 "Failed to read value", key);
+        }
+        if (!decoded) {
+            throw StoreException(StoreError::kSerializationFailed,
+                                 "Failed to deserialize value", key);
+        }
+        return fromFile;
+    }
+
+    // 后台线程睡到最早的去抖 / 最长等待期限；没有脏数据时等待 saveNow 唤醒。
+    // 落盘失败的 key 仍然过期，按重试间隔退避，避免空转
+    void flusherLoop() {
+        const FlushPolicyConfig& config = m_options.flushPolicy;
+        uint32_t retryMs = std::min<uint32_t>(config.debounceMs, 100);
+        if (config.maxDelayMs > 0) {
+            retryMs = std::min(retryMs, config.maxDelayMs);
+        }
+        const auto retryDelay = std::chrono::milliseconds(std::max<uint32_t>(retryMs, 10));
+
+        std::chrono::steady_clock::time_point retryAt;
+        std::unique_lock<std::mutex> lock(m_flusherMutex);
+        while (!m_stopping) {
+            std::chrono::steady_clock::time_point deadline;
+            if (m_flushPolicy.nextFlushTime(deadline)) {
+                m_flusherCv.wait_until(lock, std::max(deadline, retryAt));
+            } else {
+                m_flusherCv.wait(lock);
+            }
+            if (m_stopping) {
+                break;
+            }
+            lock.unlock();
+            if (std::chrono::steady_clock::now() >= retryAt && m_flushPolicy.shouldFlush()) {
+                std::string failedKey;
+                if (!flushDirty(failedKey) || !m_ready) {
+                    retryAt = std::chrono::steady_clock::now() + retryDelay;
+                }
+            }
+            lock.lock();
+        }
+    }
+
+    // 落盘当前全部脏数据；失败的 key 保留在缓存中等待下一轮重试
+    bool flushDirty(std::string& failedKey) {
+        std::lock_guard<std::mutex> commit(m_commitMutex);
+
+        std::vector<std::pair<std::string, std::string>> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            snapshot.assign(m_pending.begin(), m_pending.end());
+        }
+        if (snapshot.empty() || !m_ready) {
+            return true;
+        }
+
+        if (m_logEngine) {
+            // 整批追加，一次 fdatasync
+            if (!m_logEngine->putBatch(snapshot)) {
+                failedKey = snapshot.front().first;
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            for (const auto& entry : snapshot) {
+                auto it = m_pending.find(entry.first);
+                if (it != m_pending.end() && it->second == entry.second) {
+                    m_pending.erase(it);
+                    m_flushPolicy.clearDirty(entry.first);
+                }
+            }
+            return true;
+        }
+
+        // 与批次提交相同的加锁顺序
+        std::sort(snapshot.begin(), snapshot.end(), [](const auto& a, const auto& b) {
+            return FileLock::lockOrder(a.first, b.first);
+        });
+        std::vector<std::pair<std::string, std::string>> locked;
+        locked.reserve(snapshot.size());
+        for (auto& entry : snapshot) {
+            if (!m_fileLock.acquire(entry.first, 1000)) {
+                if (failedKey.empty()) {
+                    failedKey = entry.first;
+                }
+                continue;
+            }
+            // 等锁期间被 remove 或再次 save 的 key 跳过：前者不能写回，后者留待下一轮
+            bool current;
+            {
+                std::lock_guard<std::mutex> lock(m_pendingMutex);
+                auto it = m_pending.find(entry.first);
+                current = it != m_pending.end() && it->second == entry.second;
+            }
+            if (current) {
+                locked.push_back(std::move(entry));
+            } else {
+                m_fileLock.release(entry.first);
+            }
+        }
+
+        std::vector<size_t> committed;
+        bool writeFailed = false;
+        if (m_options.flushPolicy.enableBatch) {
+            // 整批一次目录同步
+            if (m_atomicWriter.writeBatch(locked)) {
+                for (size_t i = 0; i < locked.size(); ++i) {
+                    committed.push_back(i);
+                }
+            } else if (!locked.empty()) {
+                writeFailed = true;
+                if (failedKey.empty()) {
+                    failedKey = locked.front().first;
+                }
+            }
+        } else {
+            for (size_t i = 0; i < locked.size(); ++i) {
+                if (m_atomicWriter.write(locked[i].first, locked[i].second)) {
+                    committed.push_back(i);
+                } else {
+                    writeFailed = true;
+                    if (failedKey.empty()) {
+                        failedKey = locked[i].first;
+                    }
+                }
+            }
+        }
+
+        if (writeFailed) {
+            // 失败的写入可能已 rename：缓存失效并递增代数，目录索引留待重建
+            for (const auto& entry : locked) {
+                m_readCache.invalidate(entry.first);
+            }
+            m_generation.bump();
+        } else if (!committed.empty()) {
+            for (size_t i : committed) {
+                m_keyIndex.update(locked[i].first, true);
+            }
+            publish();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            for (size_t i : committed) {
+                // 落盘期间被再次 save 的 key 保持脏
+                auto it = m_pending.find(locked[i].first);
+                if (it != m_pending.end() && it->second == locked[i].second) {
+                    m_pending.erase(it);
+                    m_flushPolicy.clearDirty(locked[i].first);
+                }
+            }
+        }
+
+        for (const auto& entry : locked) {
+            m_fileLock.release(entry.first);
+        }
+        return failedKey.empty();
+    }
 };
 
 Store Store::open(const std::string& serviceName, const std::string& storeRoot) {
@@ -172,24 +884,197 @@ Store Store::open(const std::string& serviceName, const std::string& storeRoot)
     return store;
 }
 
+Store Store::open(const std::string& serviceName, const std::string& storeRoot,
+                  const StoreOptions& options) {
+    Store store;
+    store.m_impl.reset(new Impl(serviceName, storeRoot, options));
+    return store;
+}
+
+// ============================================================
+// Store::WriteBatch
+// ============================================================
+class Store::WriteBatch::Impl {
+public:
+    Store::Impl* store = nullptr;
+    std::vector<Mutation> mutations;
+    std::map<std::string, size_t> positions;    // key → mutations 下标
+
+    void record(const std::string& key, std::string value, bool remove) {
+        auto it = positions.find(key);
+        if (it != positions.end()) {
+            mutations[it->second].value = std::move(value);
+            mutations[it->second].remove = remove;
+            return;
+        }
+        positions.emplace(key, mutations.size());
+        Mutation mutation;
+        mutation.key = key;
+        mutation.value = std::move(value);
+        mutation.remove = remove;
+        mutations.push_back(std::move(mutation));
+    }
+};
+
+Store::WriteBatch::WriteBatch(Store::Impl* store)
+    : m_impl(new Impl())
+{
+    m_impl->store = store;
+}
+
+Store::WriteBatch::~WriteBatch() = default;
+Store::WriteBatch::WriteBatch(WriteBatch&& other) = default;
+Store::WriteBatch& Store::WriteBatch::operator=(WriteBatch&& other) = default;
+
+void Store::WriteBatch::putEncoded(const std::string& key, uint8_t typeTag, CodecWriter& writer) {
+    if (!Serializer::seal(typeTag, writer.buffer())) {
+        throw StoreException(StoreError::kSerializationFailed,
+                             "Failed to serialize value", key);
+    }
+    m_impl->record(key, std::move(writer.buffer()), false);
+}
+
+Store::WriteBatch& Store::WriteBatch::remove(const std::string& key) {
+    m_impl->record(key, std::string(), true);
+    return *this;
+}
+
+size_t Store::WriteBatch::size() const {
+    return m_impl->mutations.size();
+}
+
+void Store::WriteBatch::clear() {
+    m_impl->mutations.clear();
+    m_impl->positions.clear();
+}
+
+void Store::WriteBatch::commit() {
+    m_impl->store->commitBatch(m_impl->mutations);
+    clear();
+}
+
+// ============================================================
+// Store
+// ============================================================
 Store::Store() = default;
 Store::~Store() = default;
 Store::Store(Store&& other) = default;
 Store& Store::operator=(Store&& other) = default;
 
-template<typename T>
-void Store::save(const std::string& key, const T& value) {
-    m_impl->save<T>(key, value);
+void Store::saveEncoded(const std::string& key, uint8_t typeTag, CodecWriter& writer) {
+    if (!Serializer::seal(typeTag, writer.buffer())) {
+        throw StoreException(StoreError::kSerializationFailed,
+                             "Failed to serialize value", key);
+    }
+    m_impl->save(key, std::move(writer.buffer()));
+}
+
+namespace {
+
+// future 形式：回调只调用一次
+Store::AsyncCallback promiseCallback(const std::shared_ptr<std::promise<void>>& promise) {
+    return [promise](const StoreErrorInfo* error) {
+        if (error == nullptr) {
+            promise->set_value();
+        } else {
+            promise->set_exception(std::make_exception_ptr(
+                StoreException(error->code, error->message, error->key)));
+        }
+    };
+}
+
+} // namespace
+
+std::future<void> Store::saveAsyncEncoded(const std::string& key, uint8_t typeTag, CodecWriter& writer) {
+    auto promise = std::make_shared<std::promise<void>>();
+    std::future<void> future = promise->get_future();
+    saveAsyncEncoded(key, typeTag, writer, promiseCallback(promise));
+    return future;
+}
+
+void Store::saveAsyncEncoded(const std::string& key, uint8_t typeTag, CodecWriter& writer,
+                             AsyncCallback done) {
+    if (!Serializer::seal(typeTag, writer.buffer())) {
+        throw StoreException(StoreError::kSerializationFailed,
+                             "Failed to serialize value", key);
+    }
+    m_impl->enqueue(key, std::move(writer.buffer()), false, std::move(done));
+}
+
+std::future<void> Store::removeAsync(const std::string& key) {
+    auto promise = std::make_shared<std::promise<void>>();
+    std::future<void> future = promise->get_future();
+    removeAsync(key, promiseCallback(promise));
+    return future;
+}
+
+void Store::removeAsync(const std::string& key, AsyncCallback done) {
+    m_impl->enqueue(key, std::string(), true, std::move(done));
+}
+
+void Store::loadDecoded(const std::string& key, const detail::CodecTarget& target) const {
+    m_impl->loadInto(key, target);
+}
+
+template<>
+int Store::load<int>(const std::string& key) const {
+    return m_impl->load<int>(key);
+}
+
+template<>
+double Store::load<double>(const std::string& key) const {
+    return m_impl->load<double>(key);
+}
+
+template<>
+bool Store::load<bool>(const std::string& key) const {
+    return m_impl->load<bool>(key);
+}
+
+template<>
+std::string Store::load<std::string>(const std::string& key) const {
+    return m_impl->load<std::string>(key);
+}
+
+namespace {
+
+// loadInto(key, buffer, capacity) 的解码目标
+struct RawBuffer {
+    void* data;
+    size_t capacity;
+    size_t size;
+    bool tooSmall;
+};
+
+bool decodeRawBuffer(CodecReader& reader, void* object) {
+    RawBuffer* buffer = static_cast<RawBuffer*>(object);
+    buffer->size = reader.remaining();
+    if (buffer->size > buffer->capacity) {
+        buffer->tooSmall = true;
+        return false;
+    }
+    return buffer->size == 0 || reader.read(buffer->data, buffer->size);
 }
 
-template<typename T>
-T Store::load(const std::string& key) const {
-    return m_impl->load<T>(key);
+} // namespace
+
+size_t Store::loadInto(const std::string& key, void* buffer, size_t capacity) const {
+    RawBuffer raw{buffer, capacity, 0, false};
+    detail::CodecTarget target{kTagBytes, &raw, &decodeRawBuffer, nullptr};
+    try {
+        m_impl->loadInto(key, target);
+    } catch (const StoreException&) {
+        if (raw.tooSmall) {
+            throw StoreException(StoreError::kSerializationFailed,
+                                 "Buffer too small: " + std::to_string(raw.size) + " bytes required", key);
+        }
+        throw;
+    }
+    return raw.size;
 }
 
-template<typename T>
-T Store::loadOr(const std::string& key, const T& defaultValue) const {
-    return m_impl->loadOr<T>(key, defaultValue);
+Store::WriteBatch Store::batch() {
+    return WriteBatch(m_impl.get());
 }
 
 bool Store::has(const std::string& key) const {
@@ -212,20 +1097,5 @@ void Store::cleanup() {
     m_impl->cleanup();
 }
 
-template void Store::save<int>(const std::string&, const int&);
-template void Store::save<double>(const std::string&, const double&);
-template void Store::save<bool>(const std::string&, const bool&);
-template void Store::save<std::string>(const std::string&, const std::string&);
-
-template int Store::load<int>(const std::string&) const;
-template double Store::load<double>(const std::string&) const;
-template bool Store::load<bool>(const std::string&) const;
-template std::string Store::load<std::string>(const std::string&) const;
-
-template int Store::loadOr<int>(const std::string&, const int&) const;
-template double Store::loadOr<double>(const std::string&, const double&) const;
-template bool Store::loadOr<bool>(const std::string&, const bool&) const;
-template std::string Store::loadOr<std::string>(const std::string&, const std::string&) const;
-
 } // namespace store
 } // namespace hwyz
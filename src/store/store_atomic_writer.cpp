@@ -46,6 +46,43 @@ bool AtomicWriter::write(const std::string& key, const std::string& data) {
     return true;
 }
 
+bool AtomicWriter::writeBatch(const std::vector<std::pair<std::string, std::string>>& entries) {
+    if (entries.empty()) {
+        return true;
+    }
+
+    // 1. 写入并同步全部临时文件
+    std::vector<std::string> tempPaths;
+    tempPaths.reserve(entries.size());
+    for (const auto& entry : entries) {
+        std::string tempPath = m_pathResolver.getTempPath(entry.first);
+        if (!writeTempFile(tempPath, entry.second) || !syncFile(tempPath)) {
+            std::remove(tempPath.c_str());
+            for (const auto& path : tempPaths) {
+                std::remove(path.c_str());
+            }
+            return false;
+        }
+        tempPaths.push_back(tempPath);
+    }
+
+    // 2. 逐个原子重命名
+    bool ok = true;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (!atomicRename(tempPaths[i], m_pathResolver.getKeyPath(entries[i].first))) {
+            std::remove(tempPaths[i].c_str());
+            ok = false;
+        }
+    }
+
+    // 3. 整批只同步一次目录
+    if (!syncDirectory(m_pathResolver.getStorePath())) {
+        return false;
+    }
+
+    return ok;
+}
+
 bool AtomicWriter::exists(const std::string& key) const {
     std::string filePath = m_pathResolver.getKeyPath(key);
     struct stat st;
@@ -2,6 +2,8 @@
 
 #include "store_path_resolver.h"
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace hwyz {
 namespace store {
@@ -15,6 +17,10 @@ public:
     // 失败时保留原文件
     bool write(const std::string& key, const std::string& data);
 
+    // 批量原子写入：逐个写temp并fsync → 全部rename → 仅一次fsync(dir)
+    // 任一temp失败则全部放弃，原文件不变；rename阶段失败时已重命名的key保留新值
+    bool writeBatch(const std::vector<std::pair<std::string, std::string>>& entries);
+
     // 检查key对应的文件是否存在
     bool exists(const std::string& key) const;
 
@@ -0,0 +1,56 @@
+#include "store_codec.h"
+#include "store_crc32c.h"
+#include <unistd.h>
+#include <cerrno>
+
+namespace hwyz {
+namespace store {
+
+namespace {
+
+bool preadFully(int fd, char* p, size_t size, uint64_t& offset) {
+    while (size > 0) {
+        ssize_t n = ::pread(fd, p, size, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+bool CodecReader::read(void* data, size_t size) {
+    if (size > m_remaining) {
+        return false;
+    }
+    if (m_data == nullptr && m_remaining <= kInlineSize) {
+        // 小值整体读入，之后按内存读取
+        if (!preadFully(m_fd, m_inline, m_remaining, m_offset)) {
+            m_ioError = true;
+            return false;
+        }
+        m_data = m_inline;
+    }
+    if (m_data != nullptr) {
+        std::memcpy(data, m_data, size);
+        m_data += size;
+    } else if (!preadFully(m_fd, static_cast<char*>(data), size, m_offset)) {
+        m_ioError = true;
+        return false;
+    }
+    m_remaining -= size;
+    if (m_checksum) {
+        m_crc = crc32c(data, size, m_crc);
+    }
+    return true;
+}
+
+} // namespace store
+} // namespace hwyz
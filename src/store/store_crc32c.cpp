@@ -0,0 +1,129 @@
+#include "store_crc32c.h"
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+namespace hwyz {
+namespace store {
+
+namespace {
+
+struct Crc32cTable {
+    uint32_t entries[256];
+
+    Crc32cTable() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : (crc >> 1);
+            }
+            entries[i] = crc;
+        }
+    }
+};
+
+const Crc32cTable kTable;
+
+using Crc32cFunc = uint32_t (*)(const uint8_t* p, size_t size, uint32_t crc);
+
+uint32_t crc32cTable(const uint8_t* p, size_t size, uint32_t crc) {
+    for (size_t i = 0; i < size; ++i) {
+        crc = kTable.entries[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+// ============================================================
+// 硬件实现：每条指令处理 8 字节，首尾不足 8 字节的部分逐字节处理。
+// 函数级 target 属性只对该函数启用指令集，整体编译选项不变
+// ============================================================
+#if defined(__x86_64__)
+
+__attribute__((target("sse4.2")))
+uint32_t crc32cHw(const uint8_t* p, size_t size, uint32_t crc) {
+    uint64_t crc64 = crc;
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        p += 8;
+        size -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+    while (size > 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+        --size;
+    }
+    return crc;
+}
+
+Crc32cFunc selectImpl() {
+    return __builtin_cpu_supports("sse4.2") ? crc32cHw : crc32cTable;
+}
+
+#elif defined(__aarch64__) && defined(__linux__)
+
+#if defined(__clang__)
+#define STORE_CRC_TARGET __attribute__((target("crc")))
+#define STORE_CRC32CX __builtin_arm_crc32cd
+#define STORE_CRC32CB __builtin_arm_crc32cb
+#else
+#define STORE_CRC_TARGET __attribute__((target("+crc")))
+#define STORE_CRC32CX __builtin_aarch64_crc32cx
+#define STORE_CRC32CB __builtin_aarch64_crc32cb
+#endif
+
+STORE_CRC_TARGET
+uint32_t crc32cHw(const uint8_t* p, size_t size, uint32_t crc) {
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        crc = STORE_CRC32CX(crc, word);
+        p += 8;
+        size -= 8;
+    }
+    while (size > 0) {
+        crc = STORE_CRC32CB(crc, *p++);
+        --size;
+    }
+    return crc;
+}
+
+Crc32cFunc selectImpl() {
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) ? crc32cHw : crc32cTable;
+}
+
+#else
+
+Crc32cFunc selectImpl() {
+    return crc32cTable;
+}
+
+#endif
+
+Crc32cFunc impl() {
+    static const Crc32cFunc func = selectImpl();
+    return func;
+}
+
+} // namespace
+
+uint32_t crc32c(const void* data, size_t size, uint32_t seed) {
+    return ~impl()(static_cast<const uint8_t*>(data), size, ~seed);
+}
+
+uint32_t crc32cPortable(const void* data, size_t size, uint32_t seed) {
+    return ~crc32cTable(static_cast<const uint8_t*>(data), size, ~seed);
+}
+
+bool crc32cHardware() {
+    return impl() != crc32cTable;
+}
+
+} // namespace store
+} // namespace hwyz
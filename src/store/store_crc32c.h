@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace hwyz {
+namespace store {
+
+// CRC-32C（Castagnoli）；seed 传入上一段的结果可分段累计。
+// 运行时检测 SSE4.2 / ARMv8 CRC 指令，不支持时回退为查表实现
+uint32_t crc32c(const void* data, size_t size, uint32_t seed = 0);
+
+// 查表实现，供测试与基准对照
+uint32_t crc32cPortable(const void* data, size_t size, uint32_t seed = 0);
+
+// 当前进程是否使用硬件 CRC 指令
+bool crc32cHardware();
+
+} // namespace store
+} // namespace hwyz
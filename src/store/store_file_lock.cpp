@@ -1,100 +1,276 @@
 #include "store_file_lock.h"
+#include "store_crc32c.h"
 #include <fcntl.h>
 #include <unistd.h>
-#include <sys/file.h>
-#include <chrono>
-#include <thread>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
 
 namespace hwyz {
 namespace store {
 
-FileLock::FileLock(const PathResolver& pathResolver)
+namespace {
+
+// 截止时间之后每隔该间隔重发信号：信号若在 F_OFD_SETLKW 进入阻塞前到达，下一次仍能打断
+const long kTimerIntervalNs = 10 * 1000 * 1000;
+
+void onTimeoutSignal(int) {}
+
+// 安装不带 SA_RESTART 的空处理函数，使 F_OFD_SETLKW 被信号打断时返回 EINTR；
+// 信号已有其他处理函数时不覆盖
+bool installTimeoutHandler(int signo) {
+    struct sigaction current;
+    if (sigaction(signo, nullptr, &current) != 0) {
+        return false;
+    }
+    if (!(current.sa_flags & SA_SIGINFO) && current.sa_handler == onTimeoutSignal) {
+        return true;
+    }
+    if ((current.sa_flags & SA_SIGINFO) || current.sa_handler != SIG_DFL) {
+        return false;
+    }
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = onTimeoutSignal;
+    sigemptyset(&action.sa_mask);
+    return sigaction(signo, &action, nullptr) == 0;
+}
+
+// 只发给当前线程的一次性定时器；生存期内解除本线程对超时信号的屏蔽
+class WaitTimer {
+public:
+    WaitTimer(int signo, std::chrono::nanoseconds remaining) {
+        sigset_t set;
+        sigemptyset(&set);
+        sigaddset(&set, signo);
+        pthread_sigmask(SIG_UNBLOCK, &set, &m_oldMask);
+
+        struct sigevent event;
+        std::memset(&event, 0, sizeof(event));
+        event.sigev_notify = SIGEV_THREAD_ID;
+        event.sigev_signo = signo;
+        event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+        if (timer_create(CLOCK_MONOTONIC, &event, &m_timer) != 0) {
+            return;
+        }
+        m_created = true;
+
+        long long ns = std::max<long long>(remaining.count(), 1);
+        struct itimerspec spec;
+        spec.it_value.tv_sec = static_cast<time_t>(ns / 1000000000);
+        spec.it_value.tv_nsec = static_cast<long>(ns % 1000000000);
+        spec.it_interval.tv_sec = 0;
+        spec.it_interval.tv_nsec = kTimerIntervalNs;
+        m_armed = (timer_settime(m_timer, 0, &spec, nullptr) == 0);
+    }
+
+    ~WaitTimer() {
+        if (m_created) {
+            timer_delete(m_timer);
+        }
+        pthread_sigmask(SIG_SETMASK, &m_oldMask, nullptr);
+    }
+
+    bool armed() const { return m_armed; }
+
+private:
+    timer_t m_timer;
+    bool m_created = false;
+    bool m_armed = false;
+    sigset_t m_oldMask;
+};
+
+bool isContended(int error) {
+    return error == EAGAIN || error == EACCES;
+}
+
+} // namespace
+
+FileLock::FileLock(const PathResolver& pathResolver, int timeoutSignal)
     : m_pathResolver(pathResolver)
+    , m_timeoutSignal(timeoutSignal)
 {
 }
 
 FileLock::~FileLock() {
-    for (auto& pair : m_lockFds) {
-        releaseFileLock(pair.second);
+    // 关闭即释放该打开文件描述上的全部 OFD 锁
+    if (m_fd >= 0) {
+        close(m_fd);
     }
-    m_lockFds.clear();
 }
 
 bool FileLock::acquire(const std::string& key, uint32_t timeoutMs) {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    if (!openLockFile()) {
+        return false;
+    }
+
+    uint32_t index = slotOf(key);
+    Stripe& stripe = stripeOf(index);
+    std::unique_lock<std::shared_mutex> lock(stripe.mutex);
 
-    if (m_lockFds.find(key) != m_lockFds.end()) {
+    auto owner = stripe.owners.find(key);
+    if (owner != stripe.owners.end() && owner->second == std::this_thread::get_id()) {
         return true;
     }
 
-    std::string lockPath = getLockFilePath(key);
-    int fd = -1;
-
-    if (timeoutMs == 0) {
-        if (!tryFileLock(lockPath, fd)) {
+    // 进程内：同一 key 排队
+    while (stripe.owners.find(key) != stripe.owners.end()) {
+        if (timeoutMs == 0 || Clock::now() >= deadline) {
             return false;
         }
-    } else {
-        auto start = std::chrono::steady_clock::now();
-        while (!tryFileLock(lockPath, fd)) {
-            auto now = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
-            if (elapsed >= timeoutMs) {
-                return false;
+        stripe.changed.wait_until(lock, deadline);
+    }
+    stripe.owners[key] = std::this_thread::get_id();
+
+    // 跨进程：槽位字节锁，同一槽位只由一个线程去获取
+    Slot& slot = stripe.slots[index];
+    ++slot.holders;
+    while (!slot.locked) {
+        if (!slot.acquiring) {
+            slot.acquiring = true;
+            lock.unlock();
+            bool locked = lockSlot(index, timeoutMs, deadline);
+            lock.lock();
+            slot.acquiring = false;
+            slot.locked = locked;
+            stripe.changed.notify_all();
+            if (!locked) {
+                break;
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        } else if (timeoutMs == 0 || Clock::now() >= deadline) {
+            break;
+        } else {
+            stripe.changed.wait_until(lock, deadline);
         }
     }
+    if (slot.locked) {
+        return true;
+    }
 
-    m_lockFds[key] = fd;
-
-    return true;
+    stripe.owners.erase(key);
+    dropSlot(stripe, index);
+    stripe.changed.notify_all();
+    return false;
 }
 
 void FileLock::release(const std::string& key) {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t index = slotOf(key);
+    Stripe& stripe = stripeOf(index);
+    std::lock_guard<std::shared_mutex> lock(stripe.mutex);
 
-    auto it = m_lockFds.find(key);
-    if (it == m_lockFds.end()) {
+    auto it = stripe.owners.find(key);
+    if (it == stripe.owners.end() || it->second != std::this_thread::get_id()) {
         return;
     }
-
-    releaseFileLock(it->second);
-    m_lockFds.erase(it);
-
-    std::string lockPath = getLockFilePath(key);
-    unlink(lockPath.c_str());
+    stripe.owners.erase(it);
+    dropSlot(stripe, index);
+    stripe.changed.notify_all();
 }
 
 bool FileLock::isHeld(const std::string& key) const {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return m_lockFds.find(key) != m_lockFds.end();
+    const Stripe& stripe = m_stripes[slotOf(key) % kStripeCount];
+    std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+    return stripe.owners.find(key) != stripe.owners.end();
+}
+
+uint32_t FileLock::slotOf(const std::string& key) {
+    return crc32c(key.data(), key.size()) % kSlotCount;
 }
 
-std::string FileLock::getLockFilePath(const std::string& key) const {
-    return m_pathResolver.getKeyPath(key) + ".lock";
+bool FileLock::lockOrder(const std::string& a, const std::string& b) {
+    uint32_t slotA = slotOf(a);
+    uint32_t slotB = slotOf(b);
+    return slotA != slotB ? slotA < slotB : a < b;
 }
 
-bool FileLock::tryFileLock(const std::string& lockPath, int& fd) {
-    fd = open(lockPath.c_str(), O_CREAT | O_RDWR, 0600);
+bool FileLock::openLockFile() {
+    if (m_fd.load(std::memory_order_acquire) >= 0) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(m_openMutex);
+    if (m_fd.load(std::memory_order_relaxed) >= 0) {
+        return true;
+    }
+    std::string lockPath = m_pathResolver.getStorePath() + ".lock";
+    int fd = open(lockPath.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0600);
     if (fd < 0) {
         return false;
     }
+    m_fd.store(fd, std::memory_order_release);
+    return true;
+}
+
+bool FileLock::lockSlot(uint32_t slot, uint32_t timeoutMs, Clock::time_point deadline) {
+    struct flock range;
+    std::memset(&range, 0, sizeof(range));
+    range.l_type = F_WRLCK;
+    range.l_whence = SEEK_SET;
+    range.l_start = static_cast<off_t>(slot);
+    range.l_len = 1;
 
-    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
-        close(fd);
-        fd = -1;
+    if (fcntl(m_fd, F_OFD_SETLK, &range) == 0) {
+        return true;
+    }
+    if (!isContended(errno) || timeoutMs == 0) {
         return false;
     }
 
-    return true;
+    if (m_timeoutSignal != 0 && installTimeoutHandler(m_timeoutSignal)) {
+        WaitTimer timer(m_timeoutSignal, deadline - Clock::now());
+        if (timer.armed()) {
+            while (true) {
+                if (fcntl(m_fd, F_OFD_SETLKW, &range) == 0) {
+                    return true;
+                }
+                if (errno != EINTR || Clock::now() >= deadline) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    // 未指定超时信号或信号不可用：重试
+    while (Clock::now() < deadline) {
+        usleep(1000);
+        if (fcntl(m_fd, F_OFD_SETLK, &range) == 0) {
+            return true;
+        }
+        if (!isContended(errno)) {
+            return false;
+        }
+    }
+    return false;
 }
 
-void FileLock::releaseFileLock(int fd) {
-    if (fd >= 0) {
-        flock(fd, LOCK_UN);
-        close(fd);
+void FileLock::unlockSlot(uint32_t slot) {
+    struct flock range;
+    std::memset(&range, 0, sizeof(range));
+    range.l_type = F_UNLCK;
+    range.l_whence = SEEK_SET;
+    range.l_start = static_cast<off_t>(slot);
+    range.l_len = 1;
+    fcntl(m_fd, F_OFD_SETLK, &range);
+}
+
+void FileLock::dropSlot(Stripe& stripe, uint32_t slot) {
+    auto it = stripe.slots.find(slot);
+    if (it == stripe.slots.end() || --it->second.holders > 0) {
+        return;
+    }
+    // 持条带锁解锁：避免同一槽位被重新加锁后又被这里解开
+    if (it->second.locked) {
+        unlockSlot(slot);
     }
+    stripe.slots.erase(it);
 }
 
 } // namespace store
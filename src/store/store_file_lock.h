@@ -3,29 +3,90 @@
 #include "store_path_resolver.h"
 #include <string>
 #include <mutex>
-#include <map>
+#include <shared_mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <chrono>
 
 namespace hwyz {
 namespace store {
 
+// ============================================================
+// FileLock — key 级多进程/多线程互斥
+//
+// 每个存储目录一个常驻锁文件 .lock，不随加解锁创建或删除。
+// key 经 CRC32C 映射到 kSlotCount 个字节槽位之一，跨进程用 OFD 字节锁
+// （F_OFD_SETLK / F_OFD_SETLKW）锁住该字节；同一进程内按 key 排队，
+// 多个 key 落在同一槽位时共享这一个字节锁。
+//
+// 进程内状态按槽位分到 kStripeCount 个条带，每个条带有自己的读写锁与
+// 条件变量：条带锁只在登记持有者时短暂持有，等待期间释放，不同条带的
+// key 互不影响；isHeld 只取共享锁。
+//
+// 进程内等待为 condition_variable 定时等待。跨进程等待默认以 F_OFD_SETLK
+// 每 1ms 重试；构造时指定 timeoutSignal 后改为阻塞的 F_OFD_SETLKW，超时由
+// 线程级 POSIX 定时器发送该信号打断。此时本类为该信号安装空处理函数；
+// 进程已为其设置其他处理函数时不覆盖，仍退化为重试。
+// ============================================================
 class FileLock {
 public:
-    FileLock(const PathResolver& pathResolver);
+    static const uint32_t kSlotCount = 4096;
+    static const uint32_t kStripeCount = 64;
+
+    // timeoutSignal 为 0 时不使用信号
+    explicit FileLock(const PathResolver& pathResolver, int timeoutSignal = 0);
     ~FileLock();
 
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+    // timeoutMs 为 0 时只尝试一次
     bool acquire(const std::string& key, uint32_t timeoutMs = 0);
+
+    // 只有加锁的线程可以释放
     void release(const std::string& key);
+
+    // 本进程是否有线程持有该 key
     bool isHeld(const std::string& key) const;
 
+    static uint32_t slotOf(const std::string& key);
+
+    // 多 key 加锁顺序：先按槽位再按 key。同槽位的不同 key 共用一把字节锁，
+    // 只按 key 排序时两个批次可能以相反顺序获取同一组槽位而互相等待
+    static bool lockOrder(const std::string& a, const std::string& b);
+
 private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Slot {
+        uint32_t holders = 0;       // 本进程持有或正在获取该槽位的 key 数
+        bool locked = false;        // 已持有 OFD 字节锁
+        bool acquiring = false;     // 某线程正在等待 OFD 字节锁
+    };
+
+    // 同一槽位的 key 总在同一条带
+    struct alignas(64) Stripe {
+        mutable std::shared_mutex mutex;
+        std::condition_variable_any changed;
+        std::unordered_map<std::string, std::thread::id> owners;   // key → 持有线程
+        std::unordered_map<uint32_t, Slot> slots;
+    };
+
     const PathResolver& m_pathResolver;
+    const int m_timeoutSignal;
+
+    Stripe m_stripes[kStripeCount];
 
-    mutable std::mutex m_mutex;
-    std::map<std::string, int> m_lockFds;
+    std::mutex m_openMutex;
+    std::atomic<int> m_fd{-1};
 
-    std::string getLockFilePath(const std::string& key) const;
-    bool tryFileLock(const std::string& lockPath, int& fd);
-    void releaseFileLock(int fd);
+    Stripe& stripeOf(uint32_t slot) { return m_stripes[slot % kStripeCount]; }
+    bool openLockFile();
+    bool lockSlot(uint32_t slot, uint32_t timeoutMs, Clock::time_point deadline);
+    void unlockSlot(uint32_t slot);
+    void dropSlot(Stripe& stripe, uint32_t slot);   // 须持有条带锁
 };
 
 } // namespace store
@@ -1,4 +1,5 @@
 #include "store_flush_policy.h"
+#include <algorithm>
 
 namespace hwyz {
 namespace store {
@@ -11,9 +12,16 @@ FlushPolicy::FlushPolicy(const FlushPolicyConfig& config)
 void FlushPolicy::markDirty(const std::string& key) {
     std::lock_guard<std::mutex> lock(m_mutex);
 
-    auto& entry = m_dirtyEntries[key];
-    entry.dirty = true;
-    entry.lastDirtyTime = std::chrono::steady_clock::now();
+    auto now = std::chrono::steady_clock::now();
+    auto it = m_dirtyEntries.find(key);
+    if (it == m_dirtyEntries.end() || !it->second.dirty) {
+        DirtyEntry& entry = m_dirtyEntries[key];
+        entry.dirty = true;
+        entry.firstDirtyTime = now;
+        entry.lastDirtyTime = now;
+        return;
+    }
+    it->second.lastDirtyTime = now;
 }
 
 void FlushPolicy::clearDirty(const std::string& key) {
@@ -65,6 +73,33 @@ bool FlushPolicy::shouldFlush() const {
     return false;
 }
 
+bool FlushPolicy::nextFlushTime(std::chrono::steady_clock::time_point& when) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t dirtyCount = 0;
+    bool found = false;
+    for (const auto& pair : m_dirtyEntries) {
+        if (!pair.second.dirty) {
+            continue;
+        }
+        dirtyCount++;
+        if (m_config.enableDebounce) {
+            auto deadline = debounceDeadline(pair.second);
+            if (!found || deadline < when) {
+                when = deadline;
+                found = true;
+            }
+        }
+    }
+
+    // 已达到阈值：立即刷新
+    if (dirtyCount > 0 && dirtyCount >= m_config.maxDirtyCount) {
+        when = std::chrono::steady_clock::now();
+        return true;
+    }
+    return found;
+}
+
 std::vector<std::string> FlushPolicy::getDirtyKeys() const {
     std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -83,11 +118,16 @@ void FlushPolicy::reset() {
 }
 
 bool FlushPolicy::checkDebounce(const DirtyEntry& entry) const {
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now - entry.lastDirtyTime).count();
+    return std::chrono::steady_clock::now() >= debounceDeadline(entry);
+}
+
+std::chrono::steady_clock::time_point FlushPolicy::debounceDeadline(const DirtyEntry& entry) const {
+    auto debounced = entry.lastDirtyTime + std::chrono::milliseconds(m_config.debounceMs);
 
-    return (elapsed >= m_config.debounceMs);
+    // 持续更新的 key 去抖永不到期：距首次标脏超过 maxDelayMs 也要落盘
+    uint32_t maxDelayMs = m_config.maxDelayMs > 0 ? m_config.maxDelayMs : m_config.debounceMs;
+    auto delayed = entry.firstDirtyTime + std::chrono::milliseconds(maxDelayMs);
+    return std::min(debounced, delayed);
 }
 
 } // namespace store
@@ -27,6 +27,9 @@ public:
     // 检查是否应该刷新
     bool shouldFlush() const;
 
+    // 最早满足 shouldFlush() 的时刻；没有脏条目，或只能由数量阈值触发时返回 false
+    bool nextFlushTime(std::chrono::steady_clock::time_point& when) const;
+
     // 获取所有脏key
     std::vector<std::string> getDirtyKeys() const;
 
@@ -40,12 +43,16 @@ private:
     // 脏条目跟踪
     struct DirtyEntry {
         bool dirty;
+        std::chrono::steady_clock::time_point firstDirtyTime;   // 本轮首次标脏
         std::chrono::steady_clock::time_point lastDirtyTime;
     };
     std::map<std::string, DirtyEntry> m_dirtyEntries;
 
     // 检查去抖时间
     bool checkDebounce(const DirtyEntry& entry) const;
+
+    // 条目的去抖 / 最长等待到期时刻
+    std::chrono::steady_clock::time_point debounceDeadline(const DirtyEntry& entry) const;
 };
 
 } // namespace store
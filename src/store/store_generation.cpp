@@ -0,0 +1,66 @@
+#include "store_generation.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace hwyz {
+namespace store {
+
+Generation::Generation(const PathResolver& pathResolver)
+    : m_pathResolver(pathResolver)
+{
+}
+
+Generation::~Generation() {
+    close();
+}
+
+bool Generation::open() {
+    close();
+
+    std::string path = m_pathResolver.getStorePath() + ".generation";
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        (st.st_size < static_cast<off_t>(sizeof(uint64_t)) && ftruncate(fd, sizeof(uint64_t)) != 0)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* base = mmap(nullptr, sizeof(uint64_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    m_value = static_cast<uint64_t*>(base);
+    return true;
+}
+
+void Generation::close() {
+    if (m_value != nullptr) {
+        munmap(m_value, sizeof(uint64_t));
+        m_value = nullptr;
+    }
+}
+
+uint64_t Generation::load() const {
+    if (m_value == nullptr) {
+        return 0;
+    }
+    return __atomic_load_n(m_value, __ATOMIC_ACQUIRE);
+}
+
+uint64_t Generation::bump() {
+    if (m_value == nullptr) {
+        return 0;
+    }
+    return __atomic_add_fetch(m_value, 1, __ATOMIC_ACQ_REL);
+}
+
+} // namespace store
+} // namespace hwyz
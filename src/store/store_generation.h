@@ -0,0 +1,40 @@
+#pragma once
+
+#include "store_path_resolver.h"
+#include <cstdint>
+
+namespace hwyz {
+namespace store {
+
+// ============================================================
+// Generation — 存储目录的共享代数
+//
+// 存储目录下的 .generation 文件（8 字节）以 MAP_SHARED 映射，任何进程经
+// Store 写入或删除 key 后递增。读缓存与目录索引只需比较一次共享内存中的
+// 代数即可判断是否有进程改动过本存储，不需要系统调用。
+// ============================================================
+class Generation {
+public:
+    Generation(const PathResolver& pathResolver);
+    ~Generation();
+
+    Generation(const Generation&) = delete;
+    Generation& operator=(const Generation&) = delete;
+
+    // 映射代数文件；失败时 load() 恒为 0，bump() 无效
+    bool open();
+    void close();
+    bool isOpen() const { return m_value != nullptr; }
+
+    uint64_t load() const;
+
+    // 返回递增后的代数
+    uint64_t bump();
+
+private:
+    const PathResolver& m_pathResolver;
+    uint64_t* m_value = nullptr;
+};
+
+} // namespace store
+} // namespace hwyz
@@ -0,0 +1,290 @@
+#include "store_journal.h"
+#include "store_crc32c.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <atomic>
+#include <algorithm>
+
+namespace hwyz {
+namespace store {
+
+namespace {
+
+const char kJournalMagic[4] = {'T', 'S', 'J', 'N'};
+const uint16_t kJournalVersion = 1;
+const char kJournalPrefix[] = ".journal-";
+
+// 头：magic(4) | version(2) | 保留(2) | count(4)
+const size_t kJournalHeaderSize = 12;
+// 条目头：op(1) | 保留(1) | keyLen(2) | valueLen(4)
+const size_t kEntryHeaderSize = 8;
+
+const uint8_t kOpPut = 1;
+const uint8_t kOpRemove = 2;
+
+std::atomic<uint32_t> g_journalSeq{0};
+
+void putU16(std::string& out, uint16_t v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+void putU32(std::string& out, uint32_t v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+
+template<typename T>
+T getLE(const char* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+bool writeFile(const std::string& path, const std::string& data, int flags, bool sync) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | flags, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    const char* p = data.data();
+    size_t left = data.size();
+    while (left > 0) {
+        ssize_t n = ::write(fd, p, left);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            ::close(fd);
+            return false;
+        }
+        p += n;
+        left -= static_cast<size_t>(n);
+    }
+    bool ok = true;
+    if (sync) {
+        ok = fdatasync(fd) == 0;
+    } else {
+        // 只发起回写不等待，之后的 fdatasync 与其他文件的回写并行
+        sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+    }
+    ::close(fd);
+    return ok;
+}
+
+bool syncDirectory(const std::string& dirPath) {
+    int fd = ::open(dirPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    int result = fsync(fd);
+    ::close(fd);
+    return (result == 0);
+}
+
+} // namespace
+
+Journal::Journal(const PathResolver& pathResolver)
+    : m_pathResolver(pathResolver)
+{
+}
+
+Journal::Result Journal::commit(const std::vector<Mutation>& mutations) {
+    if (mutations.empty()) {
+        return Result::kCommitted;
+    }
+
+    // 1. journal 落盘：此后的任何掉电都能前滚
+    std::string storePath = m_pathResolver.getStorePath();
+    std::string journalPath = storePath + kJournalPrefix + std::to_string(getpid()) + "-" +
+                              std::to_string(g_journalSeq.fetch_add(1));
+    if (!writeFile(journalPath, encode(mutations), O_EXCL, true)) {
+        std::remove(journalPath.c_str());
+        return Result::kAborted;
+    }
+    if (!syncDirectory(storePath)) {
+        std::remove(journalPath.c_str());
+        return Result::kAborted;
+    }
+
+    // 2~4. 失败时重试一次；仍失败则保留 journal
+    if (rollForward(mutations, journalPath) || rollForward(mutations, journalPath)) {
+        return Result::kCommitted;
+    }
+    return Result::kPending;
+}
+
+bool Journal::rollForward(const std::vector<Mutation>& mutations, const std::string& journalPath) const {
+    // 2~3. 应用并一次性同步
+    if (!apply(mutations) || !syncStore(mutations)) {
+        return false;
+    }
+    // 4. 删除 journal 必须落盘，否则掉电后会用旧批次覆盖更新的值
+    if (std::remove(journalPath.c_str()) != 0 && errno != ENOENT) {
+        return false;
+    }
+    return syncDirectory(m_pathResolver.getStorePath());
+}
+
+size_t Journal::recover(FileLock& fileLock, bool* stuck) {
+    std::string storePath = m_pathResolver.getStorePath();
+    std::vector<std::string> journals;
+    DIR* dir = opendir(storePath.c_str());
+    if (dir == nullptr) {
+        return 0;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (std::strncmp(entry->d_name, kJournalPrefix, sizeof(kJournalPrefix) - 1) == 0) {
+            journals.push_back(storePath + entry->d_name);
+        }
+    }
+    closedir(dir);
+
+    size_t replayed = 0;
+    for (const auto& path : journals) {
+        std::vector<Mutation> mutations;
+        if (!decode(path, mutations)) {
+            // 写 journal 时掉电：批次尚未应用，丢弃即可。
+            // 其他进程正在写入的 journal 同样校验失败，只清理一分钟前的残留
+            struct stat st;
+            if (stat(path.c_str(), &st) == 0 && time(nullptr) - st.st_mtime > 60) {
+                std::remove(path.c_str());
+            }
+            continue;
+        }
+
+        // 提交方仍持有锁：由其自行完成
+        std::vector<std::string> keys;
+        for (const auto& mutation : mutations) {
+            keys.push_back(mutation.key);
+        }
+        std::sort(keys.begin(), keys.end(), FileLock::lockOrder);
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        std::vector<std::string> locked;
+        for (const auto& key : keys) {
+            if (!fileLock.acquire(key, 0)) {
+                break;
+            }
+            locked.push_back(key);
+        }
+
+        // 加锁后重新读取：提交方可能已完成并删除
+        if (locked.size() == keys.size() && decode(path, mutations)) {
+            if (rollForward(mutations, path)) {
+                ++replayed;
+            } else if (stuck != nullptr) {
+                *stuck = true;
+            }
+        }
+        for (const auto& key : locked) {
+            fileLock.release(key);
+        }
+    }
+    return replayed;
+}
+
+std::string Journal::encode(const std::vector<Mutation>& mutations) const {
+    std::string data(kJournalMagic, sizeof(kJournalMagic));
+    putU16(data, kJournalVersion);
+    putU16(data, 0);
+    putU32(data, static_cast<uint32_t>(mutations.size()));
+    for (const auto& mutation : mutations) {
+        data.push_back(static_cast<char>(mutation.remove ? kOpRemove : kOpPut));
+        data.push_back('\0');
+        putU16(data, static_cast<uint16_t>(mutation.key.size()));
+        putU32(data, static_cast<uint32_t>(mutation.value.size()));
+        data.append(mutation.key);
+        data.append(mutation.value);
+    }
+    putU32(data, crc32c(data.data(), data.size()));
+    return data;
+}
+
+bool Journal::decode(const std::string& path, std::vector<Mutation>& mutations) const {
+    mutations.clear();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    std::string data;
+    char buffer[65536];
+    ssize_t n;
+    while ((n = ::read(fd, buffer, sizeof(buffer))) > 0) {
+        data.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+
+    if (data.size() < kJournalHeaderSize + 4) {
+        return false;
+    }
+    size_t bodySize = data.size() - 4;
+    const char* p = data.data();
+    if (crc32c(p, bodySize) != getLE<uint32_t>(p + bodySize) ||
+        std::memcmp(p, kJournalMagic, sizeof(kJournalMagic)) != 0 ||
+        getLE<uint16_t>(p + 4) != kJournalVersion) {
+        return false;
+    }
+
+    uint32_t count = getLE<uint32_t>(p + 8);
+    size_t pos = kJournalHeaderSize;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (pos + kEntryHeaderSize > bodySize) {
+            return false;
+        }
+        uint8_t op = static_cast<uint8_t>(p[pos]);
+        uint16_t keyLen = getLE<uint16_t>(p + pos + 2);
+        uint32_t valueLen = getLE<uint32_t>(p + pos + 4);
+        pos += kEntryHeaderSize;
+        if (pos + keyLen + valueLen > bodySize || keyLen == 0) {
+            return false;
+        }
+        Mutation mutation;
+        mutation.key.assign(p + pos, keyLen);
+        mutation.value.assign(p + pos + keyLen, valueLen);
+        mutation.remove = (op == kOpRemove);
+        mutations.push_back(std::move(mutation));
+        pos += keyLen + valueLen;
+    }
+    return pos == bodySize;
+}
+
+bool Journal::apply(const std::vector<Mutation>& mutations) const {
+    for (const auto& mutation : mutations) {
+        std::string finalPath = m_pathResolver.getKeyPath(mutation.key);
+        if (mutation.remove) {
+            if (std::remove(finalPath.c_str()) != 0 && errno != ENOENT) {
+                return false;
+            }
+            continue;
+        }
+        std::string tempPath = m_pathResolver.getTempPath(mutation.key);
+        if (!writeFile(tempPath, mutation.value, O_TRUNC, false) ||
+            rename(tempPath.c_str(), finalPath.c_str()) != 0) {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Journal::syncStore(const std::vector<Mutation>& mutations) const {
+    // 只同步本批写入的文件与一次目录项，不波及文件系统上的其他写入。
+    // 调用方持有这些 key 的锁，按最终路径重新打开即为刚 rename 的文件
+    for (const auto& mutation : mutations) {
+        if (mutation.remove) {
+            continue;
+        }
+        int fd = ::open(m_pathResolver.getKeyPath(mutation.key).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        int result = fdatasync(fd);
+        ::close(fd);
+        if (result != 0) {
+            return false;
+        }
+    }
+    return syncDirectory(m_pathResolver.getStorePath());
+}
+
+} // namespace store
+} // namespace hwyz
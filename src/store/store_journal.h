@@ -0,0 +1,56 @@
+#pragma once
+
+#include "store_types.h"
+#include "store_path_resolver.h"
+#include "store_file_lock.h"
+#include <string>
+#include <vector>
+
+namespace hwyz {
+namespace store {
+
+// ============================================================
+// Journal — 文件级存储的多 key 原子提交
+//
+// 提交流程（共 N + 4 次同步，N 为本批写入的文件数；只同步本批涉及的文件，
+// 以随批量线性增长的 fdatasync 换取不波及同一文件系统上的其他写入）：
+//   1. 全部变更写入 .journal-<pid>-<seq>，fdatasync + fsync(dir)
+//   2. 逐个写 temp → rename / unlink，写入时发起回写（sync_file_range）但不等待
+//   3. 逐个 fdatasync 本批写入的文件（回写已并行进行），再 fsync(dir) 一次
+//   4. 删除 journal，fsync(dir)
+// 第 2、3 步中掉电时 journal 完整（CRC32C 校验通过），打开存储时重放；
+// 第 1 步中掉电时 journal 校验失败，直接丢弃，原值不变。
+// 第 2~4 步出错时先重试一次；仍失败则 journal 留在磁盘上，下次打开时会重放，
+// 在此之前对这些 key 的写入都会被覆盖，调用方须停止写入。
+//
+// 调用方负责在提交期间持有所有相关 key 的文件锁。
+// ============================================================
+class Journal {
+public:
+    Journal(const PathResolver& pathResolver);
+    ~Journal() = default;
+
+    enum class Result : uint8_t {
+        kCommitted = 0,
+        kAborted = 1,       // journal 未落盘，未做任何修改
+        kPending = 2        // 变更可能已部分应用，journal 保留到下次 recover() 前滚
+    };
+
+    Result commit(const std::vector<Mutation>& mutations);
+
+    // 重放存储目录中遗留的 journal；正被其他进程提交（锁未释放）的跳过。
+    // 返回重放的 journal 数量；stuck 非空时报告是否有可重放却前滚失败的 journal
+    size_t recover(FileLock& fileLock, bool* stuck = nullptr);
+
+private:
+    const PathResolver& m_pathResolver;
+
+    std::string encode(const std::vector<Mutation>& mutations) const;
+    bool decode(const std::string& path, std::vector<Mutation>& mutations) const;
+    bool apply(const std::vector<Mutation>& mutations) const;
+    bool syncStore(const std::vector<Mutation>& mutations) const;
+    bool rollForward(const std::vector<Mutation>& mutations, const std::string& journalPath) const;
+};
+
+} // namespace store
+} // namespace hwyz
@@ -0,0 +1,112 @@
+#include "store_key_index.h"
+#include <dirent.h>
+#include <mutex>
+
+namespace hwyz {
+namespace store {
+
+namespace {
+
+const char kKeySuffix[] = ".dat";
+const size_t kKeySuffixSize = sizeof(kKeySuffix) - 1;
+
+} // namespace
+
+KeyIndex::KeyIndex(const PathResolver& pathResolver, const Generation& generation)
+    : m_pathResolver(pathResolver)
+    , m_generation(generation)
+{
+}
+
+bool KeyIndex::open() {
+    std::lock_guard<std::shared_mutex> lock(m_mutex);
+    m_enabled = m_generation.isOpen();
+    if (m_enabled) {
+        rebuild();
+    }
+    return m_enabled;
+}
+
+void KeyIndex::close() {
+    std::lock_guard<std::shared_mutex> lock(m_mutex);
+    m_enabled = false;
+    m_keys.clear();
+    m_indexed = 0;
+}
+
+bool KeyIndex::contains(const std::string& key) {
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        if (m_indexed == m_generation.load()) {
+            return m_keys.count(key) > 0;
+        }
+    }
+    std::lock_guard<std::shared_mutex> lock(m_mutex);
+    if (m_indexed != m_generation.load()) {
+        rebuild();
+    }
+    return m_keys.count(key) > 0;
+}
+
+size_t KeyIndex::size() {
+    std::lock_guard<std::shared_mutex> lock(m_mutex);
+    if (m_indexed != m_generation.load()) {
+        rebuild();
+    }
+    return m_keys.size();
+}
+
+std::vector<std::string> KeyIndex::keys() {
+    std::lock_guard<std::shared_mutex> lock(m_mutex);
+    if (m_indexed != m_generation.load()) {
+        rebuild();
+    }
+    return std::vector<std::string>(m_keys.begin(), m_keys.end());
+}
+
+void KeyIndex::update(const std::string& key, bool present) {
+    std::lock_guard<std::shared_mutex> lock(m_mutex);
+    if (present) {
+        m_keys.insert(key);
+    } else {
+        m_keys.erase(key);
+    }
+}
+
+void KeyIndex::published(uint64_t generation) {
+    std::lock_guard<std::shared_mutex> lock(m_mutex);
+    if (m_indexed + 1 == generation) {
+        m_indexed = generation;
+    }
+}
+
+bool KeyIndex::keyOf(const std::string& fileName, std::string& key) {
+    if (fileName.size() < kKeySuffixSize ||
+        fileName.compare(fileName.size() - kKeySuffixSize, kKeySuffixSize, kKeySuffix) != 0) {
+        return false;
+    }
+    key = fileName.substr(0, fileName.size() - kKeySuffixSize);
+    return true;
+}
+
+void KeyIndex::rebuild() {
+    // 先取代数再扫描：扫描期间的写入会让索引在下次查询时再次重建
+    m_indexed = m_generation.load();
+    m_keys.clear();
+
+    DIR* dir = opendir(m_pathResolver.getStorePath().c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    struct dirent* entry;
+    std::string key;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (keyOf(entry->d_name, key)) {
+            m_keys.insert(key);
+        }
+    }
+    closedir(dir);
+}
+
+} // namespace store
+} // namespace hwyz
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "store_path_resolver.h"
+#include "store_generation.h"
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <shared_mutex>
+#include <cstdint>
+
+namespace hwyz {
+namespace store {
+
+// ============================================================
+// KeyIndex — 存储目录中已有 key 的内存索引
+//
+// open 时 readdir 一次建立；本进程的写入与删除直接更新索引，
+// 其他进程的改动经共享代数发现：代数与索引记录的不一致时下次查询重新扫描目录。
+// 命中时只有一次哈希查找与一次共享内存读取，不访问文件系统。
+//
+// 本进程递增代数后调用 published()：索引此前与代数同步则随之前进，
+// 否则说明期间有其他进程写入，保持过期等待重建。
+// 绕过 Store 直接增删 key 文件不会递增代数，索引不可见此类修改。
+// ============================================================
+class KeyIndex {
+public:
+    KeyIndex(const PathResolver& pathResolver, const Generation& generation);
+
+    KeyIndex(const KeyIndex&) = delete;
+    KeyIndex& operator=(const KeyIndex&) = delete;
+
+    // 扫描目录建立索引；代数不可用时索引停用，返回 false
+    bool open();
+    void close();
+    bool enabled() const { return m_enabled; }
+
+    bool contains(const std::string& key);
+    size_t size();
+    std::vector<std::string> keys();
+
+    // 本进程已写入（present）或删除了 key 文件，在递增代数之前调用
+    void update(const std::string& key, bool present);
+    void published(uint64_t generation);
+
+    // 目录中 key 文件名对应的 key；临时文件与其他文件返回 false
+    static bool keyOf(const std::string& fileName, std::string& key);
+
+private:
+    const PathResolver& m_pathResolver;
+    const Generation& m_generation;
+    bool m_enabled = false;
+
+    std::shared_mutex m_mutex;
+    std::unordered_set<std::string> m_keys;
+    uint64_t m_indexed = 0;     // 索引对应的代数
+
+    // 须持有独占锁
+    void rebuild();
+};
+
+} // namespace store
+} // namespace hwyz
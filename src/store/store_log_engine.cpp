@@ -0,0 +1,822 @@
+#include "store_log_engine.h"
+#include "store_crc32c.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+namespace hwyz {
+namespace store {
+
+namespace {
+
+const char kLogMagic[4] = {'T', 'S', 'L', 'G'};
+const char kCheckpointMagic[4] = {'T', 'S', 'C', 'K'};
+const uint16_t kFormatVersion = 1;
+
+// 文件头：magic(4) | version(2) | 保留(2) | fileId(8)
+const size_t kHeaderSize = 16;
+// 记录头：crc(4) | op(1) | 保留(1) | keyLen(2) | valueLen(4)
+const size_t kRecordHeaderSize = 12;
+// 检查点头：magic(4) | version(2) | 保留(2) | fileId(8) | covered(8) | live(8) | garbage(8) | count(4)
+const size_t kCheckpointHeaderSize = 44;
+
+const uint8_t kOpPut = 1;
+const uint8_t kOpDelete = 2;
+const uint8_t kOpBatch = 3;     // value 为若干条内层记录，外层 crc 保证整批要么全在要么全无
+
+const size_t kCompactBufferBytes = 1 << 20;
+
+void putU16(std::string& out, uint16_t v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+void putU32(std::string& out, uint32_t v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+void putU64(std::string& out, uint64_t v) { out.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+
+template<typename T>
+T getLE(const char* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint64_t newFileId() {
+    std::random_device rd;
+    uint64_t id = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    return id ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+std::string encodeHeader(uint64_t fileId) {
+    std::string header(kLogMagic, sizeof(kLogMagic));
+    putU16(header, kFormatVersion);
+    putU16(header, 0);
+    putU64(header, fileId);
+    return header;
+}
+
+void encodeRecord(std::string& out, uint8_t op, const std::string& key, const std::string& value) {
+    size_t start = out.size();
+    putU32(out, 0);
+    out.push_back(static_cast<char>(op));
+    out.push_back('\0');
+    putU16(out, static_cast<uint16_t>(key.size()));
+    putU32(out, static_cast<uint32_t>(value.size()));
+    out.append(key);
+    out.append(value);
+    uint32_t crc = crc32c(out.data() + start + 4, out.size() - start - 4);
+    std::memcpy(&out[start], &crc, sizeof(crc));
+}
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool readAt(int fd, char* data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t n = ::pread(fd, data, size, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+bool syncDirectory(const std::string& dirPath) {
+    int fd = ::open(dirPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    int result = fsync(fd);
+    ::close(fd);
+    return (result == 0);
+}
+
+uint64_t recordSize(uint32_t keyLen, uint32_t valueLen) {
+    return kRecordHeaderSize + keyLen + valueLen;
+}
+
+} // namespace
+
+LogEngine::LogEngine(const PathResolver& pathResolver, const Options& options)
+    : m_pathResolver(pathResolver)
+    , m_options(options)
+{
+}
+
+LogEngine::~LogEngine() {
+    close();
+}
+
+LogEngine::FileHandle::~FileHandle() {
+    ::close(fd);
+}
+
+std::string LogEngine::logPath() const {
+    return m_pathResolver.getStorePath() + "store.log";
+}
+
+std::string LogEngine::checkpointPath() const {
+    return m_pathResolver.getStorePath() + "store.ckpt";
+}
+
+bool LogEngine::open() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_fd >= 0) {
+            return true;
+        }
+
+        int fd = ::open(logPath().c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            return false;
+        }
+        // 独占：同一存储只允许一个进程打开
+        if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        uint64_t fileSize = static_cast<uint64_t>(st.st_size);
+
+        m_file = std::make_shared<FileHandle>(fd);
+        m_fd = fd;
+        m_index.clear();
+        m_liveBytes = 0;
+        m_garbageBytes = 0;
+
+        bool ok = true;
+        if (fileSize < kHeaderSize) {
+            // 新文件，或创建文件头时掉电
+            ok = createLog(fd);
+            fileSize = kHeaderSize;
+        } else {
+            char header[kHeaderSize];
+            ok = readAt(fd, header, kHeaderSize, 0) &&
+                 std::memcmp(header, kLogMagic, sizeof(kLogMagic)) == 0 &&
+                 getLE<uint16_t>(header + 4) == kFormatVersion;
+            if (ok) {
+                m_fileId = getLE<uint64_t>(header + 8);
+            }
+        }
+
+        if (ok) {
+            uint64_t covered = kHeaderSize;
+            if (!loadCheckpoint(fileSize, covered)) {
+                m_index.clear();
+                m_liveBytes = 0;
+                m_garbageBytes = 0;
+                covered = kHeaderSize;
+            }
+            ok = recover(covered, fileSize);
+        }
+
+        if (!ok) {
+            m_file.reset();
+            m_fd = -1;
+            m_index.clear();
+            return false;
+        }
+    }
+
+    if (m_options.background) {
+        m_stopping = false;
+        m_worker = std::thread(&LogEngine::workerLoop, this);
+    }
+    return true;
+}
+
+void LogEngine::close(bool discard) {
+    stopWorker();
+
+    std::lock_guard<std::mutex> maintenance(m_maintenanceMutex);
+    bool dirty = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        dirty = m_fd >= 0 && m_sinceCheckpoint > 0;
+    }
+    // 检查点之后没有追加时沿用现有检查点
+    if (!discard && dirty) {
+        checkpointLocked();
+    }
+
+    std::lock_guard<std::mutex> append(m_appendMutex);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // 正在读取的读者持有旧描述符，读完后关闭
+    m_file.reset();
+    m_fd = -1;
+    m_index.clear();
+    m_liveBytes = 0;
+    m_garbageBytes = 0;
+}
+
+bool LogEngine::isOpen() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_fd >= 0;
+}
+
+bool LogEngine::put(const std::string& key, const std::string& value) {
+    return putBatch({{key, value}});
+}
+
+bool LogEngine::putBatch(const std::vector<std::pair<std::string, std::string>>& entries) {
+    if (entries.empty()) {
+        return true;
+    }
+
+    std::string buffer;
+    for (const auto& entry : entries) {
+        if (entry.first.empty() || entry.first.size() > UINT16_MAX || entry.second.size() > UINT32_MAX) {
+            return false;
+        }
+        encodeRecord(buffer, kOpPut, entry.first, entry.second);
+    }
+
+    bool needsWork = false;
+    {
+        std::lock_guard<std::mutex> append(m_appendMutex);
+        uint64_t offset = 0;
+        if (!appendLocked(buffer, offset)) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& entry : entries) {
+            Location location{offset,
+                              static_cast<uint32_t>(entry.first.size()),
+                              static_cast<uint32_t>(entry.second.size())};
+            apply(m_index, kOpPut, entry.first, location, m_liveBytes, m_garbageBytes);
+            offset += recordSize(location.keyLen, location.valueLen);
+        }
+        m_end = offset;
+        m_sinceCheckpoint += buffer.size();
+        needsWork = needsCompactionLocked() || m_sinceCheckpoint >= m_options.checkpointBytes;
+    }
+
+    if (needsWork) {
+        notifyWorker();
+    }
+    return true;
+}
+
+bool LogEngine::remove(const std::string& key) {
+    bool needsWork = false;
+    {
+        std::lock_guard<std::mutex> append(m_appendMutex);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_fd < 0) {
+                return false;
+            }
+            if (m_index.find(key) == m_index.end()) {
+                return true;
+            }
+        }
+
+        std::string buffer;
+        encodeRecord(buffer, kOpDelete, key, std::string());
+        uint64_t offset = 0;
+        if (!appendLocked(buffer, offset)) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        apply(m_index, kOpDelete, key, Location{offset, static_cast<uint32_t>(key.size()), 0},
+              m_liveBytes, m_garbageBytes);
+        m_end = offset + buffer.size();
+        m_sinceCheckpoint += buffer.size();
+        needsWork = needsCompactionLocked();
+    }
+
+    if (needsWork) {
+        notifyWorker();
+    }
+    return true;
+}
+
+bool LogEngine::commitBatch(const std::vector<Mutation>& mutations) {
+    if (mutations.empty()) {
+        return true;
+    }
+
+    std::string inner;
+    for (const auto& mutation : mutations) {
+        if (mutation.key.empty() || mutation.key.size() > UINT16_MAX || mutation.value.size() > UINT32_MAX) {
+            return false;
+        }
+        encodeRecord(inner, mutation.remove ? kOpDelete : kOpPut, mutation.key,
+                     mutation.remove ? std::string() : mutation.value);
+    }
+    if (inner.size() > UINT32_MAX) {
+        return false;
+    }
+    std::string buffer;
+    encodeRecord(buffer, kOpBatch, std::string(), inner);
+
+    bool needsWork = false;
+    {
+        std::lock_guard<std::mutex> append(m_appendMutex);
+        uint64_t offset = 0;
+        if (!appendLocked(buffer, offset)) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        replay(buffer.data(), buffer.size(), offset, m_index, m_liveBytes, m_garbageBytes);
+        m_end = offset + buffer.size();
+        m_sinceCheckpoint += buffer.size();
+        needsWork = needsCompactionLocked() || m_sinceCheckpoint >= m_options.checkpointBytes;
+    }
+
+    if (needsWork) {
+        notifyWorker();
+    }
+    return true;
+}
+
+int LogEngine::get(const std::string& key, std::string& value) const {
+    std::shared_ptr<const FileHandle> file;
+    Location location;
+    if (int error = locate(key, file, location)) {
+        return error;
+    }
+
+    std::string record(recordSize(location.keyLen, location.valueLen), '\0');
+    if (!readAt(file->fd, &record[0], record.size(), location.offset)) {
+        return EIO;
+    }
+    if (crc32c(record.data() + 4, record.size() - 4) != getLE<uint32_t>(record.data())) {
+        return EIO;
+    }
+    value.assign(record, kRecordHeaderSize + location.keyLen, location.valueLen);
+    return 0;
+}
+
+int LogEngine::read(const std::string& key,
+                    const std::function<int(int fd, uint64_t offset, uint32_t size)>& reader) const {
+    std::shared_ptr<const FileHandle> file;
+    Location location;
+    if (int error = locate(key, file, location)) {
+        return error;
+    }
+    return reader(file->fd, location.offset + kRecordHeaderSize + location.keyLen, location.valueLen);
+}
+
+int LogEngine::locate(const std::string& key, std::shared_ptr<const FileHandle>& file,
+                      Location& location) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file) {
+        return EBADF;
+    }
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        return ENOENT;
+    }
+    // 位置与描述符一并取出，压缩替换文件后二者仍相互对应
+    file = m_file;
+    location = it->second;
+    return 0;
+}
+
+bool LogEngine::contains(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_index.find(key) != m_index.end();
+}
+
+bool LogEngine::compact() {
+    std::lock_guard<std::mutex> maintenance(m_maintenanceMutex);
+
+    // 1. 快照索引；快照之前的文件内容只追加不修改，可在锁外读取
+    std::vector<std::pair<std::string, Location>> live;
+    uint64_t snapshotEnd = 0;
+    std::shared_ptr<const FileHandle> source;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_file) {
+            return false;
+        }
+        live.assign(m_index.begin(), m_index.end());
+        snapshotEnd = m_end;
+        source = m_file;
+    }
+    std::sort(live.begin(), live.end(), [](const auto& a, const auto& b) {
+        return a.second.offset < b.second.offset;
+    });
+
+    // 2. 存活记录顺序复制到新文件
+    std::string tempPath = logPath() + ".compact";
+    int fd = ::open(tempPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    auto abort = [&]() {
+        ::close(fd);
+        std::remove(tempPath.c_str());
+        return false;
+    };
+    flock(fd, LOCK_EX | LOCK_NB);
+
+    uint64_t fileId = newFileId();
+    std::string buffer = encodeHeader(fileId);
+    uint64_t offset = kHeaderSize;
+    Index index;
+    uint64_t liveBytes = 0;
+    uint64_t garbageBytes = 0;
+    bool ok = true;
+    for (const auto& entry : live) {
+        const Location& location = entry.second;
+        size_t size = recordSize(location.keyLen, location.valueLen);
+        size_t start = buffer.size();
+        buffer.resize(start + size);
+        if (!readAt(source->fd, &buffer[start], size, location.offset)) {
+            ok = false;
+            break;
+        }
+        index.emplace(entry.first, Location{offset, location.keyLen, location.valueLen});
+        liveBytes += size;
+        offset += size;
+        if (buffer.size() >= kCompactBufferBytes) {
+            if (!writeAll(fd, buffer.data(), buffer.size())) {
+                ok = false;
+                break;
+            }
+            buffer.clear();
+        }
+    }
+    source.reset();
+    // 主体在锁外同步，持锁期间只同步压缩期间追加的尾部
+    if (!ok || !writeAll(fd, buffer.data(), buffer.size()) || fdatasync(fd) != 0) {
+        return abort();
+    }
+
+    // 3. 持锁补上压缩期间追加的尾部，原子替换；期间没有进行中的追加。
+    //    目录同步也在锁内：放锁后的追加写入新文件，rename 须先持久
+    {
+        std::lock_guard<std::mutex> append(m_appendMutex);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_fd < 0) {
+            return abort();
+        }
+        if (m_end > snapshotEnd) {
+            std::string tail(m_end - snapshotEnd, '\0');
+            if (!readAt(m_fd, &tail[0], tail.size(), snapshotEnd) ||
+                replay(tail.data(), tail.size(), offset, index, liveBytes, garbageBytes) != tail.size() ||
+                !writeAll(fd, tail.data(), tail.size())) {
+                return abort();
+            }
+            offset += tail.size();
+        }
+        if (m_end > snapshotEnd && fdatasync(fd) != 0) {
+            return abort();
+        }
+        if (rename(tempPath.c_str(), logPath().c_str()) != 0) {
+            return abort();
+        }
+        syncDirectory(m_pathResolver.getStorePath());
+
+        m_file = std::make_shared<FileHandle>(fd);
+        m_fd = fd;
+        m_fileId = fileId;
+        m_end = offset;
+        m_index.swap(index);
+        m_liveBytes = liveBytes;
+        m_garbageBytes = garbageBytes;
+    }
+
+    // 4. 旧检查点属于旧文件，立即写新的
+    return checkpointLocked();
+}
+
+bool LogEngine::checkpoint() {
+    std::lock_guard<std::mutex> maintenance(m_maintenanceMutex);
+    return checkpointLocked();
+}
+
+bool LogEngine::checkpointLocked() {
+    std::string data(kCheckpointMagic, sizeof(kCheckpointMagic));
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_fd < 0) {
+            return false;
+        }
+        putU16(data, kFormatVersion);
+        putU16(data, 0);
+        putU64(data, m_fileId);
+        putU64(data, m_end);
+        putU64(data, m_liveBytes);
+        putU64(data, m_garbageBytes);
+        putU32(data, static_cast<uint32_t>(m_index.size()));
+        for (const auto& entry : m_index) {
+            putU16(data, static_cast<uint16_t>(entry.first.size()));
+            putU64(data, entry.second.offset);
+            putU32(data, entry.second.valueLen);
+            data.append(entry.first);
+        }
+        m_sinceCheckpoint = 0;
+    }
+    putU32(data, crc32c(data.data(), data.size()));
+
+    std::string tempPath = checkpointPath() + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = writeAll(fd, data.data(), data.size()) && fdatasync(fd) == 0;
+    ::close(fd);
+    if (!ok || rename(tempPath.c_str(), checkpointPath().c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    syncDirectory(m_pathResolver.getStorePath());
+    return true;
+}
+
+size_t LogEngine::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_index.size();
+}
+
+uint64_t LogEngine::liveBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_liveBytes;
+}
+
+uint64_t LogEngine::garbageBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_garbageBytes;
+}
+
+uint64_t LogEngine::fileBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_end;
+}
+
+bool LogEngine::createLog(int fd) {
+    m_fileId = newFileId();
+    std::string header = encodeHeader(m_fileId);
+    if (ftruncate(fd, 0) != 0 ||
+        pwrite(fd, header.data(), header.size(), 0) != static_cast<ssize_t>(header.size()) ||
+        fdatasync(fd) != 0) {
+        return false;
+    }
+    // 旧检查点（若有）不属于新文件
+    std::remove(checkpointPath().c_str());
+    return syncDirectory(m_pathResolver.getStorePath());
+}
+
+bool LogEngine::loadCheckpoint(uint64_t fileSize, uint64_t& covered) {
+    int fd = ::open(checkpointPath().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kCheckpointHeaderSize + 4) {
+        ::close(fd);
+        return false;
+    }
+    std::string data(static_cast<size_t>(st.st_size), '\0');
+    bool ok = readAt(fd, &data[0], data.size(), 0);
+    ::close(fd);
+    if (!ok) {
+        return false;
+    }
+
+    size_t bodySize = data.size() - 4;
+    const char* p = data.data();
+    if (crc32c(p, bodySize) != getLE<uint32_t>(p + bodySize) ||
+        std::memcmp(p, kCheckpointMagic, sizeof(kCheckpointMagic)) != 0 ||
+        getLE<uint16_t>(p + 4) != kFormatVersion ||
+        getLE<uint64_t>(p + 8) != m_fileId) {
+        return false;
+    }
+    uint64_t checkpointEnd = getLE<uint64_t>(p + 16);
+    if (checkpointEnd < kHeaderSize || checkpointEnd > fileSize) {
+        return false;
+    }
+    m_liveBytes = getLE<uint64_t>(p + 24);
+    m_garbageBytes = getLE<uint64_t>(p + 32);
+    uint32_t count = getLE<uint32_t>(p + 40);
+
+    size_t pos = kCheckpointHeaderSize;
+    m_index.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (pos + 14 > bodySize) {
+            return false;
+        }
+        uint16_t keyLen = getLE<uint16_t>(p + pos);
+        Location location{getLE<uint64_t>(p + pos + 2), keyLen, getLE<uint32_t>(p + pos + 10)};
+        pos += 14;
+        if (pos + keyLen > bodySize ||
+            location.offset + recordSize(location.keyLen, location.valueLen) > checkpointEnd) {
+            return false;
+        }
+        m_index.emplace(std::string(p + pos, keyLen), location);
+        pos += keyLen;
+    }
+    covered = checkpointEnd;
+    return true;
+}
+
+bool LogEngine::recover(uint64_t from, uint64_t fileSize) {
+    m_end = from;
+    m_sinceCheckpoint = 0;
+    if (from >= fileSize) {
+        return true;
+    }
+
+    void* base = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    size_t consumed = replay(static_cast<const char*>(base) + from, fileSize - from, from,
+                             m_index, m_liveBytes, m_garbageBytes);
+    munmap(base, fileSize);
+
+    m_end = from + consumed;
+    m_sinceCheckpoint = consumed;
+    if (m_end < fileSize) {
+        // 残缺或损坏的尾部：截断到最后一条完整记录
+        if (ftruncate(m_fd, static_cast<off_t>(m_end)) != 0 || fdatasync(m_fd) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LogEngine::appendLocked(const std::string& buffer, uint64_t& offset) {
+    int fd = -1;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_fd < 0) {
+            return false;
+        }
+        fd = m_fd;
+        offset = m_end;
+    }
+
+    // 写入与同步不持有 m_mutex：读者只访问 m_end 之前已发布的记录；
+    // 压缩与关闭替换文件描述符前先获取 m_appendMutex
+    size_t written = 0;
+    while (written < buffer.size()) {
+        ssize_t n = pwrite(fd, buffer.data() + written, buffer.size() - written,
+                           static_cast<off_t>(offset + written));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+
+    // 整批一次 fdatasync；失败时丢弃已写入的部分，下次从原末尾覆盖
+    if (written < buffer.size() || fdatasync(fd) != 0) {
+        if (ftruncate(fd, static_cast<off_t>(offset)) != 0) {
+            // 截断失败：残缺尾部在下次打开时由校验丢弃
+        }
+        return false;
+    }
+    return true;
+}
+
+void LogEngine::apply(Index& index, uint8_t op, const std::string& key, const Location& location,
+                      uint64_t& liveBytes, uint64_t& garbageBytes) const {
+    uint64_t size = recordSize(location.keyLen, location.valueLen);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        uint64_t oldSize = recordSize(it->second.keyLen, it->second.valueLen);
+        liveBytes -= oldSize;
+        garbageBytes += oldSize;
+    }
+
+    if (op == kOpPut) {
+        if (it != index.end()) {
+            it->second = location;
+        } else {
+            index.emplace(key, location);
+        }
+        liveBytes += size;
+    } else {
+        if (it != index.end()) {
+            index.erase(it);
+        }
+        // 墓碑本身在下一次压缩时即可丢弃
+        garbageBytes += size;
+    }
+}
+
+size_t LogEngine::replay(const char* data, size_t size, uint64_t baseOffset, Index& index,
+                         uint64_t& liveBytes, uint64_t& garbageBytes) const {
+    size_t pos = 0;
+    while (size - pos >= kRecordHeaderSize) {
+        const char* p = data + pos;
+        uint8_t op = static_cast<uint8_t>(p[4]);
+        uint16_t keyLen = getLE<uint16_t>(p + 6);
+        uint32_t valueLen = getLE<uint32_t>(p + 8);
+        uint64_t size64 = recordSize(keyLen, valueLen);
+        if (size64 > size - pos || (keyLen == 0) != (op == kOpBatch)) {
+            break;
+        }
+        if ((op != kOpPut && op != kOpDelete && op != kOpBatch) ||
+            crc32c(p + 4, static_cast<size_t>(size64) - 4) != getLE<uint32_t>(p)) {
+            break;
+        }
+        if (op == kOpBatch) {
+            // 内层记录各自带 crc，索引直接指向内层记录；外壳计为垃圾
+            replay(p + kRecordHeaderSize, valueLen, baseOffset + pos + kRecordHeaderSize,
+                   index, liveBytes, garbageBytes);
+            garbageBytes += kRecordHeaderSize;
+        } else {
+            apply(index, op, std::string(p + kRecordHeaderSize, keyLen),
+                  Location{baseOffset + pos, keyLen, valueLen}, liveBytes, garbageBytes);
+        }
+        pos += static_cast<size_t>(size64);
+    }
+    return pos;
+}
+
+bool LogEngine::needsCompactionLocked() const {
+    if (m_garbageBytes < m_options.compactMinBytes) {
+        return false;
+    }
+    return m_garbageBytes * 100 >= (m_liveBytes + m_garbageBytes) * m_options.compactGarbagePercent;
+}
+
+void LogEngine::notifyWorker() {
+    if (!m_options.background) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_workerMutex);
+        m_workPending = true;
+    }
+    m_workerCv.notify_one();
+}
+
+void LogEngine::workerLoop() {
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    for (;;) {
+        m_workerCv.wait(lock, [this]() { return m_stopping || m_workPending; });
+        if (m_stopping) {
+            break;
+        }
+        m_workPending = false;
+        lock.unlock();
+
+        bool compactNow = false;
+        bool checkpointNow = false;
+        {
+            std::lock_guard<std::mutex> state(m_mutex);
+            compactNow = needsCompactionLocked();
+            checkpointNow = m_sinceCheckpoint >= m_options.checkpointBytes;
+        }
+        if (compactNow) {
+            compact();
+        } else if (checkpointNow) {
+            checkpoint();
+        }
+
+        lock.lock();
+    }
+}
+
+void LogEngine::stopWorker() {
+    if (!m_worker.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_workerMutex);
+        m_stopping = true;
+    }
+    m_workerCv.notify_all();
+    m_worker.join();
+}
+
+} // namespace store
+} // namespace hwyz
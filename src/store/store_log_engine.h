@@ -0,0 +1,148 @@
+#pragma once
+
+#include "store_types.h"
+#include "store_path_resolver.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <cstdint>
+
+namespace hwyz {
+namespace store {
+
+// ============================================================
+// LogEngine — 单文件日志结构存储
+//
+// 目录 <storeRoot>/<service>/ 下：
+//   store.log    文件头(16B) + 追加写入的记录
+//   store.ckpt   索引快照，记录其覆盖到的 store.log 偏移
+//
+// 记录：crc32c(4) | op(1) | 保留(1) | keyLen(2) | valueLen(4) | key | value
+// crc 覆盖 crc 之后的全部字节；op 为写入、删除（墓碑）或批次。
+// 批次记录的 value 是若干内层记录，整条校验通过才生效，用于多 key 原子提交。
+//
+// 写入追加到文件末尾后 fdatasync 一次，一批记录共用一次同步；
+// 追加与同步只串行化写者，不持有索引锁，同步完成后才发布到索引，读取不等待磁盘。
+// 内存索引保存每个 key 最新记录的位置。打开时载入检查点并从其覆盖偏移
+// 继续扫描，遇到校验失败的残缺尾部即截断。
+// 垃圾（被覆盖的旧值与墓碑）超过阈值后由后台线程压缩：复制存活记录到
+// 新文件，再补上压缩期间追加的尾部，原子替换 store.log。
+//
+// 整个文件由一个进程独占（flock），不支持多进程并发写同一存储。
+// ============================================================
+class LogEngine {
+public:
+    struct Options {
+        uint64_t compactMinBytes = 1 << 20;     // 垃圾字节下限
+        uint32_t compactGarbagePercent = 50;    // 垃圾占比阈值
+        uint64_t checkpointBytes = 4 << 20;     // 距上次检查点追加超过该值后后台写检查点
+        bool background = true;                 // false 时只在 compact() 中压缩
+    };
+
+    LogEngine(const PathResolver& pathResolver, const Options& options);
+    ~LogEngine();
+
+    LogEngine(const LogEngine&) = delete;
+    LogEngine& operator=(const LogEngine&) = delete;
+
+    // 加锁并恢复索引；文件被其他进程占用或格式不符时返回 false
+    bool open();
+
+    // 写检查点后关闭；discard 为 true 时不写检查点（存储即将被删除）
+    void close(bool discard = false);
+
+    bool isOpen() const;
+
+    bool put(const std::string& key, const std::string& value);
+    bool putBatch(const std::vector<std::pair<std::string, std::string>>& entries);
+    bool remove(const std::string& key);
+
+    // 多 key 原子提交：整批一条记录、一次 fdatasync
+    bool commitBatch(const std::vector<Mutation>& mutations);
+
+    // 返回 0、ENOENT（key 不存在）或其他 errno（读取失败、校验失败为 EIO）
+    int get(const std::string& key, std::string& value) const;
+
+    // 以值在文件中的位置调用 reader，由其直接 pread 到目标内存。调用时不持有索引锁，
+    // fd 在 reader 返回前保持打开（压缩替换文件后仍指向旧文件，位置与之对应）。
+    // 不校验记录 CRC（值自身的帧带校验）。返回 ENOENT、EBADF 或 reader 的返回值
+    int read(const std::string& key,
+             const std::function<int(int fd, uint64_t offset, uint32_t size)>& reader) const;
+    bool contains(const std::string& key) const;
+
+    // 同步压缩 / 写检查点
+    bool compact();
+    bool checkpoint();
+
+    size_t size() const;
+    uint64_t liveBytes() const;
+    uint64_t garbageBytes() const;
+    uint64_t fileBytes() const;
+
+private:
+    struct Location {
+        uint64_t offset;        // 记录起始偏移
+        uint32_t keyLen;
+        uint32_t valueLen;
+    };
+    using Index = std::unordered_map<std::string, Location>;
+
+    // 共享持有的文件描述符：读者取得后在 m_mutex 外读取，
+    // 压缩或关闭替换 m_file 后由最后一个持有者关闭
+    struct FileHandle {
+        int fd;
+        explicit FileHandle(int descriptor) : fd(descriptor) {}
+        ~FileHandle();
+        FileHandle(const FileHandle&) = delete;
+        FileHandle& operator=(const FileHandle&) = delete;
+    };
+
+    const PathResolver& m_pathResolver;
+    Options m_options;
+
+    mutable std::mutex m_mutex;         // 保护 fd、索引与计数
+    std::shared_ptr<const FileHandle> m_file;
+    int m_fd = -1;                      // m_file 的描述符；追加与恢复直接使用
+    uint64_t m_fileId = 0;
+    uint64_t m_end = 0;
+    Index m_index;
+    uint64_t m_liveBytes = 0;
+    uint64_t m_garbageBytes = 0;
+    uint64_t m_sinceCheckpoint = 0;
+
+    std::mutex m_appendMutex;           // 串行化追加；先于 m_mutex 获取
+    std::mutex m_maintenanceMutex;      // 串行化压缩与检查点；先于 m_appendMutex 获取
+    std::thread m_worker;
+    std::mutex m_workerMutex;
+    std::condition_variable m_workerCv;
+    bool m_stopping = false;
+    bool m_workPending = false;
+
+    std::string logPath() const;
+    std::string checkpointPath() const;
+
+    bool checkpointLocked();    // 须持有 m_maintenanceMutex
+    // 取出 key 的位置与对应文件；返回 0、EBADF 或 ENOENT
+    int locate(const std::string& key, std::shared_ptr<const FileHandle>& file, Location& location) const;
+    bool createLog(int fd);
+    bool loadCheckpoint(uint64_t fileSize, uint64_t& covered);
+    bool recover(uint64_t from, uint64_t fileSize);
+    bool appendLocked(const std::string& buffer, uint64_t& offset);     // 须持有 m_appendMutex
+    void apply(Index& index, uint8_t op, const std::string& key, const Location& location,
+               uint64_t& liveBytes, uint64_t& garbageBytes) const;
+    size_t replay(const char* data, size_t size, uint64_t baseOffset, Index& index,
+                  uint64_t& liveBytes, uint64_t& garbageBytes) const;
+    bool needsCompactionLocked() const;
+    void notifyWorker();
+    void workerLoop();
+    void stopWorker();
+};
+
+} // namespace store
+} // namespace hwyz
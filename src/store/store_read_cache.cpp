@@ -0,0 +1,149 @@
+#include "store_read_cache.h"
+#include <sys/stat.h>
+
+namespace hwyz {
+namespace store {
+
+namespace {
+
+// 条目固定开销估算：key、链表节点与哈希节点
+const size_t kEntryOverhead = 96;
+
+size_t costOf(const std::string& key, const ReadCache::Value& value) {
+    size_t cost = kEntryOverhead + key.size();
+    if (const std::string* str = std::get_if<std::string>(&value)) {
+        cost += str->size();
+    }
+    return cost;
+}
+
+void fillIdentity(const struct stat& st, FileIdentity& identity) {
+    identity.dev = st.st_dev;
+    identity.ino = st.st_ino;
+    identity.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    identity.size = static_cast<int64_t>(st.st_size);
+}
+
+} // namespace
+
+ReadCache::ReadCache(const PathResolver& pathResolver, const Generation& generation, size_t maxBytes)
+    : m_pathResolver(pathResolver)
+    , m_maxBytes(maxBytes)
+    , m_generation(generation)
+{
+}
+
+ReadCache::~ReadCache() {
+    close();
+}
+
+bool ReadCache::open() {
+    close();
+    m_open = m_generation.isOpen();
+    return m_open;
+}
+
+void ReadCache::close() {
+    clear();
+    m_open = false;
+}
+
+uint64_t ReadCache::generation() const {
+    return m_generation.load();
+}
+
+void ReadCache::invalidate(const std::string& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        erase(it);
+    }
+}
+
+void ReadCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_bytes = 0;
+}
+
+size_t ReadCache::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+size_t ReadCache::bytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+bool ReadCache::identityOf(const std::string& path, FileIdentity& identity) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    fillIdentity(st, identity);
+    return true;
+}
+
+bool ReadCache::identityOf(int fd, FileIdentity& identity) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return false;
+    }
+    fillIdentity(st, identity);
+    return true;
+}
+
+ReadCache::Entry* ReadCache::find(const std::string& key) {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return nullptr;
+    }
+
+    // 代数变化：有进程写过本存储，校验该 key 的文件是否被替换
+    uint64_t current = generation();
+    Entry& entry = it->second;
+    if (entry.generation != current) {
+        FileIdentity identity;
+        if (!identityOf(m_pathResolver.getKeyPath(key), identity) || identity != entry.identity) {
+            erase(it);
+            return nullptr;
+        }
+        entry.generation = current;
+    }
+
+    m_lru.splice(m_lru.begin(), m_lru, entry.lru);
+    return &entry;
+}
+
+void ReadCache::insert(const std::string& key, Value value,
+                       const FileIdentity& identity, uint64_t generation) {
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        erase(it);
+    }
+
+    size_t cost = costOf(key, value);
+    if (m_maxBytes > 0 && cost > m_maxBytes) {
+        return;
+    }
+    // 超出上限时淘汰最久未用的条目
+    while (m_maxBytes > 0 && m_bytes + cost > m_maxBytes && !m_lru.empty()) {
+        erase(m_entries.find(m_lru.back()));
+    }
+
+    m_lru.push_front(key);
+    Entry entry{std::move(value), identity, generation, cost, m_lru.begin()};
+    m_entries.emplace(key, std::move(entry));
+    m_bytes += cost;
+}
+
+void ReadCache::erase(std::unordered_map<std::string, Entry>::iterator it) {
+    m_bytes -= it->second.cost;
+    m_lru.erase(it->second.lru);
+    m_entries.erase(it);
+}
+
+} // namespace store
+} // namespace hwyz
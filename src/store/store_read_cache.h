@@ -0,0 +1,119 @@
+#pragma once
+
+#include "store_path_resolver.h"
+#include "store_generation.h"
+#include <string>
+#include <unordered_map>
+#include <list>
+#include <mutex>
+#include <variant>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace hwyz {
+namespace store {
+
+// 文件身份：原子写入每次 rename 出新 inode，配合 mtime/size 判断文件是否被替换
+struct FileIdentity {
+    dev_t dev = 0;
+    ino_t ino = 0;
+    int64_t mtimeNs = 0;
+    int64_t size = 0;
+
+    bool operator==(const FileIdentity& other) const {
+        return dev == other.dev && ino == other.ino &&
+               mtimeNs == other.mtimeNs && size == other.size;
+    }
+    bool operator!=(const FileIdentity& other) const { return !(*this == other); }
+};
+
+// ============================================================
+// ReadCache — 已反序列化值的进程内缓存
+//
+// 一致性依赖存储目录的共享代数（见 Generation）：
+// 任何进程经 Store 写入或删除 key 后递增代数。命中时只比较一次共享内存中的
+// 代数；代数变化后条目在下次访问时用 stat 校验文件身份，身份不变即继续使用。
+// 绕过 Store 直接改写文件不会递增代数，缓存不可见此类修改。
+//
+// 调用方须在读文件之前取 generation()，并以该值 put()，保证与并发写入不冲突。
+// ============================================================
+class ReadCache {
+public:
+    using Value = std::variant<int, double, bool, std::string>;
+
+    // 使用调用方打开并负责递增的共享代数；maxBytes 为 0 表示不限
+    ReadCache(const PathResolver& pathResolver, const Generation& generation, size_t maxBytes = 0);
+    ~ReadCache();
+
+    ReadCache(const ReadCache&) = delete;
+    ReadCache& operator=(const ReadCache&) = delete;
+
+    // 代数未打开时缓存停用，get() 恒不命中
+    bool open();
+    void close();
+    bool enabled() const { return m_open; }
+
+    uint64_t generation() const;
+
+    template<typename T>
+    bool get(const std::string& key, T& value) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Entry* entry = find(key);
+        if (entry == nullptr) {
+            return false;
+        }
+        const T* cached = std::get_if<T>(&entry->value);
+        if (cached == nullptr) {
+            return false;
+        }
+        value = *cached;
+        return true;
+    }
+
+    template<typename T>
+    void put(const std::string& key, const T& value,
+             const FileIdentity& identity, uint64_t generation) {
+        if (!enabled()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        insert(key, Value(value), identity, generation);
+    }
+
+    void invalidate(const std::string& key);
+    void clear();
+
+    size_t size() const;
+    size_t bytes() const;
+
+    // stat / fstat 文件身份
+    static bool identityOf(const std::string& path, FileIdentity& identity);
+    static bool identityOf(int fd, FileIdentity& identity);
+
+private:
+    struct Entry {
+        Value value;
+        FileIdentity identity;
+        uint64_t generation;
+        size_t cost;
+        std::list<std::string>::iterator lru;
+    };
+
+    const PathResolver& m_pathResolver;
+    size_t m_maxBytes;
+    const Generation& m_generation;
+    bool m_open = false;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::list<std::string> m_lru;       // 头部最近使用
+    size_t m_bytes = 0;
+
+    Entry* find(const std::string& key);
+    void insert(const std::string& key, Value value,
+                const FileIdentity& identity, uint64_t generation);
+    void erase(std::unordered_map<std::string, Entry>::iterator it);
+};
+
+} // namespace store
+} // namespace hwyz
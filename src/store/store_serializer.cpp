@@ -1,18 +1,66 @@
 #include "store_serializer.h"
+#include "store_crc32c.h"
+#include <algorithm>
 
 namespace hwyz {
 namespace store {
 
-template<>
-std::string Serializer::serialize<std::string>(const std::string& value) const {
-    return value;
-}
+namespace {
+
+const uint8_t kMagic0 = 0xFE;
+const uint8_t kMagic1 = 0x53;
 
-template<>
-bool Serializer::deserialize<std::string>(const std::string& bytes, std::string& value) const {
-    value = bytes;
+} // namespace
+
+bool Serializer::seal(uint8_t typeTag, std::string& frame) {
+    size_t length = frame.size() - kHeaderSize;
+    if (length > UINT32_MAX) {
+        return false;
+    }
+    char* p = &frame[0];
+    p[0] = static_cast<char>(kMagic0);
+    p[1] = static_cast<char>(kMagic1);
+    p[2] = static_cast<char>(kVersion);
+    p[3] = static_cast<char>(typeTag);
+    detail::storeLE(p + 4, static_cast<uint32_t>(length));
+    uint32_t crc = crc32c(p + kHeaderSize, length, crc32c(p, 8));
+    detail::storeLE(p + 8, crc);
     return true;
 }
 
+bool Serializer::decode(CodecReader& reader, const detail::CodecTarget& target) {
+    char header[kHeaderSize];
+    size_t headerSize = std::min(reader.remaining(), kHeaderSize);
+    if (!reader.read(header, headerSize)) {
+        return false;
+    }
+
+    if (headerSize < 2 || static_cast<uint8_t>(header[0]) != kMagic0 ||
+        static_cast<uint8_t>(header[1]) != kMagic1) {
+        // 旧版文本格式
+        if (target.decodeText == nullptr) {
+            return false;
+        }
+        std::string text(header, headerSize);
+        size_t rest = reader.remaining();
+        if (rest > 0) {
+            text.resize(headerSize + rest);
+            if (!reader.read(&text[headerSize], rest)) {
+                return false;
+            }
+        }
+        return target.decodeText(text, target.object);
+    }
+
+    if (headerSize < kHeaderSize || static_cast<uint8_t>(header[2]) != kVersion ||
+        static_cast<uint8_t>(header[3]) != target.typeTag ||
+        detail::loadLE<uint32_t>(header + 4) != reader.remaining()) {
+        return false;
+    }
+    reader.beginChecksum(crc32c(header, 8));
+    return target.decode(reader, target.object) && reader.remaining() == 0 &&
+           reader.checksum() == detail::loadLE<uint32_t>(header + 8);
+}
+
 } // namespace store
 } // namespace hwyz
@@ -1,39 +1,45 @@
 #pragma once
 
+#include <store_codec.h>
 #include <string>
-#include <sstream>
 #include <type_traits>
 
 namespace hwyz {
 namespace store {
 
+// ============================================================
+// Serializer — 值的二进制帧
+//
+// 布局（小端）：
+//   magic(2) = FE 53 | version(1) | type(1) | length(4) | crc32c(4) | payload
+// crc32c 覆盖 crc 字段之前的 8 字节头与 payload；payload 由 StoreCodec<T> 编码。
+//
+// 读取时兼容旧版文本格式（ostringstream 输出）：0xFE 不会出现在
+// UTF-8 文本与数字文本中，以此区分两种格式，文本交给 StoreCodec<T>::decodeText。
+// 类型标签不一致、长度不符或校验失败时解码返回 false。
+// ============================================================
 class Serializer {
 public:
+    static constexpr uint8_t kVersion = 1;
+    static constexpr size_t kHeaderSize = detail::kFrameHeaderSize;
+
     Serializer() = default;
     ~Serializer() = default;
 
     template<typename T>
     std::string serialize(const T& value) const {
-        static_assert(std::is_arithmetic<T>::value || std::is_same<T, std::string>::value,
-                      "Type must be arithmetic or std::string");
-
-        std::ostringstream oss;
-        oss << value;
-        return oss.str();
+        CodecWriter writer;
+        StoreCodec<T>::encode(value, writer);
+        if (!seal(StoreCodec<T>::kTypeTag, writer.buffer())) {
+            return std::string();
+        }
+        return std::move(writer.buffer());
     }
 
     template<typename T>
     bool deserialize(const std::string& bytes, T& value) const {
-        static_assert(std::is_arithmetic<T>::value || std::is_same<T, std::string>::value,
-                      "Type must be arithmetic or std::string");
-
-        if (bytes.empty()) {
-            return false;
-        }
-
-        std::istringstream iss(bytes);
-        iss >> value;
-        return !iss.fail() || std::is_same<T, std::string>::value;
+        CodecReader reader(bytes.data(), bytes.size());
+        return decode(reader, detail::codecTarget(value));
     }
 
     template<typename T>
@@ -44,13 +50,13 @@ public:
         if (std::is_same<T, std::string>::value) return "string";
         return "unknown";
     }
-};
 
-template<>
-std::string Serializer::serialize<std::string>(const std::string& value) const;
+    // 填写 CodecWriter 预留的帧头；payload 超过 4 GB 时返回 false
+    static bool seal(uint8_t typeTag, std::string& frame);
 
-template<>
-bool Serializer::deserialize<std::string>(const std::string& bytes, std::string& value) const;
+    // 读取并校验一帧，payload 直接解码到 target
+    static bool decode(CodecReader& reader, const detail::CodecTarget& target);
+};
 
 } // namespace store
 } // namespace hwyz
@@ -10,12 +10,11 @@ namespace store {
 using SerializerFunc = std::function<std::string(const void* data, size_t size)>;
 using DeserializerFunc = std::function<bool(const std::string& bytes, void* data, size_t size)>;
 
-// 刷新策略配置
-struct FlushPolicyConfig {
-    bool enableDebounce = true;      // 启用去抖
-    uint32_t debounceMs = 1000;      // 去抖时间(ms)
-    uint32_t maxDirtyCount = 10;     // 最大脏条目数
-    bool enableBatch = true;         // 启用批量提交
+// 批量提交中的一项变更（已序列化）
+struct Mutation {
+    std::string key;
+    std::string value;
+    bool remove = false;
 };
 
 } // namespace store
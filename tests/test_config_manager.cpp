@@ -3,6 +3,10 @@
 #include <iostream>
 #include <fstream>
 #include <cstdio>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace hwyz::config;
 
@@ -122,9 +126,160 @@ database:
     std::cout << "test_snapshot_operations passed" << std::endl;
 }
 
+void test_reload_and_subscribe() {
+    std::string tempDir = "/tmp/test_config_reload";
+    std::string commonPath = tempDir + "/common.yaml";
+    system(("mkdir -p " + tempDir).c_str());
+
+    createTempFile(commonPath, R"(
+log:
+  level: INFO
+server:
+  port: 8080
+)");
+
+    ConfigManager& manager = ConfigManager::instance();
+    assert(manager.load("reload", tempDir) == ConfigError::kOk);
+
+    int logChanges = 0;
+    int serverChanges = 0;
+    std::string lastLevel;
+    ConfigManager::SubscriptionId logSub = manager.subscribe("log",
+        [&](const std::string& section, std::shared_ptr<const ImmutableConfigView> view) {
+            assert(section == "log");
+            ++logChanges;
+            lastLevel = view ? view->getString("level") : "";
+        });
+    ConfigManager::SubscriptionId serverSub = manager.subscribe("server",
+        [&](const std::string&, std::shared_ptr<const ImmutableConfigView>) {
+            ++serverChanges;
+        });
+
+    // 内容未变化：不通知
+    assert(manager.reload() == ConfigError::kOk);
+    assert(logChanges == 0 && serverChanges == 0);
+
+    // 仅 log 节变化
+    createTempFile(commonPath, R"(
+log:
+  level: DEBUG
+server:
+  port: 8080
+)");
+    assert(manager.reload() == ConfigError::kOk);
+    assert(logChanges == 1 && serverChanges == 0);
+    assert(lastLevel == "DEBUG");
+    assert(manager.getSnapshot()->getString("log.level") == "DEBUG");
+
+    // 解析失败：保留原快照，不通知
+    createTempFile(commonPath, "log: [unclosed");
+    assert(manager.reload() == ConfigError::kParseFailed);
+    assert(manager.getSnapshot()->getString("log.level") == "DEBUG");
+    assert(logChanges == 1);
+
+    // 取消订阅后不再通知
+    manager.unsubscribe(logSub);
+    manager.unsubscribe(serverSub);
+    createTempFile(commonPath, R"(
+log:
+  level: WARN
+)");
+    assert(manager.reload() == ConfigError::kOk);
+    assert(logChanges == 1 && serverChanges == 0);
+
+    removeTempFile(commonPath);
+    system(("rmdir " + tempDir).c_str());
+
+    std::cout << "test_reload_and_subscribe passed" << std::endl;
+}
+
+void test_concurrent_reload() {
+    std::string tempDir = "/tmp/test_config_concurrent";
+    std::string commonPath = tempDir + "/common.yaml";
+    system(("mkdir -p " + tempDir).c_str());
+
+    // 经 rename 整体替换，reload 不会读到半个文件
+    auto writeLevel = [&](const std::string& level) {
+        createTempFile(commonPath + ".tmp", "log:\n  level: " + level + "\n");
+        std::rename((commonPath + ".tmp").c_str(), commonPath.c_str());
+    };
+    writeLevel("INFO");
+
+    ConfigManager& manager = ConfigManager::instance();
+    assert(manager.load("concurrent", tempDir) == ConfigError::kOk);
+
+    std::atomic<int> active{0};
+    std::mutex levelMutex;
+    std::string lastLevel = "INFO";
+    ConfigManager::SubscriptionId sub = manager.subscribe("log",
+        [&](const std::string&, std::shared_ptr<const ImmutableConfigView> view) {
+            // 回调不并发执行
+            assert(active.fetch_add(1) == 0);
+            std::lock_guard<std::mutex> lock(levelMutex);
+            lastLevel = view->getString("level");
+            active.fetch_sub(1);
+        });
+
+    std::vector<std::thread> reloaders;
+    for (int t = 0; t < 4; ++t) {
+        reloaders.emplace_back([&manager] {
+            for (int i = 0; i < 50; ++i) {
+                assert(manager.reload() == ConfigError::kOk);
+            }
+        });
+    }
+    for (int i = 0; i < 100; ++i) {
+        writeLevel(i % 2 == 0 ? "DEBUG" : "WARN");
+    }
+    for (auto& reloader : reloaders) {
+        reloader.join();
+    }
+
+    // 最后一次回调与最终发布的快照一致
+    {
+        std::lock_guard<std::mutex> lock(levelMutex);
+        assert(lastLevel == manager.getSnapshot()->getString("log.level"));
+    }
+
+    manager.unsubscribe(sub);
+    removeTempFile(commonPath);
+    system(("rmdir " + tempDir).c_str());
+
+    std::cout << "test_concurrent_reload passed" << std::endl;
+}
+
+// 树外实现：只实现只读接口，不覆盖 toYaml()
+class MapConfigView : public ImmutableConfigView {
+public:
+    bool has(const std::string& key) const override { return key == "level" || key == "root"; }
+    std::string getString(const std::string& key, const std::string& defaultValue = "") const override {
+        if (key == "level") return "DEBUG";
+        if (key == "root") return "/var/log/tbox";
+        return defaultValue;
+    }
+    int getInt(const std::string&, int defaultValue = 0) const override { return defaultValue; }
+    double getDouble(const std::string&, double defaultValue = 0.0) const override { return defaultValue; }
+    bool getBool(const std::string&, bool defaultValue = false) const override { return defaultValue; }
+    std::vector<std::string> getStringList(const std::string&) const override { return {}; }
+    std::shared_ptr<const ImmutableConfigView> getSection(const std::string&) const override { return nullptr; }
+    std::vector<std::string> getKeys() const override { return {"level", "root"}; }
+};
+
+void test_default_to_yaml() {
+    MapConfigView view;
+    std::string yaml = view.toYaml();
+    assert(yaml.find("level: DEBUG") != std::string::npos);
+    assert(yaml.find("root: /var/log/tbox") != std::string::npos);
+
+    std::cout << "test_default_to_yaml passed" << std::endl;
+}
+
 int main() {
     test_load_basic();
     test_load_missing_common();
     test_snapshot_operations();
+    test_reload_and_subscribe();
+    test_concurrent_reload();
+    test_default_to_yaml();
     return 0;
 }
@@ -0,0 +1,179 @@
+#include "log.h"
+#include "log/log_backtrace.h"
+#include "log/log_config_adapter.h"
+#include <cassert>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstdlib>
+
+using namespace tbox::fw::log;
+
+static const std::string kRoot = "/tmp/tbox_test_backtrace";
+static const std::string kPath = kRoot + "/bt_svc/bt_svc_0.log";
+
+static const CatalogSite kCanRx("can", LogLevel::kDebug, "can.rx", "frame received", {"id", "dlc"});
+
+static std::vector<std::string> readLines() {
+    std::vector<std::string> lines;
+    std::ifstream in(kPath);
+    std::string line;
+    while (std::getline(in, line)) lines.push_back(line);
+    return lines;
+}
+
+static bool contains(const std::string& line, const std::string& part) {
+    return line.find(part) != std::string::npos;
+}
+
+static void pushRecord(BacktraceBuffer& buffer, uint32_t capacity, const std::string& event,
+                       const std::string& traceId = "") {
+    BacktraceRecord& record = buffer.push(capacity);
+    record.event = event;
+    record.traceId = traceId;
+}
+
+void test_buffer_keeps_latest() {
+    BacktraceBuffer buffer;
+    for (int i = 0; i < 5; ++i) {
+        pushRecord(buffer, 3, "e" + std::to_string(i));
+    }
+    assert(buffer.size() == 3);
+
+    std::vector<std::string> events;
+    buffer.drain("", [&events](BacktraceRecord& record) { events.push_back(record.event); });
+    assert((events == std::vector<std::string>{"e2", "e3", "e4"}));
+    assert(buffer.empty());
+
+    std::cout << "  [PASS] test_buffer_keeps_latest" << std::endl;
+}
+
+void test_buffer_trace_filter() {
+    BacktraceBuffer buffer;
+    pushRecord(buffer, 4, "a1", "A");
+    pushRecord(buffer, 4, "b1", "B");
+    pushRecord(buffer, 4, "a2", "A");
+    pushRecord(buffer, 4, "b2", "B");
+
+    std::vector<std::string> events;
+    buffer.drain("A", [&events](BacktraceRecord& record) { events.push_back(record.event); });
+    assert((events == std::vector<std::string>{"a1", "a2"}));
+    assert(buffer.size() == 2);
+
+    // 其他 trace 的记录保留且顺序不变，后续写入接在其后
+    pushRecord(buffer, 4, "b3", "B");
+    events.clear();
+    buffer.drain("", [&events](BacktraceRecord& record) { events.push_back(record.event); });
+    assert((events == std::vector<std::string>{"b1", "b2", "b3"}));
+
+    std::cout << "  [PASS] test_buffer_trace_filter" << std::endl;
+}
+
+void test_backtrace_config() {
+    auto result = LogConfigAdapter::loadFromSection(
+        "backtrace:\n  enabled: true\n  size: 16\n  capture_level: trace\n");
+    assert(result.second.code == LogError::kOk);
+    assert(result.first.backtrace_config.enabled);
+    assert(result.first.backtrace_config.size == 16);
+    assert(result.first.backtrace_config.capture_level == LogLevel::kTrace);
+
+    result = LogConfigAdapter::loadFromSection("backtrace:\n  enabled: true\n  size: 0\n");
+    assert(result.second.code == LogError::kConfigInvalid);
+
+    std::cout << "  [PASS] test_backtrace_config" << std::endl;
+}
+
+void test_logger_emits_backtrace_before_error() {
+    system(("rm -rf " + kRoot).c_str());
+    system(("mkdir -p " + kRoot).c_str());
+
+    LogConfig config = LogConfigAdapter::getDefaultConfig();
+    config.async_config.enabled = false;
+    config.console_config.enabled = false;
+    config.flight_recorder_config.enabled = false;
+    config.file_config.enabled = true;
+    config.file_config.root = kRoot;
+    config.backtrace_config.enabled = true;
+    config.backtrace_config.size = 4;
+    assert(Logger::init("bt_svc", config).error == LogError::kOk);
+
+    Logger logger = Logger::get("diag");
+    logger.trace("diag.trace", "below capture level");
+    logger.debug("diag.step", "dropped by ring", {Field::i64("step", 0)});
+    logger.debug("diag.step", "plain step", {Field::i64("step", 1)});
+    logger.debug("diag.step", "template step {}", 2);
+    logger.emit(kCanRx, 0x7E8u, 8);
+    logger.info("diag.info", "steady state");
+    logger.debug("diag.step", "last step", {Field::str("note", "before error")});
+    logger.error("diag.fail", "routine failed");
+    logger.error("diag.fail", "second failure");
+    logger.flush();
+
+    std::vector<std::string> lines = readLines();
+    assert(lines.size() == 7);
+    assert(contains(lines[0], "\"event\":\"diag.info\""));
+    assert(contains(lines[1], "\"message\":\"plain step\"") && contains(lines[1], "\"backtrace\":true"));
+    assert(contains(lines[1], "\"level\":\"DEBUG\"") && contains(lines[1], "\"step\":1"));
+    assert(contains(lines[2], "\"message\":\"template step 2\"") && contains(lines[2], "\"backtrace\":true"));
+    assert(contains(lines[3], "\"event\":\"can.rx\"") && contains(lines[3], "\"id\":2024,\"dlc\":8"));
+    assert(contains(lines[4], "\"note\":\"before error\""));
+    assert(contains(lines[5], "\"message\":\"routine failed\"") && !contains(lines[5], "backtrace"));
+    // 回溯记录保留捕获时刻，不晚于触发它的 ERROR
+    assert(lines[1].substr(lines[1].find("\"timestamp\":\""), 40) <= lines[5].substr(lines[5].find("\"timestamp\":\""), 40));
+    assert(contains(lines[6], "\"message\":\"second failure\""));
+
+    std::cout << "  [PASS] test_logger_emits_backtrace_before_error" << std::endl;
+}
+
+void test_logger_backtrace_scoped_by_trace_and_thread() {
+    size_t base = readLines().size();
+    LogConfig config = LogConfigAdapter::getDefaultConfig();
+    config.async_config.enabled = true;
+    config.console_config.enabled = false;
+    config.flight_recorder_config.enabled = false;
+    config.file_config.enabled = true;
+    config.file_config.root = kRoot;
+    config.backtrace_config.enabled = true;
+    assert(Logger::reload(config).error == LogError::kOk);
+
+    Logger logger = Logger::get("tsp");
+    {
+        ContextScope scope({"trace-a", "", ""});
+        logger.debug("tsp.step", "step of a");
+    }
+    {
+        ContextScope scope({"trace-b", "", ""});
+        logger.debug("tsp.step", "step of b");
+    }
+    // 其他线程的 ERROR 不会带出本线程的记录
+    std::thread other([]() { Logger::get("tsp").error("tsp.other", "other thread failed"); });
+    other.join();
+    {
+        ContextScope scope({"trace-a", "", ""});
+        logger.error("tsp.fail", "upload failed");
+    }
+    logger.flush();
+
+    std::vector<std::string> lines = readLines();
+    lines.erase(lines.begin(), lines.begin() + static_cast<std::ptrdiff_t>(base));
+    assert(lines.size() == 3);
+    assert(contains(lines[0], "other thread failed"));
+    assert(contains(lines[1], "step of a") && contains(lines[1], "\"trace_id\":\"trace-a\""));
+    assert(contains(lines[2], "upload failed"));
+
+    system(("rm -rf " + kRoot).c_str());
+    std::cout << "  [PASS] test_logger_backtrace_scoped_by_trace_and_thread" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Backtrace tests..." << std::endl;
+    test_buffer_keeps_latest();
+    test_buffer_trace_filter();
+    test_backtrace_config();
+    test_logger_emits_backtrace_before_error();
+    test_logger_backtrace_scoped_by_trace_and_thread();
+    std::cout << "All Backtrace tests passed!" << std::endl;
+    return 0;
+}
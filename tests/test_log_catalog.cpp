@@ -0,0 +1,274 @@
+#include "log.h"
+#include "log_catalog.h"
+#include "log/log_catalog_registry.h"
+#include "log/log_binary_sink.h"
+#include "log/log_config_adapter.h"
+#include "log/log_module_table.h"
+#include <cassert>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace tbox::fw::log;
+
+static const std::string kRoot = "/tmp/tbox_test_catalog";
+
+static const CatalogSite kCanRx("can", LogLevel::kInfo, "can.rx", "frame received",
+                                {"id", "dlc", "data"});
+static const CatalogSite kDiagSession("diag", LogLevel::kInfo, "diag.session", "session changed",
+                                      {"session", "ok", "voltage"});
+static const CatalogSite kAuth("diag", LogLevel::kInfo, "diag.auth", "security access",
+                               {"level", "token"});
+static const CatalogSite kVin("diag", LogLevel::kInfo, "diag.vin", "vin read",
+                              {{"vin", Sensitivity::Identifier}});
+
+static std::vector<std::string> decodeDir(const std::string& service) {
+    std::vector<std::string> lines;
+    LogErrorInfo error = BinaryLogReader::decodeDir(kRoot + "/" + service, service,
+                                                    [&lines](std::string_view line) {
+        lines.emplace_back(line);
+        return true;
+    });
+    assert(error.code == LogError::kOk);
+    return lines;
+}
+
+static bool contains(const std::string& line, const std::string& part) {
+    return line.find(part) != std::string::npos;
+}
+
+void test_args_roundtrip() {
+    CatalogArgs args;
+    args.add(-5);
+    args.add(300u);
+    args.add(2.5);
+    args.add(true);
+    args.add("abc");
+    args.add(std::string("xyz"));
+    assert(args.count() == 6);
+
+    std::vector<FieldValue> values;
+    assert(catalog_wire::decodeArgs(args.data(), args.size(), values));
+    assert(values.size() == 6);
+    assert(values[0].type == FieldValueType::kInt64 && values[0].intVal == -5);
+    assert(values[1].type == FieldValueType::kUint64 && values[1].uintVal == 300);
+    assert(values[2].type == FieldValueType::kDouble && values[2].doubleVal == 2.5);
+    assert(values[3].type == FieldValueType::kBool && values[3].boolVal);
+    assert(values[4].stringView() == "abc");
+    assert(values[5].stringView() == "xyz");
+
+    // 超出容量：整体转入堆存储，长字符串与后续参数完整保留
+    CatalogArgs full;
+    full.add(1);
+    full.add(std::string(1000, 'x'));
+    full.add(7);
+    assert(full.count() == 3);
+    assert(full.spilled());
+    assert(full.size() > CatalogArgs::kCapacity);
+    values.clear();
+    assert(catalog_wire::decodeArgs(full.data(), full.size(), values));
+    assert(values.size() == 3);
+    assert(values[0].intVal == 1);
+    assert(values[1].stringView() == std::string(1000, 'x'));
+    assert(values[2].intVal == 7);
+
+    // 拷贝后的编码独立有效
+    CatalogArgs copy = full;
+    full = CatalogArgs();
+    assert(!full.spilled() && full.size() == 0);
+    values.clear();
+    assert(catalog_wire::decodeArgs(copy.data(), copy.size(), values));
+    assert(values.size() == 3 && values[1].stringView().size() == 1000);
+
+    std::cout << "  [PASS] test_args_roundtrip" << std::endl;
+}
+
+void test_site_registration() {
+    assert(kCanRx.id() != 0 && kDiagSession.id() == kCanRx.id() + 1);
+    assert(kCanRx.moduleId() == ModuleTable::instance().intern("can"));
+    assert(!kCanRx.requiresRedaction());
+    assert(kAuth.requiresRedaction());
+    assert(kVin.requiresRedaction());
+
+    CatalogEntry entry;
+    assert(CatalogRegistry::instance().lookup(kDiagSession.id(), entry));
+    assert(entry.event == "diag.session" && entry.keys.size() == 3 && entry.keys[2] == "voltage");
+    assert(!CatalogRegistry::instance().lookup(0, entry));
+
+    std::cout << "  [PASS] test_site_registration" << std::endl;
+}
+
+void test_binary_sink_roundtrip() {
+    system(("rm -rf " + kRoot).c_str());
+    system(("mkdir -p " + kRoot).c_str());
+
+    FileConfig config;
+    config.enabled = true;
+    config.root = kRoot;
+    config.format = "binary";
+    {
+        BinaryFileSink sink(config, "sink_svc");
+        assert(sink.isAvailable());
+
+        LogContext ctx;
+        ctx.trace_id = "trace-1";
+        CatalogArgs args;
+        args.add(0x123u);
+        args.add(8);
+        args.add("0102030405060708");
+        std::string payload;
+        BinaryFileSink::encodeRecord(payload, kCanRx.id(), 1704067200123000000ULL, 42, &ctx, args);
+        // 动态部分远小于对应的 JSON 行
+        assert(payload.size() < 48);
+        assert(sink.writeRecord(kCanRx.id(), payload));
+        assert(sink.writeLine("{\"event\":\"plain.json\"}"));
+        sink.flush();
+    }
+
+    std::vector<std::string> lines = decodeDir("sink_svc");
+    assert(lines.size() == 2);
+    assert(lines[0] == "{\"schema_version\":1,\"timestamp\":\"2024-01-01T00:00:00.123Z\",\"level\":\"INFO\","
+                       "\"service\":\"sink_svc\",\"module\":\"can\",\"event\":\"can.rx\","
+                       "\"message\":\"frame received\",\"pid\":" + std::to_string(getpid()) +
+                       ",\"tid\":42,\"trace_id\":\"trace-1\",\"id\":291,\"dlc\":8,"
+                       "\"data\":\"0102030405060708\"}");
+    assert(lines[1] == "{\"event\":\"plain.json\"}");
+
+    std::cout << "  [PASS] test_binary_sink_roundtrip" << std::endl;
+}
+
+void test_logger_binary_mode() {
+    LogConfig config = LogConfigAdapter::getDefaultConfig();
+    config.async_config.enabled = false;
+    config.console_config.enabled = false;
+    config.flight_recorder_config.enabled = false;
+    config.file_config.enabled = true;
+    config.file_config.root = kRoot;
+    config.file_config.format = "binary";
+    assert(LogConfigAdapter::validate(config).code == LogError::kOk);
+    assert(Logger::init("catalog_svc", config).error == LogError::kOk);
+
+    Logger can = Logger::get("can");
+    for (int i = 0; i < 100; ++i) {
+        can.emit(kCanRx, static_cast<uint32_t>(i), 8, "0011223344556677");
+    }
+    can.emit(kDiagSession, "extended", true, 12.5);
+    can.emit(kAuth, 3, "s3cr3t");           // 含密钥 key：走 JSON 脱敏路径
+    can.emit(kVin, "LSGJA52U7SA123456");    // 标识符：按 mask 脱敏
+    can.info("plain.event", "regular record", {Field::i64("n", 1)});
+    can.flush();
+
+    std::vector<std::string> lines = decodeDir("catalog_svc");
+    assert(lines.size() == 104);
+    assert(contains(lines[0], "\"event\":\"can.rx\"") && contains(lines[0], "\"id\":0,"));
+    assert(contains(lines[99], "\"id\":99,"));
+    assert(contains(lines[100], "\"session\":\"extended\",\"ok\":true,\"voltage\":12.5"));
+    assert(contains(lines[101], "\"token_redacted\":\"[REDACTED:secret]\""));
+    assert(!contains(lines[101], "s3cr3t"));
+    assert(!contains(lines[102], "LSGJA52U7SA123456"));
+    assert(contains(lines[103], "\"event\":\"plain.event\"") && contains(lines[103], "\"n\":1"));
+
+    std::cout << "  [PASS] test_logger_binary_mode" << std::endl;
+}
+
+void test_decode_truncated_tail() {
+    std::string path = kRoot + "/catalog_svc/catalog_svc_0.tlog";
+    struct stat st;
+    assert(stat(path.c_str(), &st) == 0);
+    assert(truncate(path.c_str(), st.st_size - 3) == 0);
+
+    std::vector<std::string> lines = decodeDir("catalog_svc");
+    assert(lines.size() == 103);
+
+    LogErrorInfo error = BinaryLogReader::decodeFile(kRoot + "/missing.tlog",
+                                                     [](std::string_view) { return true; });
+    assert(error.code == LogError::kSearchFailed);
+
+    std::cout << "  [PASS] test_decode_truncated_tail" << std::endl;
+}
+
+void test_logger_json_fallback() {
+    LogConfig config = LogConfigAdapter::getDefaultConfig();
+    config.async_config.enabled = false;
+    config.console_config.enabled = false;
+    config.flight_recorder_config.enabled = false;
+    config.file_config.enabled = true;
+    config.file_config.root = kRoot;
+    assert(Logger::reload(config).error == LogError::kOk);
+
+    Logger::get("can").emit(kCanRx, 0x7DFu, 2, "0102");
+    Logger::get("can").flush();
+
+    std::ifstream in(kRoot + "/catalog_svc/catalog_svc_0.log");
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::string content = ss.str();
+    assert(contains(content, "\"module\":\"can\",\"event\":\"can.rx\",\"message\":\"frame received\""));
+    assert(contains(content, "\"id\":2015,\"dlc\":2,\"data\":\"0102\""));
+
+    LogConfig invalid = config;
+    invalid.file_config.format = "xml";
+    assert(LogConfigAdapter::validate(invalid).code == LogError::kConfigInvalid);
+
+    system(("rm -rf " + kRoot).c_str());
+    std::cout << "  [PASS] test_logger_json_fallback" << std::endl;
+}
+
+void test_logger_binary_with_console() {
+    system(("mkdir -p " + kRoot).c_str());
+    LogConfig config = LogConfigAdapter::getDefaultConfig();
+    config.async_config.enabled = false;
+    config.console_config.enabled = true;
+    config.flight_recorder_config.enabled = false;
+    config.file_config.enabled = true;
+    config.file_config.root = kRoot;
+    config.file_config.format = "binary";
+    assert(Logger::reload(config).error == LogError::kOk);
+
+    // 默认路由为 console|file：文件写二进制，控制台仍收到 JSON
+    const std::string consolePath = kRoot + "/console.out";
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int fd = open(consolePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    assert(saved >= 0 && fd >= 0);
+    dup2(fd, STDOUT_FILENO);
+    close(fd);
+
+    Logger::get("can").emit(kCanRx, 0x123u, 4, "deadbeef");
+    Logger::get("can").flush();
+
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    std::ifstream in(consolePath);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    assert(contains(ss.str(), "\"event\":\"can.rx\"") && contains(ss.str(), "\"id\":291,"));
+
+    std::vector<std::string> lines = decodeDir("catalog_svc");
+    assert(lines.size() == 1);
+    assert(contains(lines[0], "\"event\":\"can.rx\"") && contains(lines[0], "\"data\":\"deadbeef\""));
+
+    system(("rm -rf " + kRoot).c_str());
+    std::cout << "  [PASS] test_logger_binary_with_console" << std::endl;
+}
+
+int main() {
+    std::cout << "Running LogCatalog tests..." << std::endl;
+    test_args_roundtrip();
+    test_site_registration();
+    test_binary_sink_roundtrip();
+    test_logger_binary_mode();
+    test_decode_truncated_tail();
+    test_logger_json_fallback();
+    test_logger_binary_with_console();
+    std::cout << "All LogCatalog tests passed!" << std::endl;
+    return 0;
+}
@@ -39,6 +39,7 @@ common:
     assert(result.first.level == LogLevel::kWarn);
     assert(result.first.async_config.queue_size == 8192);
     assert(result.first.redact_config.raw_payload_max_bytes == 512);
+    assert(result.first.redact_config.payload_encoding == "hex");
     std::cout << "  [PASS] test_valid_config" << std::endl;
 }
 
@@ -93,6 +94,44 @@ log:
     assert(result.first.level == LogLevel::kDebug);
     assert(result.first.module_levels["transport"] == LogLevel::kWarn);
     assert(result.first.module_levels["uds"] == LogLevel::kInfo);
+
+    // 服务层的其他字段同样生效，未写的沿用公共层
+    std::string commonFull = R"(
+common:
+  log:
+    schema_version: 1
+    file:
+      enabled: true
+      root: /var/log/common
+      max_files: 3
+    redact:
+      identifiers: hash
+)";
+    std::string serviceFull = R"(
+log:
+  file:
+    root: /var/log/svc
+  async:
+    queue_size: 1024
+  redact:
+    raw_payload_max_bytes: 64
+  backtrace:
+    enabled: true
+  overrides:
+    - session_id: sess-1
+      level: TRACE
+)";
+    result = LogConfigAdapter::loadFromYamlString(commonFull, serviceFull);
+    assert(result.second.code == LogError::kOk);
+    assert(result.first.file_config.enabled);
+    assert(result.first.file_config.root == "/var/log/svc");
+    assert(result.first.file_config.max_files == 3);
+    assert(result.first.async_config.queue_size == 1024);
+    assert(result.first.redact_config.identifiers == "hash");
+    assert(result.first.redact_config.raw_payload_max_bytes == 64);
+    assert(result.first.backtrace_config.enabled);
+    assert(result.first.level_overrides.size() == 1);
+    assert(result.first.level_overrides[0].session_id == "sess-1");
     std::cout << "  [PASS] test_service_override" << std::endl;
 }
 
@@ -105,6 +144,97 @@ void test_default_degradation_on_error() {
     std::cout << "  [PASS] test_default_degradation_on_error" << std::endl;
 }
 
+void test_sampling_config() {
+    std::string yaml = R"(
+common:
+  log:
+    schema_version: 1
+    level: INFO
+    sampling:
+      - module: uds
+        event: diag.uds.tx
+        every_n: 10
+      - module: tsp
+        max_level: TRACE
+        trace_ratio: 0.25
+)";
+    auto result = LogConfigAdapter::loadFromYamlString(yaml);
+    assert(result.second.code == LogError::kOk);
+    assert(result.first.sampling_rules.size() == 2);
+    assert(result.first.sampling_rules[0].module == "uds");
+    assert(result.first.sampling_rules[0].event == "diag.uds.tx");
+    assert(result.first.sampling_rules[0].every_n == 10);
+    assert(result.first.sampling_rules[0].max_level == LogLevel::kDebug);
+    assert(result.first.sampling_rules[1].max_level == LogLevel::kTrace);
+    assert(result.first.sampling_rules[1].trace_ratio == 0.25);
+
+    std::string invalid = R"(
+common:
+  log:
+    schema_version: 1
+    sampling:
+      - module: uds
+        every_n: 10
+        trace_ratio: 0.5
+)";
+    result = LogConfigAdapter::loadFromYamlString(invalid);
+    assert(result.second.code == LogError::kConfigInvalid);
+    assert(result.second.detail == "sampling[0]");
+    std::cout << "  [PASS] test_sampling_config" << std::endl;
+}
+
+void test_level_override_config() {
+    std::string section = R"(
+overrides:
+  - trace_id: trace-42
+  - session_id: VIN123
+    prefix: true
+    module: can
+    level: TRACE
+)";
+    auto result = LogConfigAdapter::loadFromSection(section);
+    assert(result.second.code == LogError::kOk);
+    assert(result.first.level_overrides.size() == 2);
+    assert(result.first.level_overrides[0].trace_id == "trace-42");
+    assert(result.first.level_overrides[0].level == LogLevel::kDebug);
+    assert(result.first.level_overrides[1].session_id == "VIN123");
+    assert(result.first.level_overrides[1].prefix);
+    assert(result.first.level_overrides[1].module == "can");
+    assert(result.first.level_overrides[1].level == LogLevel::kTrace);
+
+    result = LogConfigAdapter::loadFromSection("overrides:\n  - level: DEBUG\n");
+    assert(result.second.code == LogError::kConfigInvalid);
+    assert(result.second.detail == "overrides[0]");
+    std::cout << "  [PASS] test_level_override_config" << std::endl;
+}
+
+void test_load_from_section() {
+    // ConfigManager 合并后的 log 节不带 common 前缀，且已合并服务层 modules
+    std::string section = R"(
+level: DEBUG
+modules:
+  uds: WARN
+sampling:
+  - module: can
+    every_n: 5
+)";
+    auto result = LogConfigAdapter::loadFromSection(section);
+    assert(result.second.code == LogError::kOk);
+    assert(result.first.level == LogLevel::kDebug);
+    assert(result.first.module_levels["uds"] == LogLevel::kWarn);
+    assert(result.first.sampling_rules.size() == 1);
+
+    result = LogConfigAdapter::loadFromSection("redact:\n  payload_encoding: base64\n");
+    assert(result.second.code == LogError::kOk);
+    assert(result.first.redact_config.payload_encoding == "base64");
+    result = LogConfigAdapter::loadFromSection("redact:\n  payload_encoding: ascii\n");
+    assert(result.second.code == LogError::kConfigInvalid);
+
+    result = LogConfigAdapter::loadFromSection("schema_version: 3\n");
+    assert(result.second.code == LogError::kConfigInvalid);
+    std::cout << "  [PASS] test_load_from_section" << std::endl;
+}
+
 int main() {
     std::cout << "Running LogConfigAdapter tests..." << std::endl;
     test_default_config();
@@ -113,6 +243,9 @@ int main() {
     test_file_budget_violation();
     test_service_override();
     test_default_degradation_on_error();
+    test_sampling_config();
+    test_level_override_config();
+    test_load_from_section();
     std::cout << "All LogConfigAdapter tests passed!" << std::endl;
     return 0;
 }
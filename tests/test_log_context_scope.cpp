@@ -3,6 +3,10 @@
 #include <cassert>
 #include <iostream>
 #include <thread>
+#include <functional>
+#include <set>
+#include <string>
+#include <type_traits>
 
 using namespace tbox::fw::log;
 
@@ -73,11 +77,113 @@ void test_context_scope_thread_isolation() {
     std::cout << "  [PASS] test_context_scope_thread_isolation" << std::endl;
 }
 
+void test_inline_ids() {
+    static_assert(std::is_trivially_copyable<LogContext>::value, "LogContext must copy without allocation");
+
+    LogContext ctx;
+    assert(ctx.trace_id.empty());
+    std::string dynamic = "req-" + std::to_string(42);
+    ctx.request_id = dynamic;
+    assert(ctx.request_id == "req-42" && ctx.request_id == dynamic);
+    assert(ctx.request_id != "req-43");
+
+    // 超出容量截断
+    ctx.session_id = std::string(LogContext::Id::kCapacity + 8, 's');
+    assert(ctx.session_id.size() == LogContext::Id::kCapacity);
+    assert(ctx.session_id == std::string(LogContext::Id::kCapacity, 's'));
+
+    LogContext copy = ctx;
+    ctx.request_id.clear();
+    assert(copy.request_id == "req-42" && ctx.request_id.empty());
+
+    std::cout << "  [PASS] test_inline_ids" << std::endl;
+}
+
+void test_capture_restore_across_threads() {
+    LogContext ctx;
+    ctx.trace_id = "capture-trace";
+    ctx.request_id = "capture-req";
+
+    ContextScope::Handle handle;
+    std::function<void()> task;
+    {
+        ContextScope scope(ctx);
+        handle = ContextScope::capture();
+        task = ContextScope::bind([]() {
+            assert(ContextScope::current() != nullptr);
+            assert(ContextScope::current()->trace_id == "capture-trace");
+        });
+    }
+    // 源作用域结束后快照仍然有效
+    assert(ContextScope::current() == nullptr);
+    assert(handle.active() && handle.context().request_id == "capture-req");
+
+    std::thread worker([handle, task]() {
+        assert(ContextScope::current() == nullptr);
+        {
+            auto scope = ContextScope::restore(handle);
+            assert(ContextScope::current()->trace_id == "capture-trace");
+            assert(ContextScope::current()->request_id == "capture-req");
+        }
+        assert(ContextScope::current() == nullptr);
+        task();
+        assert(ContextScope::current() == nullptr);
+    });
+    worker.join();
+
+    // 未激活的句柄：恢复为“无上下文”，结束后回到原上下文
+    ContextScope::Handle empty = ContextScope::capture();
+    assert(!empty.active());
+    ContextScope outer(ctx);
+    {
+        auto scope = ContextScope::restore(empty);
+        assert(ContextScope::current() == nullptr);
+    }
+    assert(ContextScope::current()->trace_id == "capture-trace");
+
+    std::cout << "  [PASS] test_capture_restore_across_threads" << std::endl;
+}
+
+void test_trace_id_generator() {
+    std::set<std::string> seen;
+    for (int i = 0; i < 1000; ++i) {
+        LogContext::Id id = ContextScope::newTraceId();
+        assert(id.size() == 32);
+        assert(id != std::string(32, '0'));
+        for (char c : id.view()) {
+            assert((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'));
+        }
+        seen.insert(id.str());
+    }
+    assert(seen.size() == 1000);
+
+    // 不同线程的序列互不相同
+    std::string other;
+    std::thread t([&other]() { other = ContextScope::newTraceId().str(); });
+    t.join();
+    assert(seen.count(other) == 0);
+
+    LogContext ctx;
+    ctx.session_id = "VIN123";
+    ContextScope session(ctx);
+    {
+        auto trace = ContextScope::startTrace();
+        assert(ContextScope::current()->trace_id.size() == 32);
+        assert(ContextScope::current()->session_id == "VIN123");
+    }
+    assert(ContextScope::current()->trace_id.empty());
+
+    std::cout << "  [PASS] test_trace_id_generator" << std::endl;
+}
+
 int main() {
     std::cout << "Running ContextScope tests..." << std::endl;
     test_context_scope_basic();
     test_context_scope_nested();
     test_context_scope_thread_isolation();
+    test_inline_ids();
+    test_capture_restore_across_threads();
+    test_trace_id_generator();
     std::cout << "All ContextScope tests passed!" << std::endl;
     return 0;
 }
@@ -22,7 +22,7 @@ void test_enricher_basic_fields() {
     std::vector<Field> fields;
     fields.push_back({"user_id", FieldValue::makeString("U123")});
 
-    auto enriched = enricher.enrich(fields, LogLevel::kInfo, "uds", "test.event", "Test message");
+    auto enriched = enricher.enrich(fields, LogLevel::kInfo, ModuleTable::instance().intern("uds"), "test.event", "Test message");
 
     assert(hasField(enriched, "schema_version"));
     assert(hasField(enriched, "timestamp"));
@@ -38,10 +38,10 @@ void test_enricher_basic_fields() {
     assert(hasField(enriched, "user_id"));
 
     const Field* svc = findField(enriched, "service");
-    assert(svc != nullptr && svc->value.stringVal == "test_svc");
+    assert(svc != nullptr && svc->value.stringView() == "test_svc");
 
     const Field* lvl = findField(enriched, "level");
-    assert(lvl != nullptr && lvl->value.stringVal == "INFO");
+    assert(lvl != nullptr && lvl->value.stringView() == "INFO");
 
     std::cout << "  [PASS] test_enricher_basic_fields" << std::endl;
 }
@@ -54,23 +54,23 @@ void test_enricher_with_context() {
     ctx.session_id = "sess-xyz";
 
     std::vector<Field> fields;
-    auto enriched = enricher.enrich(fields, LogLevel::kError, "uds", "diag.uds.failed", "UDS failed", &ctx);
+    auto enriched = enricher.enrich(fields, LogLevel::kError, ModuleTable::instance().intern("uds"), "diag.uds.failed", "UDS failed", &ctx);
 
     assert(hasField(enriched, "trace_id"));
     assert(hasField(enriched, "request_id"));
     assert(hasField(enriched, "session_id"));
 
     const Field* trace = findField(enriched, "trace_id");
-    assert(trace != nullptr && trace->value.stringVal == "trace-abc");
+    assert(trace != nullptr && trace->value.stringView() == "trace-abc");
 
     std::cout << "  [PASS] test_enricher_with_context" << std::endl;
 }
 
 void test_enricher_mono_ms_increasing() {
     Enricher enricher("test");
-    auto r1 = enricher.enrich({}, LogLevel::kInfo, "m", "e", "msg1");
+    auto r1 = enricher.enrich({}, LogLevel::kInfo, ModuleTable::instance().intern("m"), "e", "msg1");
     for (volatile int i = 0; i < 100000; ++i) {}
-    auto r2 = enricher.enrich({}, LogLevel::kInfo, "m", "e", "msg2");
+    auto r2 = enricher.enrich({}, LogLevel::kInfo, ModuleTable::instance().intern("m"), "e", "msg2");
 
     const Field* mono1 = findField(r1, "mono_ms");
     const Field* mono2 = findField(r2, "mono_ms");
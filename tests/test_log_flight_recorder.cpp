@@ -0,0 +1,258 @@
+#include "log_types.h"
+#include "log/log_flight_recorder.h"
+#include "log/log_emergency_writer.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <set>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <csignal>
+
+using namespace tbox::fw::log;
+
+static FlightRecorderConfig makeConfig(uint32_t sizeKb) {
+    FlightRecorderConfig config;
+    config.dir = "/tmp/tbox_test_flight";
+    config.size_kb = sizeKb;
+    return config;
+}
+
+void test_flight_record_and_read() {
+    FlightRecorderConfig config = makeConfig(16);
+    std::string path;
+    {
+        FlightRecorder recorder(config, "flight_basic");
+        assert(recorder.isAvailable());
+        path = recorder.getPath();
+
+        // 环中含 DEBUG 上下文，仅属主可读写
+        struct stat st;
+        assert(stat(path.c_str(), &st) == 0);
+        assert((st.st_mode & 077) == 0);
+
+        recorder.record(LogLevel::kDebug, "uds", "diag.uds.tx", "frame sent");
+        recorder.record(LogLevel::kInfo, "uds", "diag.uds.rx", "frame received");
+    }
+
+    std::vector<FlightRecord> records;
+    assert(FlightRecorder::readFile(path, records));
+    assert(records.size() == 2);
+    assert(records[0].seq == 0);
+    assert(records[0].level == LogLevel::kDebug);
+    assert(records[0].module == "uds");
+    assert(records[0].event == "diag.uds.tx");
+    assert(records[0].message == "frame sent");
+    assert(records[1].message == "frame received");
+
+    std::string json = FlightRecorder::toJsonLine(records[1]);
+    assert(json.find("\"event\":\"diag.uds.rx\"") != std::string::npos);
+    assert(json.find("\"level\":\"INFO\"") != std::string::npos);
+
+    std::remove(path.c_str());
+    std::cout << "  [PASS] test_flight_record_and_read" << std::endl;
+}
+
+void test_flight_ring_wraps() {
+    FlightRecorderConfig config = makeConfig(4);
+    std::string path;
+    uint32_t slots = (4 * 1024 - 64) / FlightRecorder::kSlotSize;
+    {
+        FlightRecorder recorder(config, "flight_wrap");
+        path = recorder.getPath();
+        for (uint32_t i = 0; i < slots * 3; ++i) {
+            recorder.record(LogLevel::kTrace, "can", "can.rx", "msg " + std::to_string(i));
+        }
+    }
+
+    std::vector<FlightRecord> records;
+    assert(FlightRecorder::readFile(path, records));
+    assert(records.size() == slots);
+    assert(records.front().seq == slots * 2);
+    assert(records.back().message == "msg " + std::to_string(slots * 3 - 1));
+
+    std::remove(path.c_str());
+    std::cout << "  [PASS] test_flight_ring_wraps" << std::endl;
+}
+
+void test_flight_truncates_long_message() {
+    FlightRecorderConfig config = makeConfig(8);
+    std::string path;
+    {
+        FlightRecorder recorder(config, "flight_trunc");
+        path = recorder.getPath();
+        recorder.record(LogLevel::kWarn, "m", "e", std::string(4096, 'x'));
+    }
+
+    std::vector<FlightRecord> records;
+    assert(FlightRecorder::readFile(path, records));
+    assert(records.size() == 1);
+    assert(!records[0].message.empty());
+    assert(records[0].message.size() < FlightRecorder::kSlotSize);
+
+    std::remove(path.c_str());
+    std::cout << "  [PASS] test_flight_truncates_long_message" << std::endl;
+}
+
+void test_flight_previous_ring_preserved() {
+    FlightRecorderConfig config = makeConfig(8);
+    std::string path;
+    {
+        FlightRecorder first(config, "flight_prev");
+        path = first.getPath();
+        first.record(LogLevel::kError, "m", "crash.before", "last words");
+    }
+    {
+        FlightRecorder second(config, "flight_prev");
+        second.record(LogLevel::kInfo, "m", "restart", "new run");
+    }
+
+    std::vector<FlightRecord> records;
+    assert(FlightRecorder::readFile(path + ".prev", records));
+    assert(records.size() == 1 && records[0].message == "last words");
+
+    std::remove(path.c_str());
+    std::remove((path + ".prev").c_str());
+    std::cout << "  [PASS] test_flight_previous_ring_preserved" << std::endl;
+}
+
+void test_flight_concurrent_writers() {
+    FlightRecorderConfig config = makeConfig(64);
+    std::string path;
+    {
+        FlightRecorder recorder(config, "flight_mt");
+        path = recorder.getPath();
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&recorder]() {
+                for (int i = 0; i < 50; ++i) {
+                    recorder.record(LogLevel::kDebug, "mt", "mt.event", "payload");
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+    }
+
+    std::vector<FlightRecord> records;
+    assert(FlightRecorder::readFile(path, records));
+    assert(records.size() == 200);
+    for (size_t i = 0; i < records.size(); ++i) {
+        assert(records[i].seq == i);
+    }
+
+    std::remove(path.c_str());
+    std::cout << "  [PASS] test_flight_concurrent_writers" << std::endl;
+}
+
+void test_flight_read_while_writing() {
+    // 小环快速绕圈：读者只能看到完整的记录，写到一半或被改写的槽位被丢弃
+    FlightRecorderConfig config = makeConfig(8);
+    FlightRecorder recorder(config, "flight_torn");
+    std::string path = recorder.getPath();
+
+    std::atomic<bool> done(false);
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&recorder, t]() {
+            std::string event = "w" + std::to_string(t);
+            std::string message(150, static_cast<char>('a' + t));
+            for (int i = 0; i < 20000; ++i) {
+                recorder.record(LogLevel::kDebug, "torn", event, message);
+            }
+        });
+    }
+    std::thread reader([&]() {
+        std::vector<FlightRecord> records;
+        while (!done.load()) {
+            assert(FlightRecorder::readFile(path, records));
+            std::set<uint64_t> seen;
+            for (const auto& record : records) {
+                assert(record.module == "torn");
+                assert(record.event.size() == 2 && record.event[0] == 'w');
+                char fill = static_cast<char>('a' + (record.event[1] - '0'));
+                assert(record.message == std::string(150, fill));
+                assert(seen.insert(record.seq).second);
+            }
+        }
+    });
+    for (auto& writer : writers) writer.join();
+    done = true;
+    reader.join();
+
+    std::remove(path.c_str());
+    std::cout << "  [PASS] test_flight_read_while_writing" << std::endl;
+}
+
+void test_flight_dump_to_fd() {
+    FlightRecorderConfig config = makeConfig(8);
+    FlightRecorder recorder(config, "flight_dump");
+    recorder.record(LogLevel::kDebug, "sec", "sec.hsm.call", "before crash");
+
+    int fds[2];
+    assert(pipe(fds) == 0);
+    recorder.dumpTo(fds[1]);
+    close(fds[1]);
+
+    std::string out;
+    char buf[512];
+    ssize_t n;
+    while ((n = read(fds[0], buf, sizeof(buf))) > 0) {
+        out.append(buf, static_cast<size_t>(n));
+    }
+    close(fds[0]);
+
+    assert(out.find("sec.hsm.call") != std::string::npos);
+    assert(out.find("before crash") != std::string::npos);
+    assert(out.find("DEBUG") != std::string::npos);
+
+    std::remove(recorder.getPath().c_str());
+    std::cout << "  [PASS] test_flight_dump_to_fd" << std::endl;
+}
+
+static void onPreviousHandler(int sig, siginfo_t* info, void* context) {
+    // 原 SA_SIGINFO 处理函数收到完整的 siginfo 与上下文
+    bool intact = info != nullptr && info->si_signo == sig && context != nullptr;
+    _exit(intact ? 42 : 1);
+}
+
+void test_fatal_signal_chains_siginfo() {
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_sigaction = &onPreviousHandler;
+        sigemptyset(&sa.sa_mask);
+        sa.sa_flags = SA_SIGINFO;
+        sigaction(SIGABRT, &sa, nullptr);
+        EmergencyWriter::installFatalSignalHandlers();
+        raise(SIGABRT);
+        _exit(2);
+    }
+
+    int status = 0;
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 42);
+    std::cout << "  [PASS] test_fatal_signal_chains_siginfo" << std::endl;
+}
+
+int main() {
+    std::cout << "Running FlightRecorder tests..." << std::endl;
+    test_flight_record_and_read();
+    test_flight_ring_wraps();
+    test_flight_truncates_long_message();
+    test_flight_previous_ring_preserved();
+    test_flight_concurrent_writers();
+    test_flight_read_while_writing();
+    test_flight_dump_to_fd();
+    test_fatal_signal_chains_siginfo();
+    std::cout << "All FlightRecorder tests passed!" << std::endl;
+    return 0;
+}
@@ -1,12 +1,37 @@
 #include "log.h"
 #include "log/log_config_adapter.h"
+#include "log/log_module_table.h"
 #include <cassert>
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
 #include <sys/wait.h>
 #include <unistd.h>
 
 using namespace tbox::fw::log;
 
+void test_logger_before_init() {
+    // init 之前获取的 Logger 不崩溃，init 之后自动接入处理链
+    Logger early = Logger::get("early");
+    early.debug("t.e", "dropped before init");
+    early.error("t.e", "goes to stderr before init");
+    early.flush();
+
+    LogConfig config = LogConfigAdapter::getDefaultConfig();
+    config.async_config.enabled = false;
+    InitResult result = Logger::init("test_early", config);
+    assert(result.error == LogError::kOk);
+
+    early.info("t.e", "delivered after init");
+    Logger::get("early").info("t.e", "same module shares instance");
+    early.flush();
+    std::cout << "  [PASS] test_logger_before_init" << std::endl;
+}
+
 void test_logger_init_and_log() {
     LogConfig config = LogConfigAdapter::getDefaultConfig();
     InitResult result = Logger::init("test_svc", config);
@@ -101,12 +126,275 @@ void test_logger_fatal_aborts() {
     }
 }
 
+static size_t countLines(const std::string& path, const std::string& needle) {
+    std::ifstream in(path);
+    std::string line;
+    size_t count = 0;
+    while (std::getline(in, line)) {
+        if (line.find(needle) != std::string::npos) ++count;
+    }
+    return count;
+}
+
+void test_logger_reload() {
+    // 处理链在首个测试中以 test_early 初始化，此处只做热重载
+    const std::string root = "/tmp/tbox_test_reload";
+    const std::string path = root + "/test_early/test_early_0.log";
+    system(("rm -rf " + root).c_str());
+    system(("mkdir -p " + root).c_str());
+
+    LogConfig config = LogConfigAdapter::getDefaultConfig();
+    config.level = LogLevel::kWarn;
+    config.console_config.enabled = false;
+    config.file_config.enabled = true;
+    config.file_config.root = root;
+    config.async_config.enabled = true;
+    assert(Logger::reload(config).error == LogError::kOk);
+
+    Logger logger = Logger::get("reload");
+    logger.info("t.reload", "filtered at WARN");
+    logger.flush();
+    assert(countLines(path, "filtered at WARN") == 0);
+
+    // 级别下调立即生效
+    config.level = LogLevel::kInfo;
+    assert(Logger::reload(config).error == LogError::kOk);
+    logger.info("t.reload", "visible at INFO");
+    logger.flush();
+    assert(countLines(path, "visible at INFO") == 1);
+
+    // 写入线程持续记录，期间反复切换异步/同步与队列参数：不丢记录
+    std::atomic<bool> running{true};
+    std::atomic<int> written{0};
+    std::thread writer([&]() {
+        Logger worker = Logger::get("reload_worker");
+        while (running.load()) {
+            worker.error("t.reload.burst", "burst record");
+            written.fetch_add(1);
+        }
+    });
+    for (int i = 0; i < 20; ++i) {
+        config.async_config.enabled = (i % 2 == 0);
+        config.async_config.queue_size = 4096 + static_cast<uint32_t>(i);
+        assert(Logger::reload(config).error == LogError::kOk);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    running = false;
+    writer.join();
+
+    config.async_config.enabled = false;
+    assert(Logger::reload(config).error == LogError::kOk);
+    logger.flush();
+    assert(countLines(path, "burst record") == static_cast<size_t>(written.load()));
+
+    // 恢复 console 输出，供后续测试使用
+    LogConfig restore = LogConfigAdapter::getDefaultConfig();
+    restore.async_config.enabled = false;
+    assert(Logger::reload(restore).error == LogError::kOk);
+    system(("rm -rf " + root).c_str());
+    std::cout << "  [PASS] test_logger_reload" << std::endl;
+}
+
+void test_logger_reload_stress() {
+    // 多个线程持续记录，同时背靠背热重载：旧处理链回收时不得仍被读者使用
+    const std::string root = "/tmp/tbox_test_reload_stress";
+    const std::string path = root + "/test_early/test_early_0.log";
+    system(("rm -rf " + root).c_str());
+    system(("mkdir -p " + root).c_str());
+
+    LogConfig config = LogConfigAdapter::getDefaultConfig();
+    config.console_config.enabled = false;
+    config.file_config.enabled = true;
+    config.file_config.root = root;
+    config.async_config.enabled = false;
+    assert(Logger::reload(config).error == LogError::kOk);
+
+    // 每个线程的记录数有上限，避免文件轮转；重载持续到全部线程写完
+    const int kPerThread = 5000;
+    std::atomic<int> written{0};
+    std::atomic<int> finished{0};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&]() {
+            Logger worker = Logger::get("reload_stress");
+            for (int i = 0; i < kPerThread; ++i) {
+                worker.error("t.reload.stress", "stress record");
+                written.fetch_add(1);
+            }
+            finished.fetch_add(1);
+        });
+    }
+    for (int i = 0; i < 500 || finished.load() < 4; ++i) {
+        config.level = (i % 2 == 0) ? LogLevel::kInfo : LogLevel::kWarn;
+        assert(Logger::reload(config).error == LogError::kOk);
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    Logger::get("reload_stress").flush();
+    assert(countLines(path, "stress record") == static_cast<size_t>(written.load()));
+
+    LogConfig restore = LogConfigAdapter::getDefaultConfig();
+    restore.async_config.enabled = false;
+    assert(Logger::reload(restore).error == LogError::kOk);
+    system(("rm -rf " + root).c_str());
+    std::cout << "  [PASS] test_logger_reload_stress" << std::endl;
+}
+
+void test_logger_format_template() {
+    const std::string root = "/tmp/tbox_test_format";
+    const std::string path = root + "/test_early/test_early_0.log";
+    system(("rm -rf " + root).c_str());
+    system(("mkdir -p " + root).c_str());
+
+    LogConfig config = LogConfigAdapter::getDefaultConfig();
+    config.console_config.enabled = false;
+    config.file_config.enabled = true;
+    config.file_config.root = root;
+    config.async_config.enabled = true;
+    assert(Logger::reload(config).error == LogError::kOk);
+
+    // 异步：消息在 dispatcher 线程展开，参数按值捕获
+    Logger logger = Logger::get("fmt");
+    {
+        std::string ifname = "eth0";
+        logger.info("net.link", "link {} up after {} ms", ifname, 42);
+        ifname = "changed";
+    }
+    logger.debug("net.link", "filtered {}", 1);
+    logger.flush();
+    assert(countLines(path, "\"message\":\"link eth0 up after 42 ms\"") == 1);
+    assert(countLines(path, "filtered") == 0);
+
+    // 超过栈上缓冲的参数完整保留，后续参数不丢
+    const std::string longValue(600, 'v');
+    logger.info("cfg.load", "cfg {} loaded from {}", longValue, "/etc/a.yaml");
+    logger.flush();
+    assert(countLines(path, "\"message\":\"cfg " + longValue + " loaded from /etc/a.yaml\"") == 1);
+
+    // 同步：过滤之后就地展开
+    config.async_config.enabled = false;
+    assert(Logger::reload(config).error == LogError::kOk);
+    logger.warn("net.link", "{{{}}} retry={} ok={}", -3, 2.5, false);
+    logger.warn("cfg.load", "cfg {} loaded from {}", longValue, "/etc/b.yaml");
+    logger.flush();
+    assert(countLines(path, "\"message\":\"{-3} retry=2.5 ok=false\"") == 1);
+    assert(countLines(path, "\"message\":\"cfg " + longValue + " loaded from /etc/b.yaml\"") == 1);
+
+    LogConfig restore = LogConfigAdapter::getDefaultConfig();
+    restore.async_config.enabled = false;
+    assert(Logger::reload(restore).error == LogError::kOk);
+    system(("rm -rf " + root).c_str());
+    std::cout << "  [PASS] test_logger_format_template" << std::endl;
+}
+
+void test_logger_level_override() {
+    const std::string root = "/tmp/tbox_test_override";
+    const std::string path = root + "/test_early/test_early_0.log";
+    system(("rm -rf " + root).c_str());
+    system(("mkdir -p " + root).c_str());
+
+    LogConfig config = LogConfigAdapter::getDefaultConfig();
+    config.async_config.enabled = false;
+    config.console_config.enabled = false;
+    config.file_config.enabled = true;
+    config.file_config.root = root;
+    LevelOverride fromConfig;
+    fromConfig.session_id = "sess-cfg";
+    config.level_overrides.push_back(fromConfig);
+    assert(Logger::reload(config).error == LogError::kOk);
+
+    LevelOverride runtime;
+    runtime.trace_id = "veh-";
+    runtime.prefix = true;
+    uint64_t id = Logger::addLevelOverride(runtime);
+    assert(id != 0);
+
+    Logger logger = Logger::get("override");
+    logger.debug("t.override", "no context");
+    {
+        ContextScope scope({"veh-001", "", ""});
+        logger.debug("t.override", "matched trace prefix");
+    }
+    {
+        ContextScope scope({"other", "", "sess-cfg"});
+        logger.debug("t.override", "matched config session");
+    }
+
+    // 运行期覆盖跨热重载保留，移除后立即失效
+    assert(Logger::reload(config).error == LogError::kOk);
+    {
+        ContextScope scope({"veh-002", "", ""});
+        logger.debug("t.override", "after reload");
+        assert(Logger::removeLevelOverride(id));
+        assert(!Logger::removeLevelOverride(id));
+        logger.debug("t.override", "after remove");
+    }
+    logger.flush();
+
+    assert(countLines(path, "no context") == 0);
+    assert(countLines(path, "matched trace prefix") == 1);
+    assert(countLines(path, "matched config session") == 1);
+    assert(countLines(path, "after reload") == 1);
+    assert(countLines(path, "after remove") == 0);
+
+    LogConfig restore = LogConfigAdapter::getDefaultConfig();
+    restore.async_config.enabled = false;
+    assert(Logger::reload(restore).error == LogError::kOk);
+    system(("rm -rf " + root).c_str());
+    std::cout << "  [PASS] test_logger_level_override" << std::endl;
+}
+
+void test_logger_module_overflow() {
+    const std::string root = "/tmp/tbox_test_module_overflow";
+    const std::string path = root + "/test_early/test_early_0.log";
+    system(("rm -rf " + root).c_str());
+    system(("mkdir -p " + root).c_str());
+
+    LogConfig config = LogConfigAdapter::getDefaultConfig();
+    config.async_config.enabled = true;     // 模板消息走延迟展开路径
+    config.console_config.enabled = false;
+    config.file_config.enabled = true;
+    config.file_config.root = root;
+    assert(Logger::reload(config).error == LogError::kOk);
+
+    // 填满模块表：之后的新模块共用溢出 ID，但记录保留各自的模块名
+    ModuleTable& table = ModuleTable::instance();
+    for (size_t i = 0; table.size() < ModuleTable::kMaxModules; ++i) {
+        table.intern("fill_" + std::to_string(i));
+    }
+    assert(table.intern("overflow_a") == ModuleTable::kOverflowId);
+
+    Logger first = Logger::get("overflow_a");
+    Logger second = Logger::get("overflow_b");
+    first.info("t.overflow", "from first");
+    second.info("t.overflow", "from second");
+    first.info("t.overflow", "template {}", 1);
+    first.flush();
+
+    assert(countLines(path, "\"module\":\"overflow_a\"") == 2);
+    assert(countLines(path, "\"module\":\"overflow_b\"") == 1);
+    assert(countLines(path, "\"module\":\"_overflow\"") == 0);
+
+    LogConfig restore = LogConfigAdapter::getDefaultConfig();
+    restore.async_config.enabled = false;
+    assert(Logger::reload(restore).error == LogError::kOk);
+    system(("rm -rf " + root).c_str());
+    std::cout << "  [PASS] test_logger_module_overflow" << std::endl;
+}
+
 int main() {
     std::cout << "Running integration tests..." << std::endl;
+    test_logger_before_init();
     test_logger_init_and_log();
     test_logger_level_filtering();
     test_logger_context_propagation();
     test_logger_redaction();
+    test_logger_reload();
+    test_logger_reload_stress();
+    test_logger_format_template();
+    test_logger_level_override();
+    test_logger_module_overflow();
     test_logger_fatal_aborts();
     std::cout << "All integration tests passed!" << std::endl;
     return 0;
@@ -78,6 +78,87 @@ void test_json_single_line_no_newline() {
     std::cout << "  [PASS] test_json_single_line_no_newline" << std::endl;
 }
 
+void test_json_typed_fields() {
+    const unsigned char raw[] = {0x00, 0xAB, 0x7F};
+    std::vector<Field> fields;
+    fields.push_back(Field::u64("bytes_total", 18446744073709551615ULL));
+    fields.push_back(Field::i64("offset", -3));
+    fields.push_back(Field::flag("ok", true));
+    fields.push_back(Field::bytes("frame", raw, sizeof(raw)));
+    fields.push_back(Field::view("vin", std::string_view("LSV123")));
+
+    std::string json = JsonLineFormatter::format(fields);
+    assert(json.find("\"bytes_total\":18446744073709551615") != std::string::npos);
+    assert(json.find("\"offset\":-3") != std::string::npos);
+    assert(json.find("\"ok\":true") != std::string::npos);
+    assert(json.find("\"frame\":\"00ab7f\"") != std::string::npos);
+    assert(json.find("\"vin\":\"LSV123\"") != std::string::npos);
+
+    std::cout << "  [PASS] test_json_typed_fields" << std::endl;
+}
+
+void test_json_bytes_encoding() {
+    const unsigned char raw[] = {'M', 'a', 'n', 0xFF, 0x00};
+    FieldValue hex = FieldValue::makeBytesView(raw, sizeof(raw));
+    hex.truncateBytes(3);
+    FieldValue b64 = FieldValue::makeBytesView(raw, 4);
+    b64.setBase64(true);
+    FieldValue b64Short = FieldValue::makeBytesView(raw, 1);
+    b64Short.setBase64(true);
+
+    std::vector<Field> fields;
+    fields.push_back(Field("hex", hex));
+    fields.push_back(Field("b64", b64));
+    fields.push_back(Field("b64_short", b64Short));
+    std::string json = JsonLineFormatter::format(fields);
+    assert(json == "{\"hex\":\"4d616e...[truncated]\",\"b64\":\"TWFu/w==\",\"b64_short\":\"TQ==\"}");
+
+    std::cout << "  [PASS] test_json_bytes_encoding" << std::endl;
+}
+
+void test_field_value_storage() {
+    // 短字符串内联，长字符串在堆上，拷贝后互不影响
+    FieldValue shortVal = FieldValue::makeString("short");
+    std::string longText(100, 'x');
+    FieldValue longVal = FieldValue::makeString(longText);
+    FieldValue shortCopy = shortVal;
+    FieldValue longCopy = longVal;
+    longText.assign(100, 'y');
+    assert(shortCopy.stringView() == "short");
+    assert(longCopy.stringView() == std::string(100, 'x'));
+
+    FieldValue moved = std::move(longCopy);
+    assert(moved.stringView() == std::string(100, 'x'));
+
+    // 借用字符串 own() 后脱离原缓冲区
+    std::string buffer = "borrowed";
+    FieldValue borrowed = FieldValue::makeStringView(buffer);
+    assert(borrowed.isBorrowed());
+    borrowed.own();
+    assert(!borrowed.isBorrowed());
+    buffer = "changed!";
+    assert(borrowed.stringView() == "borrowed");
+
+    // 运行期 key 拷贝后仍指向自有存储
+    std::string key = "dynamic_key";
+    Field dynamic(key, FieldValue::makeInt(1));
+    Field copy = dynamic;
+    key = "other";
+    assert(copy.key == "dynamic_key");
+
+    // 栈上 char 数组 key 借用，own() 后脱离原缓冲区
+    char stackKey[] = "stack_key";
+    Field fromArray(stackKey, FieldValue::makeInt(2));
+    assert(fromArray.key.data() == stackKey);
+    fromArray.own();
+    stackKey[0] = 'X';
+    assert(fromArray.key == "stack_key");
+    Field moved2 = std::move(fromArray);
+    assert(moved2.key == "stack_key");
+
+    std::cout << "  [PASS] test_field_value_storage" << std::endl;
+}
+
 int main() {
     std::cout << "Running JsonLineFormatter tests..." << std::endl;
     test_json_basic_format();
@@ -85,6 +166,9 @@ int main() {
     test_json_field_order_preserved();
     test_json_value_types();
     test_json_single_line_no_newline();
+    test_json_typed_fields();
+    test_json_bytes_encoding();
+    test_field_value_storage();
     std::cout << "All JsonLineFormatter tests passed!" << std::endl;
     return 0;
 }
@@ -2,6 +2,9 @@
 #include "log/log_level_filter.h"
 #include <cassert>
 #include <iostream>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 using namespace tbox::fw::log;
 
@@ -57,11 +60,137 @@ void test_dynamic_level_update() {
     std::cout << "  [PASS] test_dynamic_level_update" << std::endl;
 }
 
+void test_module_id_lookup() {
+    ModuleTable& table = ModuleTable::instance();
+    ModuleId uds = table.intern("uds");
+    ModuleId can = table.intern("can");
+
+    assert(uds != can);
+    assert(table.intern("uds") == uds);
+    assert(table.name(uds) == "uds");
+    assert(table.name(can) == "can");
+
+    LogConfig config;
+    config.level = LogLevel::kInfo;
+    config.module_levels["uds"] = LogLevel::kDebug;
+    LevelFilter filter(config);
+
+    assert(filter.shouldLog(LogLevel::kDebug, uds) == true);
+    assert(filter.shouldLog(LogLevel::kDebug, can) == false);
+    assert(filter.shouldLog(LogLevel::kInfo, can) == true);
+
+    std::cout << "  [PASS] test_module_id_lookup" << std::endl;
+}
+
+void test_context_overrides() {
+    LogConfig config;
+    config.level = LogLevel::kInfo;
+    LevelFilter filter(config);
+    ModuleId uds = ModuleTable::instance().intern("uds");
+
+    LogContext ctx;
+    ctx.trace_id = "trace-42";
+    ctx.session_id = "VIN123-s7";
+    // 无覆盖：不匹配任何上下文
+    assert(!filter.overrideAllows(LogLevel::kDebug, uds, &ctx));
+
+    LevelOverride byTrace;
+    byTrace.trace_id = "trace-42";
+    LevelOverride bySessionPrefix;
+    bySessionPrefix.session_id = "VIN123";
+    bySessionPrefix.prefix = true;
+    bySessionPrefix.module = "can";
+    bySessionPrefix.level = LogLevel::kTrace;
+    filter.setOverrides({byTrace, bySessionPrefix});
+
+    assert(filter.overrideAllows(LogLevel::kDebug, uds, &ctx));
+    assert(!filter.overrideAllows(LogLevel::kTrace, uds, &ctx));
+    assert(!filter.overrideAllows(LogLevel::kDebug, uds, nullptr));
+
+    ModuleId can = ModuleTable::instance().intern("can");
+    ctx.trace_id = "trace-other";
+    assert(filter.overrideAllows(LogLevel::kTrace, can, &ctx));
+    assert(!filter.overrideAllows(LogLevel::kTrace, uds, &ctx));
+    ctx.session_id = "VIN12";
+    assert(!filter.overrideAllows(LogLevel::kTrace, can, &ctx));
+
+    filter.setOverrides({});
+    ctx.trace_id = "trace-42";
+    assert(!filter.overrideAllows(LogLevel::kDebug, uds, &ctx));
+
+    std::cout << "  [PASS] test_context_overrides" << std::endl;
+}
+
+void test_uuid_session_override() {
+    LogConfig config;
+    config.level = LogLevel::kInfo;
+    LevelFilter filter(config);
+    ModuleId uds = ModuleTable::instance().intern("uds");
+
+    // 36 字符 UUID 完整存入上下文，精确匹配不因截断失效
+    const std::string uuid = "123e4567-e89b-12d3-a456-426614174000";
+    assert(uuid.size() == 36);
+    LevelOverride bySession;
+    bySession.session_id = uuid;
+    bySession.level = LogLevel::kDebug;
+    filter.setOverrides({bySession});
+
+    LogContext ctx;
+    ctx.session_id = uuid;
+    assert(ctx.session_id.size() == 36);
+    assert(filter.overrideAllows(LogLevel::kDebug, uds, &ctx));
+
+    ctx.session_id = "123e4567-e89b-12d3-a456-426614174001";
+    assert(!filter.overrideAllows(LogLevel::kDebug, uds, &ctx));
+
+    std::cout << "  [PASS] test_uuid_session_override" << std::endl;
+}
+
+void test_overrides_replaced_while_reading() {
+    LogConfig config;
+    config.level = LogLevel::kInfo;
+    LevelFilter filter(config);
+    ModuleId uds = ModuleTable::instance().intern("uds");
+
+    LevelOverride stable;
+    stable.trace_id = "trace-stable";
+    LevelOverride toggled;
+    toggled.trace_id = "trace-toggled";
+
+    // 读者无锁读取快照：替换期间始终看到完整的旧快照或新快照
+    std::atomic<bool> done(false);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&]() {
+            LogContext ctx;
+            ctx.trace_id = "trace-stable";
+            while (!done.load()) {
+                assert(filter.overrideAllows(LogLevel::kDebug, uds, &ctx));
+            }
+        });
+    }
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 2 == 0) {
+            filter.setOverrides({stable, toggled});
+        } else {
+            filter.setOverrides({toggled, stable});
+        }
+    }
+    done = true;
+    for (auto& reader : readers) reader.join();
+
+    std::cout << "  [PASS] test_overrides_replaced_while_reading" << std::endl;
+}
+
 int main() {
     std::cout << "Running LevelFilter tests..." << std::endl;
     test_global_level_filter();
     test_module_override();
     test_dynamic_level_update();
+    test_module_id_lookup();
+    test_context_overrides();
+    test_uuid_session_override();
+    test_overrides_replaced_while_reading();
     std::cout << "All LevelFilter tests passed!" << std::endl;
     return 0;
 }
@@ -0,0 +1,63 @@
+#include "log_types.h"
+#include "log_format.h"
+#include "log/log_message_formatter.h"
+#include <cassert>
+#include <iostream>
+
+using namespace tbox::fw::log;
+
+template<typename... Args>
+static std::string render(std::string_view format, const Args&... args) {
+    CatalogArgs packed;
+    (packed.add(args), ...);
+    return MessageFormatter::format(format, packed);
+}
+
+void test_placeholder_count() {
+    static_assert(detail::countPlaceholders("link {} up after {} ms", 22) == 2, "two placeholders");
+    static_assert(detail::countPlaceholders("{{}} {}", 7) == 1, "escaped braces");
+    static_assert(detail::countPlaceholders("{:x}", 4) == 1, "spec ignored");
+    static_assert(detail::countPlaceholders("none", 4) == 0, "no placeholders");
+
+    FormatString<int, const char*> format("a={} b={}");
+    assert(format.get() == "a={} b={}");
+
+    std::cout << "  [PASS] test_placeholder_count" << std::endl;
+}
+
+void test_format_values() {
+    assert(render("link {} up after {} ms", "eth0", 42) == "link eth0 up after 42 ms");
+    assert(render("{} {} {} {}", -7, 7u, 0.5, true) == "-7 7 0.5 true");
+    assert(render("{{{}}}", std::string("x")) == "{x}");
+    assert(render("id={:x}", 255) == "id=255");
+
+    // 参数不足：占位符原样保留；参数多余：忽略
+    assert(render("{} and {}", 1) == "1 and {}");
+    assert(render("only {}", 1, 2) == "only 1");
+    assert(render("unterminated {", 1) == "unterminated {");
+
+    std::cout << "  [PASS] test_format_values" << std::endl;
+}
+
+void test_deferred_record_render() {
+    DeferredRecord record;
+    record.fields.push_back({"event", FieldValue::makeString("net.link")});
+    record.fields.push_back({"message", FieldValue::makeString("")});
+    record.messageIndex = 1;
+    record.format = "retry {} of {}";
+    record.args.add(2);
+    record.args.add(5);
+
+    assert(record.render() == "{\"event\":\"net.link\",\"message\":\"retry 2 of 5\"}");
+
+    std::cout << "  [PASS] test_deferred_record_render" << std::endl;
+}
+
+int main() {
+    std::cout << "Running MessageFormatter tests..." << std::endl;
+    test_placeholder_count();
+    test_format_values();
+    test_deferred_record_render();
+    std::cout << "All MessageFormatter tests passed!" << std::endl;
+    return 0;
+}
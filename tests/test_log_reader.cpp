@@ -0,0 +1,223 @@
+#include "log_types.h"
+#include "log_reader.h"
+#include "log/log_rolling_file_sink.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace tbox::fw::log;
+
+static const std::string kRoot = "/tmp/tbox_test_reader";
+static const std::string kService = "reader_svc";
+static const std::string kLogDir = kRoot + "/" + kService;
+
+static const char* kLevels[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+static const char* kModules[] = {"can", "diag", "tsp"};
+
+// 约 200 字节/行；level 与 module 按序号轮换
+static std::string makeLine(int i) {
+    return "{\"timestamp\":\"2024-01-01T00:00:00.000Z\",\"level\":\"" + std::string(kLevels[i % 4]) +
+           "\",\"service\":\"" + kService + "\",\"module\":\"" + kModules[i % 3] +
+           "\",\"event\":\"reader.test\",\"message\":\"padding padding padding padding padding padding\"" +
+           ",\"seq\":" + std::to_string(i) + "}";
+}
+
+static int seqOf(std::string_view line) {
+    size_t pos = line.find("\"seq\":");
+    assert(pos != std::string_view::npos);
+    return std::atoi(std::string(line.substr(pos + 6)).c_str());
+}
+
+static FileConfig sinkConfig() {
+    FileConfig config;
+    config.enabled = true;
+    config.root = kRoot;
+    config.max_file_size_mb = 1;
+    config.max_files = 10;
+    config.total_budget_mb = 10;
+    config.index = false;
+    return config;
+}
+
+static void resetDir() {
+    system(("rm -rf " + kRoot).c_str());
+    system(("mkdir -p " + kLogDir).c_str());
+}
+
+void test_read_across_segments() {
+    resetDir();
+    {
+        RollingFileSink sink(sinkConfig(), kService);
+        for (int i = 0; i < 12000; ++i) {
+            assert(sink.write(makeLine(i)));
+        }
+        sink.flush();
+    }
+
+    LogReaderOptions options;
+    options.batch_lines = 100;
+    options.map_window_bytes = 8192;    // 小窗口：覆盖窗口边界上的行
+    LogReader reader;
+    assert(reader.open(kLogDir, kService, LogReadFilter(), options).code == LogError::kOk);
+
+    int expected = 0;
+    size_t maxBatch = 0;
+    LogErrorInfo error = reader.readAvailable([&](const std::vector<std::string_view>& lines) {
+        maxBatch = std::max(maxBatch, lines.size());
+        for (std::string_view line : lines) {
+            assert(line.front() == '{' && line.back() == '}');
+            assert(seqOf(line) == expected);
+            ++expected;
+        }
+        return true;
+    });
+    assert(error.code == LogError::kOk);
+    assert(expected == 12000);
+    assert(maxBatch <= 100);
+    assert(reader.currentSegment() >= 2);
+
+    // 再读一次没有新内容
+    int again = 0;
+    reader.readAvailable([&](const std::vector<std::string_view>& lines) {
+        again += static_cast<int>(lines.size());
+        return true;
+    });
+    assert(again == 0);
+    std::cout << "  [PASS] test_read_across_segments" << std::endl;
+}
+
+void test_filter_and_stop() {
+    LogReadFilter filter;
+    filter.min_level = LogLevel::kWarn;
+    filter.modules = {"diag"};
+    LogReader reader;
+    assert(reader.open(kLogDir, kService, filter).code == LogError::kOk);
+
+    int matched = 0;
+    reader.readAvailable([&](const std::vector<std::string_view>& lines) {
+        for (std::string_view line : lines) {
+            int seq = seqOf(line);
+            assert(seq % 4 >= 2 && seq % 3 == 1);
+            ++matched;
+        }
+        return true;
+    });
+    // seq % 12 ∈ {7, 10}
+    assert(matched == 2000);
+
+    // 回调返回 false：停止，位置停在已交付的最后一行之后
+    LogReaderOptions options;
+    options.batch_lines = 10;
+    LogReader limited;
+    assert(limited.open(kLogDir, kService, LogReadFilter(), options).code == LogError::kOk);
+    int delivered = 0;
+    limited.readAvailable([&](const std::vector<std::string_view>& lines) {
+        delivered += static_cast<int>(lines.size());
+        return false;
+    });
+    assert(delivered == 10);
+    int next = -1;
+    limited.readAvailable([&](const std::vector<std::string_view>& lines) {
+        next = seqOf(lines.front());
+        return false;
+    });
+    assert(next == 10);
+    std::cout << "  [PASS] test_filter_and_stop" << std::endl;
+}
+
+void test_partial_line() {
+    resetDir();
+    std::string path = kLogDir + "/" + kService + "_0.log";
+    FILE* f = fopen(path.c_str(), "w");
+    fputs("{\"seq\":0}\n{\"seq\":1", f);
+    fflush(f);
+
+    LogReader reader;
+    assert(reader.open(kLogDir, kService).code == LogError::kOk);
+    std::vector<int> seqs;
+    auto collect = [&](const std::vector<std::string_view>& lines) {
+        for (std::string_view line : lines) seqs.push_back(seqOf(line));
+        return true;
+    };
+    reader.readAvailable(collect);
+    assert(seqs.size() == 1 && seqs[0] == 0);
+
+    fputs("}\n", f);
+    fclose(f);
+    reader.readAvailable(collect);
+    assert(seqs.size() == 2 && seqs[1] == 1);
+    std::cout << "  [PASS] test_partial_line" << std::endl;
+}
+
+void test_follow_rotation() {
+    resetDir();
+    RollingFileSink sink(sinkConfig(), kService);
+    assert(sink.write(makeLine(0)));
+    sink.flush();
+
+    LogReaderOptions options;
+    options.start_at_end = true;
+    LogReader reader;
+    assert(reader.open(kLogDir, kService, LogReadFilter(), options).code == LogError::kOk);
+    // 超时：没有新内容时返回
+    assert(reader.follow([](const std::vector<std::string_view>&) { return true; }, 50).code == LogError::kOk);
+
+    const int total = 10000;    // 约 2 MB，跨越两次滚动
+    std::thread writer([&sink]() {
+        for (int i = 1; i <= total; ++i) {
+            sink.write(makeLine(i));
+            if (i % 500 == 0) {
+                sink.flush();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        sink.flush();
+    });
+
+    int expected = 1;
+    LogErrorInfo error = reader.follow([&](const std::vector<std::string_view>& lines) {
+        for (std::string_view line : lines) {
+            assert(seqOf(line) == expected);
+            ++expected;
+        }
+        return expected <= total;
+    }, 5000);
+    writer.join();
+    assert(error.code == LogError::kOk);
+    assert(expected == total + 1);
+    assert(reader.currentSegment() >= 1);
+
+    // stop() 从其他线程唤醒阻塞中的 follow
+    std::atomic<bool> returned{false};
+    std::thread follower([&]() {
+        reader.follow([](const std::vector<std::string_view>&) { return true; });
+        returned = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    assert(!returned);
+    reader.stop();
+    follower.join();
+    assert(returned);
+
+    LogReader missing;
+    assert(missing.open(kRoot + "/missing", kService).code == LogError::kSearchFailed);
+
+    system(("rm -rf " + kRoot).c_str());
+    std::cout << "  [PASS] test_follow_rotation" << std::endl;
+}
+
+int main() {
+    std::cout << "Running LogReader tests..." << std::endl;
+    test_read_across_segments();
+    test_filter_and_stop();
+    test_partial_line();
+    test_follow_rotation();
+    std::cout << "All LogReader tests passed!" << std::endl;
+    return 0;
+}
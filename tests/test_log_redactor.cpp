@@ -24,10 +24,10 @@ void test_redactor_secret_rejected() {
 
     const Field* pass = findField(result, "password_redacted");
     assert(pass != nullptr);
-    assert(pass->value.stringVal.find("REDACTED") != std::string::npos);
+    assert(pass->value.stringView().find("REDACTED") != std::string::npos);
 
     const Field* user = findField(result, "username");
-    assert(user != nullptr && user->value.stringVal == "admin");
+    assert(user != nullptr && user->value.stringView() == "admin");
 
     std::cout << "  [PASS] test_redactor_secret_rejected" << std::endl;
 }
@@ -61,7 +61,7 @@ void test_redactor_identifier_mask() {
 
     auto result = redactor.redact(std::move(fields));
     assert(result.size() == 1);
-    assert(result[0].value.stringVal == "LV****01");
+    assert(result[0].value.stringView() == "LV****01");
 
     std::cout << "  [PASS] test_redactor_identifier_mask" << std::endl;
 }
@@ -76,11 +76,91 @@ void test_redactor_payload_truncate() {
 
     auto result = redactor.redact(std::move(fields));
     assert(result.size() == 1);
-    assert(result[0].value.stringVal.find("truncated") != std::string::npos);
+    assert(result[0].value.stringView().find("truncated") != std::string::npos);
 
     std::cout << "  [PASS] test_redactor_payload_truncate" << std::endl;
 }
 
+void test_redactor_bytes_truncate_in_place() {
+    RedactConfig cfg;
+    cfg.raw_payload_max_bytes = 16;
+    Redactor redactor(cfg);
+
+    // 借用的 4 KB 帧：截断只缩短长度，仍指向调用方缓冲区
+    std::vector<unsigned char> frame(4096, 0xAB);
+    std::vector<Field> fields;
+    fields.push_back(Field::bytes("frame", frame.data(), frame.size()));
+    fields.push_back(Field::bytes("short", frame.data(), 4));
+
+    auto result = redactor.redact(std::move(fields));
+    assert(result.size() == 2);
+    assert(result[0].value.isBorrowed());
+    assert(result[0].value.stringView().data() == reinterpret_cast<const char*>(frame.data()));
+    assert(result[0].value.stringView().size() == 16);
+    assert(result[0].value.isTruncated());
+    assert(!result[1].value.isTruncated() && result[1].value.stringView().size() == 4);
+
+    // own() 只拷贝保留的前缀
+    result[0].value.own();
+    assert(!result[0].value.isBorrowed() && result[0].value.stringView().size() == 16);
+    assert(result[0].value.isTruncated());
+
+    cfg.payload_encoding = "base64";
+    Redactor base64(cfg);
+    std::vector<Field> encoded;
+    encoded.push_back(Field::bytes("frame", frame.data(), 3));
+    encoded = base64.redact(std::move(encoded));
+    assert(encoded[0].value.isBase64());
+
+    std::cout << "  [PASS] test_redactor_bytes_truncate_in_place" << std::endl;
+}
+
+void test_redactor_bytes_identifier() {
+    const unsigned char sn[] = {0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC};
+    RedactConfig cfg;
+
+    // 标识符策略作用于字节的十六进制文本，不以原文落盘
+    cfg.identifiers = "mask";
+    std::vector<Field> fields;
+    fields.push_back(Field::bytes("device_sn", sn, sizeof(sn), Sensitivity::Identifier));
+    auto result = Redactor(cfg).redact(std::move(fields));
+    assert(result.size() == 1 && result[0].key == "device_sn");
+    assert(result[0].value.type == FieldValueType::kString);
+    assert(result[0].value.stringView() == "12****bc");
+
+    cfg.identifiers = "hash";
+    fields.clear();
+    fields.push_back(Field::bytes("device_sn", sn, sizeof(sn), Sensitivity::Identifier));
+    result = Redactor(cfg).redact(std::move(fields));
+    assert(result[0].value.stringView() == "[hash:12]");
+
+    cfg.identifiers = "reject";
+    fields.clear();
+    fields.push_back(Field::bytes("device_sn", sn, sizeof(sn), Sensitivity::Identifier));
+    result = Redactor(cfg).redact(std::move(fields));
+    assert(result[0].key == "device_sn_redacted");
+    assert(result[0].value.stringView() == "[REDACTED:identifier]");
+
+    std::cout << "  [PASS] test_redactor_bytes_identifier" << std::endl;
+}
+
+void test_redactor_bytes_any_sensitivity_limited() {
+    RedactConfig cfg;
+    cfg.raw_payload_max_bytes = 8;
+    Redactor redactor(cfg);
+
+    // 非 Payload 的字节字段同样限长
+    std::vector<unsigned char> blob(64, 0x01);
+    std::vector<Field> fields;
+    fields.push_back(Field::bytes("blob", blob.data(), blob.size(), Sensitivity::Normal));
+    auto result = redactor.redact(std::move(fields));
+    assert(result.size() == 1);
+    assert(result[0].value.stringView().size() == 8);
+    assert(result[0].value.isTruncated());
+
+    std::cout << "  [PASS] test_redactor_bytes_any_sensitivity_limited" << std::endl;
+}
+
 void test_redactor_normal_passthrough() {
     RedactConfig cfg;
     Redactor redactor(cfg);
@@ -91,7 +171,7 @@ void test_redactor_normal_passthrough() {
 
     auto result = redactor.redact(std::move(fields));
     assert(result.size() == 2);
-    assert(result[0].value.stringVal == "test.event");
+    assert(result[0].value.stringView() == "test.event");
     assert(result[1].value.intVal == 42);
 
     std::cout << "  [PASS] test_redactor_normal_passthrough" << std::endl;
@@ -103,6 +183,9 @@ int main() {
     test_redactor_secret_key_names();
     test_redactor_identifier_mask();
     test_redactor_payload_truncate();
+    test_redactor_bytes_truncate_in_place();
+    test_redactor_bytes_identifier();
+    test_redactor_bytes_any_sensitivity_limited();
     test_redactor_normal_passthrough();
     std::cout << "All Redactor tests passed!" << std::endl;
     return 0;
@@ -0,0 +1,109 @@
+#include "log_types.h"
+#include "log/log_sampler.h"
+#include "log/log_module_table.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace tbox::fw::log;
+
+static SamplingRule everyN(const std::string& module, const std::string& event, uint32_t n) {
+    SamplingRule rule;
+    rule.module = module;
+    rule.event = event;
+    rule.every_n = n;
+    return rule;
+}
+
+void test_sampler_no_rule_keeps_all() {
+    Sampler sampler({everyN("sampler_uds", "", 10)});
+    ModuleId other = ModuleTable::instance().intern("sampler_other");
+    for (int i = 0; i < 100; ++i) {
+        assert(sampler.shouldKeep(LogLevel::kDebug, other, "any.event", nullptr));
+    }
+    std::cout << "  [PASS] test_sampler_no_rule_keeps_all" << std::endl;
+}
+
+void test_sampler_every_n() {
+    Sampler sampler({everyN("sampler_can", "", 10)});
+    ModuleId can = ModuleTable::instance().intern("sampler_can");
+
+    int kept = 0;
+    for (int i = 0; i < 1000; ++i) {
+        if (sampler.shouldKeep(LogLevel::kDebug, can, "can.rx", nullptr)) ++kept;
+    }
+    assert(kept == 100);
+
+    // 高于 max_level 的记录不采样
+    for (int i = 0; i < 10; ++i) {
+        assert(sampler.shouldKeep(LogLevel::kInfo, can, "can.rx", nullptr));
+    }
+    std::cout << "  [PASS] test_sampler_every_n" << std::endl;
+}
+
+void test_sampler_event_filter() {
+    Sampler sampler({everyN("sampler_diag", "diag.uds.tx", 1000)});
+    ModuleId diag = ModuleTable::instance().intern("sampler_diag");
+
+    int keptTx = 0;
+    for (int i = 0; i < 100; ++i) {
+        if (sampler.shouldKeep(LogLevel::kTrace, diag, "diag.uds.tx", nullptr)) ++keptTx;
+        assert(sampler.shouldKeep(LogLevel::kTrace, diag, "diag.uds.rx", nullptr));
+    }
+    assert(keptTx == 1);
+    std::cout << "  [PASS] test_sampler_event_filter" << std::endl;
+}
+
+void test_sampler_trace_hash() {
+    SamplingRule rule;
+    rule.module = "sampler_tsp";
+    rule.trace_ratio = 0.25;
+    Sampler sampler({rule});
+    ModuleId tsp = ModuleTable::instance().intern("sampler_tsp");
+
+    int keptTraces = 0;
+    for (int t = 0; t < 2000; ++t) {
+        LogContext ctx;
+        ctx.trace_id = "trace-" + std::to_string(t);
+        // 同一 trace 的所有记录判定一致
+        bool first = sampler.shouldKeep(LogLevel::kDebug, tsp, "tsp.upload", &ctx);
+        for (int i = 0; i < 5; ++i) {
+            assert(sampler.shouldKeep(LogLevel::kDebug, tsp, "tsp.retry", &ctx) == first);
+        }
+        assert(first == Sampler::traceSelected(ctx.trace_id, 0.25));
+        if (first) ++keptTraces;
+    }
+    assert(keptTraces > 400 && keptTraces < 600);
+
+    // 无 trace 上下文：退化为每 4 条保留 1 条
+    int kept = 0;
+    for (int i = 0; i < 400; ++i) {
+        if (sampler.shouldKeep(LogLevel::kDebug, tsp, "tsp.upload", nullptr)) ++kept;
+    }
+    assert(kept == 100);
+    std::cout << "  [PASS] test_sampler_trace_hash" << std::endl;
+}
+
+void test_sampler_first_rule_wins() {
+    Sampler sampler({everyN("sampler_gnss", "gnss.fix", 1), everyN("sampler_gnss", "", 1000)});
+    ModuleId gnss = ModuleTable::instance().intern("sampler_gnss");
+
+    for (int i = 0; i < 10; ++i) {
+        assert(sampler.shouldKeep(LogLevel::kDebug, gnss, "gnss.fix", nullptr));
+    }
+    assert(sampler.shouldKeep(LogLevel::kDebug, gnss, "gnss.nmea", nullptr));
+    assert(!sampler.shouldKeep(LogLevel::kDebug, gnss, "gnss.nmea", nullptr));
+    std::cout << "  [PASS] test_sampler_first_rule_wins" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Sampler tests..." << std::endl;
+    test_sampler_no_rule_keeps_all();
+    test_sampler_every_n();
+    test_sampler_event_filter();
+    test_sampler_trace_hash();
+    test_sampler_first_rule_wins();
+    std::cout << "All Sampler tests passed!" << std::endl;
+    return 0;
+}
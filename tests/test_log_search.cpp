@@ -0,0 +1,230 @@
+#include "log_types.h"
+#include "log_search.h"
+#include "log/log_rolling_file_sink.h"
+#include "log/log_segment_index.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+
+using namespace tbox::fw::log;
+
+static const std::string kRoot = "/tmp/tbox_test_search";
+static const std::string kService = "search_svc";
+static const std::string kLogDir = kRoot + "/" + kService;
+static const int64_t kBaseMs = 1704067200000LL;     // 2024-01-01T00:00:00.000Z
+static const int kLineCount = 15000;
+
+static std::string formatTimestamp(int64_t epochMs) {
+    time_t sec = static_cast<time_t>(epochMs / 1000);
+    struct tm tm_result;
+    gmtime_r(&sec, &tm_result);
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+             tm_result.tm_year + 1900, tm_result.tm_mon + 1, tm_result.tm_mday,
+             tm_result.tm_hour, tm_result.tm_min, tm_result.tm_sec,
+             static_cast<int>(epochMs % 1000));
+    return buf;
+}
+
+// 每秒一条，每 100 条共用一个 trace_id，约 200 字节/行
+static std::string makeLine(int i) {
+    return "{\"timestamp\":\"" + formatTimestamp(kBaseMs + i * 1000LL) +
+           "\",\"level\":\"INFO\",\"service\":\"" + kService +
+           "\",\"module\":\"tsp\",\"event\":\"tsp.upload\",\"message\":\"uploading batch with padding padding padding\"" +
+           ",\"trace_id\":\"trace-" + std::to_string(i / 100) +
+           "\",\"request_id\":\"req-" + std::to_string(i) + "\",\"seq\":" + std::to_string(i) + "}";
+}
+
+static uint64_t totalSegmentBytes() {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < 16; ++i) {
+        struct stat st;
+        std::string path = kLogDir + "/" + kService + "_" + std::to_string(i) + ".log";
+        if (stat(path.c_str(), &st) == 0) total += static_cast<uint64_t>(st.st_size);
+    }
+    return total;
+}
+
+static void writeLogs() {
+    system(("rm -rf " + kRoot).c_str());
+    system(("mkdir -p " + kRoot).c_str());
+
+    FileConfig config;
+    config.enabled = true;
+    config.root = kRoot;
+    config.max_file_size_mb = 1;
+    config.max_files = 10;
+
+    RollingFileSink sink(config, kService);
+    assert(sink.isAvailable());
+    for (int i = 0; i < kLineCount; ++i) {
+        assert(sink.write(makeLine(i)));
+    }
+    sink.flush();
+}
+
+static std::vector<std::string> runSearch(const LogSearchQuery& query, LogSearchStats& stats) {
+    std::vector<std::string> lines;
+    LogErrorInfo error = LogSearch::search(kLogDir, kService, query, [&lines](std::string_view line) {
+        lines.emplace_back(line);
+        return true;
+    }, &stats);
+    assert(error.code == LogError::kOk);
+    return lines;
+}
+
+void test_segment_helpers() {
+    uint32_t index = 0;
+    assert(SegmentIndex::parseSegmentName("svc_12.log", "svc", index) && index == 12);
+    assert(!SegmentIndex::parseSegmentName("svc_12.log.idx", "svc", index));
+    assert(!SegmentIndex::parseSegmentName("svc_x.log", "svc", index));
+    assert(!SegmentIndex::parseSegmentName("other_1.log", "svc", index));
+
+    assert(LogSearch::parseTimestamp("2024-01-01T00:00:00.000Z") == kBaseMs);
+    assert(LogSearch::parseTimestamp("2024-03-01T12:30:15.250Z") == 1709296215250LL);
+    assert(LogSearch::parseTimestamp("2024-03-01T12:30:15Z") == 1709296215000LL);
+    assert(LogSearch::parseTimestamp("not a time") == -1);
+
+    std::string_view value;
+    std::string line = "{\"message\":\"say \\\"trace_id\\\":\\\"x\\\"\",\"trace_id\":\"abc\"}";
+    assert(SegmentIndex::extractString(line, "trace_id", value) && value == "abc");
+
+    std::cout << "  [PASS] test_segment_helpers" << std::endl;
+}
+
+void test_sink_writes_index() {
+    writeLogs();
+
+    int segments = 0;
+    for (uint32_t i = 0; i < 16; ++i) {
+        std::string path = kLogDir + "/" + kService + "_" + std::to_string(i) + ".log";
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) continue;
+        ++segments;
+        SegmentIndex index;
+        assert(index.load(SegmentIndex::indexPathFor(path)));
+        assert(index.coveredBytes() == static_cast<uint64_t>(st.st_size));
+        assert(!index.buckets().empty());
+    }
+    assert(segments >= 3);
+
+    std::cout << "  [PASS] test_sink_writes_index" << std::endl;
+}
+
+void test_search_by_trace_id() {
+    LogSearchQuery query;
+    query.trace_id = "trace-42";
+    LogSearchStats stats;
+    std::vector<std::string> lines = runSearch(query, stats);
+
+    assert(lines.size() == 100);
+    assert(lines.front().find("\"seq\":4200}") != std::string::npos);
+    assert(lines.back().find("\"seq\":4299}") != std::string::npos);
+    assert(stats.segments_unindexed == 0);
+    assert(stats.segments_skipped >= 1);
+    assert(stats.bytes_scanned < totalSegmentBytes());
+
+    query.trace_id = "trace-missing";
+    lines = runSearch(query, stats);
+    assert(lines.empty());
+
+    query.trace_id.clear();
+    query.request_id = "req-14999";
+    lines = runSearch(query, stats);
+    assert(lines.size() == 1);
+
+    std::cout << "  [PASS] test_search_by_trace_id" << std::endl;
+}
+
+void test_search_by_time_range() {
+    LogSearchQuery query;
+    query.from_ms = kBaseMs + 7000 * 1000LL;
+    query.to_ms = kBaseMs + 7010 * 1000LL;
+    LogSearchStats stats;
+    std::vector<std::string> lines = runSearch(query, stats);
+
+    assert(lines.size() == 11);
+    assert(lines.front().find("\"seq\":7000}") != std::string::npos);
+    // 只读取与时间范围相交的桶
+    assert(stats.bytes_scanned <= 2 * SegmentIndex::kBucketBytes);
+
+    query.limit = 3;
+    lines = runSearch(query, stats);
+    assert(lines.size() == 3);
+
+    std::cout << "  [PASS] test_search_by_time_range" << std::endl;
+}
+
+void test_search_unindexed_and_tail() {
+    // 删除一个段的索引：退化为整段扫描
+    std::string segment0 = kLogDir + "/" + kService + "_0.log";
+    std::remove(SegmentIndex::indexPathFor(segment0).c_str());
+
+    LogSearchQuery query;
+    query.trace_id = "trace-1";
+    LogSearchStats stats;
+    std::vector<std::string> lines = runSearch(query, stats);
+    assert(lines.size() == 100);
+    assert(stats.segments_unindexed == 1);
+
+    // 索引之后追加的内容通过尾部扫描找到
+    std::string lastSegment;
+    for (uint32_t i = 0; i < 16; ++i) {
+        std::string path = kLogDir + "/" + kService + "_" + std::to_string(i) + ".log";
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0) lastSegment = path;
+    }
+    FILE* f = fopen(lastSegment.c_str(), "a");
+    assert(f != nullptr);
+    std::string extra = makeLine(kLineCount) + "\n";
+    fwrite(extra.data(), 1, extra.size(), f);
+    fclose(f);
+
+    query.trace_id = "trace-150";
+    lines = runSearch(query, stats);
+    assert(lines.size() == 1);
+
+    std::cout << "  [PASS] test_search_unindexed_and_tail" << std::endl;
+}
+
+void test_reindex() {
+    int rebuilt = LogSearch::reindex(kLogDir, kService);
+    assert(rebuilt >= 3);
+
+    LogSearchQuery query;
+    query.trace_id = "trace-1";
+    LogSearchStats stats;
+    std::vector<std::string> lines = runSearch(query, stats);
+    assert(lines.size() == 100);
+    assert(stats.segments_unindexed == 0);
+    assert(stats.segments_skipped >= 1);
+
+    system(("rm -rf " + kRoot).c_str());
+    std::cout << "  [PASS] test_reindex" << std::endl;
+}
+
+void test_search_missing_dir() {
+    LogSearchQuery query;
+    LogErrorInfo error = LogSearch::search("/tmp/tbox_test_search_missing", kService, query,
+                                           [](std::string_view) { return true; });
+    assert(error.code == LogError::kSearchFailed);
+
+    std::cout << "  [PASS] test_search_missing_dir" << std::endl;
+}
+
+int main() {
+    std::cout << "Running LogSearch tests..." << std::endl;
+    test_segment_helpers();
+    test_sink_writes_index();
+    test_search_by_trace_id();
+    test_search_by_time_range();
+    test_search_unindexed_and_tail();
+    test_reindex();
+    test_search_missing_dir();
+    std::cout << "All LogSearch tests passed!" << std::endl;
+    return 0;
+}
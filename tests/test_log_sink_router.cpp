@@ -0,0 +1,202 @@
+#include "log.h"
+#include "log/log_sink_router.h"
+#include "log/log_sink_manager.h"
+#include "log/log_config_adapter.h"
+#include "log/log_module_table.h"
+#include <cassert>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+
+using namespace tbox::fw::log;
+
+static const std::string kRoot = "/tmp/tbox_test_router";
+
+static SinkRoute makeRoute(const std::string& module, LogLevel minLevel, LogLevel maxLevel,
+                           std::vector<std::string> sinks) {
+    SinkRoute route;
+    route.module = module;
+    route.min_level = minLevel;
+    route.max_level = maxLevel;
+    route.sinks = std::move(sinks);
+    return route;
+}
+
+static FileConfig namedSink() {
+    FileConfig config;
+    config.enabled = true;
+    config.root = kRoot;
+    config.max_file_size_mb = 1;
+    config.max_files = 2;
+    config.total_budget_mb = 2;
+    return config;
+}
+
+static size_t countLines(const std::string& path, const std::string& part = "") {
+    std::ifstream in(path);
+    std::string line;
+    size_t count = 0;
+    while (std::getline(in, line)) {
+        if (line.find(part) != std::string::npos) ++count;
+    }
+    return count;
+}
+
+void test_router_default() {
+    LogConfig config;
+    SinkRouter router(config);
+    ModuleId module = ModuleTable::instance().intern("router_any");
+    assert(router.route(module, LogLevel::kTrace) == SinkRouter::kDefaultMask);
+    assert(router.route(module, LogLevel::kFatal) == SinkRouter::kDefaultMask);
+    std::cout << "  [PASS] test_router_default" << std::endl;
+}
+
+void test_router_first_match() {
+    LogConfig config;
+    config.named_sinks["audit"] = namedSink();
+    config.named_sinks["can"] = namedSink();
+    config.routes.push_back(makeRoute("router_can", LogLevel::kTrace, LogLevel::kDebug, {"can"}));
+    config.routes.push_back(makeRoute("router_can", LogLevel::kInfo, LogLevel::kFatal, {"can", "file"}));
+    config.routes.push_back(makeRoute("", LogLevel::kError, LogLevel::kFatal, {"console", "file", "audit"}));
+    config.routes.push_back(makeRoute("router_noise", LogLevel::kTrace, LogLevel::kFatal, {}));
+    SinkRouter router(config);
+
+    // 命名 sink 按名字排序分配位：audit=bit2, can=bit3
+    uint32_t audit = SinkRouter::namedBit(0);
+    uint32_t can = SinkRouter::namedBit(1);
+    assert(SinkRouter::sinkBit(config, "audit") == audit);
+    assert(SinkRouter::sinkBit(config, "can") == can);
+    assert(SinkRouter::sinkBit(config, "missing") == 0);
+
+    ModuleId canModule = ModuleTable::instance().intern("router_can");
+    ModuleId other = ModuleTable::instance().intern("router_other");
+    ModuleId noise = ModuleTable::instance().intern("router_noise");
+    assert(router.route(canModule, LogLevel::kDebug) == can);
+    assert(router.route(canModule, LogLevel::kError) == (can | SinkRouter::kFile));
+    assert(router.route(other, LogLevel::kInfo) == SinkRouter::kDefaultMask);
+    assert(router.route(other, LogLevel::kError) == (SinkRouter::kDefaultMask | audit));
+    // 前面的通配规则先命中
+    assert(router.route(noise, LogLevel::kFatal) == (SinkRouter::kDefaultMask | audit));
+    assert(router.route(noise, LogLevel::kInfo) == 0);
+    std::cout << "  [PASS] test_router_first_match" << std::endl;
+}
+
+void test_sink_manager_mask() {
+    system(("rm -rf " + kRoot).c_str());
+    system(("mkdir -p " + kRoot).c_str());
+
+    LogConfig config = LogConfigAdapter::getDefaultConfig();
+    config.console_config.enabled = false;
+    config.file_config.enabled = true;
+    config.file_config.root = kRoot;
+    config.named_sinks["can"] = namedSink();
+    {
+        SinkManager manager(config, "mask_svc");
+        uint32_t can = SinkRouter::namedBit(0);
+        assert(manager.write("{\"n\":1}", false, SinkRouter::kFile));
+        assert(manager.write("{\"n\":2}", false, can));
+        assert(manager.write("{\"n\":3}", false, can | SinkRouter::kFile));
+        assert(manager.write("{\"n\":4}", false, 0));
+        manager.flush();
+    }
+    assert(countLines(kRoot + "/mask_svc/mask_svc_0.log") == 2);
+    assert(countLines(kRoot + "/mask_svc-can/mask_svc-can_0.log") == 2);
+    assert(countLines(kRoot + "/mask_svc-can/mask_svc-can_0.log", "\"n\":2") == 1);
+    std::cout << "  [PASS] test_sink_manager_mask" << std::endl;
+}
+
+void test_logger_routes() {
+    LogConfig config = LogConfigAdapter::getDefaultConfig();
+    config.level = LogLevel::kDebug;
+    config.console_config.enabled = false;
+    config.file_config.enabled = true;
+    config.file_config.root = kRoot;
+    config.flight_recorder_config.enabled = false;
+    config.named_sinks["can"] = namedSink();
+    config.routes.push_back(makeRoute("can", LogLevel::kTrace, LogLevel::kInfo, {"can"}));
+    config.routes.push_back(makeRoute("can", LogLevel::kWarn, LogLevel::kFatal, {"can", "file"}));
+    assert(LogConfigAdapter::validate(config).code == LogError::kOk);
+    assert(Logger::init("route_svc", config).error == LogError::kOk);
+
+    Logger can = Logger::get("can");
+    for (int i = 0; i < 50; ++i) {
+        can.debug("can.rx", "frame", {Field::i64("i", i)});
+    }
+    can.info("can.bus", "link {} up", "can0");
+    can.error("can.bus", "bus off");
+    Logger::get("diag").info("diag.session", "default route");
+    can.flush();
+
+    std::string mainLog = kRoot + "/route_svc/route_svc_0.log";
+    std::string canLog = kRoot + "/route_svc-can/route_svc-can_0.log";
+    assert(countLines(canLog, "\"event\":\"can.rx\"") == 50);
+    assert(countLines(canLog, "link can0 up") == 1);
+    assert(countLines(canLog, "bus off") == 1);
+    assert(countLines(mainLog, "can.rx") == 0);
+    assert(countLines(mainLog, "bus off") == 1);
+    assert(countLines(mainLog, "diag.session") == 1);
+
+    // 热重载去掉路由：恢复默认 console|file
+    config.routes.clear();
+    assert(Logger::reload(config).error == LogError::kOk);
+    can.debug("can.rx", "after reload");
+    can.flush();
+    assert(countLines(mainLog, "after reload") == 1);
+    assert(countLines(canLog, "after reload") == 0);
+
+    system(("rm -rf " + kRoot).c_str());
+    std::cout << "  [PASS] test_logger_routes" << std::endl;
+}
+
+void test_route_config() {
+    std::string section = R"(
+file:
+  enabled: true
+  root: /tmp/tbox_test_router
+sinks:
+  can:
+    max_file_size_mb: 5
+    max_files: 4
+    total_budget_mb: 20
+routes:
+  - module: can
+    max_level: DEBUG
+    sinks: [can]
+  - min_level: ERROR
+    sinks: [console, file]
+)";
+    auto result = LogConfigAdapter::loadFromSection(section);
+    assert(result.second.code == LogError::kOk);
+    const LogConfig& config = result.first;
+    assert(config.named_sinks.size() == 1);
+    assert(config.named_sinks.at("can").root == "/tmp/tbox_test_router");
+    assert(config.named_sinks.at("can").max_files == 4);
+    assert(config.routes.size() == 2);
+    assert(config.routes[0].module == "can" && config.routes[0].max_level == LogLevel::kDebug);
+    assert(config.routes[1].min_level == LogLevel::kError && config.routes[1].sinks.size() == 2);
+
+    result = LogConfigAdapter::loadFromSection("routes:\n  - sinks: [nowhere]\n");
+    assert(result.second.code == LogError::kConfigInvalid);
+    assert(result.second.detail == "routes[0]");
+
+    result = LogConfigAdapter::loadFromSection("routes:\n  - min_level: ERROR\n    max_level: INFO\n");
+    assert(result.second.code == LogError::kConfigInvalid);
+
+    result = LogConfigAdapter::loadFromSection(
+        "sinks:\n  big:\n    root: /tmp\n    max_file_size_mb: 50\n    max_files: 5\n    total_budget_mb: 100\n");
+    assert(result.second.code == LogError::kConfigInvalid);
+    assert(result.second.detail == "sinks.big");
+    std::cout << "  [PASS] test_route_config" << std::endl;
+}
+
+int main() {
+    std::cout << "Running SinkRouter tests..." << std::endl;
+    test_router_default();
+    test_router_first_match();
+    test_sink_manager_mask();
+    test_logger_routes();
+    test_route_config();
+    std::cout << "All SinkRouter tests passed!" << std::endl;
+    return 0;
+}
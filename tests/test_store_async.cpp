@@ -0,0 +1,196 @@
+#include "store.h"
+#include "store/store_file_lock.h"
+#include "store/store_generation.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <sys/stat.h>
+
+using namespace hwyz::store;
+
+static const std::string kRoot = "/tmp/tbox_test_store_async";
+
+static bool fileExists(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+void test_future_and_callback() {
+    system(("rm -rf " + kRoot).c_str());
+    Store store = Store::open("async_svc", kRoot);
+
+    std::future<void> saved = store.saveAsync<int>("counter", 7);
+    saved.get();
+    assert(store.load<int>("counter") == 7);
+
+    std::promise<bool> called;
+    store.saveAsync<std::string>("name", "tbox", [&](const StoreErrorInfo* error) {
+        called.set_value(error == nullptr);
+    });
+    assert(called.get_future().get());
+    assert(store.load<std::string>("name") == "tbox");
+
+    store.removeAsync("counter").get();
+    assert(!store.has("counter"));
+
+    store.cleanup();
+    std::cout << "  [PASS] test_future_and_callback" << std::endl;
+}
+
+void test_coalesce_and_read_queue() {
+    system(("rm -rf " + kRoot).c_str());
+    PathResolver resolver("async_svc", kRoot);
+    Store store = Store::open("async_svc", kRoot);
+    store.save<int>("gone", 1);
+
+    Generation generation(resolver);
+    assert(generation.open());
+
+    // 另一个锁文件描述持有 blocker 的槽位，I/O 线程在其上阻塞
+    assert(FileLock::slotOf("blocker") != FileLock::slotOf("sync"));
+    FileLock holder(resolver);
+    assert(holder.acquire("blocker"));
+    std::future<void> blocked = store.saveAsync<int>("blocker", 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    uint64_t before = generation.load();
+
+    std::vector<std::future<void>> writes;
+    for (int i = 1; i <= 5; ++i) {
+        writes.push_back(store.saveAsync<int>("value", i));
+    }
+    std::future<void> removed = store.removeAsync("gone");
+    std::future<void> superseded = store.saveAsync<int>("sync", 1);
+
+    // 排队期间读取队列中的最新值
+    assert(store.load<int>("value") == 5);
+    assert(store.has("value"));
+    assert(!fileExists(resolver.getKeyPath("value")));
+    assert(!store.has("gone"));
+    try {
+        store.load<int>("gone");
+        assert(false);
+    } catch (const StoreException& e) {
+        assert(e.getError().code == StoreError::kKeyNotFound);
+    }
+    assert(store.loadOr<int>("gone", -1) == -1);
+
+    // 同步写入覆盖排队中的同 key 写入
+    store.save<int>("sync", 2);
+    superseded.get();
+    assert(store.load<int>("sync") == 2);
+
+    // 锁等待超时：错误经 future 传回
+    try {
+        blocked.get();
+        assert(false);
+    } catch (const StoreException& e) {
+        assert(e.getError().code == StoreError::kLockFailed);
+        assert(e.getError().key == "blocker");
+    }
+    holder.release("blocker");
+
+    store.flush();
+    for (auto& write : writes) {
+        write.get();
+    }
+    removed.get();
+    assert(store.load<int>("value") == 5);
+    assert(!fileExists(resolver.getKeyPath("gone")));
+    assert(store.load<int>("sync") == 2);
+
+    // 5 次写入合并为 1 次，另有删除与同步写入各 1 次；被覆盖的异步写入不执行
+    assert(generation.load() - before == 3);
+
+    store.cleanup();
+    std::cout << "  [PASS] test_coalesce_and_read_queue" << std::endl;
+}
+
+void test_drain_and_write_back() {
+    system(("rm -rf " + kRoot).c_str());
+    {
+        Store store = Store::open("async_svc", kRoot);
+        for (int i = 0; i < 50; ++i) {
+            store.saveAsync<int>("key" + std::to_string(i), i, nullptr);
+        }
+    }
+    {
+        // 析构前执行完队列
+        Store store = Store::open("async_svc", kRoot);
+        for (int i = 0; i < 50; ++i) {
+            assert(store.load<int>("key" + std::to_string(i)) == i);
+        }
+        store.cleanup();
+    }
+
+    StoreOptions writeBack;
+    writeBack.writeMode = WriteMode::kWriteBack;
+    writeBack.flushPolicy.debounceMs = 60000;
+    {
+        Store store = Store::open("async_wb", kRoot, writeBack);
+        std::atomic<int> completed{0};
+        store.saveAsync<int>("counter", 3, [&](const StoreErrorInfo* error) {
+            assert(error == nullptr);
+            ++completed;
+        });
+        store.flush();
+        assert(store.load<int>("counter") == 3);
+        assert(fileExists(kRoot + "/async_wb/counter.dat"));
+        while (completed.load() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        store.cleanup();
+    }
+
+    std::cout << "  [PASS] test_drain_and_write_back" << std::endl;
+}
+
+void test_cleanup_fails_queued() {
+    system(("rm -rf " + kRoot).c_str());
+    PathResolver resolver("async_svc", kRoot);
+    Store store = Store::open("async_svc", kRoot);
+
+    // 只有加锁的线程可以释放，加解锁都在同一线程
+    FileLock holder(resolver);
+    std::promise<void> held;
+    std::thread releaser([&] {
+        assert(holder.acquire("blocker"));
+        held.set_value();
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        holder.release("blocker");
+    });
+    held.get_future().get();
+    std::future<void> blocked = store.saveAsync<int>("blocker", 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::future<void> queued = store.saveAsync<int>("queued", 1);
+
+    // 丢弃排队中的 queued，等待执行中的 blocker 结束
+    store.cleanup();
+    releaser.join();
+
+    blocked.get();
+    try {
+        queued.get();
+        assert(false);
+    } catch (const StoreException& e) {
+        assert(e.getError().code == StoreError::kPathUnavailable);
+    }
+
+    system(("rm -rf " + kRoot).c_str());
+    std::cout << "  [PASS] test_cleanup_fails_queued" << std::endl;
+}
+
+int main() {
+    std::cout << "Running Store async tests..." << std::endl;
+    test_future_and_callback();
+    test_coalesce_and_read_queue();
+    test_drain_and_write_back();
+    test_cleanup_fails_queued();
+    std::cout << "All Store async tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,230 @@
+#include "store.h"
+#include "store/store_serializer.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+using namespace hwyz::store;
+
+static const std::string kRoot = "/tmp/tbox_test_store_codec";
+
+struct Calibration {
+    float gain[16];
+    uint32_t flags;
+};
+
+struct CalibrationV1 {
+    float gain[16];
+    uint32_t flags;
+};
+
+// 自定义编解码器：不依赖内存布局
+struct Point {
+    int32_t x;
+    int32_t y;
+};
+
+namespace hwyz {
+namespace store {
+
+template<>
+struct StoreCodec<Calibration> : TrivialStoreCodec<Calibration, 2> {};
+
+template<>
+struct StoreCodec<CalibrationV1> : TrivialStoreCodec<CalibrationV1, 1> {};
+
+template<>
+struct StoreCodec<Point> {
+    static constexpr uint8_t kTypeTag = kTagUser + 1;
+
+    static void encode(const Point& value, CodecWriter& out) {
+        out.writeLE(static_cast<uint32_t>(value.x));
+        out.writeLE(static_cast<uint32_t>(value.y));
+    }
+
+    static bool decode(CodecReader& in, Point& value) {
+        uint32_t x = 0;
+        uint32_t y = 0;
+        if (in.remaining() != 8 || !in.readLE(x) || !in.readLE(y)) {
+            return false;
+        }
+        value.x = static_cast<int32_t>(x);
+        value.y = static_cast<int32_t>(y);
+        return true;
+    }
+};
+
+} // namespace store
+} // namespace hwyz
+
+static bool throwsCode(StoreError code, void (*fn)(Store&), Store& store) {
+    try {
+        fn(store);
+    } catch (const StoreException& e) {
+        return e.getError().code == code;
+    }
+    return false;
+}
+
+void test_integer_types() {
+    system(("rm -rf " + kRoot).c_str());
+    Store store = Store::open("codec_svc", kRoot);
+
+    store.save<int64_t>("big", INT64_MIN + 1);
+    store.save<uint32_t>("mask", 0xFFFFFFF0u);
+    store.save<uint64_t>("total", UINT64_MAX);
+    assert(store.load<int64_t>("big") == INT64_MIN + 1);
+    assert(store.load<uint32_t>("mask") == 0xFFFFFFF0u);
+    assert(store.load<uint64_t>("total") == UINT64_MAX);
+    assert(store.loadOr<uint64_t>("missing", 9) == 9);
+
+    // 宽度或符号不同即类型不符
+    assert(throwsCode(StoreError::kSerializationFailed,
+                      [](Store& s) { s.load<int>("big"); }, store));
+    assert(throwsCode(StoreError::kSerializationFailed,
+                      [](Store& s) { s.load<int32_t>("mask"); }, store));
+
+    store.cleanup();
+    std::cout << "  [PASS] test_integer_types" << std::endl;
+}
+
+void test_bytes_load_into() {
+    system(("rm -rf " + kRoot).c_str());
+    Store store = Store::open("codec_svc", kRoot);
+
+    std::vector<uint8_t> cert(4096);
+    for (size_t i = 0; i < cert.size(); ++i) {
+        cert[i] = static_cast<uint8_t>(i * 7);
+    }
+    store.save("cert", cert);
+    assert(store.load<std::vector<uint8_t>>("cert") == cert);
+
+    // 复用已有容量，不重新分配
+    std::vector<uint8_t> buffer;
+    buffer.reserve(8192);
+    const uint8_t* data = buffer.data();
+    store.loadInto("cert", buffer);
+    assert(buffer == cert);
+    assert(buffer.data() == data);
+
+    // 定长缓冲区
+    uint8_t raw[4096];
+    assert(store.loadInto("cert", raw, sizeof(raw)) == cert.size());
+    assert(std::memcmp(raw, cert.data(), cert.size()) == 0);
+    try {
+        uint8_t small[16];
+        store.loadInto("cert", small, sizeof(small));
+        assert(false);
+    } catch (const StoreException& e) {
+        assert(e.getError().code == StoreError::kSerializationFailed);
+    }
+    try {
+        store.loadInto("absent", raw, sizeof(raw));
+        assert(false);
+    } catch (const StoreException& e) {
+        assert(e.getError().code == StoreError::kKeyNotFound);
+    }
+
+    // 字符串不是字节数组
+    store.save<std::string>("name", "tbox");
+    assert(throwsCode(StoreError::kSerializationFailed,
+                      [](Store& s) { s.load<std::vector<uint8_t>>("name"); }, store));
+
+    std::string name;
+    name.reserve(64);
+    store.loadInto("name", name);
+    assert(name == "tbox");
+
+    store.cleanup();
+    std::cout << "  [PASS] test_bytes_load_into" << std::endl;
+}
+
+void test_trivial_struct() {
+    system(("rm -rf " + kRoot).c_str());
+    Store store = Store::open("codec_svc", kRoot);
+
+    Calibration calibration;
+    for (int i = 0; i < 16; ++i) {
+        calibration.gain[i] = 1.0f + static_cast<float>(i) / 8;
+    }
+    calibration.flags = 0xA5;
+    store.save("calibration", calibration);
+
+    Calibration loaded;
+    store.loadInto("calibration", loaded);
+    assert(std::memcmp(&loaded, &calibration, sizeof(Calibration)) == 0);
+    assert(store.load<Calibration>("calibration").flags == 0xA5);
+
+    // schema 版本不同
+    assert(throwsCode(StoreError::kSerializationFailed,
+                      [](Store& s) { s.load<CalibrationV1>("calibration"); }, store));
+
+    // 自定义编解码器与批量写入
+    auto batch = store.batch();
+    batch.put("origin", Point{-3, 4}).put<uint64_t>("count", 2);
+    batch.commit();
+    Point point = store.load<Point>("origin");
+    assert(point.x == -3 && point.y == 4);
+    assert(store.load<uint64_t>("count") == 2);
+
+    store.cleanup();
+    std::cout << "  [PASS] test_trivial_struct" << std::endl;
+}
+
+void test_other_sources() {
+    system(("rm -rf " + kRoot).c_str());
+    std::vector<uint8_t> blob(1000, 0x5A);
+
+    // 写回缓存中的值
+    StoreOptions writeBack;
+    writeBack.writeMode = WriteMode::kWriteBack;
+    writeBack.flushPolicy.debounceMs = 60000;
+    {
+        Store store = Store::open("codec_wb", kRoot, writeBack);
+        store.save("blob", blob);
+        std::vector<uint8_t> loaded;
+        store.loadInto("blob", loaded);
+        assert(loaded == blob);
+        store.save<int64_t>("offset", -1);
+        assert(store.load<int64_t>("offset") == -1);
+        store.cleanup();
+    }
+
+    // 日志结构后端
+    StoreOptions log;
+    log.backend = StoreBackend::kLogStructured;
+    {
+        Store store = Store::open("codec_log", kRoot, log);
+        store.save("blob", blob);
+        store.save<uint32_t>("version", 7);
+    }
+    {
+        Store store = Store::open("codec_log", kRoot, log);
+        std::vector<uint8_t> loaded;
+        store.loadInto("blob", loaded);
+        assert(loaded == blob);
+        assert(store.load<uint32_t>("version") == 7);
+        uint8_t raw[1000];
+        assert(store.loadInto("blob", raw, sizeof(raw)) == blob.size());
+        assert(throwsCode(StoreError::kSerializationFailed,
+                          [](Store& s) { s.load<int>("version"); }, store));
+        store.cleanup();
+    }
+
+    system(("rm -rf " + kRoot).c_str());
+    std::cout << "  [PASS] test_other_sources" << std::endl;
+}
+
+int main() {
+    std::cout << "Running StoreCodec tests..." << std::endl;
+    test_integer_types();
+    test_bytes_load_into();
+    test_trivial_struct();
+    test_other_sources();
+    std::cout << "All StoreCodec tests passed!" << std::endl;
+    return 0;
+}
@@ -4,6 +4,16 @@
 #include <iostream>
 #include <thread>
 #include <vector>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
 
 using namespace hwyz::store;
 
@@ -52,9 +62,294 @@ void test_concurrent_access() {
     std::remove("/tmp/tbox_test_concurrent");
 }
 
+static long long elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+static std::vector<std::string> listDir(const std::string& path) {
+    std::vector<std::string> names;
+    DIR* dir = opendir(path.c_str());
+    if (dir == nullptr) return names;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name != "." && name != "..") names.push_back(name);
+    }
+    closedir(dir);
+    return names;
+}
+
+void test_persistent_lock_file() {
+    system("rm -rf /tmp/tbox_test_lock_file");
+    PathResolver resolver("svc", "/tmp/tbox_test_lock_file");
+    assert(resolver.ensureDirectory());
+
+    FileLock lock(resolver);
+    for (int i = 0; i < 50; ++i) {
+        std::string key = "key" + std::to_string(i);
+        assert(lock.acquire(key));
+        assert(lock.isHeld(key));
+        lock.release(key);
+        assert(!lock.isHeld(key));
+    }
+    // 只有一个常驻锁文件，不按 key 创建
+    std::vector<std::string> names = listDir(resolver.getStorePath());
+    assert(names.size() == 1 && names[0] == ".lock");
+
+    system("rm -rf /tmp/tbox_test_lock_file");
+    std::cout << "  [PASS] test_persistent_lock_file" << std::endl;
+}
+
+void test_thread_blocking_wait() {
+    system("rm -rf /tmp/tbox_test_lock_wait");
+    PathResolver resolver("svc", "/tmp/tbox_test_lock_wait");
+    assert(resolver.ensureDirectory());
+    FileLock lock(resolver);
+
+    assert(lock.acquire("counter"));
+    std::atomic<bool> acquired(false);
+    std::thread waiter([&]() {
+        // 非持有者：只尝试一次失败，释放无效
+        assert(lock.acquire("counter", 0) == false);
+        lock.release("counter");
+        assert(lock.acquire("counter", 5000));
+        acquired = true;
+        lock.release("counter");
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    assert(!acquired);
+    assert(lock.isHeld("counter"));
+    lock.release("counter");
+    waiter.join();
+    assert(acquired);
+
+    // 进程内超时
+    assert(lock.acquire("counter"));
+    std::thread timeout([&]() {
+        auto start = std::chrono::steady_clock::now();
+        assert(lock.acquire("counter", 100) == false);
+        assert(elapsedMs(start) >= 90);
+    });
+    timeout.join();
+    lock.release("counter");
+
+    system("rm -rf /tmp/tbox_test_lock_wait");
+    std::cout << "  [PASS] test_thread_blocking_wait" << std::endl;
+}
+
+void test_cross_process() {
+    system("rm -rf /tmp/tbox_test_lock_proc");
+    PathResolver resolver("svc", "/tmp/tbox_test_lock_proc");
+    assert(resolver.ensureDirectory());
+
+    // 同一槽位的两个 key 在同进程内共享字节锁
+    std::string first = "slot.a";
+    std::string second;
+    for (int i = 0; second.empty(); ++i) {
+        std::string candidate = "slot." + std::to_string(i);
+        if (candidate != first && FileLock::slotOf(candidate) == FileLock::slotOf(first)) {
+            second = candidate;
+        }
+    }
+
+    int toChild[2];
+    int toParent[2];
+    assert(pipe(toChild) == 0 && pipe(toParent) == 0);
+    pid_t pid = fork();
+    if (pid == 0) {
+        FileLock childLock(resolver);
+        char c;
+        bool ok = childLock.acquire("shared", 1000) && childLock.acquire(first, 1000) &&
+                  childLock.acquire(second, 1000);
+        c = ok ? 'L' : 'F';
+        (void)!write(toParent[1], &c, 1);
+        (void)!read(toChild[0], &c, 1);
+        // 释放其中一个后槽位仍被另一个 key 占用
+        childLock.release(first);
+        (void)!write(toParent[1], &c, 1);
+        (void)!read(toChild[0], &c, 1);
+        childLock.release("shared");
+        childLock.release(second);
+        _exit(ok ? 0 : 1);
+    }
+
+    FileLock lock(resolver);
+    char c = 0;
+    assert(read(toParent[0], &c, 1) == 1 && c == 'L');
+
+    auto start = std::chrono::steady_clock::now();
+    assert(lock.acquire("shared", 0) == false);
+    assert(lock.acquire("shared", 150) == false);
+    long long waited = elapsedMs(start);
+    assert(waited >= 140 && waited < 1000);
+
+    assert(write(toChild[1], &c, 1) == 1);
+    assert(read(toParent[0], &c, 1) == 1);
+    assert(lock.acquire(first, 50) == false);
+
+    // 阻塞等待：对方释放后立即获得，而不是等到下一次轮询
+    std::thread releaser([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        char r = 0;
+        assert(write(toChild[1], &r, 1) == 1);
+    });
+    start = std::chrono::steady_clock::now();
+    assert(lock.acquire("shared", 5000));
+    assert(lock.acquire(first, 5000));
+    waited = elapsedMs(start);
+    assert(waited >= 90 && waited < 1000);
+    releaser.join();
+
+    int status = 0;
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    lock.release("shared");
+    lock.release(first);
+
+    system("rm -rf /tmp/tbox_test_lock_proc");
+    std::cout << "  [PASS] test_cross_process" << std::endl;
+}
+
+void test_unrelated_keys_not_blocked() {
+    system("rm -rf /tmp/tbox_test_lock_stripe");
+    PathResolver resolver("svc", "/tmp/tbox_test_lock_stripe");
+    assert(resolver.ensureDirectory());
+    FileLock lock(resolver);
+
+    // 与热点 key 同条带、不同槽位的 key
+    std::string hot = "hot";
+    std::string neighbor;
+    for (int i = 0; neighbor.empty(); ++i) {
+        std::string candidate = "n" + std::to_string(i);
+        uint32_t slot = FileLock::slotOf(candidate);
+        if (slot % FileLock::kStripeCount == FileLock::slotOf(hot) % FileLock::kStripeCount &&
+            slot != FileLock::slotOf(hot)) {
+            neighbor = candidate;
+        }
+    }
+
+    assert(lock.acquire(hot));
+    std::atomic<bool> waiting(true);
+    std::thread waiter([&]() {
+        assert(lock.acquire(hot, 5000));
+        waiting = false;
+        lock.release(hot);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // 热点 key 有线程在等待时，其他 key 与 isHeld 不受影响
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i) {
+        assert(lock.acquire(neighbor, 0));
+        assert(lock.isHeld(hot));
+        lock.release(neighbor);
+        assert(lock.acquire("other" + std::to_string(i), 0));
+        lock.release("other" + std::to_string(i));
+    }
+    assert(elapsedMs(start) < 500);
+    assert(waiting);
+
+    lock.release(hot);
+    waiter.join();
+    assert(!waiting);
+    assert(!lock.isHeld(hot));
+
+    system("rm -rf /tmp/tbox_test_lock_stripe");
+    std::cout << "  [PASS] test_unrelated_keys_not_blocked" << std::endl;
+}
+
+static void onCustomSignal(int) {}
+
+static bool hasDefaultHandler(int signo) {
+    struct sigaction current;
+    assert(sigaction(signo, nullptr, &current) == 0);
+    return !(current.sa_flags & SA_SIGINFO) && current.sa_handler == SIG_DFL;
+}
+
+void test_timeout_signal_opt_in() {
+    // 前面的跨进程等待未指定信号：不触碰任何信号处理函数
+    const int signo = SIGRTMAX - 1;
+    assert(hasDefaultHandler(signo));
+
+    system("rm -rf /tmp/tbox_test_lock_signal");
+    PathResolver resolver("svc", "/tmp/tbox_test_lock_signal");
+    assert(resolver.ensureDirectory());
+
+    int toChild[2];
+    int toParent[2];
+    assert(pipe(toChild) == 0 && pipe(toParent) == 0);
+    pid_t pid = fork();
+    if (pid == 0) {
+        FileLock childLock(resolver);
+        char c = childLock.acquire("held", 1000) ? 'L' : 'F';
+        (void)!write(toParent[1], &c, 1);
+        (void)!read(toChild[0], &c, 1);
+        childLock.release("held");
+        _exit(c == 'L' ? 0 : 1);
+    }
+    char c = 0;
+    assert(read(toParent[0], &c, 1) == 1 && c == 'L');
+
+    // 指定信号：阻塞等待按时超时，并为该信号安装处理函数
+    FileLock lock(resolver, signo);
+    auto start = std::chrono::steady_clock::now();
+    assert(lock.acquire("held", 150) == false);
+    long long waited = elapsedMs(start);
+    assert(waited >= 140 && waited < 1000);
+    assert(!hasDefaultHandler(signo));
+
+    // 信号已有其他处理函数：不覆盖，退化为重试，超时仍然有效
+    const int taken = SIGRTMAX - 2;
+    struct sigaction custom;
+    std::memset(&custom, 0, sizeof(custom));
+    custom.sa_handler = onCustomSignal;
+    sigemptyset(&custom.sa_mask);
+    assert(sigaction(taken, &custom, nullptr) == 0);
+    FileLock polling(resolver, taken);
+    start = std::chrono::steady_clock::now();
+    assert(polling.acquire("held", 100) == false);
+    waited = elapsedMs(start);
+    assert(waited >= 90 && waited < 1000);
+    struct sigaction after;
+    assert(sigaction(taken, nullptr, &after) == 0 && after.sa_handler == onCustomSignal);
+
+    assert(write(toChild[1], &c, 1) == 1);
+    int status = 0;
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(lock.acquire("held", 1000));
+    lock.release("held");
+
+    system("rm -rf /tmp/tbox_test_lock_signal");
+    std::cout << "  [PASS] test_timeout_signal_opt_in" << std::endl;
+}
+
+void test_lock_order() {
+    // 先按槽位再按 key：同槽位的 key 相邻，槽位间按编号递增
+    std::vector<std::string> keys;
+    for (int i = 0; i < 64; ++i) {
+        keys.push_back("k" + std::to_string(i));
+    }
+    std::sort(keys.begin(), keys.end(), FileLock::lockOrder);
+    for (size_t i = 1; i < keys.size(); ++i) {
+        uint32_t prev = FileLock::slotOf(keys[i - 1]);
+        uint32_t cur = FileLock::slotOf(keys[i]);
+        assert(prev < cur || (prev == cur && keys[i - 1] < keys[i]));
+    }
+    assert(!FileLock::lockOrder("k1", "k1"));
+    std::cout << "  [PASS] test_lock_order" << std::endl;
+}
+
 int main() {
     test_basic_lock_unlock();
     test_concurrent_access();
+    test_persistent_lock_file();
+    test_thread_blocking_wait();
+    test_cross_process();
+    test_unrelated_keys_not_blocked();
+    test_timeout_signal_opt_in();
+    test_lock_order();
     std::cout << "All file lock tests passed!" << std::endl;
     return 0;
 }
@@ -2,6 +2,7 @@
 #include <cassert>
 #include <iostream>
 #include <thread>
+#include <chrono>
 
 using namespace hwyz::store;
 
@@ -60,6 +61,33 @@ void test_debounce() {
     assert(policy.shouldFlush() == true);
 }
 
+void test_max_delay() {
+    FlushPolicyConfig config;
+    config.enableDebounce = true;
+    config.debounceMs = 50;
+    config.maxDelayMs = 100;
+
+    FlushPolicy policy(config);
+
+    // 持续更新：去抖永不到期，但首次标脏满 maxDelayMs 后仍应刷新
+    auto start = std::chrono::steady_clock::now();
+    bool flushed = false;
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(300)) {
+        policy.markDirty("counter");
+        if (policy.shouldFlush()) {
+            flushed = true;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    assert(flushed);
+
+    // 清除后重新计时
+    policy.clearDirty("counter");
+    policy.markDirty("counter");
+    assert(policy.shouldFlush() == false);
+}
+
 void test_get_dirty_keys() {
     FlushPolicy policy;
 
@@ -116,12 +144,47 @@ void test_reset() {
     assert(policy.isDirty("key3") == true);
 }
 
+void test_next_flush_time() {
+    FlushPolicyConfig config;
+    config.enableDebounce = true;
+    config.debounceMs = 200;
+    config.maxDelayMs = 500;
+    config.maxDirtyCount = 3;
+
+    FlushPolicy policy(config);
+    std::chrono::steady_clock::time_point when;
+
+    // 没有脏条目：无期限
+    assert(policy.nextFlushTime(when) == false);
+
+    // 期限为最早的去抖到期时刻
+    auto before = std::chrono::steady_clock::now();
+    policy.markDirty("key1");
+    assert(policy.nextFlushTime(when) == true);
+    assert(when >= before + std::chrono::milliseconds(200));
+    assert(when <= std::chrono::steady_clock::now() + std::chrono::milliseconds(200));
+
+    // 达到数量阈值：立即
+    policy.markDirty("key2");
+    policy.markDirty("key3");
+    assert(policy.nextFlushTime(when) == true);
+    assert(when <= std::chrono::steady_clock::now());
+
+    // 关闭去抖时只能由数量阈值触发
+    config.enableDebounce = false;
+    FlushPolicy countOnly(config);
+    countOnly.markDirty("key1");
+    assert(countOnly.nextFlushTime(when) == false);
+}
+
 int main() {
     test_dirty_marking();
     test_should_flush();
     test_debounce();
+    test_max_delay();
     test_get_dirty_keys();
     test_reset();
+    test_next_flush_time();
     std::cout << "All flush policy tests passed!" << std::endl;
     return 0;
 }
@@ -0,0 +1,156 @@
+#include "store.h"
+#include "store/store_key_index.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+
+using namespace hwyz::store;
+
+static const std::string kRoot = "/tmp/tbox_test_store_key_index";
+
+static void writeFile(const std::string& path, const std::string& data) {
+    std::ofstream ofs(path, std::ios::trunc);
+    ofs << data;
+}
+
+void test_key_of() {
+    std::string key;
+    assert(KeyIndex::keyOf("counter.dat", key) && key == "counter");
+    assert(KeyIndex::keyOf("session.id.dat", key) && key == "session.id");
+    assert(KeyIndex::keyOf("counter.dat.tmp", key) == false);
+    assert(KeyIndex::keyOf(".generation", key) == false);
+    assert(KeyIndex::keyOf(".lock", key) == false);
+    assert(KeyIndex::keyOf("store.log", key) == false);
+    std::cout << "  [PASS] test_key_of" << std::endl;
+}
+
+void test_build_and_publish() {
+    system(("rm -rf " + kRoot).c_str());
+    PathResolver resolver("index_unit", kRoot);
+    assert(resolver.ensureDirectory());
+    writeFile(resolver.getKeyPath("a"), "1");
+    writeFile(resolver.getKeyPath("b"), "2");
+    writeFile(resolver.getTempPath("c"), "3");
+
+    Generation generation(resolver);
+    assert(generation.open());
+    KeyIndex index(resolver, generation);
+    assert(index.open());
+    assert(index.size() == 2);
+    std::vector<std::string> keys = index.keys();
+    std::sort(keys.begin(), keys.end());
+    assert(keys == std::vector<std::string>({"a", "b"}));
+    assert(index.contains("a") && !index.contains("c"));
+
+    // 本进程写入：索引随代数前进，不重新扫描
+    writeFile(resolver.getKeyPath("d"), "4");
+    index.update("d", true);
+    index.published(generation.bump());
+    std::remove(resolver.getKeyPath("a").c_str());
+    assert(index.contains("d") && index.contains("a"));
+
+    // 期间有其他进程递增代数：下次查询重新扫描目录
+    index.update("e", true);
+    generation.bump();
+    index.published(generation.bump());
+    assert(!index.contains("e") && !index.contains("a"));
+    assert(index.contains("d") && index.size() == 2);
+
+    index.close();
+    assert(!index.enabled());
+    system(("rm -rf " + kRoot).c_str());
+    std::cout << "  [PASS] test_build_and_publish" << std::endl;
+}
+
+void test_store_lookup() {
+    system(("rm -rf " + kRoot).c_str());
+    {
+        Store store = Store::open("index_svc", kRoot);
+        store.save<int>("counter", 1);
+        store.save<std::string>("name", "tbox");
+    }
+
+    Store store = Store::open("index_svc", kRoot);
+    assert(store.has("counter") && store.has("name"));
+    assert(!store.has("absent"));
+    try {
+        store.load<int>("absent");
+        assert(false);
+    } catch (const StoreException& e) {
+        assert(e.getError().code == StoreError::kKeyNotFound);
+    }
+
+    // has() 与 load 由索引应答：绕过 Store 的增删不可见
+    const std::string dir = kRoot + "/index_svc/";
+    std::remove((dir + "name.dat").c_str());
+    writeFile(dir + "ghost.dat", "7");
+    assert(store.has("name"));
+    assert(!store.has("ghost"));
+    try {
+        store.load<int>("ghost");
+        assert(false);
+    } catch (const StoreException& e) {
+        assert(e.getError().code == StoreError::kKeyNotFound);
+    }
+
+    // 关闭索引时按文件系统判断
+    StoreOptions options;
+    options.keyIndex = false;
+    Store direct = Store::open("index_svc", kRoot, options);
+    assert(!direct.has("name"));
+    assert(direct.has("ghost") && direct.load<int>("ghost") == 7);
+
+    store.remove("counter");
+    assert(!store.has("counter"));
+    store.cleanup();
+    std::cout << "  [PASS] test_store_lookup" << std::endl;
+}
+
+void test_cross_instance() {
+    system(("rm -rf " + kRoot).c_str());
+    Store writer = Store::open("index_svc", kRoot);
+    Store reader = Store::open("index_svc", kRoot);
+    assert(!reader.has("token"));
+
+    writer.save<std::string>("token", "abc");
+    assert(reader.has("token"));
+    assert(reader.load<std::string>("token") == "abc");
+
+    writer.remove("token");
+    assert(!reader.has("token"));
+
+    auto batch = writer.batch();
+    batch.put<int>("x", 1).put<int>("y", 2).remove("x");
+    batch.commit();
+    assert(!reader.has("x") && reader.has("y"));
+    assert(!writer.has("x") && writer.has("y"));
+
+    // 写回模式落盘后其他实例可见
+    StoreOptions writeBack;
+    writeBack.writeMode = WriteMode::kWriteBack;
+    writeBack.flushPolicy.debounceMs = 60000;
+    Store buffered = Store::open("index_svc", kRoot, writeBack);
+    buffered.save<int>("pending", 3);
+    assert(buffered.has("pending"));
+    assert(!reader.has("pending"));
+    buffered.flush();
+    assert(buffered.has("pending"));
+    assert(reader.has("pending") && reader.load<int>("pending") == 3);
+
+    writer.cleanup();
+    std::cout << "  [PASS] test_cross_instance" << std::endl;
+}
+
+int main() {
+    std::cout << "Running KeyIndex tests..." << std::endl;
+    test_key_of();
+    test_build_and_publish();
+    test_store_lookup();
+    test_cross_instance();
+    std::cout << "All KeyIndex tests passed!" << std::endl;
+    return 0;
+}
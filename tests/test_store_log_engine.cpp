@@ -0,0 +1,333 @@
+#include "store.h"
+#include "store/store_log_engine.h"
+#include <cassert>
+#include <cerrno>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <future>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace hwyz::store;
+
+static const std::string kRoot = "/tmp/tbox_test_store_log";
+
+static LogEngine::Options foregroundOptions() {
+    LogEngine::Options options;
+    options.background = false;
+    return options;
+}
+
+static uint64_t fileSize(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+void test_put_get_remove() {
+    system(("rm -rf " + kRoot).c_str());
+    PathResolver resolver("engine", kRoot);
+    assert(resolver.ensureDirectory());
+
+    LogEngine engine(resolver, foregroundOptions());
+    assert(engine.open());
+
+    assert(engine.put("counter", "1"));
+    assert(engine.put("name", "tbox"));
+    assert(engine.put("counter", "2"));
+
+    std::string value;
+    assert(engine.get("counter", value) == 0 && value == "2");
+    assert(engine.get("name", value) == 0 && value == "tbox");
+    assert(engine.get("missing", value) == ENOENT);
+    assert(engine.size() == 2);
+    assert(engine.garbageBytes() > 0);
+
+    assert(engine.remove("name"));
+    assert(engine.contains("name") == false);
+    assert(engine.get("name", value) == ENOENT);
+    assert(engine.remove("name"));
+
+    assert(engine.putBatch({{"a", "1"}, {"b", "2"}, {"a", "3"}}));
+    assert(engine.get("a", value) == 0 && value == "3");
+    assert(engine.get("b", value) == 0 && value == "2");
+
+    // 空 key 拒绝
+    assert(engine.put("", "x") == false);
+
+    // 同一存储只允许一个实例
+    LogEngine other(resolver, foregroundOptions());
+    assert(other.open() == false);
+
+    std::cout << "  [PASS] test_put_get_remove" << std::endl;
+}
+
+void test_recovery() {
+    PathResolver resolver("engine", kRoot);
+    std::string storePath = resolver.getStorePath();
+
+    // 正常关闭：从检查点恢复
+    {
+        LogEngine engine(resolver, foregroundOptions());
+        assert(engine.open());
+        std::string value;
+        assert(engine.get("counter", value) == 0 && value == "2");
+        assert(engine.get("a", value) == 0 && value == "3");
+        assert(engine.contains("name") == false);
+        assert(engine.size() == 3);
+
+        // 检查点之后再写入，然后模拟掉电：复制磁盘上的文件
+        assert(engine.put("after", "checkpoint"));
+        assert(engine.remove("b"));
+        system(("rm -rf " + kRoot + "/crash && mkdir -p " + kRoot + "/crash && cp " +
+                storePath + "store.log " + storePath + "store.ckpt " + kRoot + "/crash/").c_str());
+    }
+
+    // 追加一条写到一半的记录
+    std::string crashLog = kRoot + "/crash/store.log";
+    uint64_t intactSize = fileSize(crashLog);
+    {
+        std::ofstream ofs(crashLog, std::ios::app | std::ios::binary);
+        ofs.write("\x12\x34\x56\x78\x01\x00\x05\x00", 8);
+    }
+
+    PathResolver crashResolver("crash", kRoot);
+    LogEngine engine(crashResolver, foregroundOptions());
+    assert(engine.open());
+    std::string value;
+    assert(engine.get("after", value) == 0 && value == "checkpoint");
+    assert(engine.contains("b") == false);
+    assert(engine.get("counter", value) == 0 && value == "2");
+    assert(engine.size() == 3);
+    // 残缺尾部被截断
+    assert(fileSize(crashLog) == intactSize);
+
+    // 检查点损坏：回退为全量扫描
+    engine.close();
+    {
+        std::fstream fs(kRoot + "/crash/store.ckpt", std::ios::in | std::ios::out | std::ios::binary);
+        fs.seekp(20);
+        fs.write("\xFF", 1);
+    }
+    assert(engine.open());
+    assert(engine.get("after", value) == 0 && value == "checkpoint");
+    assert(engine.size() == 3);
+
+    std::cout << "  [PASS] test_recovery" << std::endl;
+}
+
+void test_compaction() {
+    system(("rm -rf " + kRoot).c_str());
+    PathResolver resolver("compact", kRoot);
+    assert(resolver.ensureDirectory());
+    std::string logPath = resolver.getStorePath() + "store.log";
+
+    LogEngine engine(resolver, foregroundOptions());
+    assert(engine.open());
+    std::string payload(1000, 'x');
+    for (int i = 0; i < 200; ++i) {
+        assert(engine.put("key" + std::to_string(i % 10), payload + std::to_string(i)));
+    }
+    assert(engine.remove("key9"));
+    uint64_t before = engine.fileBytes();
+    assert(engine.garbageBytes() > engine.liveBytes());
+
+    assert(engine.compact());
+    assert(engine.garbageBytes() == 0);
+    assert(engine.fileBytes() < before / 10);
+    assert(fileSize(logPath) == engine.fileBytes());
+    std::string value;
+    for (int k = 0; k < 9; ++k) {
+        assert(engine.get("key" + std::to_string(k), value) == 0);
+        assert(value == payload + std::to_string(190 + k));
+    }
+    assert(engine.contains("key9") == false);
+
+    // 压缩后的文件可恢复
+    engine.close();
+    assert(engine.open());
+    assert(engine.size() == 9);
+    assert(engine.get("key3", value) == 0 && value == payload + "193");
+    engine.close();
+
+    // 后台压缩：写入过程中达到阈值自动触发
+    LogEngine::Options options;
+    options.compactMinBytes = 64 * 1024;
+    LogEngine background(resolver, options);
+    assert(background.open());
+    for (int i = 0; i < 500; ++i) {
+        assert(background.put("hot", payload + std::to_string(i)));
+    }
+    for (int i = 0; i < 100 && background.fileBytes() > 128 * 1024; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    assert(background.fileBytes() < 128 * 1024);
+    assert(background.get("hot", value) == 0 && value == payload + "499");
+
+    std::cout << "  [PASS] test_compaction" << std::endl;
+}
+
+void test_concurrent_append() {
+    system(("rm -rf " + kRoot).c_str());
+    PathResolver resolver("concurrent", kRoot);
+    assert(resolver.ensureDirectory());
+
+    // 追加与同步期间读者照常读取已发布的记录；后台压缩同时进行
+    LogEngine::Options options;
+    options.compactMinBytes = 16 * 1024;
+    LogEngine engine(resolver, options);
+    assert(engine.open());
+
+    const int kWriters = 4;
+    const int kWrites = 200;
+    std::atomic<bool> done(false);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&]() {
+            std::string value;
+            while (!done.load()) {
+                for (int t = 0; t < kWriters; ++t) {
+                    std::string key = "w" + std::to_string(t);
+                    int rc = engine.get(key, value);
+                    assert(rc == 0 || rc == ENOENT);
+                    assert(rc != 0 || value.compare(0, key.size() + 1, key + "-") == 0);
+                }
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kWriters; ++t) {
+        writers.emplace_back([&engine, t]() {
+            std::string key = "w" + std::to_string(t);
+            for (int i = 0; i < kWrites; ++i) {
+                assert(engine.put(key, key + "-" + std::to_string(i) + std::string(200, 'p')));
+            }
+        });
+    }
+    for (auto& writer : writers) writer.join();
+    done = true;
+    for (auto& reader : readers) reader.join();
+
+    std::string value;
+    for (int t = 0; t < kWriters; ++t) {
+        std::string key = "w" + std::to_string(t);
+        assert(engine.get(key, value) == 0);
+        assert(value == key + "-" + std::to_string(kWrites - 1) + std::string(200, 'p'));
+    }
+    engine.close();
+    assert(engine.open());
+    assert(engine.size() == kWriters);
+    assert(engine.get("w0", value) == 0 && value.compare(0, 6, "w0-199") == 0);
+    engine.close();
+
+    std::cout << "  [PASS] test_concurrent_append" << std::endl;
+}
+
+void test_read_during_compaction() {
+    system(("rm -rf " + kRoot).c_str());
+    PathResolver resolver("slow_read", kRoot);
+    assert(resolver.ensureDirectory());
+
+    LogEngine engine(resolver, foregroundOptions());
+    assert(engine.open());
+    std::string payload(1000, 'r');
+    for (int i = 0; i < 50; ++i) {
+        assert(engine.put("key", payload + std::to_string(i)));
+    }
+
+    // 读取回调不持有索引锁：回调阻塞期间写入与压缩照常完成，
+    // 回调读到的仍是取位置时的文件与记录
+    std::promise<void> entered;
+    std::promise<void> resume;
+    std::string slowValue;
+    std::thread reader([&] {
+        int rc = engine.read("key", [&](int fd, uint64_t offset, uint32_t size) {
+            entered.set_value();
+            resume.get_future().wait();
+            slowValue.resize(size);
+            return pread(fd, &slowValue[0], size, static_cast<off_t>(offset)) == static_cast<ssize_t>(size)
+                   ? 0 : EIO;
+        });
+        assert(rc == 0);
+    });
+    entered.get_future().get();
+
+    assert(engine.put("key", payload + "new"));
+    assert(engine.compact());
+    std::string value;
+    assert(engine.get("key", value) == 0 && value == payload + "new");
+
+    resume.set_value();
+    reader.join();
+    assert(slowValue == payload + "49");
+    engine.close();
+
+    std::cout << "  [PASS] test_read_during_compaction" << std::endl;
+}
+
+void test_store_backend() {
+    system(("rm -rf " + kRoot).c_str());
+    StoreOptions options;
+    options.backend = StoreBackend::kLogStructured;
+    {
+        Store store = Store::open("log_svc", kRoot, options);
+        assert(store.isReady());
+        store.save<int>("counter", 7);
+        store.save<double>("ratio", 0.25);
+        store.save<std::string>("name", "tbox");
+        store.save<bool>("enabled", true);
+        assert(store.load<int>("counter") == 7);
+        assert(store.has("name"));
+        store.remove("name");
+        assert(store.has("name") == false);
+        assert(store.loadOr<std::string>("name", "none") == "none");
+
+        // 同一存储被占用时打不开
+        Store busy = Store::open("log_svc", kRoot, options);
+        assert(busy.isReady() == false);
+    }
+    // 单文件布局：没有按 key 的文件
+    assert(fileSize(kRoot + "/log_svc/counter.dat") == 0);
+
+    {
+        Store store = Store::open("log_svc", kRoot, options);
+        assert(store.load<int>("counter") == 7);
+        assert(store.load<double>("ratio") == 0.25);
+        assert(store.load<bool>("enabled") == true);
+        assert(store.has("name") == false);
+    }
+
+    // 写回模式：整批追加
+    options.writeMode = WriteMode::kWriteBack;
+    {
+        Store store = Store::open("log_svc", kRoot, options);
+        for (int i = 0; i < 100; ++i) {
+            store.save<int>("counter", i);
+        }
+        store.flush();
+    }
+    options.writeMode = WriteMode::kWriteThrough;
+    Store store = Store::open("log_svc", kRoot, options);
+    assert(store.load<int>("counter") == 99);
+    store.cleanup();
+
+    std::cout << "  [PASS] test_store_backend" << std::endl;
+}
+
+int main() {
+    std::cout << "Running LogEngine tests..." << std::endl;
+    test_put_get_remove();
+    test_recovery();
+    test_compaction();
+    test_concurrent_append();
+    test_read_during_compaction();
+    test_store_backend();
+    system(("rm -rf " + kRoot).c_str());
+    std::cout << "All LogEngine tests passed!" << std::endl;
+    return 0;
+}
@@ -2,6 +2,14 @@
 #include <cassert>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <chrono>
+#include <sys/stat.h>
+
+static bool fileExists(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
 
 using namespace hwyz::store;
 
@@ -86,6 +94,65 @@ void test_exception_on_missing_key() {
     store.cleanup();
 }
 
+void test_write_back() {
+    StoreOptions options;
+    options.writeMode = WriteMode::kWriteBack;
+    options.flushPolicy.debounceMs = 50;
+    options.flushPolicy.maxDelayMs = 100;
+    const std::string keyPath = "/tmp/tbox_test_store_wb/test_wb/counter.dat";
+
+    Store store = Store::open("test_wb", "/tmp/tbox_test_store_wb", options);
+    assert(store.isReady() == true);
+
+    // save 只进内存：立即可读，文件尚未写出
+    store.save<int>("counter", 1);
+    assert(store.load<int>("counter") == 1);
+    assert(store.has("counter") == true);
+    assert(fileExists(keyPath) == false);
+
+    // 10 Hz 以上的持续更新由后台线程按 maxDelayMs 落盘
+    for (int i = 2; i <= 30; ++i) {
+        store.save<int>("counter", i);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    assert(fileExists(keyPath) == true);
+    assert(store.load<int>("counter") == 30);
+
+    // flush() 强制落盘
+    store.save<std::string>("name", "wb");
+    store.flush();
+    Store reader = Store::open("test_wb", "/tmp/tbox_test_store_wb");
+    assert(reader.load<std::string>("name") == "wb");
+    assert(reader.load<int>("counter") == 30);
+
+    // remove 同时丢弃未落盘的值
+    store.save<int>("counter", 31);
+    store.remove("counter");
+    assert(store.has("counter") == false);
+    store.flush();
+    assert(fileExists(keyPath) == false);
+
+    store.cleanup();
+}
+
+void test_write_back_flush_on_destroy() {
+    StoreOptions options;
+    options.writeMode = WriteMode::kWriteBack;
+    options.flushPolicy.debounceMs = 60000;
+    {
+        Store store = Store::open("test_wb_dtor", "/tmp/tbox_test_store_wb_dtor", options);
+        store.save<double>("ratio", 0.5);
+        store.save<bool>("enabled", true);
+    }
+
+    // 析构时落盘剩余脏数据
+    Store store = Store::open("test_wb_dtor", "/tmp/tbox_test_store_wb_dtor");
+    assert(store.load<double>("ratio") == 0.5);
+    assert(store.load<bool>("enabled") == true);
+    store.cleanup();
+}
+
 int main() {
     test_store_open();
     test_save_load_int();
@@ -93,6 +160,8 @@ int main() {
     test_load_or_default();
     test_has_remove();
     test_exception_on_missing_key();
+    test_write_back();
+    test_write_back_flush_on_destroy();
     std::cout << "All store manager tests passed!" << std::endl;
     return 0;
 }
@@ -0,0 +1,181 @@
+#include "store.h"
+#include "store/store_read_cache.h"
+#include "store/store_generation.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <fstream>
+#include <cstdlib>
+
+using namespace hwyz::store;
+
+static const std::string kRoot = "/tmp/tbox_test_store_cache";
+
+static void writeFile(const std::string& path, const std::string& data) {
+    std::ofstream ofs(path, std::ios::trunc);
+    ofs << data;
+}
+
+void test_cache_hit_and_type() {
+    system(("rm -rf " + kRoot).c_str());
+    PathResolver resolver("cache_unit", kRoot);
+    assert(resolver.ensureDirectory());
+
+    // 未打开的代数：缓存停用
+    Generation closed(resolver);
+    ReadCache disabled(resolver, closed);
+    assert(disabled.open() == false);
+    assert(disabled.enabled() == false);
+
+    Generation generation(resolver);
+    assert(generation.open());
+    ReadCache cache(resolver, generation);
+    assert(cache.open());
+    assert(cache.enabled());
+
+    std::string path = resolver.getKeyPath("counter");
+    writeFile(path, "42");
+    FileIdentity identity;
+    assert(ReadCache::identityOf(path, identity));
+
+    cache.put("counter", 42, identity, cache.generation());
+    int value = 0;
+    assert(cache.get("counter", value) && value == 42);
+
+    // 类型不一致视为未命中
+    std::string str;
+    assert(cache.get("counter", str) == false);
+
+    cache.invalidate("counter");
+    assert(cache.get("counter", value) == false);
+    assert(cache.size() == 0);
+
+    std::cout << "  [PASS] test_cache_hit_and_type" << std::endl;
+}
+
+void test_cache_generation() {
+    PathResolver resolver("cache_unit", kRoot);
+    Generation generation(resolver);
+    assert(generation.open());
+    ReadCache cache(resolver, generation);
+    assert(cache.open());
+
+    std::string path = resolver.getKeyPath("counter");
+    FileIdentity identity;
+    assert(ReadCache::identityOf(path, identity));
+    cache.put("counter", 42, identity, cache.generation());
+
+    // 代数变化但文件未变：校验后继续命中
+    generation.bump();
+    int value = 0;
+    assert(cache.get("counter", value) && value == 42);
+
+    // 文件被替换（新 inode）且代数变化：条目失效
+    writeFile(path + ".tmp", "43");
+    assert(rename((path + ".tmp").c_str(), path.c_str()) == 0);
+    assert(cache.get("counter", value) && value == 42);
+    generation.bump();
+    assert(cache.get("counter", value) == false);
+
+    std::cout << "  [PASS] test_cache_generation" << std::endl;
+}
+
+void test_cache_memory_cap() {
+    PathResolver resolver("cache_unit", kRoot);
+    Generation generation(resolver);
+    assert(generation.open());
+    ReadCache cache(resolver, generation, 1024);
+    assert(cache.open());
+
+    FileIdentity identity;
+    for (int i = 0; i < 20; ++i) {
+        cache.put("key" + std::to_string(i), std::string(100, 'x'), identity, cache.generation());
+        assert(cache.bytes() <= 1024);
+    }
+    assert(cache.size() < 20);
+
+    // 最近写入的保留，最早的被淘汰
+    std::string value;
+    assert(cache.get("key19", value) && value.size() == 100);
+    assert(cache.get("key0", value) == false);
+
+    // 单条超过上限不缓存
+    cache.put("huge", std::string(4096, 'x'), identity, cache.generation());
+    assert(cache.get("huge", value) == false);
+
+    std::cout << "  [PASS] test_cache_memory_cap" << std::endl;
+}
+
+void test_store_coherence() {
+    // 两个 Store 实例各自持有缓存，模拟两个进程
+    Store reader = Store::open("cache_svc", kRoot);
+    Store writer = Store::open("cache_svc", kRoot);
+
+    writer.save<int>("counter", 1);
+    assert(reader.load<int>("counter") == 1);
+    assert(reader.load<int>("counter") == 1);
+
+    writer.save<int>("counter", 2);
+    assert(reader.load<int>("counter") == 2);
+
+    writer.save<std::string>("name", "a");
+    assert(reader.load<std::string>("name") == "a");
+    writer.remove("name");
+    assert(reader.loadOr<std::string>("name", "none") == "none");
+
+    // 关闭读缓存时行为不变
+    StoreOptions options;
+    options.readCache = false;
+    Store uncached = Store::open("cache_svc", kRoot, options);
+    assert(uncached.load<int>("counter") == 2);
+    writer.save<int>("counter", 3);
+    assert(uncached.load<int>("counter") == 3);
+    assert(reader.load<int>("counter") == 3);
+
+    writer.cleanup();
+    system(("rm -rf " + kRoot).c_str());
+    std::cout << "  [PASS] test_store_coherence" << std::endl;
+}
+
+void test_failed_write_publishes() {
+    system(("rm -rf " + kRoot).c_str());
+    PathResolver resolver("cache_svc", kRoot);
+    Store store = Store::open("cache_svc", kRoot);
+    store.save<int>("counter", 1);
+    assert(store.load<int>("counter") == 1);
+
+    Generation generation(resolver);
+    assert(generation.open());
+    uint64_t before = generation.load();
+
+    // 临时文件位置被非空目录占据，写入失败
+    system(("mkdir -p " + resolver.getTempPath("counter") + "/busy").c_str());
+    try {
+        store.save<int>("counter", 2);
+        assert(false);
+    } catch (const StoreException& e) {
+        assert(e.getError().code == StoreError::kAtomicWriteFailed);
+    }
+    // 失败的写入同样递增代数，其他实例据此重新校验缓存
+    assert(generation.load() > before);
+    assert(store.load<int>("counter") == 1);
+
+    system(("rm -rf " + resolver.getTempPath("counter")).c_str());
+    store.save<int>("counter", 3);
+    assert(store.load<int>("counter") == 3);
+
+    store.cleanup();
+    system(("rm -rf " + kRoot).c_str());
+    std::cout << "  [PASS] test_failed_write_publishes" << std::endl;
+}
+
+int main() {
+    std::cout << "Running ReadCache tests..." << std::endl;
+    test_cache_hit_and_type();
+    test_cache_generation();
+    test_cache_memory_cap();
+    test_store_coherence();
+    test_failed_write_publishes();
+    std::cout << "All ReadCache tests passed!" << std::endl;
+    return 0;
+}
@@ -1,8 +1,14 @@
 #include "store/store_serializer.h"
+#include "store/store_crc32c.h"
+#include "store.h"
 #include <cassert>
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
 
 using namespace hwyz::store;
 
@@ -67,12 +73,181 @@ void test_invalid_deserialization() {
     assert(success == false);
 }
 
+void test_binary_layout() {
+    Serializer serializer;
+
+    std::string bytes = serializer.serialize<int>(0x01020304);
+    assert(bytes.size() == Serializer::kHeaderSize + 4);
+    assert(static_cast<uint8_t>(bytes[0]) == 0xFE && bytes[1] == 0x53);
+    assert(bytes[2] == Serializer::kVersion);
+    assert(bytes[3] == kTagInt32);
+    assert(bytes[4] == 4 && bytes[5] == 0 && bytes[6] == 0 && bytes[7] == 0);
+    // 小端 payload
+    assert(bytes[12] == 0x04 && bytes[13] == 0x03 && bytes[14] == 0x02 && bytes[15] == 0x01);
+
+    assert(serializer.serialize<bool>(true).size() == Serializer::kHeaderSize + 1);
+    assert(serializer.serialize<std::string>("").size() == Serializer::kHeaderSize);
+    std::cout << "  [PASS] test_binary_layout" << std::endl;
+}
+
+void test_round_trip_precision() {
+    Serializer serializer;
+
+    double values[] = {0.1, 1.0 / 3.0, -2.5e-300, 123456789.123456789};
+    for (double value : values) {
+        double result = 0.0;
+        assert(serializer.deserialize(serializer.serialize(value), result));
+        assert(result == value);
+    }
+
+    int64_t big = INT64_MIN;
+    int64_t bigResult = 0;
+    assert(serializer.deserialize(serializer.serialize(big), bigResult) && bigResult == big);
+
+    uint16_t small = 65535;
+    uint16_t smallResult = 0;
+    assert(serializer.deserialize(serializer.serialize(small), smallResult) && smallResult == small);
+
+    std::string binary("a\0b\xFE\x53", 5);
+    std::string binaryResult;
+    assert(serializer.deserialize(serializer.serialize(binary), binaryResult) && binaryResult == binary);
+
+    std::string empty = "x";
+    assert(serializer.deserialize(serializer.serialize(std::string()), empty) && empty.empty());
+    std::cout << "  [PASS] test_round_trip_precision" << std::endl;
+}
+
+void test_type_mismatch() {
+    Serializer serializer;
+
+    int intResult = 7;
+    assert(serializer.deserialize(serializer.serialize<std::string>("42"), intResult) == false);
+    assert(serializer.deserialize(serializer.serialize<double>(42.0), intResult) == false);
+    assert(serializer.deserialize(serializer.serialize<int64_t>(42), intResult) == false);
+    assert(intResult == 7);
+
+    std::string stringResult;
+    assert(serializer.deserialize(serializer.serialize<int>(42), stringResult) == false);
+
+    bool boolResult = false;
+    assert(serializer.deserialize(serializer.serialize<int>(1), boolResult) == false);
+    std::cout << "  [PASS] test_type_mismatch" << std::endl;
+}
+
+void test_corruption_detected() {
+    Serializer serializer;
+
+    std::string bytes = serializer.serialize<std::string>("hello world");
+    std::string result;
+    for (size_t i = 2; i < bytes.size(); ++i) {
+        std::string corrupt = bytes;
+        corrupt[i] ^= 0x10;
+        assert(serializer.deserialize(corrupt, result) == false);
+    }
+
+    // 截断
+    assert(serializer.deserialize(bytes.substr(0, bytes.size() - 1), result) == false);
+    assert(serializer.deserialize(bytes.substr(0, 6), result) == false);
+
+    std::string doubleBytes = serializer.serialize<double>(2.5);
+    doubleBytes[14] ^= 0x01;
+    double value = 0.0;
+    assert(serializer.deserialize(doubleBytes, value) == false);
+    std::cout << "  [PASS] test_corruption_detected" << std::endl;
+}
+
+void test_legacy_text() {
+    Serializer serializer;
+
+    int intResult = 0;
+    assert(serializer.deserialize(std::string("42"), intResult) && intResult == 42);
+    assert(serializer.deserialize(std::string("-7"), intResult) && intResult == -7);
+    // 旧格式中混入多余字符不再被部分解析
+    assert(serializer.deserialize(std::string("12abc"), intResult) == false);
+
+    double doubleResult = 0.0;
+    assert(serializer.deserialize(std::string("3.14159"), doubleResult) && doubleResult == 3.14159);
+
+    bool boolResult = false;
+    assert(serializer.deserialize(std::string("1"), boolResult) && boolResult == true);
+
+    std::string stringResult;
+    assert(serializer.deserialize(std::string("legacy text"), stringResult) && stringResult == "legacy text");
+    std::cout << "  [PASS] test_legacy_text" << std::endl;
+}
+
+void test_crc32c() {
+    // RFC 3720 校验值
+    assert(crc32c("123456789", 9) == 0xE3069283u);
+    assert(crc32cPortable("123456789", 9) == 0xE3069283u);
+
+    // 硬件与查表实现一致：各种长度与非对齐起点，以及分段累计
+    std::vector<char> data(1031);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 131 + 7);
+    }
+    for (size_t offset = 0; offset < 9; ++offset) {
+        for (size_t size = 0; size + offset <= data.size(); size += 37) {
+            assert(crc32c(data.data() + offset, size) == crc32cPortable(data.data() + offset, size));
+        }
+    }
+    uint32_t whole = crc32c(data.data(), data.size());
+    assert(crc32c(data.data() + 500, data.size() - 500, crc32c(data.data(), 500)) == whole);
+
+    std::cout << "  [PASS] test_crc32c (hardware: " << (crc32cHardware() ? "yes" : "no") << ")" << std::endl;
+}
+
+void test_store_integration() {
+    const std::string root = "/tmp/tbox_test_store_serializer";
+    system(("rm -rf " + root).c_str());
+    Store store = Store::open("serializer_svc", root);
+
+    store.save<std::string>("name", "tbox");
+    try {
+        store.load<int>("name");
+        assert(false);
+    } catch (const StoreException& e) {
+        assert(e.getError().code == StoreError::kSerializationFailed);
+    }
+
+    // 损坏的值抛出序列化异常
+    store.save<int>("counter", 5);
+    {
+        std::fstream fs(root + "/serializer_svc/counter.dat", std::ios::in | std::ios::out | std::ios::binary);
+        fs.seekp(Serializer::kHeaderSize);
+        fs.write("\x09", 1);
+    }
+    // 旧版文本文件（绕过 Store 写入，重新打开后可见）
+    {
+        std::ofstream ofs(root + "/serializer_svc/legacy.dat", std::ios::binary);
+        ofs << "2.718281828";
+    }
+    Store reopened = Store::open("serializer_svc", root);
+    assert(reopened.load<double>("legacy") == 2.718281828);
+    try {
+        reopened.load<int>("counter");
+        assert(false);
+    } catch (const StoreException& e) {
+        assert(e.getError().code == StoreError::kSerializationFailed);
+    }
+
+    system(("rm -rf " + root).c_str());
+    std::cout << "  [PASS] test_store_integration" << std::endl;
+}
+
 int main() {
     test_int_serialization();
     test_string_serialization();
     test_double_serialization();
     test_bool_serialization();
     test_invalid_deserialization();
+    test_binary_layout();
+    test_round_trip_precision();
+    test_type_mismatch();
+    test_corruption_detected();
+    test_legacy_text();
+    test_crc32c();
+    test_store_integration();
     std::cout << "All serializer tests passed!" << std::endl;
     return 0;
 }
@@ -0,0 +1,360 @@
+#include "store.h"
+#include "store/store_journal.h"
+#include "store/store_log_engine.h"
+#include "store/store_file_lock.h"
+#include <cassert>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <thread>
+#include <future>
+#include <chrono>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+using namespace hwyz::store;
+
+static const std::string kRoot = "/tmp/tbox_test_store_batch";
+
+static size_t countJournals(const std::string& dir) {
+    size_t count = 0;
+    DIR* d = opendir(dir.c_str());
+    if (!d) return 0;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr) {
+        if (std::string(entry->d_name).rfind(".journal-", 0) == 0) ++count;
+    }
+    closedir(d);
+    return count;
+}
+
+void test_batch_commit() {
+    system(("rm -rf " + kRoot).c_str());
+    Store store = Store::open("batch_svc", kRoot);
+    store.save<std::string>("provision.pending", "yes");
+
+    auto batch = store.batch();
+    batch.put<std::string>("provision.vin", "LSV123")
+         .put<int>("provision.step", 1)
+         .put<int>("provision.step", 3)
+         .put<double>("provision.ratio", 0.5)
+         .remove("provision.pending");
+    // 同一 key 只保留最后一次操作
+    assert(batch.size() == 4);
+
+    // 提交前不可见
+    assert(store.has("provision.vin") == false);
+    batch.commit();
+    assert(batch.size() == 0);
+
+    assert(store.load<std::string>("provision.vin") == "LSV123");
+    assert(store.load<int>("provision.step") == 3);
+    assert(store.load<double>("provision.ratio") == 0.5);
+    assert(store.has("provision.pending") == false);
+    assert(countJournals(kRoot + "/batch_svc") == 0);
+
+    // 空批次直接返回
+    store.batch().commit();
+
+    Store reopened = Store::open("batch_svc", kRoot);
+    assert(reopened.load<int>("provision.step") == 3);
+    std::cout << "  [PASS] test_batch_commit" << std::endl;
+}
+
+void test_journal_roll_forward() {
+    system(("rm -rf " + kRoot).c_str());
+    PathResolver resolver("journal_svc", kRoot);
+    assert(resolver.ensureDirectory());
+    std::string storePath = resolver.getStorePath();
+
+    // 第二个 key 的临时文件路径被非空目录占用：应用到一半失败，重试亦然，journal 保留
+    assert(system(("mkdir -p " + resolver.getTempPath("b") + "/busy").c_str()) == 0);
+    Journal journal(resolver);
+    Mutation a{"a", "1", false};
+    Mutation b{"b", "2", false};
+    assert(journal.commit({a, b}) == Journal::Result::kPending);
+    assert(countJournals(storePath) == 1);
+
+    // 打开存储时前滚：两个 key 同时生效
+    system(("rm -rf " + resolver.getTempPath("b")).c_str());
+    Store store = Store::open("journal_svc", kRoot);
+    assert(store.load<int>("a") == 1);
+    assert(store.load<int>("b") == 2);
+    assert(countJournals(storePath) == 0);
+
+    // 残缺 journal：新的保留（可能正在写入），旧的丢弃，均不应用
+    std::string torn = storePath + ".journal-1-1";
+    {
+        std::ofstream ofs(torn, std::ios::binary);
+        ofs << "TSJN-torn";
+    }
+    FileLock fileLock(resolver);
+    assert(journal.recover(fileLock) == 0);
+    assert(countJournals(storePath) == 1);
+    struct timeval old[2] = {{1000, 0}, {1000, 0}};
+    assert(utimes(torn.c_str(), old) == 0);
+    assert(journal.recover(fileLock) == 0);
+    assert(countJournals(storePath) == 0);
+    assert(store.load<int>("a") == 1);
+
+    store.cleanup();
+    std::cout << "  [PASS] test_journal_roll_forward" << std::endl;
+}
+
+void test_failed_commit_disables_store() {
+    system(("rm -rf " + kRoot).c_str());
+    PathResolver resolver("failed_svc", kRoot);
+    Store store = Store::open("failed_svc", kRoot);
+    store.save<int>("a", 1);
+    store.save<int>("b", 1);
+
+    // b 的临时文件路径被非空目录占用：应用与重试都失败，journal 保留
+    assert(system(("mkdir -p " + resolver.getTempPath("b") + "/busy").c_str()) == 0);
+    auto batch = store.batch();
+    batch.put<int>("a", 2).put<int>("b", 2);
+    try {
+        batch.commit();
+        assert(false);
+    } catch (const StoreException& e) {
+        assert(e.getError().code == StoreError::kAtomicWriteFailed);
+    }
+    assert(countJournals(resolver.getStorePath()) == 1);
+
+    // 之后的写入会在下次打开时被该批次覆盖：直接拒绝
+    assert(!store.isReady());
+    try {
+        store.save<int>("a", 3);
+        assert(false);
+    } catch (const StoreException& e) {
+        assert(e.getError().code == StoreError::kPathUnavailable);
+    }
+
+    // 重新打开时前滚，批次整体生效
+    system(("rm -rf " + resolver.getTempPath("b")).c_str());
+    Store reopened = Store::open("failed_svc", kRoot);
+    assert(reopened.isReady());
+    assert(reopened.load<int>("a") == 2);
+    assert(reopened.load<int>("b") == 2);
+    assert(countJournals(resolver.getStorePath()) == 0);
+    reopened.save<int>("a", 3);
+    assert(reopened.load<int>("a") == 3);
+
+    reopened.cleanup();
+    std::cout << "  [PASS] test_failed_commit_disables_store" << std::endl;
+}
+
+void test_batch_write_back() {
+    system(("rm -rf " + kRoot).c_str());
+    StoreOptions options;
+    options.writeMode = WriteMode::kWriteBack;
+    options.flushPolicy.debounceMs = 60000;
+    Store store = Store::open("batch_wb", kRoot, options);
+
+    store.save<int>("counter", 1);
+    auto batch = store.batch();
+    batch.put<int>("counter", 2).put<int>("other", 5);
+    batch.commit();
+
+    // 批次覆盖未落盘的写回值，之后 flush 不会写回旧值
+    assert(store.load<int>("counter") == 2);
+    store.flush();
+    Store reader = Store::open("batch_wb", kRoot);
+    assert(reader.load<int>("counter") == 2);
+    assert(reader.load<int>("other") == 5);
+    store.cleanup();
+    std::cout << "  [PASS] test_batch_write_back" << std::endl;
+}
+
+void test_batch_races_write_back_save() {
+    system(("rm -rf " + kRoot).c_str());
+    StoreOptions options;
+    options.writeMode = WriteMode::kWriteBack;
+    options.flushPolicy.debounceMs = 60000;
+    Store store = Store::open("batch_race", kRoot, options);
+    PathResolver resolver("batch_race", kRoot);
+
+    store.save<int>("counter", 1);
+
+    // 另一锁文件描述持有 counter 的槽位：批次取完待落盘快照后阻塞在加锁上
+    FileLock holder(resolver);
+    std::promise<void> held;
+    std::promise<void> release;
+    std::thread locker([&] {
+        assert(holder.acquire("counter"));
+        held.set_value();
+        release.get_future().wait();
+        holder.release("counter");
+    });
+    held.get_future().get();
+
+    std::thread committer([&] {
+        auto batch = store.batch();
+        batch.put<int>("counter", 2);
+        batch.commit();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // 提交期间的写回 save 不被批次清除
+    store.save<int>("counter", 3);
+    release.set_value();
+    committer.join();
+    locker.join();
+
+    assert(store.load<int>("counter") == 3);
+    store.flush();
+    Store reader = Store::open("batch_race", kRoot);
+    assert(reader.load<int>("counter") == 3);
+    store.cleanup();
+    std::cout << "  [PASS] test_batch_races_write_back_save" << std::endl;
+}
+
+void test_remove_not_blocked_by_batch() {
+    system(("rm -rf " + kRoot).c_str());
+    Store store = Store::open("batch_remove", kRoot);
+    PathResolver resolver("batch_remove", kRoot);
+
+    std::string other = "other";
+    for (int i = 0; FileLock::slotOf(other) == FileLock::slotOf("counter"); ++i) {
+        other = "other" + std::to_string(i);
+    }
+    store.save<int>(other, 1);
+
+    // 批次阻塞在 counter 的加锁上时，其他 key 的 remove 不排队等待批次
+    FileLock holder(resolver);
+    std::promise<void> held;
+    std::promise<void> release;
+    std::thread locker([&] {
+        assert(holder.acquire("counter"));
+        held.set_value();
+        release.get_future().wait();
+        holder.release("counter");
+    });
+    held.get_future().get();
+
+    std::thread committer([&] {
+        auto batch = store.batch();
+        batch.put<int>("counter", 2);
+        batch.commit();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto start = std::chrono::steady_clock::now();
+    store.remove(other);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    assert(elapsed < std::chrono::milliseconds(500));
+    assert(store.has(other) == false);
+
+    release.set_value();
+    committer.join();
+    locker.join();
+    assert(store.load<int>("counter") == 2);
+    store.cleanup();
+    std::cout << "  [PASS] test_remove_not_blocked_by_batch" << std::endl;
+}
+
+void test_flush_races_remove() {
+    system(("rm -rf " + kRoot).c_str());
+    StoreOptions options;
+    options.writeMode = WriteMode::kWriteBack;
+    options.flushPolicy.debounceMs = 60000;
+    Store store = Store::open("flush_remove", kRoot, options);
+    PathResolver resolver("flush_remove", kRoot);
+
+    store.save<int>("counter", 1);
+
+    // 落盘取完快照后阻塞在 counter 的加锁上，此时 remove 同一 key
+    FileLock holder(resolver);
+    std::promise<void> held;
+    std::promise<void> release;
+    std::thread locker([&] {
+        assert(holder.acquire("counter"));
+        held.set_value();
+        release.get_future().wait();
+        holder.release("counter");
+    });
+    held.get_future().get();
+
+    std::thread flusher([&] { store.flush(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::thread remover([&] { store.remove("counter"); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    release.set_value();
+    flusher.join();
+    remover.join();
+    locker.join();
+
+    // 无论谁先拿到 key 锁，已删除的 key 都不会被旧快照写回
+    assert(store.has("counter") == false);
+    Store reader = Store::open("flush_remove", kRoot);
+    assert(reader.has("counter") == false);
+    store.cleanup();
+    std::cout << "  [PASS] test_flush_races_remove" << std::endl;
+}
+
+void test_log_engine_batch() {
+    system(("rm -rf " + kRoot).c_str());
+    StoreOptions options;
+    options.backend = StoreBackend::kLogStructured;
+    {
+        Store store = Store::open("batch_log", kRoot, options);
+        store.save<int>("c", 9);
+        auto batch = store.batch();
+        batch.put<int>("a", 1).put<int>("b", 2).remove("c");
+        batch.commit();
+        assert(store.load<int>("a") == 1);
+        assert(store.has("c") == false);
+    }
+    {
+        Store store = Store::open("batch_log", kRoot, options);
+        assert(store.load<int>("b") == 2);
+        assert(store.has("c") == false);
+    }
+
+    // 批次记录被截断：整批不生效
+    PathResolver resolver("batch_log", kRoot);
+    std::string logPath = resolver.getStorePath() + "store.log";
+    std::remove((resolver.getStorePath() + "store.ckpt").c_str());
+    struct stat st;
+    assert(stat(logPath.c_str(), &st) == 0);
+    {
+        LogEngine::Options engineOptions;
+        engineOptions.background = false;
+        LogEngine engine(resolver, engineOptions);
+        assert(engine.open());
+        assert(engine.commitBatch({{"x", "1", false}, {"y", "2", false}}));
+        engine.close(true);
+    }
+    struct stat after;
+    assert(stat(logPath.c_str(), &after) == 0);
+    assert(truncate(logPath.c_str(), after.st_size - 3) == 0);
+    {
+        LogEngine::Options engineOptions;
+        engineOptions.background = false;
+        LogEngine engine(resolver, engineOptions);
+        assert(engine.open());
+        assert(engine.contains("x") == false);
+        assert(engine.contains("y") == false);
+        assert(engine.contains("a") && engine.contains("b"));
+        assert(engine.fileBytes() == static_cast<uint64_t>(st.st_size));
+    }
+
+    system(("rm -rf " + kRoot).c_str());
+    std::cout << "  [PASS] test_log_engine_batch" << std::endl;
+}
+
+int main() {
+    std::cout << "Running WriteBatch tests..." << std::endl;
+    test_batch_commit();
+    test_journal_roll_forward();
+    test_failed_commit_disables_store();
+    test_batch_write_back();
+    test_batch_races_write_back_save();
+    test_remove_not_blocked_by_batch();
+    test_flush_races_remove();
+    test_log_engine_batch();
+    std::cout << "All WriteBatch tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,47 @@
+// tbox-flight-dump：离线提取飞行记录器环文件（进程崩溃后使用）
+//
+// 用法: tbox-flight-dump <path/to/<svc>.flight> [--tail N]
+// 输出: 每条记录一行 JSON，按 seq 升序
+
+#include "log/log_flight_recorder.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+using namespace tbox::fw::log;
+
+static void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " <flight-file> [--tail N]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::string path = argv[1];
+    size_t tail = 0;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--tail" && i + 1 < argc) {
+            tail = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<FlightRecord> records;
+    if (!FlightRecorder::readFile(path, records)) {
+        std::cerr << "Failed to read flight recorder file: " << path << std::endl;
+        return 1;
+    }
+
+    size_t first = (tail > 0 && records.size() > tail) ? records.size() - tail : 0;
+    for (size_t i = first; i < records.size(); ++i) {
+        std::cout << FlightRecorder::toJsonLine(records[i]) << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+// tbox-log-decode：把二进制日志段（file.format: binary）还原为 JSON 行
+//
+// 用法: tbox-log-decode <segment.tlog>...
+//       tbox-log-decode --dir <log-dir> <service>
+// 输出: 每条记录一行 JSON，与 JSON 文件 sink 的格式一致，可直接接 grep/jq
+
+#include "log/log_binary_sink.h"
+#include <iostream>
+#include <string>
+
+using namespace tbox::fw::log;
+
+static void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " <segment.tlog>..." << std::endl;
+    std::cerr << "       " << prog << " --dir <log-dir> <service>" << std::endl;
+}
+
+static bool printLine(std::string_view line) {
+    std::cout.write(line.data(), static_cast<std::streamsize>(line.size()));
+    std::cout << '\n';
+    return static_cast<bool>(std::cout);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::string first = argv[1];
+    if (first == "--dir") {
+        if (argc != 4) {
+            usage(argv[0]);
+            return 2;
+        }
+        LogErrorInfo error = BinaryLogReader::decodeDir(argv[2], argv[3], printLine);
+        if (error.code != LogError::kOk) {
+            std::cerr << error.message << ": " << error.detail << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    int status = 0;
+    for (int i = 1; i < argc; ++i) {
+        LogErrorInfo error = BinaryLogReader::decodeFile(argv[i], printLine);
+        if (error.code != LogError::kOk) {
+            std::cerr << error.message << ": " << error.detail << std::endl;
+            status = 1;
+        }
+    }
+    return status;
+}